@@ -29,6 +29,8 @@ option(ENABLE_AVX    "Enable compile-time AVX support."    ON)
 option(ENABLE_AVX2   "Enable compile-time AVX2 support."   ON)
 option(ENABLE_FMA    "Enable compile-time FMA support."    ON)
 option(ENABLE_AVX512 "Enable compile-time AVX512 support." ON)
+option(ENABLE_AESNI  "Enable compile-time AES-NI support." ON)
+option(ENABLE_PCLMUL "Enable compile-time PCLMULQDQ support." ON)
 
 if (ENABLE_SSE)
     #
@@ -156,6 +158,60 @@ if (ENABLE_SSE)
         endif()
     endif()
 
+    if (ENABLE_AESNI)
+
+        #
+        # Check compiler for AES-NI intrinsics
+        #
+        if (CMAKE_COMPILER_IS_GNUCC OR (CMAKE_C_COMPILER_ID MATCHES "Clang") OR (CMAKE_CXX_COMPILER_ID MATCHES "Clang"))
+            set(CMAKE_REQUIRED_FLAGS "-msse4.1 -maes")
+            check_c_source_runs("
+            #include <smmintrin.h>
+            #include <wmmintrin.h>
+            int main()
+            {
+              __m128i k = _mm_set1_epi8(0);
+              __m128i b = _mm_aesenclast_si128(k, k);
+              __m128i a = _mm_aeskeygenassist_si128(k, 1);
+              /* SubBytes(0) = 0x63, RotWord(SubWord(0)) ^ rcon = 0x63636362 */
+              if( _mm_extract_epi32(b, 0) != 0x63636363 || _mm_extract_epi32(a, 1) != 0x63636362 ){
+                return -1;
+              }
+              return 0;
+            }"
+                    HAVE_AESNI)
+        endif()
+
+        if (HAVE_AESNI)
+            message(STATUS "AES-NI is enabled - target CPU must support it")
+        endif()
+    endif()
+
+    if (ENABLE_PCLMUL)
+
+        #
+        # Check compiler for carry-less multiplication intrinsics
+        #
+        if (CMAKE_COMPILER_IS_GNUCC OR (CMAKE_C_COMPILER_ID MATCHES "Clang") OR (CMAKE_CXX_COMPILER_ID MATCHES "Clang"))
+            set(CMAKE_REQUIRED_FLAGS "-msse4.1 -mpclmul")
+            check_c_source_runs("
+            #include <smmintrin.h>
+            #include <wmmintrin.h>
+            int main()
+            {
+              /* (x + 1) * (x + 1) = x^2 + 1 without carries */
+              __m128i a = _mm_cvtsi32_si128(3);
+              __m128i r = _mm_clmulepi64_si128(a, a, 0x00);
+              return _mm_extract_epi32(r, 0) == 5 ? 0 : -1;
+            }"
+                    HAVE_PCLMUL)
+        endif()
+
+        if (HAVE_PCLMUL)
+            message(STATUS "PCLMULQDQ is enabled - target CPU must support it")
+        endif()
+    endif()
+
     if (ENABLE_AVX512)
 
         #
@@ -207,4 +263,4 @@ if (ENABLE_SSE)
 
 endif()
 
-mark_as_advanced(HAVE_SSE, HAVE_AVX, HAVE_AVX2, HAVE_FMA, HAVE_AVX512)
+mark_as_advanced(HAVE_SSE, HAVE_AVX, HAVE_AVX2, HAVE_FMA, HAVE_AVX512, HAVE_AESNI, HAVE_PCLMUL)
@@ -7,11 +7,21 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <pthread.h>
+#include <getopt.h>
 #include <mutex>
+#include <algorithm>
 
-#include "src/ue_packet_handler.h"
-#include "src/gnb_packet_handler.h"
-#include "src/json_packet_maker.h"
+#include "src/decode_cache.h"
+#include "src/nas_security.h"
+#include "src/drb_lane.h"
+#include "src/pdcp_relay.h"
+#include "src/mac_tap.h"
+#include "src/gtpu_relay.h"
+#include "src/n2_relay.h"
+#include "src/rat_codec.h"
+
+#include "mitm_lib/asn1/rrc_nr_containers.h"
+#include "mitm_lib/common/buffer_pool.h"
 
 
 #define LOOPBACK_IP ("127.123.123.24")
@@ -21,6 +31,17 @@
 #define FAKE_UE_SERVER_PORT (8080)
 #define FAKE_gNB_SERVER_PORT (9090)
 
+// N3 mode: the gNB sends its GTP-U to the first address, the UPF to the second one
+#define N3_gNB_SIDE_IP (LOOPBACK_IP)
+#define N3_UPF_SIDE_IP ("127.123.123.25")
+#define GTPU_PORT (2152)
+
+// N2 mode: the gNB or eNB connects its NGAP or S1AP association to this address, on the port of the protocol
+#define N2_RAN_SIDE_IP (LOOPBACK_IP)
+
+#define DECODE_CACHE_SIZE (1024)
+#define DECODE_CACHE_REPORT_PERIOD (1000)
+
 enum RELAY_DIR 
 {
   FROM_FAKE_UE,
@@ -29,7 +50,7 @@ enum RELAY_DIR
 
 struct sockaddr_in fake_UE_server_addr;
 struct sockaddr_in fake_gNB_server_addr;
-struct sockaddr_in fake_UE_addr, fake_gNB_addr;
+peer_addr fake_UE_addr, fake_gNB_addr;
 
 struct sockaddr_in scenario_handler_addr;
 
@@ -37,17 +58,167 @@ int fake_UE_server_sock;
 int fake_gNB_server_sock;
 
 int scenario_handler_sock;
+int drb_sample_sock;
 
 int msg_count = 10;
 std::string packet2send;
 
+// RRC and NAS codecs of the session, NR unless -r says otherwise
+const rat_codec* codec = &nr_codec;
+
+// RRC containers (-c) decoded inline in the renderings, none unless subscribed
+const asn1::container_registry* rrc_containers = NULL;
+
+// Replayed and fuzzed scenarios resend the same PDUs, which are rendered only once
+decode_cache pdu_cache(DECODE_CACHE_SIZE);
+uint64_t nof_decoded = 0;
+
+// User-plane traffic is relayed by the lanes, the workers only see what the lanes queue for them
+drb_lane* relay_lanes[2];
+uint32_t drb_sample_period = 0;
+
+// PDCP mode: the datagrams carry PDCP PDUs, which are terminated and re-originated by the relays of the SRBs (used by the
+// workers) and of the DRBs (used by the lanes)
+uint8_t pdcp_drb_sn_len = 0;
+pdcp_relay* srb_relays[2];
+pdcp_relay* drb_relays[2];
+
+// MAC mode: the datagrams carry NR transport blocks, DL-SCH from the fake UE and UL-SCH from the fake gNB. The taps of
+// the workers are only used under the worker lock, the lanes have taps of their own
+bool mac_mode = false;
+mac_tap* mac_taps[2];
+
+// N3 mode: GTP-U between the gNB and the UPF is relayed too, with the TEIDs of the rewrite table rewritten on the way.
+// The gNB address is learnt from its uplink
+peer_addr gNB_n3_addr, UPF_n3_addr;
+int n3_gNB_side_sock, n3_UPF_side_sock;
+gtpu_relay* n3_uplink = NULL;
+gtpu_relay* n3_downlink = NULL;
+
+// N2 mode: NGAP or S1AP between the RAN node and the AMF or MME is relayed through the scenario handler. The NAS PDUs
+// it carries are decoded with the same NAS security context as the workers', under decode_mutex. The workers also hold
+// it while they spoof, which may protect a NAS message with that context
+std::mutex decode_mutex;
+n2_relay* n2 = NULL;
+n2_sctp* n2_associations = NULL;
+
+int decode_dlsch(uint8_t *buf, int n, asn1::json_writer &json_buffer) {
+  return mac_taps[FROM_FAKE_UE]->decode(buf, n, json_buffer);
+}
+
+int decode_ulsch(uint8_t *buf, int n, asn1::json_writer &json_buffer) {
+  return mac_taps[FROM_FAKE_gNB]->decode(buf, n, json_buffer);
+}
+
+void* lane_worker(void *arg) {
+  ((drb_lane*)arg)->run();
+  return NULL;
+}
+
+void* n3_worker(void *arg) {
+  ((gtpu_relay*)arg)->run();
+  return NULL;
+}
+
+void* n2_worker(void *arg) {
+  ((n2_sctp*)arg)->run(*n2);
+  return NULL;
+}
+
+// Reads the TEID rewrite table: lines of "ul|dl TEID rewritten-TEID", in decimal or 0x-prefixed hexadecimal. Blank
+// lines and lines starting with # are skipped
+bool load_teid_rewrites(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL) {
+    perror(path);
+    return false;
+  }
+  char line[256];
+  int line_nr = 0;
+  bool ok = true;
+  while (ok && fgets(line, sizeof(line), f) != NULL) {
+    line_nr++;
+    char dir[8], teid_in[32], teid_out[32];
+    char *p = line + strspn(line, " \t");
+    if (*p == '#' || *p == '\n' || *p == '\0') {
+      continue;
+    }
+    char *end_in, *end_out;
+    ok = sscanf(p, "%7s %31s %31s", dir, teid_in, teid_out) == 3 && (!strcmp(dir, "ul") || !strcmp(dir, "dl"));
+    unsigned long in = ok ? strtoul(teid_in, &end_in, 0) : 0;
+    unsigned long out = ok ? strtoul(teid_out, &end_out, 0) : 0;
+    ok = ok && *end_in == '\0' && *end_out == '\0' && in <= UINT32_MAX && out <= UINT32_MAX;
+    if (!ok) {
+      fprintf(stderr, "%s:%d: expected \"ul|dl TEID rewritten-TEID\"\n", path, line_nr);
+      break;
+    }
+    (strcmp(dir, "ul") == 0 ? n3_uplink : n3_downlink)->add_teid_rewrite(in, out);
+  }
+  fclose(f);
+  return ok;
+}
+
+// Next datagram for the worker of dir_v. In PDCP mode the SRB PDUs are terminated first, and every SDU they deliver is
+// handed out in a datagram of its own
+int next_control_datagram(enum RELAY_DIR dir_v, uint8_t *buf, int size) {
+  pdcp_relay *relay = srb_relays[dir_v];
+  while (1) {
+    uint32_t lcid;
+    if (relay != NULL) {
+      srsran::unique_byte_buffer_t sdu = relay->pop_sdu(lcid);
+      if (sdu != nullptr) {
+        int n = std::min((int)(sizeof(lcid) + sdu->N_bytes), size);
+        memcpy(buf, &lcid, sizeof(lcid));
+        memcpy(buf + sizeof(lcid), sdu->msg, n - sizeof(lcid));
+        return n;
+      }
+    }
+
+    int n = relay_lanes[dir_v]->pop_control(buf, size);
+    if (n < (int)sizeof(lcid) || relay == NULL) {
+      return n;
+    }
+    memcpy(&lcid, buf, sizeof(lcid));
+    if (!pdcp_relay::has_pdcp(lcid)) {
+      return n;
+    }
+    relay->update_security();
+    relay->terminate(lcid, buf + sizeof(lcid), n - sizeof(lcid));
+  }
+}
+
+// Sends a datagram to the destination, with a PDCP layer of the relay's own in PDCP mode
+void relay_send(enum RELAY_DIR dir_v, int sock, struct sockaddr_in *dst, uint8_t *datagram, int n) {
+  uint32_t lcid = 0;
+  if (n >= (int)sizeof(lcid)) {
+    memcpy(&lcid, datagram, sizeof(lcid));
+  }
+  if (srb_relays[dir_v] == NULL || !pdcp_relay::has_pdcp(lcid)) {
+    sendto(sock, datagram, n, 0, (struct sockaddr *)dst, sizeof(*dst));
+    return;
+  }
+
+  srsran::unique_byte_buffer_t pdu = srb_relays[dir_v]->reoriginate(lcid, datagram + sizeof(lcid), n - sizeof(lcid));
+  if (pdu == nullptr) {
+    return;
+  }
+  struct iovec iov[2] = {{&lcid, sizeof(lcid)}, {pdu->msg, pdu->N_bytes}};
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = dst;
+  msg.msg_namelen = sizeof(*dst);
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 2;
+  sendmsg(sock, &msg, 0);
+}
+
 
 void* worker(void *arg) {
   static std::mutex m;
   std::cout << "Thread Created!\n";
 
   int *fake_src_sock, *fake_dst_sock;
-  struct sockaddr_in *fake_src_addr, *fake_dst_addr;
+  peer_addr *fake_src_addr, *fake_dst_addr;
 
   enum RELAY_DIR dir_v = *(enum RELAY_DIR *)arg;
 
@@ -71,24 +242,55 @@ void* worker(void *arg) {
 
   while(1) {
     uint8_t buf[65535];
-    socklen_t sn=sizeof(*fake_src_addr);
 
     int result;
-    asn1::json_writer * json_buffer = new asn1::json_writer;
     std::cout << "Waiting" <<std::endl;
-    int n=recvfrom(*fake_src_sock,buf,sizeof(buf),0,(struct sockaddr *)fake_src_addr,&sn);
+    int n = next_control_datagram(dir_v, buf, sizeof(buf));
+    if (n < 0) {
+      break;
+    }
+    asn1::json_writer * json_buffer = new asn1::json_writer;
+    json_buffer->set_containers(rrc_containers);
 
     m.lock();
     
+    bool new_as_ctx = false;
+    decode_mutex.lock();
     json_buffer->start_array();
     if(dir_v == FROM_FAKE_UE){  //Target gNB's packet is arrive here
-      result = gNB::decode_packet(buf, n, *json_buffer);
+      result = pdu_cache.decode(dir_v, buf, n, *json_buffer, mac_mode ? decode_dlsch : codec->decode_dl);
     }else if(dir_v ==FROM_FAKE_gNB){  //Target UE's packet is arrive here
-      result = UE::decode_packet(buf, n, *json_buffer);
+      result = pdu_cache.decode(dir_v, buf, n, *json_buffer, mac_mode ? decode_ulsch : codec->decode_ul);
     }else{
       std::cerr << "Error: Undefined dir_v!"<< std::endl;
     }
     json_buffer->end_array();
+    decode_mutex.unlock();
+
+    // An RRC Security Mode Command is re-originated with integrity protection only, ciphering starts after it
+    if (srb_relays[dir_v] != NULL) {
+      new_as_ctx = srb_relays[dir_v]->update_security(false);
+    }
+
+    if (++nof_decoded % DECODE_CACHE_REPORT_PERIOD == 0) {
+      std::cout << pdu_cache.metrics_to_string() << std::endl;
+      std::cout << "UE->gNB " << relay_lanes[FROM_FAKE_UE]->metrics_to_string() << std::endl;
+      std::cout << "gNB->UE " << relay_lanes[FROM_FAKE_gNB]->metrics_to_string() << std::endl;
+      if (srb_relays[dir_v] != NULL) {
+        std::cout << "SRB " << srb_relays[dir_v]->metrics_to_string() << std::endl;
+      }
+      if (mac_mode) {
+        std::cout << mac_taps[dir_v]->metrics_to_string() << std::endl;
+      }
+      if (n3_uplink != NULL) {
+        std::cout << "N3 UL " << n3_uplink->metrics_to_string() << std::endl;
+        std::cout << "N3 DL " << n3_downlink->metrics_to_string() << std::endl;
+      }
+      if (n2 != NULL) {
+        std::cout << n2->metrics_to_string() << std::endl;
+      }
+      std::cout << srsran::byte_buffer_pool::get_instance()->metrics_to_string() << std::endl;
+    }
 
     std::string to_scenario_handler = json_buffer->to_string();
 
@@ -101,31 +303,49 @@ void* worker(void *arg) {
     if(buf2[0] == 0)
     {
       std::cout << "Relay" <<std::endl;
-      if(n>0 && fake_dst_addr->sin_port>0) {
-      sendto(*fake_dst_sock,buf,n,0,(struct sockaddr *)fake_dst_addr,sizeof(*fake_dst_addr));
+      struct sockaddr_in dst_addr = fake_dst_addr->load();
+      if(n>0 && dst_addr.sin_port>0) {
+      relay_send(dir_v, *fake_dst_sock, &dst_addr, buf, n);
 
-      printf("fake_src_sock: %d, fake_dst_sock: %d, fake_dst_addr port: %d, fake_src_addr port: %d, size: %d\n", *fake_src_sock, *fake_dst_sock, fake_dst_addr->sin_port, fake_src_addr->sin_port, n);
+      printf("fake_src_sock: %d, fake_dst_sock: %d, fake_dst_addr port: %d, fake_src_addr port: %d, size: %d\n", *fake_src_sock, *fake_dst_sock, dst_addr.sin_port, fake_src_addr->load().sin_port, n);
       }
     }else if(buf2[0] == 1)
     {
       //Handle Spoofing message here
       char json_char[65535];
       uint8_t* spoofed_msg;
+      int spoofed_size = 0;
 
       for (int i=0; i<n2-1; i++) {
         json_char[i] = (char)buf2[i+1];
       }
       std::string json_string = json_char;
       
-      spoofed_msg = jsonPacketMaker::json_to_packet(json_string, buf, n);
+      if (mac_mode) {
+        // A TB the spoofed SDU does not fit in goes out unchanged
+        spoofed_msg = (uint8_t*)mac_taps[dir_v]->spoof(json_string, buf, n, spoofed_size);
+        if (spoofed_msg == NULL) {
+          spoofed_msg = buf;
+          spoofed_size = n;
+        }
+      } else {
+        // Spoofing a NAS Security Mode Command protects it with the NAS security context the N2 lanes use too
+        std::lock_guard<std::mutex> lock(decode_mutex);
+        spoofed_msg = (dir_v == FROM_FAKE_UE ? codec->spoof_dl : codec->spoof_ul)(json_string, buf, n, spoofed_size);
+      }
 
-      if(n>0 && fake_dst_addr->sin_port>0) {
-      sendto(*fake_dst_sock,spoofed_msg,n2-1,0,(struct sockaddr *)fake_dst_addr,sizeof(*fake_dst_addr));
+      struct sockaddr_in dst_addr = fake_dst_addr->load();
+      if(n>0 && dst_addr.sin_port>0) {
+      relay_send(dir_v, *fake_dst_sock, &dst_addr, spoofed_msg, spoofed_size);
 
-      printf("fake_src_sock: %d, fake_dst_sock: %d, fake_dst_addr port: %d, fake_src_addr port: %d, size: %d\n", *fake_src_sock, *fake_dst_sock, fake_dst_addr->sin_port, fake_src_addr->sin_port, n);
+      printf("fake_src_sock: %d, fake_dst_sock: %d, fake_dst_addr port: %d, fake_src_addr port: %d, size: %d\n", *fake_src_sock, *fake_dst_sock, dst_addr.sin_port, fake_src_addr->load().sin_port, spoofed_size);
       }
     }
     
+    if (new_as_ctx) {
+      srb_relays[dir_v]->enable_ciphering();
+    }
+
     delete json_buffer;
 
     m.unlock();
@@ -133,23 +353,112 @@ void* worker(void *arg) {
   return NULL;
 };
 
+void usage(char* prog) {
+  printf("Usage: %s [-k K -o OPc -i IMSI [-s serving network name]] [-d N] [-p SN length | -m] [-u UPF [-t TEIDs]]"
+         " [-a AMF [-e]] [-r RAT] [-c containers]\n",
+         prog);
+  printf("\t-k Subscriber key K, enables NAS deciphering and re-protection\n");
+  printf("\t-o Subscriber OPc\n");
+  printf("\t-i Subscriber IMSI, used as SUPI\n");
+  printf("\t-s Serving network name [Default 5G:mncXXX.mccXXX.3gppnetwork.org from the IMSI with a 2 digit MNC]\n");
+  printf("\t-p Terminate and re-originate PDCP on every bearer, with this DRB SN length (12 or 18) [Default off]\n");
+  printf("\t   The scenario handler's verdicts: 0 relays, 1 spoofs, anything else drops the message\n");
+  printf("\t-m The datagrams carry NR MAC transport blocks, whose SDUs are decoded and whose MAC CEs are reported\n");
+  printf("\t   A spoofed SDU replaces the first SRB SDU of the transport block [Default off]\n");
+  printf("\t-d Report every Nth DRB packet to the scenario handler, without waiting for a verdict [Default 0, never]\n");
+  printf("\t-u Relay the GTP-U of N3 to this UPF address [Default off]\n");
+  printf("\t   The gNB must send its GTP-U to %s:%d, and advertise %s:%d to the core as its own\n", N3_gNB_SIDE_IP,
+         GTPU_PORT, N3_UPF_SIDE_IP, GTPU_PORT);
+  printf("\t-t TEID rewrite table of the N3 relay, lines of \"ul|dl TEID rewritten-TEID\" [Default none]\n");
+  printf("\t-a Relay the NGAP of N2 to this AMF address, through the scenario handler [Default off]\n");
+  printf("\t   The gNB must connect to %s:%d, the relay connects to the AMF on its behalf\n", N2_RAN_SIDE_IP,
+         n2_relay::port(n2_relay::NGAP));
+  printf("\t   A spoofing verdict is {\"NAS-PDU\": hex string or array of them} or {\"PDU\": hex string}\n");
+  printf("\t-e Relay S1AP between an eNB and the MME given with -a instead, on port %d [Default off]\n",
+         n2_relay::port(n2_relay::S1AP));
+  printf("\t-r Radio access technology of the UE and the base station, nr or lte [Default nr]\n");
+  printf("\t   On LTE the datagrams carry EUTRA RRC with EPS NAS, and a spoofing verdict is\n");
+  printf("\t   {\"NAS-PDU\": hex string or array of them} or {\"PDU\": hex string}. -p and -m are NR only\n");
+  printf("\t-c Decode the RRC containers of these types inline, e.g. CellGroupConfig,UE-NR-Capability, or all\n");
+  printf("\t   [Default none, shown as hex]. On NR a spoofing verdict may also be {\"set\": {\"path\": value}},\n");
+  printf("\t   with field paths that go through every container\n");
+}
+
 int main(int argc, char *argv[]) {
-  memset(&fake_UE_addr,0,sizeof(struct sockaddr_in));
+  std::string k, opc, imsi, serving_network_name, upf_ip, teid_table, amf_ip;
+  n2_relay::protocol_t n2_protocol = n2_relay::NGAP;
+  int opt;
+  while ((opt = getopt(argc, argv, "k:o:i:s:d:p:mu:t:a:er:c:h")) != -1) {
+    switch (opt) {
+      case 'k': k = optarg; break;
+      case 'o': opc = optarg; break;
+      case 'i': imsi = optarg; break;
+      case 's': serving_network_name = optarg; break;
+      case 'd': drb_sample_period = strtoul(optarg, NULL, 10); break;
+      case 'p': pdcp_drb_sn_len = strtoul(optarg, NULL, 10); break;
+      case 'm': mac_mode = true; break;
+      case 'u': upf_ip = optarg; break;
+      case 't': teid_table = optarg; break;
+      case 'a': amf_ip = optarg; break;
+      case 'e': n2_protocol = n2_relay::S1AP; break;
+      case 'r':
+        codec = find_rat_codec(optarg);
+        if (codec == NULL) {
+          usage(argv[0]);
+          exit(1);
+        }
+        break;
+      case 'c':
+        if (!asn1::rrc_nr::containers().subscribe(optarg)) {
+          usage(argv[0]);
+          exit(1);
+        }
+        rrc_containers = &asn1::rrc_nr::containers();
+        break;
+      default:
+        usage(argv[0]);
+        exit(1);
+    }
+  }
+  if ((pdcp_drb_sn_len != 0 && pdcp_drb_sn_len != srsran::PDCP_SN_LEN_12 && pdcp_drb_sn_len != srsran::PDCP_SN_LEN_18) ||
+      (pdcp_drb_sn_len != 0 && mac_mode) || (!teid_table.empty() && upf_ip.empty()) ||
+      (n2_protocol == n2_relay::S1AP && amf_ip.empty()) || (!codec->nr && (pdcp_drb_sn_len != 0 || mac_mode))) {
+    usage(argv[0]);
+    exit(1);
+  }
+  if (!k.empty()) {
+    if (serving_network_name.empty() && imsi.size() >= 5) {
+      serving_network_name = "5G:mnc0" + imsi.substr(3, 2) + ".mcc" + imsi.substr(0, 3) + ".3gppnetwork.org";
+    }
+    if (!nas_sec_ctx.configure(k, opc, imsi, serving_network_name)) {
+      usage(argv[0]);
+      exit(1);
+    }
+    std::cout << "NAS security enabled for SUPI " << imsi << " on " << serving_network_name << std::endl;
+  }
+  // The decoders follow the NAS and AS security contexts and the MAC taps count every TB, which a rendering served from
+  // the cache would skip
+  if (!k.empty() || pdcp_drb_sn_len != 0 || mac_mode) {
+    pdu_cache.set_enabled(false);
+  }
+
   memset(&fake_UE_server_addr,0,sizeof(struct sockaddr_in));
-  memset(&fake_gNB_addr,0,sizeof(struct sockaddr_in));
   memset(&fake_gNB_server_addr,0,sizeof(struct sockaddr_in));
 
   fake_UE_server_sock=socket(AF_INET,SOCK_DGRAM,IPPROTO_IP);
   fake_gNB_server_sock=socket(AF_INET,SOCK_DGRAM,IPPROTO_IP);
   scenario_handler_sock=socket(AF_INET,SOCK_DGRAM,IPPROTO_IP);
-
-  fake_UE_addr.sin_family=AF_INET;
-  fake_UE_addr.sin_addr.s_addr=inet_addr(LOOPBACK_IP);
-  fake_UE_addr.sin_port=htons(FAKE_UE_PORT);
-
-  fake_gNB_addr.sin_family=AF_INET;
-  fake_gNB_addr.sin_addr.s_addr=inet_addr(LOOPBACK_IP);
-  fake_gNB_addr.sin_port=htons(FAKE_gNB_PORT);
+  drb_sample_sock=socket(AF_INET,SOCK_DGRAM,IPPROTO_IP);
+
+  // Until the lanes learn them from what they receive
+  struct sockaddr_in fake_addr;
+  memset(&fake_addr,0,sizeof(struct sockaddr_in));
+  fake_addr.sin_family=AF_INET;
+  fake_addr.sin_addr.s_addr=inet_addr(LOOPBACK_IP);
+  fake_addr.sin_port=htons(FAKE_UE_PORT);
+  fake_UE_addr.store(fake_addr);
+  fake_addr.sin_port=htons(FAKE_gNB_PORT);
+  fake_gNB_addr.store(fake_addr);
 
   fake_UE_server_addr.sin_family=AF_INET;
   fake_UE_server_addr.sin_addr.s_addr=inet_addr(LOOPBACK_IP);
@@ -172,6 +481,100 @@ int main(int argc, char *argv[]) {
     exit(3);
   }
 
+  relay_lanes[FROM_FAKE_UE] = new drb_lane(fake_UE_server_sock, fake_gNB_server_sock, &fake_UE_addr, &fake_gNB_addr);
+  relay_lanes[FROM_FAKE_gNB] = new drb_lane(fake_gNB_server_sock, fake_UE_server_sock, &fake_gNB_addr, &fake_UE_addr);
+  pthread_t UE2gNB_lane, gNB2UE_lane;
+  for (drb_lane* lane : relay_lanes) {
+    // Samples go out on their own socket so that they are never taken for a verdict
+    lane->set_sampling(drb_sample_period, drb_sample_sock, scenario_handler_addr);
+    lane->set_first_drb_lcid(codec->first_drb_lcid);
+  }
+  if (pdcp_drb_sn_len != 0) {
+    // The fake UE relays what the gNB sends, the fake gNB what the UE sends
+    srb_relays[FROM_FAKE_UE] = new pdcp_relay(pdcp_relay::relayed_direction(true), pdcp_drb_sn_len);
+    srb_relays[FROM_FAKE_gNB] = new pdcp_relay(pdcp_relay::relayed_direction(false), pdcp_drb_sn_len);
+    drb_relays[FROM_FAKE_UE] = new pdcp_relay(pdcp_relay::relayed_direction(true), pdcp_drb_sn_len);
+    drb_relays[FROM_FAKE_gNB] = new pdcp_relay(pdcp_relay::relayed_direction(false), pdcp_drb_sn_len);
+    relay_lanes[FROM_FAKE_UE]->set_pdcp_relay(drb_relays[FROM_FAKE_UE]);
+    relay_lanes[FROM_FAKE_gNB]->set_pdcp_relay(drb_relays[FROM_FAKE_gNB]);
+  }
+  if (mac_mode) {
+    mac_taps[FROM_FAKE_UE] = new mac_tap(false, codec->decode_dl_sdu);
+    mac_taps[FROM_FAKE_gNB] = new mac_tap(true, codec->decode_ul_sdu);
+    relay_lanes[FROM_FAKE_UE]->set_mac_tap(new mac_tap(false, codec->decode_dl_sdu));
+    relay_lanes[FROM_FAKE_gNB]->set_mac_tap(new mac_tap(true, codec->decode_ul_sdu));
+  }
+  pthread_create(&UE2gNB_lane, NULL, lane_worker, relay_lanes[FROM_FAKE_UE]);
+  pthread_create(&gNB2UE_lane, NULL, lane_worker, relay_lanes[FROM_FAKE_gNB]);
+
+  if (!upf_ip.empty()) {
+    struct sockaddr_in upf_addr;
+    memset(&upf_addr, 0, sizeof(struct sockaddr_in));
+    upf_addr.sin_family = AF_INET;
+    upf_addr.sin_port = htons(GTPU_PORT);
+    if (inet_pton(AF_INET, upf_ip.c_str(), &upf_addr.sin_addr) != 1) {
+      usage(argv[0]);
+      exit(1);
+    }
+    UPF_n3_addr.store(upf_addr);
+
+    struct sockaddr_in n3_gNB_side_addr, n3_UPF_side_addr;
+    memset(&n3_gNB_side_addr, 0, sizeof(struct sockaddr_in));
+    memset(&n3_UPF_side_addr, 0, sizeof(struct sockaddr_in));
+    n3_gNB_side_addr.sin_family = AF_INET;
+    n3_gNB_side_addr.sin_addr.s_addr = inet_addr(N3_gNB_SIDE_IP);
+    n3_gNB_side_addr.sin_port = htons(GTPU_PORT);
+    n3_UPF_side_addr.sin_family = AF_INET;
+    n3_UPF_side_addr.sin_addr.s_addr = inet_addr(N3_UPF_SIDE_IP);
+    n3_UPF_side_addr.sin_port = htons(GTPU_PORT);
+    n3_gNB_side_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    n3_UPF_side_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (bind(n3_gNB_side_sock, (struct sockaddr *)&n3_gNB_side_addr, sizeof(n3_gNB_side_addr)) == -1 ||
+        bind(n3_UPF_side_sock, (struct sockaddr *)&n3_UPF_side_addr, sizeof(n3_UPF_side_addr)) == -1) {
+      printf("Bind N3 sockets Error!\n");
+      exit(4);
+    }
+
+    n3_uplink = new gtpu_relay(n3_gNB_side_sock, n3_UPF_side_sock, &gNB_n3_addr, &UPF_n3_addr);
+    n3_downlink = new gtpu_relay(n3_UPF_side_sock, n3_gNB_side_sock, &UPF_n3_addr, &gNB_n3_addr);
+    if (!teid_table.empty() && !load_teid_rewrites(teid_table.c_str())) {
+      exit(1);
+    }
+    pthread_t n3_uplink_thread, n3_downlink_thread;
+    pthread_create(&n3_uplink_thread, NULL, n3_worker, n3_uplink);
+    pthread_create(&n3_downlink_thread, NULL, n3_worker, n3_downlink);
+    std::cout << "Relaying N3 between " << N3_gNB_SIDE_IP << " and UPF " << upf_ip << std::endl;
+  }
+
+  if (!amf_ip.empty()) {
+    struct sockaddr_in amf_addr, n2_ran_side_addr;
+    memset(&amf_addr, 0, sizeof(struct sockaddr_in));
+    memset(&n2_ran_side_addr, 0, sizeof(struct sockaddr_in));
+    amf_addr.sin_family = AF_INET;
+    amf_addr.sin_port = htons(n2_relay::port(n2_protocol));
+    if (inet_pton(AF_INET, amf_ip.c_str(), &amf_addr.sin_addr) != 1) {
+      usage(argv[0]);
+      exit(1);
+    }
+    n2_ran_side_addr.sin_family = AF_INET;
+    n2_ran_side_addr.sin_addr.s_addr = inet_addr(N2_RAN_SIDE_IP);
+    n2_ran_side_addr.sin_port = htons(n2_relay::port(n2_protocol));
+
+    n2_associations = new n2_sctp(n2_protocol, amf_addr);
+    if (!n2_associations->listen(n2_ran_side_addr)) {
+      printf("Bind N2 socket Error!\n");
+      exit(5);
+    }
+    n2 = new n2_relay(n2_protocol, scenario_handler_addr, decode_mutex,
+                      [](n2_relay::direction_t dir, uint16_t stream, const uint8_t *msg, uint32_t len) {
+                        n2_associations->send(dir, stream, msg, len);
+                      });
+    pthread_t n2_thread;
+    pthread_create(&n2_thread, NULL, n2_worker, n2_associations);
+    std::cout << "Relaying " << (n2_protocol == n2_relay::NGAP ? "NGAP" : "S1AP") << " between " << N2_RAN_SIDE_IP
+              << " and " << amf_ip << std::endl;
+  }
+
   pthread_t UE2gNB_proc, gNB2UE_proc;
   enum RELAY_DIR argv1 = FROM_FAKE_UE;
   enum RELAY_DIR argv2 = FROM_FAKE_gNB;
@@ -180,5 +583,7 @@ int main(int argc, char *argv[]) {
 
   pthread_join(UE2gNB_proc, NULL);
   pthread_join(gNB2UE_proc, NULL);
+  pthread_join(UE2gNB_lane, NULL);
+  pthread_join(gNB2UE_lane, NULL);
   return 0;
 }
@@ -24,6 +24,7 @@
 
 #include "memblock_cache.h"
 #include "mitm_lib/adt/circular_buffer.h"
+#include <atomic>
 #include <thread>
 
 namespace srsran {
@@ -31,13 +32,18 @@ namespace srsran {
 /**
  * Concurrent fixed size memory pool made of blocks of equal size
  * Each worker keeps a separate thread-local memory block cache that it uses for fast allocation/deallocation.
- * When this cache gets depleted, the worker tries to obtain blocks from a central memory block cache.
- * When accessing a thread local cache, no locks are required.
- * Since there is no stealing of blocks between workers, it is possible that a worker can't allocate while another
- * worker still has blocks in its own cache. To minimize the impact of this event, an upper bound is place on a worker
+ * When this cache gets depleted, the worker first takes back the blocks it allocated that other workers freed, and
+ * only then tries to obtain a batch of blocks from a central memory block cache, which is protected by a mutex.
+ * A block freed by a worker other than the one that allocated it is pushed, without locks, into a remote-free list of
+ * the allocating worker. Thus, buffers allocated on one thread and freed on another, as in a pipeline, go back to
+ * their allocator without going through the central cache.
+ * A worker that finds the central cache empty reclaims the remote-free lists of all workers. Apart from that, there is
+ * no stealing of blocks between workers, so it is possible that a worker can't allocate while another worker still
+ * has blocks in its own cache. To minimize the impact of this event, an upper bound is place on a worker
  * thread cache size. Once a worker reaches that upper bound, it sends half of its stored blocks to the central cache.
+ * The caches of finished threads are kept, and handed to new threads, as blocks may still be returned to them.
  * Note: Taking into account the usage of thread_local, this class is made a singleton
- * Note2: No considerations were made regarding false sharing between threads. It is assumed that the blocks are big
+ * Note2: No considerations were made regarding false sharing between blocks. It is assumed that the blocks are big
  *        enough to fill a cache line.
  * @tparam NofObjects number of objects in the pool
  * @tparam ObjSize object size
@@ -52,45 +58,60 @@ class concurrent_fixed_memory_pool
     typename std::aligned_storage<ObjSize, alignof(detail::max_alignment_t)>::type buffer;
   };
 
-  const static size_t batch_steal_size = 16;
+  const static size_t default_batch_size = 16;
+  /// The blocks a worker takes back from its remote-free list are the working set of a pipeline, which may exceed the
+  /// local cache bound. They are only sent to the central cache past this multiple of the bound.
+  const static size_t remote_growth_factor = 4;
+
+  struct worker_ctxt;
 
   // ctor only accessible from singleton get_instance()
-  explicit concurrent_fixed_memory_pool(size_t nof_objects_)
+  explicit concurrent_fixed_memory_pool(size_t nof_objects_) :
+    nof_blocks(nof_objects_), blocks(new obj_storage_t[nof_objects_]), owners(new worker_ctxt*[nof_objects_]())
   {
-    srsran_assert(nof_objects_ > batch_steal_size, "A positive pool size must be provided");
+    srsran_assert(nof_objects_ > default_batch_size, "A positive pool size must be provided");
 
     std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks.resize(nof_objects_);
-    for (std::unique_ptr<obj_storage_t>& b : allocated_blocks) {
-      b.reset(new obj_storage_t());
-      srsran_assert(b.get() != nullptr, "Failed to instantiate fixed memory pool");
-      central_mem_cache.push(static_cast<void*>(b.get()));
+    for (size_t i = 0; i < nof_blocks; ++i) {
+      central_mem_cache.push(static_cast<void*>(&blocks[i]));
     }
-    local_growth_thres = allocated_blocks.size() / 16;
-    local_growth_thres = local_growth_thres < batch_steal_size ? batch_steal_size : local_growth_thres;
+    set_cache_batch_size(default_batch_size);
   }
 
 public:
   const static size_t BLOCK_SIZE = ObjSize;
 
+  struct metrics_t {
+    size_t   nof_blocks        = 0;
+    size_t   central_blocks    = 0; ///< blocks in the central cache
+    size_t   high_water_mark   = 0; ///< most blocks out of the central cache at once, in use or in worker caches
+    uint64_t central_lock_hits = 0; ///< batch refills and returns through the central cache
+    uint64_t remote_frees      = 0; ///< blocks freed by a worker other than the one that allocated them
+    uint64_t failed_allocs     = 0;
+    size_t   nof_workers       = 0; ///< worker caches, including those kept from finished threads
+  };
+
   concurrent_fixed_memory_pool(const concurrent_fixed_memory_pool&) = delete;
   concurrent_fixed_memory_pool(concurrent_fixed_memory_pool&&)      = delete;
   concurrent_fixed_memory_pool& operator=(const concurrent_fixed_memory_pool&) = delete;
   concurrent_fixed_memory_pool& operator=(concurrent_fixed_memory_pool&&) = delete;
 
-  ~concurrent_fixed_memory_pool()
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks.clear();
-  }
-
   static concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress>* get_instance(size_t size = 4096)
   {
     static concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress> pool(size);
     return &pool;
   }
 
-  size_t size() { return allocated_blocks.size(); }
+  size_t size() { return nof_blocks; }
+
+  /// Sets the number of blocks a worker cache takes from the central cache at once. A worker cache sends half of its
+  /// blocks back once it holds twice that number, or nof_blocks / 16 if larger.
+  void set_cache_batch_size(size_t batch_size_)
+  {
+    size_t batch = std::max<size_t>(1, std::min(batch_size_, nof_blocks / 4));
+    batch_size.store(batch, std::memory_order_relaxed);
+    local_growth_thres.store(std::max(2 * batch, nof_blocks / 16), std::memory_order_relaxed);
+  }
 
   void* allocate_node(size_t sz)
   {
@@ -99,16 +120,20 @@ public:
 
     void* node = worker_ctxt->cache.try_pop();
     if (node == nullptr) {
-      // fill the thread local cache enough for this and next allocations
-      std::array<void*, batch_steal_size> popped_blocks;
-      size_t                              n = central_mem_cache.try_pop(popped_blocks);
-      for (size_t i = 0; i < n; ++i) {
-        new (popped_blocks[i]) obj_storage_t();
-        worker_ctxt->cache.push(static_cast<void*>(popped_blocks[i]));
+      // take back the blocks freed by other workers, then fill the thread local cache from the central cache
+      drain_remote_frees(*worker_ctxt);
+      if (worker_ctxt->cache.size() >= remote_growth_factor * local_growth_thres.load(std::memory_order_relaxed)) {
+        return_blocks(*worker_ctxt, worker_ctxt->cache.size() / 2);
       }
       node = worker_ctxt->cache.try_pop();
+      if (node == nullptr) {
+        node = refill(*worker_ctxt);
+      }
     }
 
+    if (node != nullptr) {
+      owners[block_index(node)] = worker_ctxt;
+    }
 #ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
     if (node == nullptr) {
       print_error("Error allocating buffer in pool of ObjSize=%zd", ObjSize);
@@ -124,20 +149,27 @@ public:
     obj_storage_t* block_ptr   = static_cast<obj_storage_t*>(p);
 
     if (DebugSanitizeAddress) {
-      std::lock_guard<std::mutex> lock(mutex);
-      srsran_assert(std::any_of(allocated_blocks.begin(),
-                                allocated_blocks.end(),
-                                [block_ptr](const std::unique_ptr<obj_storage_t>& b) { return b.get() == block_ptr; }),
+      size_t offset = reinterpret_cast<std::uintptr_t>(block_ptr) - reinterpret_cast<std::uintptr_t>(blocks.get());
+      srsran_assert(offset < nof_blocks * sizeof(obj_storage_t) and offset % sizeof(obj_storage_t) == 0,
                     "Error deallocating block with address 0x%lx",
                     (long unsigned)block_ptr);
     }
 
+    // blocks allocated by another worker go back to it
+    auto* owner = owners[block_index(p)];
+    if (owner != nullptr and owner != worker_ctxt) {
+      push_remote_free(*owner, p);
+      worker_ctxt->nof_remote_frees.store(worker_ctxt->nof_remote_frees.load(std::memory_order_relaxed) + 1,
+                                          std::memory_order_relaxed);
+      return;
+    }
+
     // push to local memory block cache
     worker_ctxt->cache.push(static_cast<void*>(p));
 
-    if (worker_ctxt->cache.size() >= local_growth_thres) {
+    if (worker_ctxt->cache.size() >= local_growth_thres.load(std::memory_order_relaxed)) {
       // if local cache reached max capacity, send half of the blocks to central cache
-      central_mem_cache.steal_blocks(worker_ctxt->cache, worker_ctxt->cache.size() / 2);
+      return_blocks(*worker_ctxt, worker_ctxt->cache.size() / 2);
     }
   }
 
@@ -151,37 +183,170 @@ public:
     }
   }
 
+  metrics_t get_metrics()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    metrics_t                   m;
+    m.nof_blocks        = nof_blocks;
+    m.central_blocks    = central_mem_cache.size();
+    m.high_water_mark   = high_water_mark;
+    m.central_lock_hits = central_lock_hits;
+    m.failed_allocs     = failed_allocs;
+    m.nof_workers       = workers.size();
+    for (const std::unique_ptr<worker_ctxt>& w : workers) {
+      m.remote_frees += w->nof_remote_frees.load(std::memory_order_relaxed);
+    }
+    return m;
+  }
+
+  std::string metrics_to_string()
+  {
+    metrics_t m = get_metrics();
+    return fmt::format("Pool of {}B blocks: blocks={} central={} high-water={} central-lock={} remote-frees={} "
+                       "failed={} workers={}",
+                       ObjSize,
+                       m.nof_blocks,
+                       m.central_blocks,
+                       m.high_water_mark,
+                       m.central_lock_hits,
+                       m.remote_frees,
+                       m.failed_allocs,
+                       m.nof_workers);
+  }
+
   void print_all_buffers()
   {
-    auto*  worker     = get_worker_cache();
-    size_t tot_blocks = 0;
+    auto*  worker         = get_worker_cache();
+    size_t central_blocks = 0;
     {
       std::lock_guard<std::mutex> lock(mutex);
-      tot_blocks = allocated_blocks.size();
+      central_blocks = central_mem_cache.size();
     }
     printf("There are %zd/%zd buffers in shared block container. This thread contains %zd in its local cache\n",
-           central_mem_cache.size(),
-           tot_blocks,
+           central_blocks,
+           nof_blocks,
            worker->cache.size());
   }
 
 private:
+  /// Node written into a block in a remote-free list.
+  struct remote_node {
+    remote_node* next;
+  };
+
   struct worker_ctxt {
-    std::thread::id    id;
     free_memblock_list cache;
+    bool               finished = false; ///< its thread has exited, protected by the pool mutex
+    /// Written by this worker only, read by get_metrics().
+    std::atomic<uint64_t> nof_remote_frees{0};
+    /// Keeps the remote-free list, written by the other workers, off the cache lines of the worker caches.
+    char                      pad0[64];
+    std::atomic<remote_node*> remote_frees{nullptr};
+    char                      pad1[64 - sizeof(std::atomic<remote_node*>)];
+  };
 
-    worker_ctxt() : id(std::this_thread::get_id()) {}
-    ~worker_ctxt()
-    {
-      concurrent_free_memblock_list& central_cache = pool_type::get_instance()->central_mem_cache;
-      central_cache.steal_blocks(cache, cache.size());
-    }
+  /// Registers the thread in the pool on its first use of the pool.
+  struct worker_handle {
+    pool_type*   pool;
+    worker_ctxt* ctxt;
+
+    explicit worker_handle(pool_type* pool_) : pool(pool_), ctxt(pool_->register_worker()) {}
+    ~worker_handle() { pool->release_worker(ctxt); }
   };
 
   worker_ctxt* get_worker_cache()
   {
-    thread_local worker_ctxt worker_cache;
-    return &worker_cache;
+    thread_local worker_handle worker_cache(this);
+    return worker_cache.ctxt;
+  }
+
+  size_t block_index(void* p) const { return static_cast<obj_storage_t*>(p) - blocks.get(); }
+
+  /// Takes the cache of a finished thread, if any, as the blocks it allocated may still be freed by others.
+  worker_ctxt* register_worker()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::unique_ptr<worker_ctxt>& w : workers) {
+      if (w->finished) {
+        w->finished = false;
+        return w.get();
+      }
+    }
+    workers.emplace_back(new worker_ctxt);
+    return workers.back().get();
+  }
+
+  void release_worker(worker_ctxt* ctxt)
+  {
+    drain_remote_frees(*ctxt);
+    std::lock_guard<std::mutex> lock(mutex);
+    while (not ctxt->cache.empty()) {
+      central_mem_cache.push(ctxt->cache.pop());
+    }
+    ctxt->finished = true;
+  }
+
+  /// Lock-free push into the remote-free list of another worker. The list is only ever taken as a whole, so there is
+  /// no ABA problem.
+  static void push_remote_free(worker_ctxt& owner, void* p)
+  {
+    remote_node* node = ::new (p) remote_node{owner.remote_frees.load(std::memory_order_relaxed)};
+    while (not owner.remote_frees.compare_exchange_weak(
+        node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+  }
+
+  /// Moves the blocks of a remote-free list into a memory block list.
+  static void take_remote_frees(worker_ctxt& ctxt, free_memblock_list& dest)
+  {
+    remote_node* node = ctxt.remote_frees.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+      remote_node* next = node->next;
+      dest.push(static_cast<void*>(node));
+      node = next;
+    }
+  }
+
+  /// Moves the blocks freed by other workers into the worker cache.
+  static void drain_remote_frees(worker_ctxt& ctxt) { take_remote_frees(ctxt, ctxt.cache); }
+
+  /// Fills the worker cache with a batch of blocks from the central cache, returns one of them.
+  void* refill(worker_ctxt& ctxt)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    central_lock_hits++;
+
+    if (central_mem_cache.empty()) {
+      // reclaim the blocks returned to workers that do not allocate anymore, or whose thread has finished
+      for (const std::unique_ptr<worker_ctxt>& w : workers) {
+        take_remote_frees(*w, central_mem_cache);
+        while (w->finished and not w->cache.empty()) {
+          central_mem_cache.push(w->cache.pop());
+        }
+      }
+    }
+
+    size_t batch = batch_size.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < batch and not central_mem_cache.empty(); ++i) {
+      ctxt.cache.push(central_mem_cache.pop());
+    }
+    high_water_mark = std::max(high_water_mark, nof_blocks - central_mem_cache.size());
+
+    void* node = ctxt.cache.try_pop();
+    if (node == nullptr) {
+      failed_allocs++;
+    }
+    return node;
+  }
+
+  /// Sends n blocks of the worker cache to the central cache.
+  void return_blocks(worker_ctxt& ctxt, size_t n)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    central_lock_hits++;
+    for (size_t i = 0; i < n and not ctxt.cache.empty(); ++i) {
+      central_mem_cache.push(ctxt.cache.pop());
+    }
   }
 
   /// Formats and prints the input string and arguments into the configured output stream.
@@ -195,12 +360,21 @@ private:
     }
   }
 
-  size_t                local_growth_thres = 0;
-  srslog::basic_logger* logger             = nullptr;
+  const size_t                     nof_blocks;
+  std::unique_ptr<obj_storage_t[]> blocks;
+  /// Worker that allocated each block, written by it and read by the worker that frees the block.
+  std::unique_ptr<worker_ctxt*[]> owners;
+  std::atomic<size_t>             batch_size{default_batch_size};
+  std::atomic<size_t>             local_growth_thres{2 * default_batch_size};
+  srslog::basic_logger*           logger = nullptr;
 
-  concurrent_free_memblock_list                central_mem_cache;
-  std::mutex                                   mutex;
-  std::vector<std::unique_ptr<obj_storage_t> > allocated_blocks;
+  // protected by mutex
+  std::mutex                                 mutex;
+  free_memblock_list                         central_mem_cache;
+  std::vector<std::unique_ptr<worker_ctxt> > workers;
+  size_t                                     high_water_mark   = 0;
+  uint64_t                                   central_lock_hits = 0;
+  uint64_t                                   failed_allocs     = 0;
 };
 
 } // namespace srsran
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSASN1_CONTAINER_H
+#define SRSASN1_CONTAINER_H
+
+#include "asn1_field_path.h"
+#include <algorithm>
+#include <vector>
+
+namespace asn1 {
+
+/************************
+    container types
+************************/
+
+/// ASN.1 type carried encoded in an OCTET STRING field, e.g. "masterCellGroup OCTET STRING (CONTAINING
+/// CellGroupConfig)". The generated code only sees the octets; these operations decode and re-encode them.
+struct container_desc {
+  const char*  name;
+  type_desc_fn type;
+  void* (*create)();
+  void (*destroy)(void* obj);
+  bool (*unpack)(void* obj, const uint8_t* buf, uint32_t len);
+  bool (*pack)(const void* obj, dyn_octstring& octs);
+  void (*to_json)(const void* obj, json_writer& j);
+};
+
+/// Largest encoding a container is packed into.
+constexpr uint32_t max_container_size = 65535;
+
+template <class T>
+struct container_ops {
+  static void* create() { return new T(); }
+  static void  destroy(void* obj) { delete static_cast<T*>(obj); }
+  static bool  unpack(void* obj, const uint8_t* buf, uint32_t len)
+  {
+    cbit_ref bref(buf, len);
+    return static_cast<T*>(obj)->unpack(bref) == SRSASN_SUCCESS;
+  }
+  static bool pack(const void* obj, dyn_octstring& octs)
+  {
+    // the outer field is left as it was if the value doesn't pack
+    std::vector<uint8_t> buf(max_container_size);
+    bit_ref              bref(buf.data(), buf.size());
+    if (static_cast<const T*>(obj)->pack(bref) != SRSASN_SUCCESS) {
+      return false;
+    }
+    bref.align_bytes_zero();
+    octs.resize(bref.distance_bytes());
+    std::copy(buf.begin(), buf.begin() + octs.size(), octs.data());
+    return true;
+  }
+  static void to_json(const void* obj, json_writer& j) { static_cast<const T*>(obj)->to_json(j); }
+};
+
+/// Container descriptor of T, named after its ASN.1 type.
+template <class T>
+const container_desc* container_desc_of(const char* name)
+{
+  static const container_desc d = {name,
+                                   &desc_of<T>,
+                                   &container_ops<T>::create,
+                                   &container_ops<T>::destroy,
+                                   &container_ops<T>::unpack,
+                                   &container_ops<T>::pack,
+                                   &container_ops<T>::to_json};
+  return &d;
+}
+
+/************************
+   container registry
+************************/
+
+/// Maps the OCTET STRING fields that carry an encoded ASN.1 value to the type of that value.
+///
+/// JSON: a json_writer pointed at the registry writes the fields whose content type is subscribed decoded, in place of
+/// their hex form. The field is only decoded while it is being written, and its content is looked up by the JSON name
+/// of the field, plus a variant when another field tells the content type, e.g. the rat-Type of a UE capability
+/// container. Containers nest: the inner value is written through the same writer.
+///
+/// Field paths: a path compiled against the registry continues into the containers it crosses, whether subscribed or
+/// not, e.g. "...nonCriticalExtension.masterCellGroup.spCellConfig.reconfigurationWithSync.newUE-Identity". Setting
+/// such a path decodes the container, sets the field and packs the container back into the outer field.
+class container_registry
+{
+public:
+  /// Registers the field at path, relative to the type root. Fields that are not reflected, e.g. those of other
+  /// modules, are registered with a null root and their JSON name alone, and are then only decoded for JSON.
+  bool add(type_desc_fn root, const char* path, const container_desc* content, const char* variant = nullptr);
+
+  /// Subscribes to the content types in a comma-separated list of ASN.1 type names, or "all". Returns false if a name
+  /// is unknown. Not thread safe, meant for start up.
+  bool subscribe(const std::string& names);
+  void unsubscribe_all();
+  bool any_subscribed() const;
+
+  /// Container held by field idx of the reflected type holder, or nullptr.
+  const container_desc* find(const type_desc* holder, uint32_t idx) const;
+
+  /// Writes the field decoded if its content type is subscribed. Returns false, having written nothing, if it is not,
+  /// or if the octets don't decode.
+  bool write(json_writer& j, const std::string& fieldname, const char* variant, const uint8_t* ptr, uint32_t N) const;
+
+private:
+  struct entry {
+    const type_desc*      holder;
+    uint32_t              idx;
+    std::string           fieldname;
+    const char*           variant;
+    const container_desc* content;
+    bool                  subscribed;
+  };
+
+  std::vector<entry> entries;
+};
+
+} // namespace asn1
+
+#endif // SRSASN1_CONTAINER_H
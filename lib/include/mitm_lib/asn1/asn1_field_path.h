@@ -0,0 +1,394 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSASN1_FIELD_PATH_H
+#define SRSASN1_FIELD_PATH_H
+
+#include "asn1_utils.h"
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace asn1 {
+
+class container_registry;
+struct container_desc;
+
+/************************
+      field value
+************************/
+
+/// Value of a leaf field, read or written through a field_path.
+/// Integers and booleans use num. Enumerated fields report their index in num and their name in str, and accept either.
+/// Octet strings use lowercase hex and bit strings use '0'/'1' characters in str.
+struct field_value {
+  int64_t     num = 0;
+  std::string str;
+
+  field_value() = default;
+  field_value(int num_) : num(num_) {}
+  field_value(int64_t num_) : num(num_) {}
+  field_value(std::string str_) : str(std::move(str_)) {}
+  field_value(const char* str_) : str(str_) {}
+};
+
+/************************
+    type descriptors
+************************/
+
+struct type_desc;
+using type_desc_fn = const type_desc* (*)();
+
+/// Member of a SEQUENCE or alternative of a CHOICE, with its JSON name.
+struct field_desc {
+  const char*  name;
+  type_desc_fn type;
+  /// Returns the address of the field inside obj. If the field is an absent optional or a non-selected alternative,
+  /// returns nullptr, unless create is set, in which case the field is made present first.
+  void* (*access)(void* obj, bool create);
+};
+
+/// Runtime description of an ASN.1 type, as written by its to_json() method.
+struct type_desc {
+  enum kind_t { sequence, choice, sequence_of, leaf };
+
+  kind_t            kind;
+  const field_desc* fields;
+  uint32_t          nof_fields;
+  type_desc_fn      elem_type;
+  void* (*elem)(void* obj, uint32_t idx, bool create);
+  bool (*get)(const void* obj, field_value& v);
+  bool (*set)(void* obj, const field_value& v);
+
+  int find_field(const char* name, size_t len) const;
+};
+
+/// Specialized for every reflected type. The constructed types of each ASN.1 module are declared in
+/// <module>_field_path.h, the leaf and SEQUENCE OF types below.
+template <class T, class Enable = void>
+struct type_reflector;
+
+template <class T>
+const type_desc* desc_of()
+{
+  return type_reflector<T>::desc();
+}
+
+/// Type of a reflected member. Extension members held in a copy_ptr are reflected as their pointee.
+template <class T>
+struct reflected_type {
+  using type = T;
+};
+template <class T>
+struct reflected_type<copy_ptr<T> > {
+  using type = T;
+};
+template <class T>
+using reflected_t = typename reflected_type<typename std::decay<T>::type>::type;
+
+// helpers used by the generated field accessors
+template <class Choice>
+bool select_alt(Choice& c, typename Choice::types::options t, bool create)
+{
+  if (c.type() != t) {
+    if (not create) {
+      return false;
+    }
+    c.set(t);
+  }
+  return true;
+}
+inline bool select_opt(bool& present, bool create)
+{
+  present |= create;
+  return present;
+}
+template <class T>
+bool select_ptr(copy_ptr<T>& ptr, bool create)
+{
+  if (create and not ptr.is_present()) {
+    ptr.set_present();
+  }
+  return ptr.is_present();
+}
+
+/************************
+      leaf types
+************************/
+
+template <class T, class Impl>
+struct leaf_reflector {
+  static const type_desc* desc()
+  {
+    static const type_desc d = {type_desc::leaf, nullptr, 0, nullptr, nullptr, &get, &set};
+    return &d;
+  }
+  static bool get(const void* obj, field_value& v) { return Impl::get(*static_cast<const T*>(obj), v); }
+  static bool set(void* obj, const field_value& v) { return Impl::set(*static_cast<T*>(obj), v); }
+};
+
+template <class T>
+struct type_reflector<T, typename std::enable_if<std::is_integral<T>::value>::type>
+  : leaf_reflector<T, type_reflector<T> > {
+  static bool get(const T& obj, field_value& v)
+  {
+    v.num = obj;
+    return true;
+  }
+  static bool set(T& obj, const field_value& v)
+  {
+    obj = v.str.empty() ? (T)v.num : (T)std::strtoll(v.str.c_str(), nullptr, 0);
+    return true;
+  }
+};
+
+template <>
+struct type_reflector<bool> : leaf_reflector<bool, type_reflector<bool> > {
+  static bool get(const bool& obj, field_value& v)
+  {
+    v.num = obj;
+    v.str = obj ? "true" : "false";
+    return true;
+  }
+  static bool set(bool& obj, const field_value& v)
+  {
+    obj = v.str.empty() ? v.num != 0 : v.str == "true";
+    return true;
+  }
+};
+
+template <class IntType, IntType LB, IntType UB, bool Ext, bool Al>
+struct type_reflector<integer<IntType, LB, UB, Ext, Al> >
+  : leaf_reflector<integer<IntType, LB, UB, Ext, Al>, type_reflector<integer<IntType, LB, UB, Ext, Al> > > {
+  static bool get(const integer<IntType, LB, UB, Ext, Al>& obj, field_value& v)
+  {
+    return type_reflector<IntType>::get(obj.value, v);
+  }
+  static bool set(integer<IntType, LB, UB, Ext, Al>& obj, const field_value& v)
+  {
+    return type_reflector<IntType>::set(obj.value, v);
+  }
+};
+
+template <class EnumType, bool E, uint32_t M>
+struct type_reflector<enumerated<EnumType, E, M> >
+  : leaf_reflector<enumerated<EnumType, E, M>, type_reflector<enumerated<EnumType, E, M> > > {
+  static bool get(const enumerated<EnumType, E, M>& obj, field_value& v)
+  {
+    v.num = obj.value;
+    v.str = obj.to_string();
+    return true;
+  }
+  static bool set(enumerated<EnumType, E, M>& obj, const field_value& v)
+  {
+    if (not v.str.empty()) {
+      return string_to_enum(obj, v.str);
+    }
+    if (v.num < 0 or v.num >= (int64_t)obj.nof_types) {
+      return false;
+    }
+    obj = (typename EnumType::options)v.num;
+    return true;
+  }
+};
+
+/// Octet strings, bit strings and character strings, which all convert to and from their to_string() form.
+template <class T>
+struct string_reflector : leaf_reflector<T, string_reflector<T> > {
+  static bool get(const T& obj, field_value& v)
+  {
+    v.str = obj.to_string();
+    return true;
+  }
+  static bool set(T& obj, const field_value& v)
+  {
+    obj.from_string(v.str);
+    return obj.to_string().size() == v.str.size();
+  }
+};
+
+template <uint32_t N, bool Al>
+struct type_reflector<fixed_octstring<N, Al> > : string_reflector<fixed_octstring<N, Al> > {};
+template <uint32_t LB, uint32_t UB, bool Al>
+struct type_reflector<bounded_octstring<LB, UB, Al> > : string_reflector<bounded_octstring<LB, UB, Al> > {};
+template <bool Al>
+struct type_reflector<unbounded_octstring<Al> > : string_reflector<unbounded_octstring<Al> > {};
+template <uint32_t LB, uint32_t UB, bool Ext, bool Al>
+struct type_reflector<bitstring<LB, UB, Ext, Al> > : string_reflector<bitstring<LB, UB, Ext, Al> > {};
+template <uint32_t LB, uint32_t UB, uint32_t ALB, uint32_t AUB, bool Ext, bool Al>
+struct type_reflector<asn_string<LB, UB, ALB, AUB, Ext, Al> >
+  : string_reflector<asn_string<LB, UB, ALB, AUB, Ext, Al> > {};
+
+/// NULL alternatives and presence flags without a value. Setting one only selects it.
+struct null_reflector {
+  static const type_desc* desc()
+  {
+    static const type_desc d = {type_desc::leaf, nullptr, 0, nullptr, nullptr, &get, &set};
+    return &d;
+  }
+  static bool get(const void* obj, field_value& v)
+  {
+    v = {};
+    return true;
+  }
+  static bool set(void* obj, const field_value& v) { return true; }
+};
+
+template <class T>
+struct type_reflector<setup_release_c<T> > {
+  static const type_desc* desc()
+  {
+    static const field_desc fields[] = {{"release", &null_reflector::desc, &release},
+                                        {"setup", &desc_of<reflected_t<T> >, &setup}};
+    static const type_desc  d        = {type_desc::choice, fields, 2, nullptr, nullptr, nullptr, nullptr};
+    return &d;
+  }
+  static void* release(void* obj, bool create)
+  {
+    return select_alt(*static_cast<setup_release_c<T>*>(obj), setup_release_opts::release, create) ? obj : nullptr;
+  }
+  static void* setup(void* obj, bool create)
+  {
+    auto& c = *static_cast<setup_release_c<T>*>(obj);
+    return select_alt(c, setup_release_opts::setup, create) ? &c.setup() : nullptr;
+  }
+};
+
+/************************
+     SEQUENCE OF
+************************/
+
+/// Elements are addressed by index. Writing past the end grows the list, up to its capacity.
+template <class ArrayType,
+          type_desc_fn ElemDesc = &desc_of<reflected_t<decltype(*std::declval<ArrayType&>().begin())> > >
+struct seq_of_reflector {
+  static const type_desc* desc()
+  {
+    static const type_desc d = {type_desc::sequence_of, nullptr, 0, ElemDesc, &elem, nullptr, nullptr};
+    return &d;
+  }
+  static void* elem(void* obj, uint32_t idx, bool create)
+  {
+    ArrayType& arr = *static_cast<ArrayType*>(obj);
+    if (idx >= arr.size()) {
+      if (not create or not grow(arr, idx + 1)) {
+        return nullptr;
+      }
+    }
+    return &arr[idx];
+  }
+
+private:
+  template <class T>
+  static bool grow(dyn_array<T>& arr, uint32_t n)
+  {
+    arr.resize(n);
+    return true;
+  }
+  template <class T, uint32_t MAX_N>
+  static bool grow(bounded_array<T, MAX_N>& arr, uint32_t n)
+  {
+    if (n > MAX_N) {
+      return false;
+    }
+    arr.resize(n);
+    return true;
+  }
+  template <class T, std::size_t N>
+  static bool grow(std::array<T, N>& arr, uint32_t n)
+  {
+    return false;
+  }
+};
+
+template <class T>
+struct type_reflector<dyn_array<T> > : seq_of_reflector<dyn_array<T> > {};
+template <class T, uint32_t MAX_N>
+struct type_reflector<bounded_array<T, MAX_N> > : seq_of_reflector<bounded_array<T, MAX_N> > {};
+template <class T, uint32_t LB, uint32_t UB, bool Al>
+struct type_reflector<dyn_seq_of<T, LB, UB, Al> > : seq_of_reflector<dyn_seq_of<T, LB, UB, Al> > {};
+template <class T, std::size_t N>
+struct type_reflector<std::array<T, N> > : seq_of_reflector<std::array<T, N> > {};
+
+/************************
+      field path
+************************/
+
+/// Dot-separated path to a leaf field of a decoded message, using the field names of its JSON form. Elements of a
+/// SEQUENCE OF are addressed by their index, e.g. "ue-CapabilityRAT-RequestList.0.rat-Type".
+/// The path is resolved once into a list of field indexes, so that get()/set() only follow pointers.
+/// Compiled against a container_registry, the path may continue into the OCTET STRING containers it registers.
+class field_path
+{
+public:
+  field_path() = default;
+
+  static field_path
+  compile(const type_desc* root, const std::string& path, const container_registry* containers = nullptr);
+  template <class T>
+  static field_path compile(const std::string& path, const container_registry* containers = nullptr)
+  {
+    return compile(desc_of<T>(), path, containers);
+  }
+
+  bool               valid() const { return root != nullptr; }
+  const std::string& to_string() const { return path; }
+
+  /// Reads the leaf. Returns false if an optional field or CHOICE alternative on the way is absent.
+  template <class T>
+  bool get(const T& obj, field_value& v) const
+  {
+    return check_root(desc_of<T>()) and get(static_cast<const void*>(&obj), v);
+  }
+  /// Writes the leaf, selecting CHOICE alternatives and making optional fields on the way present as needed. The
+  /// containers on the way are decoded, or created if empty, and packed back once the leaf is written.
+  template <class T>
+  bool set(T& obj, const field_value& v) const
+  {
+    return check_root(desc_of<T>()) and set(static_cast<void*>(&obj), v);
+  }
+
+private:
+  friend class container_registry;
+
+  struct hop {
+    const type_desc* type;
+    uint32_t         idx;
+  };
+
+  bool  check_root(const type_desc* d) const;
+  void* walk(void* obj, bool create) const;
+  bool  get(const void* obj, field_value& v) const;
+  bool  set(void* obj, const field_value& v) const;
+
+  const type_desc* root = nullptr;
+  const type_desc* leaf = nullptr;
+  std::vector<hop> hops;
+  std::string      path;
+  // the hops end at the OCTET STRING of a container, and the rest of the path is inner, relative to its content
+  const container_desc*             container = nullptr;
+  std::shared_ptr<const field_path> inner;
+};
+
+} // namespace asn1
+
+#endif // SRSASN1_FIELD_PATH_H
@@ -182,6 +182,9 @@ public:
   SRSASN_CODE pack(uint64_t val, uint32_t n_bits);
   SRSASN_CODE pack_bytes(const uint8_t* buf, uint32_t n_bytes);
   SRSASN_CODE align_bytes_zero();
+
+private:
+  friend class varlength_field_pack_guard;
 };
 
 /*********************
@@ -659,6 +662,11 @@ void        number_to_octstring(uint8_t* ptr, uint64_t number, uint32_t nbytes);
 std::string octstring_to_string(const uint8_t* ptr, uint32_t N);
 void        string_to_octstring(uint8_t* ptr, const std::string& str);
 
+/// Writes the 2*N lowercase hex digits of ptr[0..N) to dst, without a null terminator.
+void octstring_to_hex(char* dst, const uint8_t* ptr, uint32_t N);
+/// Parses nof_chars/2 octets from str. Returns false if str contained non-hex characters.
+bool hex_to_octstring(uint8_t* ptr, const char* str, uint32_t nof_chars);
+
 /************************
     fixed_octstring
 ************************/
@@ -1325,6 +1333,10 @@ private:
    Var Length Field
 *********************/
 
+/**
+ * Packs a length-prefixed field directly into the destination buffer. The short form of the length determinant is
+ * reserved upfront and filled once the field is packed. Only fields that need the long form are shifted in place.
+ */
 class varlength_field_pack_guard
 {
 public:
@@ -1332,13 +1344,9 @@ public:
   ~varlength_field_pack_guard();
 
 private:
-  using byte_array_t   = std::array<uint8_t, srsran::byte_buffer_pool::BLOCK_SIZE>;
-  using byte_array_ptr = srsran::any_pool_ptr<byte_array_t>;
-
-  bit_ref        brefstart;
-  bit_ref*       bref_tracker;
-  byte_array_ptr buffer_ptr;
-  bool           align;
+  bit_ref  brefstart;
+  bit_ref* bref_tracker;
+  bool     align;
 };
 
 class varlength_field_unpack_guard
@@ -1359,9 +1367,24 @@ private:
 
 using json_buffer = fmt::basic_memory_buffer<char, 2048>;
 
+/// Output written to a json_writer between two positions, replayable into a writer left in the same nesting state.
+struct json_fragment {
+  std::string text;
+  uint32_t    ident_begin = 0, ident_end = 0;
+  uint8_t     sep_begin = 0, sep_end = 0;
+};
+
+class container_registry;
+
 class json_writer
 {
 public:
+  struct mark_t {
+    size_t   pos;
+    uint32_t ident;
+    uint8_t  sep;
+  };
+
   json_writer();
   void        write_fieldname(const std::string& fieldname);
   void        write_str(const std::string& fieldname, const std::string& value);
@@ -1372,17 +1395,39 @@ public:
   void        write_bool(bool value);
   void        write_null(const std::string& fieldname);
   void        write_null();
+  /// The variant tells the content of a container field whose name alone doesn't, see container_registry.
+  void write_octstring(const std::string& fieldname, const uint8_t* ptr, uint32_t N, const char* variant = nullptr);
+  void write_octstring(const uint8_t* ptr, uint32_t N);
+  template <typename OctString>
+  void write_octstring(const std::string& fieldname, const OctString& octs, const char* variant = nullptr)
+  {
+    write_octstring(fieldname, octs.data(), octs.size(), variant);
+  }
+  template <typename OctString>
+  void write_octstring(const OctString& octs)
+  {
+    write_octstring("", octs.data(), octs.size());
+  }
   void        start_obj(const std::string& fieldname = "");
   void        end_obj();
   void        start_array(const std::string& fieldname = "");
   void        end_array();
   std::string to_string() const;
 
+  /// Octet strings carrying an encoded ASN.1 value whose type is subscribed in containers are written decoded.
+  void                      set_containers(const container_registry* containers_) { containers = containers_; }
+  const container_registry* get_containers() const { return containers; }
+
+  mark_t mark() const { return {buffer.size(), (uint32_t)ident.size(), (uint8_t)sep}; }
+  void   copy_since(const mark_t& m, json_fragment& frag) const;
+  bool   write_fragment(const json_fragment& frag);
+
 private:
   json_buffer buffer;
   std::string ident;
   enum separator_t { COMMA = 0, NEWLINE, NONE };
-  separator_t sep;
+  separator_t               sep;
+  const container_registry* containers = nullptr;
 };
 
 template <typename T>
@@ -1838,7 +1838,8 @@ public:
   SRSASN_CODE unpack(const std::vector<uint8_t>& buf);
   SRSASN_CODE unpack_outer_hdr(const unique_byte_buffer_t& buf);
   SRSASN_CODE unpack_outer_hdr(const std::vector<uint8_t>& buf);
-  void        to_json(json_writer& j);
+  // integrity_check, if given, is written after the header as the outcome of the MAC check of a protected PDU
+  void        to_json(json_writer& j, const char* integrity_check = nullptr);
 
   void set(msg_types::options e = msg_types::nulltype) { hdr.message_type = e; };
   // Getters
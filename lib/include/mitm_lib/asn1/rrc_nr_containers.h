@@ -0,0 +1,40 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSASN1_RRC_NR_CONTAINERS_H
+#define SRSASN1_RRC_NR_CONTAINERS_H
+
+#include "asn1_container.h"
+#include "rrc_nr_field_path.h"
+
+namespace asn1 {
+namespace rrc_nr {
+
+/// Registry of the OCTET STRING fields that carry an NR RRC value: the cell group, radio bearer and system information
+/// containers of RRCSetup, RRCResume and RRCReconfiguration, the NR SCG RRCReconfiguration of EN-DC and NR-DC, and
+/// the NR and MR-DC UE capabilities. The EUTRA RRC fields that carry NR values (nr-SecondaryCellGroupConfig-r15,
+/// nr-RadioBearerConfig1/2-r15 and the NR UE capability containers) are registered too, for JSON only.
+container_registry& containers();
+
+} // namespace rrc_nr
+} // namespace asn1
+
+#endif // SRSASN1_RRC_NR_CONTAINERS_H
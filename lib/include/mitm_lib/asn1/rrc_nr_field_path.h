@@ -0,0 +1,2741 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSASN1_RRC_NR_FIELD_PATH_H
+#define SRSASN1_RRC_NR_FIELD_PATH_H
+
+#include "asn1_field_path.h"
+#include "rrc_nr.h"
+
+namespace asn1 {
+
+template <>
+struct type_reflector<rrc_nr::pdcch_cfg_sib1_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mib_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bcch_bch_msg_type_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bcch_bch_msg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_ns_pmax_value_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::nr_ns_pmax_value_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_freq_neigh_cell_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_multi_band_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_pci_range_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::inter_freq_neigh_cell_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::nr_multi_band_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pci_range_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdsch_time_domain_res_alloc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_time_domain_res_alloc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ctrl_res_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ctrl_res_set_s::cce_reg_map_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rach_cfg_generic_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ss_rssi_meas_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ssb_mtc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ssb_mtc_s::periodicity_and_offset_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ssb_to_measure_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::search_space_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::search_space_s::monitoring_slot_periodicity_and_offset_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::search_space_s::search_space_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::speed_state_scale_factors_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::thres_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bwp_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::carrier_freq_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::inter_freq_carrier_freq_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::intra_freq_neigh_cell_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdcch_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdcch_cfg_common_s::first_pdcch_monitoring_occasion_of_po_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdsch_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::plmn_id_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rach_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rach_cfg_common_s::ssb_per_rach_occasion_and_cb_preambs_per_ssb_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rach_cfg_common_s::prach_root_seq_idx_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scs_specific_carrier_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib_type_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::uac_barr_per_cat_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bcch_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bwp_dl_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bwp_ul_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_info_dl_sib_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_info_ul_sib_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mob_state_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pcch_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pcch_cfg_s::nand_paging_frame_offset_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pcch_cfg_s::first_pdcch_monitoring_occasion_of_po_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::plmn_id_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::si_request_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::tdd_ul_dl_pattern_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_cfg_common_sib_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::si_request_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib2_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib2_s::intra_freq_cell_resel_info_s_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib3_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib4_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib5_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib6_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib7_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib8_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib9_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sched_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::tdd_ul_dl_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::uac_barr_info_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::uac_barr_per_plmn_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::uac_barr_per_plmn_s::uac_ac_barr_list_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_cfg_common_sib_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cell_access_related_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::conn_est_fail_ctrl_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::si_sched_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::serving_cell_cfg_common_sib_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sys_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sys_info_ies_s::sib_type_and_info_item_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_timers_and_consts_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib1_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sib1_s::uac_barr_info_s_::uac_access_category1_sel_assist_info_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sys_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sys_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bcch_dl_sch_msg_type_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bcch_dl_sch_msg_type_c::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bcch_dl_sch_msg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdcp_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdcp_cfg_s::drb_s_::hdr_compress_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sdap_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drb_to_add_mod_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drb_to_add_mod_s::cn_assoc_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srb_to_add_mod_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_algorithm_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::radio_bearer_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reject_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reject_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reject_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_ccch_msg_type_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_ccch_msg_type_c::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_ccch_msg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_res_mob_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_res_mob_s::slot_cfg_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_res_mob_s::freq_domain_alloc_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_cell_mob_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::q_offset_range_list_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_res_cfg_mob_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cells_to_add_mod_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_report_quant_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_trigger_quant_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_trigger_quant_eutra_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_trigger_quant_offset_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ssb_cfg_mob_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_black_cell_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_cell_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::event_trigger_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::event_trigger_cfg_s::event_id_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::event_trigger_cfg_inter_rat_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::event_trigger_cfg_inter_rat_s::event_id_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::filt_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pci_range_elem_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::periodical_report_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::periodical_report_cfg_inter_rat_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ran_area_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ref_sig_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_cgi_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_cgi_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_sftd_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_sftd_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ssb_mtc2_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mrdc_secondary_cell_group_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mrdc_secondary_cell_group_cfg_s::mrdc_secondary_cell_group_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_obj_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_obj_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::overheat_assist_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::plmn_ran_area_cell_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::plmn_ran_area_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::quant_cfg_rs_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_cfg_inter_rat_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_cfg_inter_rat_s::report_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_cfg_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_cfg_nr_s::report_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_prio_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_prio_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::gap_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_id_to_add_mod_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_obj_to_add_mod_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_obj_to_add_mod_s::meas_obj_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::other_cfg_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::quant_cfg_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_v1560_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_cfg_to_add_mod_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::report_cfg_to_add_mod_s::report_cfg_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::carrier_info_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drb_count_msb_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::master_key_upd_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_gap_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_gap_sharing_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::other_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::other_cfg_s::delay_budget_report_cfg_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::quant_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ran_notif_area_info_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_v1540_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::redirected_carrier_info_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_rat_request_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cell_resel_priorities_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_cfg_s::s_measure_cfg_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_v1530_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_release_v1540_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_v1560_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::redirected_carrier_info_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_cfg_smc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::suspend_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::counter_check_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_info_transfer_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mob_from_nr_cmd_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reest_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_release_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_cmd_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_enquiry_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::counter_check_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::counter_check_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_info_transfer_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_info_transfer_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mob_from_nr_cmd_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mob_from_nr_cmd_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reest_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reest_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_release_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_release_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_cmd_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_cmd_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_enquiry_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_enquiry_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_dcch_msg_type_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_dcch_msg_type_c::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_dcch_msg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::paging_ue_id_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::paging_record_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::paging_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pcch_msg_type_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pcch_msg_type_c::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pcch_msg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::init_ue_id_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::reestab_ue_id_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reest_request_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_request_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_request_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_sys_info_request_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reest_request_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_request_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_request_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_sys_info_request_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_sys_info_request_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_ccch_msg_type_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_ccch_msg_type_c::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_ccch_msg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_request1_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_request1_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_ccch1_msg_type_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_ccch1_msg_type_c::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_ccch1_msg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_quant_results_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::plmn_id_eutra_minus5_gc_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cell_id_eutra_minus5_gc_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::results_per_csi_rs_idx_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::results_per_ssb_idx_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cgi_info_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cell_access_related_info_eutra_minus5_gc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cell_access_related_info_eutra_epc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cgi_info_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_quant_results_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_result_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_result_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_tx_direct_current_bwp_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_rstd_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_result2_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_result2_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_result_cell_sftd_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_result_serv_mo_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_tx_direct_current_cell_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drb_count_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_result_sftd_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::overheat_assist_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_complete_v1560_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_complete_v1560_ies_s::scg_resp_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_rat_container_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::delay_budget_report_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::fail_info_rlc_bearer_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::fail_report_scg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::fail_report_scg_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::location_meas_info_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_results_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_results_s::meas_result_neigh_cells_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_complete_v1530_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::registered_amf_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::s_nssai_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scg_fail_info_v1590_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scg_fail_info_eutra_v1590_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ueassist_info_v1540_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::counter_check_resp_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::fail_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::location_meas_ind_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_report_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_complete_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reest_complete_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_complete_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_complete_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_complete_ies_s::ng_minus5_g_s_tmsi_value_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scg_fail_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scg_fail_info_eutra_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_complete_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_fail_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ueassist_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_info_transfer_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_info_transfer_mrdc_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::counter_check_resp_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::counter_check_resp_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::fail_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::fail_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::location_meas_ind_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::location_meas_ind_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_report_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_report_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_complete_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_recfg_complete_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reest_complete_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_reest_complete_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_complete_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_resume_complete_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_complete_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrc_setup_complete_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scg_fail_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scg_fail_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scg_fail_info_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scg_fail_info_eutra_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_complete_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_complete_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_fail_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::security_mode_fail_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ueassist_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ueassist_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_info_transfer_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_info_transfer_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_info_transfer_mrdc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_info_transfer_mrdc_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_info_transfer_mrdc_s::crit_exts_c_::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_dcch_msg_type_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_dcch_msg_type_c::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_dcch_msg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bfr_csirs_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bfr_ssb_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_freq_occupation_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_res_map_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_res_map_s::freq_domain_alloc_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_res_map_s::density_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_res_periodicity_and_offset_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::int_cfg_per_serving_cell_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ptrs_dl_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::qcl_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::qcl_info_s::ref_sig_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dmrs_dl_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_preemption_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_tpc_cmd_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_tpc_cmd_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::radio_link_monitoring_rs_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::radio_link_monitoring_rs_s::detection_res_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rate_match_pattern_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rate_match_pattern_s::pattern_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rate_match_pattern_s::pattern_type_c_::bitmaps_s_::symbols_in_res_block_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rate_match_pattern_s::pattern_type_c_::bitmaps_s_::periodicity_and_pattern_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rate_match_pattern_group_item_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_tpc_cmd_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::tci_state_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::zp_csi_rs_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::zp_csi_rs_res_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdcch_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdsch_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdsch_cfg_s::prb_bundling_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::radio_link_monitoring_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sps_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bwp_dl_ded_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bwp_dl_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::beta_offsets_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::p0_pucch_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::p0_pusch_alpha_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ptrs_ul_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_pathloss_ref_rs_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_pathloss_ref_rs_s::ref_sig_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_format0_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_format1_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_format2_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_format3_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_format4_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_pathloss_ref_rs_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_pathloss_ref_rs_s::ref_sig_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sri_pusch_pwr_ctrl_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_periodicity_and_offset_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_spatial_relation_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_spatial_relation_info_s::ref_sig_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_uci_on_pusch_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dmrs_ul_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::prach_res_ded_bfr_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_format_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_pwr_ctrl_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_res_s::format_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_res_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_spatial_relation_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_spatial_relation_info_s::ref_sig_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_pwr_ctrl_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ra_prioritization_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_res_s::tx_comb_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_res_s::res_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_res_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_res_set_s::res_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_res_set_s::res_type_c_::aperiodic_s_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_res_set_s::pathloss_ref_rs_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sched_request_res_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sched_request_res_cfg_s::periodicity_and_offset_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::uci_on_pusch_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::uci_on_pusch_s::beta_offsets_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::beam_fail_recovery_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cfgured_grant_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bwp_ul_ded_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bwp_ul_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_params_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ca_params_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ca_params_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mrdc_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_switching_time_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_switching_time_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_params_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_params_v1540_s::srs_carrier_switch_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ca_params_nr_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ca_params_nr_v1550_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_v1550_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ca_params_nr_v1560_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ca_params_eutra_v1560_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ca_params_nrdc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_v1560_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ca_params_eutra_v1570_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_v1570_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mrdc_params_v1580_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_v1580_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mrdc_params_v1590_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_v1590_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::supported_csi_rs_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::beam_management_ssb_csi_rs_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_for_tracking_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_im_reception_for_feedback_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_rs_proc_framework_for_srs_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_report_framework_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_g_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_h_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ptrs_density_recommendation_dl_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ptrs_density_recommendation_ul_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::spatial_relations_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mimo_params_per_band_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_nr_s::ch_bws_dl_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_nr_s::ch_bws_ul_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_nr_s::ch_bws_dl_v1590_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_nr_s::ch_bws_ul_v1590_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cfra_csirs_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cfra_ssb_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cfra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cfra_s::res_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_associated_report_cfg_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_associated_report_cfg_info_s::res_for_ch_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_aperiodic_trigger_state_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_im_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_im_res_s::csi_im_res_elem_pattern_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_im_res_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_report_periodicity_and_offset_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_semi_persistent_on_pusch_trigger_state_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_cfg_s::codebook_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_cfg_s::codebook_type_c_::type1_s_::sub_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_cfg_s::codebook_type_c_::type1_s_::sub_type_c_::type_i_single_panel_s_::nr_of_ant_ports_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_cfg_s::codebook_type_c_::type1_s_::sub_type_c_::type_i_single_panel_s_::nr_of_ant_ports_c_::more_than_two_s_::n1_n2_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_cfg_s::codebook_type_c_::type1_s_::sub_type_c_::type_i_multi_panel_s_::ng_n1_n2_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_cfg_s::codebook_type_c_::type2_s_::sub_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::codebook_cfg_s::codebook_type_c_::type2_s_::sub_type_c_::type_ii_s_::n1_n2_codebook_subset_restrict_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pucch_csi_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::port_idx_for8_ranks_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_report_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_report_cfg_s::report_cfg_type_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_report_cfg_s::report_quant_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_report_cfg_s::report_freq_cfg_s_::csi_report_band_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_report_cfg_s::group_based_beam_report_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_res_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_res_cfg_s::csi_rs_res_set_list_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_ssb_res_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::nzp_csi_rs_res_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::nzp_csi_rs_res_set_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::csi_meas_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_mbsfn_sf_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_mbsfn_sf_cfg_s::sf_alloc1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_mbsfn_sf_cfg_s::sf_alloc2_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_cc_set_idx_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::slot_format_combination_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_info_dl_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_info_ul_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_code_block_group_tx_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_tpc_pdcch_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::slot_format_combinations_per_cell_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdsch_code_block_group_tx_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pusch_serving_cell_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rate_match_pattern_lte_crs_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_carrier_switching_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::srs_carrier_switching_s::srs_tpc_pdcch_group_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::slot_format_ind_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::tdd_ul_dl_slot_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::tdd_ul_dl_slot_cfg_s::symbols_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cross_carrier_sched_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cross_carrier_sched_cfg_s::sched_cell_info_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_am_rlc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dl_um_rlc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdcch_serving_cell_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdsch_serving_cell_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rach_cfg_ded_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sched_request_to_add_mod_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::serving_cell_cfg_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::serving_cell_cfg_common_s::ssb_positions_in_burst_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::tag_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::tdd_ul_dl_cfg_ded_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_am_rlc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_um_rlc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ul_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::bsr_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drx_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drx_cfg_s::drx_on_dur_timer_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drx_cfg_s::drx_long_cycle_start_offset_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::lc_ch_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::lc_ch_cfg_s::ul_specific_params_s_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phr_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rlc_cfg_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rlf_timers_and_consts_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::recfg_with_sync_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::recfg_with_sync_s::rach_cfg_ded_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sched_request_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::serving_cell_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::tag_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mac_cell_group_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phys_cell_group_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rlc_bearer_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rlc_bearer_cfg_s::served_radio_bearer_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::scell_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sp_cell_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cell_group_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_params_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_params_xdd_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::eutra_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_a_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_b_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_c_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_d_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_e_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_dl_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::processing_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_dl_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_dl_v15a0_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::supported_bw_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_dl_per_cc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_f_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::dummy_i_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_ul_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_ul_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_ul_per_cc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_set_ul_per_cc_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::feature_sets_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_band_info_eutra_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_band_info_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::freq_band_info_c> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ims_params_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ims_params_frx_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ims_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::inter_rat_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mac_params_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mac_params_xdd_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mac_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_frx_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_xdd_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_mrdc_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_mrdc_frx_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_mrdc_xdd_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_mrdc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_mrdc_xdd_diff_v1560_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_and_mob_params_mrdc_v1560_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_result_scg_fail_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::general_params_mrdc_xdd_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_mrdc_cap_add_frx_mode_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_mrdc_cap_add_xdd_mode_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::nrdc_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::carrier_aggregation_variant_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phy_params_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phy_params_fr1_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phy_params_fr2_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phy_params_frx_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phy_params_xdd_diff_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phy_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::naics_cap_entry_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::phy_params_mrdc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rf_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rf_params_mrdc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_request_filt_nr_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_request_filt_nr_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_mrdc_cap_add_xdd_mode_v1560_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdcp_params_mrdc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_mrdc_cap_v1560_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_mrdc_cap_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::nrdc_params_v1570_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_v1570_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_v1560_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::sdap_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_v1550_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_add_frx_mode_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_add_frx_mode_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_v1540_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_add_xdd_mode_v1530_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::pdcp_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rlc_params_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_v1530_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_add_xdd_mode_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_nr_cap_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_request_filt_common_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_cap_enquiry_v1560_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::as_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::reestab_ncell_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::band_combination_info_sn_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cfg_restrict_info_scg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::reest_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::as_context_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::victim_sys_type_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::affected_carrier_freq_comb_info_mrdc_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ph_ul_carrier_scg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_v1590_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ph_info_scg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_v1560_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::fr_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::nr_freq_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_v1540_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cfg_restrict_mod_req_scg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drx_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::drx_info_s::drx_long_cycle_start_offset_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_cfg_sn_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_s::crit_exts_c_::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_info_v1590_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ph_ul_carrier_mcg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_info_v1570_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ph_info_mcg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_info_v1560_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_info_v1540_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::mrdc_assist_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_cfg_mn_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cg_cfg_info_s::crit_exts_c_::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::cells_triggered_list_item_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ho_cmd_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ho_cmd_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ho_cmd_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ho_cmd_s::crit_exts_c_::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::rrm_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ho_prep_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ho_prep_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ho_prep_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ho_prep_info_s::crit_exts_c_::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_timing_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_timing_cfg_v1550_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_timing_cfg_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_timing_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_timing_cfg_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::meas_timing_cfg_s::crit_exts_c_::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_radio_access_cap_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_radio_access_cap_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_radio_access_cap_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_radio_access_cap_info_s::crit_exts_c_::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_radio_paging_info_ies_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_radio_paging_info_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_radio_paging_info_s::crit_exts_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::ue_radio_paging_info_s::crit_exts_c_::c1_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::var_meas_cfg_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::var_meas_cfg_s::s_measure_cfg_c_> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::var_meas_report_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::var_resume_mac_input_s> {
+  static const type_desc* desc();
+};
+template <>
+struct type_reflector<rrc_nr::var_short_mac_input_s> {
+  static const type_desc* desc();
+};
+
+} // namespace asn1
+
+#endif // SRSASN1_RRC_NR_FIELD_PATH_H
@@ -43,7 +43,7 @@ namespace net_utils {
 enum class addr_family { ipv4 = AF_INET, ipv6 = AF_INET6 };
 enum class socket_type : int { none = -1, datagram = SOCK_DGRAM, stream = SOCK_STREAM, seqpacket = SOCK_SEQPACKET };
 enum class protocol_type : int { NONE = -1, SCTP = IPPROTO_SCTP, TCP = IPPROTO_TCP, UDP = IPPROTO_UDP };
-enum class ppid_values : uint32_t { S1AP = 18 };
+enum class ppid_values : uint32_t { S1AP = 18, NGAP = 60 };
 const char* protocol_to_string(protocol_type p);
 
 // Convenience addr functions
@@ -101,4 +101,26 @@ void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks);
 
 uint8_t* s3g_f9(const uint8_t* key, uint32_t count, uint32_t fresh, uint32_t dir, uint8_t* data, uint64_t length);
 
+/* One stream of a multi-buffer keystream generation: the key and IV words as
+ * given to s3g_initialize() and room for n words of keystream.
+ */
+typedef struct {
+  const uint32_t* k;
+  const uint32_t* iv;
+  uint32_t*       ks;
+  uint32_t        n;
+} s3g_mb_job_t;
+
+/* Number of streams generated in lockstep: 16 with AVX-512, 8 with AVX2,
+ * otherwise 1.
+ */
+uint32_t s3g_mb_lanes();
+
+/* Multi-buffer keystream generation.
+ * Every job gets the keystream of s3g_initialize() + s3g_generate_keystream(),
+ * s3g_mb_lanes() jobs at a time. Each group runs for as long as its longest
+ * stream, so jobs of similar length should be grouped together.
+ */
+void s3g_generate_keystream_mb(const s3g_mb_job_t* jobs, uint32_t nof_jobs);
+
 #endif // SRSRAN_S3G_H
\ No newline at end of file
@@ -26,9 +26,12 @@
  * Common security header - wraps ciphering/integrity check algorithms.
  *****************************************************************************/
 
+#include "mitm_lib/adt/span.h"
 #include "mitm_lib/common/common.h"
+#include "mitm_lib/common/ssl.h"
 #include "mitm_lib/srslog/srslog.h"
 
+#include <initializer_list>
 #include <vector>
 
 #define AKA_RAND_LEN 16
@@ -152,10 +155,31 @@ void log_debug(const char* format, Args&&... args)
   srslog::fetch_basic_logger("SEC").debug(format, std::forward<Args>(args)...);
 }
 
+/******************************************************************************
+ * KDF Cache
+ *
+ * Results of kdf_common() are memoized by (key, S), so that re-keying many UEs
+ * with the same inputs skips the HMAC-SHA256. Only inputs with a short S are
+ * cached, which covers the gNB, RRC, UP and NAS key derivations. The cache has
+ * a fixed number of entries and wipes the derived keys it evicts or clears.
+ *****************************************************************************/
+struct kdf_cache_metrics_t {
+  uint64_t hits;
+  uint64_t misses;
+};
+
+void                kdf_cache_clear();
+kdf_cache_metrics_t kdf_cache_get_metrics();
+
 /******************************************************************************
  * Key Generation
  *****************************************************************************/
 
+// Allocation free KDF (TS 33.220 B.2): S = FC || P0 || L0 || P1 || L1 || ... is built on the stack from the parameter
+// spans, so it is limited to KDF_MAX_S_LEN bytes. The key is 32 bytes long
+#define KDF_MAX_S_LEN 512
+int kdf_common(const uint8_t fc, const uint8_t* key, std::initializer_list<span<const uint8_t> > params, uint8_t* output);
+
 int kdf_common(const uint8_t fc, const std::array<uint8_t, 32>& key, const std::vector<uint8_t>& P, uint8_t* output);
 int kdf_common(const uint8_t                  fc,
                const std::array<uint8_t, 32>& key,
@@ -253,6 +277,39 @@ uint8_t security_generate_res_star(const uint8_t* ck,
                                    const uint8_t* res,
                                    const size_t   res_len,
                                    uint8_t*       res_star);
+/******************************************************************************
+ * Keyed Contexts
+ *
+ * 128-EEA2/128-EIA2 state derived from a key once, when the key is installed,
+ * instead of on every PDU: the AES-128 key schedule and, for EIA2, the CMAC
+ * subkeys K1/K2 (RFC 4493). Built with LV_HAVE_AESNI the round keys are kept
+ * for AES-NI, otherwise the schedule of the SSL library is used.
+ *****************************************************************************/
+struct security_aes128_key_t {
+#ifdef LV_HAVE_AESNI
+  alignas(16) uint8_t rk[11][16];
+#else
+  // The library context points into itself, so it must not be copied
+  mutable aes_context ctx;
+#endif
+  security_aes128_key_t() = default;
+  security_aes128_key_t(const security_aes128_key_t&) = delete;
+  security_aes128_key_t& operator=(const security_aes128_key_t&) = delete;
+};
+
+struct security_128_eia2_ctx_t {
+  security_aes128_key_t aes;
+  uint8_t               k1[16];
+  uint8_t               k2[16];
+};
+
+struct security_128_eea2_ctx_t {
+  security_aes128_key_t aes;
+};
+
+uint8_t security_128_eia2_init(security_128_eia2_ctx_t& ctx, const uint8_t* key);
+uint8_t security_128_eea2_init(security_128_eea2_ctx_t& ctx, const uint8_t* key);
+
 /******************************************************************************
  * Integrity Protection
  *****************************************************************************/
@@ -272,6 +329,14 @@ uint8_t security_128_eia2(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac);
 
+uint8_t security_128_eia2(const security_128_eia2_ctx_t& ctx,
+                          uint32_t                       count,
+                          uint32_t                       bearer,
+                          uint8_t                        direction,
+                          const uint8_t*                 msg,
+                          uint32_t                       msg_len,
+                          uint8_t*                       mac);
+
 uint8_t security_128_eia3(const uint8_t* key,
                           uint32_t       count,
                           uint32_t       bearer,
@@ -301,6 +366,14 @@ uint8_t security_128_eea2(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+uint8_t security_128_eea2(const security_128_eea2_ctx_t& ctx,
+                          uint32_t                       count,
+                          uint8_t                        bearer,
+                          uint8_t                        direction,
+                          const uint8_t*                 msg,
+                          uint32_t                       msg_len,
+                          uint8_t*                       msg_out);
+
 uint8_t security_128_eea3(uint8_t* key,
                           uint32_t count,
                           uint8_t  bearer,
@@ -309,6 +382,42 @@ uint8_t security_128_eea3(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+/******************************************************************************
+ * Batched Processing
+ *
+ * Bursts of PDUs of one bearer, i.e. the same key, BEARER and DIRECTION, that
+ * only differ in COUNT. The key schedule is looked up once per batch and the
+ * work of consecutive PDUs is interleaved: the 128-EEA2 counter blocks of all
+ * PDUs form a single AES-CTR pipeline, four 128-EIA2 CMAC chains run side by
+ * side and 128-EEA1/128-EEA3 keystreams come from the multi-buffer generators.
+ *****************************************************************************/
+
+// For ciphering, out receives msg_len bytes and may be equal to msg. For integrity protection, out receives the MAC.
+struct security_pdu_t {
+  const uint8_t* msg;
+  uint32_t       msg_len;
+  uint32_t       count;
+  uint8_t*       out;
+};
+
+uint8_t security_128_eia1_batch(const uint8_t* key, uint32_t bearer, uint8_t direction, span<const security_pdu_t> pdus);
+
+uint8_t security_128_eia2_batch(const security_128_eia2_ctx_t& ctx,
+                                uint32_t                       bearer,
+                                uint8_t                        direction,
+                                span<const security_pdu_t>     pdus);
+
+uint8_t security_128_eia3_batch(const uint8_t* key, uint32_t bearer, uint8_t direction, span<const security_pdu_t> pdus);
+
+uint8_t security_128_eea1_batch(const uint8_t* key, uint8_t bearer, uint8_t direction, span<const security_pdu_t> pdus);
+
+uint8_t security_128_eea2_batch(const security_128_eea2_ctx_t& ctx,
+                                uint8_t                        bearer,
+                                uint8_t                        direction,
+                                span<const security_pdu_t>     pdus);
+
+uint8_t security_128_eea3_batch(const uint8_t* key, uint8_t bearer, uint8_t direction, span<const security_pdu_t> pdus);
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
@@ -326,5 +435,39 @@ uint8_t security_milenage_f5_star(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_
 int security_xor_f2345(uint8_t* k, uint8_t* rand, uint8_t* res, uint8_t* ck, uint8_t* ik, uint8_t* ak);
 int security_xor_f1(uint8_t* k, uint8_t* rand, uint8_t* sqn, uint8_t* amf, uint8_t* mac_a);
 
+/******************************************************************************
+ * Authentication Vector Generation
+ *
+ * Milenage for many vectors at a time: the AES-128 key schedule of K is
+ * expanded once per subscriber, and the five AES calls of each vector run as
+ * four independent blocks (f1, f2/f5, f3, f4) after TEMP, whose blocks are
+ * themselves computed for four vectors together.
+ *****************************************************************************/
+struct security_milenage_subscriber_t {
+  security_aes128_key_t aes;
+  uint8_t               opc[16];
+};
+
+uint8_t security_milenage_subscriber_init(security_milenage_subscriber_t& sub, const uint8_t* k, const uint8_t* opc);
+
+// 5G AKA authentication vector of the home network (TS 33.501 6.1.3.2)
+struct security_5g_av_t {
+  uint8_t rand[AKA_RAND_LEN];
+  uint8_t xres_star[16];
+  uint8_t autn[AKA_AUTN_LEN];
+  uint8_t k_ausf[32];
+};
+
+// One vector to generate. RAND, SQN and AMF are chosen by the caller
+struct security_5g_av_req_t {
+  const security_milenage_subscriber_t* sub;
+  const uint8_t*                        rand;
+  const uint8_t*                        sqn;
+  const uint8_t*                        amf;
+  security_5g_av_t*                     av;
+};
+
+uint8_t security_generate_5g_av_batch(span<const security_5g_av_req_t> reqs, const char* serving_network_name);
+
 } // namespace srsran
 #endif // SRSRAN_SECURITY_H
@@ -55,5 +55,21 @@ typedef struct {
 
 void zuc_initialize(zuc_state_t* state, const u8* k, u8* iv);
 void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream);
+/* Next words of a keystream started with zuc_generate_keystream() */
+void zuc_continue_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream);
+
+/* One stream of a multi-buffer keystream generation */
+typedef struct {
+  const u8* k;
+  const u8* iv;
+  u32*      ks;
+  int       key_stream_len;
+} zuc_mb_job_t;
+
+/* Number of streams generated in lockstep: 16 with AVX-512, 8 with AVX2, otherwise 1 */
+int zuc_mb_lanes(void);
+/* Same keystreams as zuc_initialize() + zuc_generate_keystream() for every job, zuc_mb_lanes() jobs at a time. Jobs
+ * of similar length should be grouped, a group runs for as long as its longest stream */
+void zuc_generate_keystream_mb(const zuc_mb_job_t* jobs, int nof_jobs);
 
 #endif // SRSRAN_ZUC_H
@@ -22,6 +22,7 @@
 #ifndef SRSRAN_MAC_SCH_PDU_NR_H
 #define SRSRAN_MAC_SCH_PDU_NR_H
 
+#include "mitm_lib/adt/bounded_vector.h"
 #include "mitm_lib/common/byte_buffer.h"
 #include "mitm_lib/common/common.h"
 #include "mitm_lib/config.h"
@@ -63,7 +64,7 @@ public:
   // SDUs up to 256 B can use the short 8-bit L field
   static const int32_t MAC_SUBHEADER_LEN_THRESHOLD = 256;
 
-  mac_sch_subpdu_nr(mac_sch_pdu_nr* parent_) : parent(parent_), logger(&srslog::fetch_basic_logger("MAC-NR")){};
+  mac_sch_subpdu_nr(mac_sch_pdu_nr* parent_);
 
   nr_lcid_sch_t get_type();
   bool          is_sdu() const;
@@ -91,8 +92,8 @@ public:
   lcg_bsr_t            get_sbsr() const;
   static const uint8_t max_num_lcg_lbsr = 8;
   struct lbsr_t {
-    uint8_t                bitmap; // the first octet of LBSR and Long Trunc BSR
-    std::vector<lcg_bsr_t> list;   // one entry for each reported LCG
+    uint8_t                                             bitmap; // the first octet of LBSR and Long Trunc BSR
+    srsran::bounded_vector<lcg_bsr_t, max_num_lcg_lbsr> list;   // one entry for each reported LCG
   };
   lbsr_t get_lbsr() const;
 
@@ -126,6 +127,8 @@ public:
   void to_string(fmt::memory_buffer& buffer);
 
 private:
+  friend class mac_sch_pdu_nr;
+
   srslog::basic_logger* logger;
 
   // internal helpers
@@ -200,6 +203,9 @@ private:
 class mac_sch_pdu_nr
 {
 public:
+  // Sub-PDUs are kept in place, a PDU with more of them is rejected by unpack()
+  static const uint32_t max_num_subpdus = 128;
+
   mac_sch_pdu_nr(bool ulsch_ = false) : ulsch(ulsch_), logger(srslog::fetch_basic_logger("MAC-NR")) {}
 
   void                     pack();
@@ -220,6 +226,8 @@ public:
   uint32_t add_sbsr_ce(const mac_sch_subpdu_nr::lcg_bsr_t bsr_);
   uint32_t add_lbsr_ce(const std::array<mac_sch_subpdu_nr::lcg_bsr_t, mac_sch_subpdu_nr::max_num_lcg_lbsr> bsr_);
   uint32_t add_ue_con_res_id_ce(const mac_sch_subpdu_nr::ue_con_res_id_t id);
+  // Copies a subPDU of another PDU, e.g. an unpacked one, its payload included
+  uint32_t add_subpdu(const mac_sch_subpdu_nr& subpdu_);
 
   uint32_t get_remaing_len();
 
@@ -227,12 +235,14 @@ public:
 
   uint32_t size_header_sdu(const uint32_t lcid_, const uint32_t nbytes);
 
+  srslog::basic_logger& get_logger() { return logger; }
+
 private:
   /// Private helper that adds a subPDU to the MAC PDU
   uint32_t add_sudpdu(mac_sch_subpdu_nr& subpdu);
 
-  bool                           ulsch = false;
-  std::vector<mac_sch_subpdu_nr> subpdus;
+  bool                                               ulsch = false;
+  bounded_vector<mac_sch_subpdu_nr, max_num_subpdus> subpdus;
 
   byte_buffer_t*        buffer        = nullptr;
   uint32_t              pdu_len       = 0;
@@ -25,6 +25,8 @@
 #include "mitm_lib/adt/circular_buffer.h"
 #include "mitm_lib/adt/circular_map.h"
 #include "mitm_lib/adt/intrusive_list.h"
+#include "mitm_lib/adt/pool/cached_alloc.h"
+#include "mitm_lib/adt/pool/memblock_cache.h"
 #include "mitm_lib/common/buffer_pool.h"
 #include <array>
 #include <list>
@@ -257,6 +259,202 @@ private:
   srsran::static_circular_map<uint32_t, T, WINDOW_SIZE> window;
 };
 
+/// Free list of the nodes of the segment lists of one RLC AM NR entity. Released nodes are kept for reuse, so that a
+/// bearer segmenting at a steady rate stops allocating once the pool holds as many nodes as there are segments in
+/// flight. Not thread-safe: it is only used under the lock of its entity.
+template <class T>
+class rlc_segment_pool
+{
+public:
+  struct node_t {
+    T       value;
+    node_t* next = nullptr;
+
+    template <typename... Args>
+    explicit node_t(Args&&... args) : value(std::forward<Args>(args)...)
+    {}
+  };
+
+  rlc_segment_pool() = default;
+  rlc_segment_pool(const rlc_segment_pool&) = delete;
+  rlc_segment_pool& operator=(const rlc_segment_pool&) = delete;
+  ~rlc_segment_pool()
+  {
+    while (not free_list.empty()) {
+      ::operator delete(free_list.pop());
+    }
+  }
+
+  template <typename... Args>
+  node_t* make_node(Args&&... args)
+  {
+    void* block = free_list.try_pop();
+    if (block == nullptr) {
+      block = ::operator new(std::max(sizeof(node_t), detail::intrusive_memblock_list::min_memblock_size()));
+    }
+    return new (block) node_t(std::forward<Args>(args)...);
+  }
+
+  void release(node_t* node)
+  {
+    node->~node_t();
+    free_list.push(node);
+  }
+
+  size_t nof_cached_nodes() const { return free_list.size(); }
+
+private:
+  detail::intrusive_memblock_list free_list;
+};
+
+/// Singly linked list of the segments of one SDU, with nodes taken from a rlc_segment_pool. Without a pool, the nodes
+/// come from the heap.
+template <class T>
+class rlc_segment_list
+{
+  using node_t = typename rlc_segment_pool<T>::node_t;
+
+  template <typename U>
+  class iterator_impl
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = U;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = U*;
+    using reference         = U&;
+
+    explicit iterator_impl(node_t* node_ = nullptr) : node(node_) {}
+    U&             operator*() const { return node->value; }
+    U*             operator->() const { return &node->value; }
+    iterator_impl& operator++()
+    {
+      node = node->next;
+      return *this;
+    }
+    iterator_impl operator++(int)
+    {
+      iterator_impl prev = *this;
+      node               = node->next;
+      return prev;
+    }
+    bool operator==(const iterator_impl& other) const { return node == other.node; }
+    bool operator!=(const iterator_impl& other) const { return node != other.node; }
+
+  private:
+    friend class rlc_segment_list<T>;
+    node_t* node;
+  };
+
+public:
+  using iterator       = iterator_impl<T>;
+  using const_iterator = iterator_impl<const T>;
+
+  rlc_segment_list() = default;
+  explicit rlc_segment_list(rlc_segment_pool<T>* pool_) : pool(pool_) {}
+  rlc_segment_list(const rlc_segment_list&) = delete;
+  rlc_segment_list(rlc_segment_list&& other) noexcept :
+    pool(other.pool), head(other.head), tail(other.tail), count(other.count)
+  {
+    other.head  = nullptr;
+    other.tail  = nullptr;
+    other.count = 0;
+  }
+  rlc_segment_list& operator=(const rlc_segment_list&) = delete;
+  rlc_segment_list& operator=(rlc_segment_list&& other) noexcept
+  {
+    if (this != &other) {
+      clear();
+      pool        = other.pool;
+      head        = other.head;
+      tail        = other.tail;
+      count       = other.count;
+      other.head  = nullptr;
+      other.tail  = nullptr;
+      other.count = 0;
+    }
+    return *this;
+  }
+  ~rlc_segment_list() { clear(); }
+
+  void set_pool(rlc_segment_pool<T>* pool_) { pool = pool_; }
+
+  void push_back(T value) { insert_after(iterator(tail), std::move(value)); }
+
+  /// Inserts after pos, or at the front if pos is end(). Returns the position of the new element
+  iterator insert_after(iterator pos, T value)
+  {
+    node_t* node = pool != nullptr ? pool->make_node(std::move(value)) : new node_t(std::move(value));
+    if (pos.node == nullptr) {
+      node->next = head;
+      head       = node;
+    } else {
+      node->next     = pos.node->next;
+      pos.node->next = node;
+    }
+    if (node->next == nullptr) {
+      tail = node;
+    }
+    count++;
+    return iterator(node);
+  }
+
+  /// Inserts in the order given by cmp. As in a std::set, nothing is inserted if an equivalent element is present.
+  /// Returns true if the element was inserted
+  template <typename Compare>
+  bool insert_sorted(T value, Compare cmp)
+  {
+    node_t* prev = nullptr;
+    if (tail != nullptr and cmp(tail->value, value)) {
+      // Segments mostly arrive in order
+      prev = tail;
+    } else {
+      for (node_t* n = head; n != nullptr and cmp(n->value, value); n = n->next) {
+        prev = n;
+      }
+      node_t* next = prev == nullptr ? head : prev->next;
+      if (next != nullptr and not cmp(value, next->value)) {
+        return false;
+      }
+    }
+    insert_after(iterator(prev), std::move(value));
+    return true;
+  }
+
+  void clear()
+  {
+    while (head != nullptr) {
+      node_t* next = head->next;
+      if (pool != nullptr) {
+        pool->release(head);
+      } else {
+        delete head;
+      }
+      head = next;
+    }
+    tail  = nullptr;
+    count = 0;
+  }
+
+  T&       front() { return head->value; }
+  const T& front() const { return head->value; }
+  T&       back() { return tail->value; }
+  const T& back() const { return tail->value; }
+  bool     empty() const { return head == nullptr; }
+  size_t   size() const { return count; }
+
+  iterator       begin() { return iterator(head); }
+  iterator       end() { return iterator(nullptr); }
+  const_iterator begin() const { return const_iterator(head); }
+  const_iterator end() const { return const_iterator(nullptr); }
+
+private:
+  rlc_segment_pool<T>* pool  = nullptr;
+  node_t*              head  = nullptr;
+  node_t*              tail  = nullptr;
+  size_t               count = 0;
+};
+
 template <typename HeaderType>
 struct buffered_pdcp_pdu_list {
 public:
@@ -462,7 +660,8 @@ private:
 template <class T>
 class pdu_retx_queue_list
 {
-  std::list<T> queue;
+  // Deque nodes are cached, as entries are pushed and popped at the same rate
+  srsran::deque<T> queue;
 
 public:
   ~pdu_retx_queue_list() = default;
@@ -485,7 +684,7 @@ public:
     return queue.front();
   }
 
-  const std::list<T>& get_inner_queue() const { return queue; }
+  const srsran::deque<T>& get_inner_queue() const { return queue; }
 
   void   clear() { queue.clear(); }
   size_t size() const { return queue.size(); }
@@ -90,7 +90,8 @@ struct rlc_amd_tx_pdu_nr {
     uint32_t so          = 0;
     uint32_t payload_len = 0;
   };
-  std::list<pdu_segment> segment_list;
+  using segment_list_t = rlc_segment_list<pdu_segment>;
+  segment_list_t segment_list;
   explicit rlc_amd_tx_pdu_nr(uint32_t sn) : rlc_sn(sn) {}
 };
 
@@ -104,7 +105,7 @@ public:
   bool     configure(const rlc_config_t& cfg_) final;
   uint32_t read_pdu(uint8_t* payload, uint32_t nof_bytes) final;
   void     handle_control_pdu(uint8_t* payload, uint32_t nof_bytes) final;
-  void     handle_nack(const rlc_status_nack_t& nack, std::set<uint32_t>& retx_sn_set);
+  void     handle_nack(const rlc_status_nack_t& nack, std::vector<uint32_t>& retx_sn_list);
 
   void reestablish() final;
   void stop() final;
@@ -161,6 +162,7 @@ private:
    * Ref: 3GPP TS 38.322 version 16.2.0 Section 7.1
    ***************************************************************************/
   struct rlc_am_nr_tx_state_t                              st = {};
+  rlc_segment_pool<rlc_amd_tx_pdu_nr::pdu_segment>         segment_pool; // outlives the segment lists in tx_window
   std::unique_ptr<rlc_ringbuffer_base<rlc_amd_tx_pdu_nr> > tx_window;
 
   // Queues, buffers and container
@@ -168,6 +170,12 @@ private:
   uint32_t         sdu_under_segmentation_sn = INVALID_RLC_SN; // SN of the SDU currently being segmented.
   pdcp_sn_vector_t notify_info_vec;
 
+  // Status PDUs built and received, reused from one PDU to the next. Created by configure()
+  std::unique_ptr<rlc_am_nr_status_pdu_t> tx_status;
+  std::unique_ptr<rlc_am_nr_status_pdu_t> rx_status;
+  byte_buffer_t                           status_buf;
+  std::vector<uint32_t>                   retx_sn_list; // SNs scheduled for RETX by a status PDU, without duplicates
+
   // Helper constants
   uint32_t min_hdr_size = 2; // Pre-initialized for 12 bit SN, updated by configure()
   uint32_t so_size      = 2;
@@ -280,7 +288,9 @@ private:
   uint32_t rx_mod_base_nr(uint32_t sn) const;
 
   // RX Window
+  rlc_segment_pool<rlc_amd_rx_pdu_nr>                        segment_pool; // outlives the segment lists in rx_window
   std::unique_ptr<rlc_ringbuffer_base<rlc_amd_rx_sdu_nr_t> > rx_window;
+  std::unique_ptr<rlc_am_nr_status_pdu_t>                    length_status; // for get_status_pdu_length()
 
   // Mutexes
   std::mutex mutex;
@@ -22,9 +22,10 @@
 #ifndef SRSRAN_RLC_AM_NR_PACKING_H
 #define SRSRAN_RLC_AM_NR_PACKING_H
 
+#include "mitm_lib/adt/bounded_vector.h"
 #include "mitm_lib/common/string_helpers.h"
 #include "mitm_lib/rlc/rlc_am_base.h"
-#include <set>
+#include "mitm_lib/rlc/rlc_am_data_structs.h"
 
 namespace srsran {
 
@@ -72,7 +73,7 @@ struct rlc_amd_rx_sdu_nr_t {
   bool                 fully_received = false;
   bool                 has_gap        = false;
   unique_byte_buffer_t buf;
-  using segment_list_t = std::set<rlc_amd_rx_pdu_nr, rlc_amd_rx_pdu_nr_cmp>;
+  using segment_list_t = rlc_segment_list<rlc_amd_rx_pdu_nr>; // sorted by SO, see rlc_amd_rx_pdu_nr_cmp
   segment_list_t segments;
 
   rlc_amd_rx_sdu_nr_t() = default;
@@ -96,15 +97,20 @@ constexpr uint32_t rlc_am_nr_status_pdu_sizeof_nack_range           = 1; ///< NA
 /// AM NR Status PDU header
 class rlc_am_nr_status_pdu_t
 {
+public:
+  using nack_list_t = srsran::bounded_vector<rlc_status_nack_t, RLC_AM_NR_MAX_NACKS>;
+
 private:
   /// Stored SN size required to compute the packed size
   rlc_am_nr_sn_size_t sn_size = rlc_am_nr_sn_size_t::nulltype;
   /// Stored modulus to determine continuous sequences across SN overflows
   uint32_t mod_nr = cardinality(rlc_am_nr_sn_size_t::nulltype);
   /// Internal NACK container; keep in sync with packed_size_
-  std::vector<rlc_status_nack_t> nacks_ = {};
+  nack_list_t nacks_ = {};
   /// Stores the current packed size; sync on each change of nacks_
   uint32_t packed_size_ = rlc_am_nr_status_pdu_sizeof_header_ack_sn;
+  /// SN of the first NACK that did not fit into nacks_, INVALID_RLC_SN if none was dropped
+  uint32_t dropped_sn_ = INVALID_RLC_SN;
 
   void     refresh_packed_size();
   uint32_t nack_size(const rlc_status_nack_t& nack) const;
@@ -115,17 +121,20 @@ public:
   /// SN of the next not received RLC Data PDU
   uint32_t ack_sn = INVALID_RLC_SN;
   /// Read-only reference to NACKs
-  const std::vector<rlc_status_nack_t>& nacks = nacks_;
+  const nack_list_t& nacks = nacks_;
   /// Read-only reference to packed size
   const uint32_t& packed_size = packed_size_;
 
   rlc_am_nr_status_pdu_t(rlc_am_nr_sn_size_t sn_size);
   void reset();
   bool is_continuous_sequence(const rlc_status_nack_t& left, const rlc_status_nack_t& right) const;
-  void push_nack(const rlc_status_nack_t& nack);
-  const std::vector<rlc_status_nack_t>& get_nacks() const { return nacks_; }
-  uint32_t                              get_packed_size() const { return packed_size; }
-  bool                                  trim(uint32_t max_packed_size);
+  /// Appends a NACK, merging it into the last one if they are continuous. Returns false if the NACK list is full; the
+  /// NACK is then dropped and trim() moves ACK_SN back to the first dropped SN.
+  bool               push_nack(const rlc_status_nack_t& nack);
+  bool               has_dropped_nacks() const { return dropped_sn_ != INVALID_RLC_SN; }
+  const nack_list_t& get_nacks() const { return nacks_; }
+  uint32_t           get_packed_size() const { return packed_size; }
+  bool               trim(uint32_t max_packed_size);
 };
 
 /****************************************************************************
@@ -22,7 +22,7 @@
 #ifndef SRSLOG_DETAIL_SUPPORT_BACKEND_CAPACITY_H
 #define SRSLOG_DETAIL_SUPPORT_BACKEND_CAPACITY_H
 
-/// Take this default value if users did not specify any custom size.
+/// Take this default value if users did not specify any custom size. Must be a power of two.
 #ifndef SRSLOG_QUEUE_CAPACITY
 #define SRSLOG_QUEUE_CAPACITY 8192
 #endif
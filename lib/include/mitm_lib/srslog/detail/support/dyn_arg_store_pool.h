@@ -24,6 +24,7 @@
 
 #include "mitm_lib/srslog/bundled/fmt/printf.h"
 #include "mitm_lib/srslog/detail/support/backend_capacity.h"
+#include "mitm_lib/srslog/detail/support/lockfree_ring.h"
 
 namespace srslog {
 
@@ -31,7 +32,8 @@ namespace detail {
 
 /// Keeps a pool of dynamic_format_arg_store objects. The main reason for this class is that the arg store objects are
 /// implemented with std::vectors, so we want to avoid allocating memory each time we create a new object. Instead,
-/// reserve memory for each vector during initialization and recycle the objects.
+/// reserve memory for each vector during initialization and recycle the objects. The free objects are kept in a
+/// lock-free ring, log calls from any thread take them and the backend returns them.
 class dyn_arg_store_pool
 {
 public:
@@ -42,23 +44,18 @@ public:
       // Reserve for 10 normal and 2 named arguments.
       elem.reserve(10, 2);
     }
-    free_list.reserve(SRSLOG_QUEUE_CAPACITY);
     for (auto& elem : pool) {
-      free_list.push_back(&elem);
+      free_list.try_push(&elem);
     }
   }
 
   /// Returns a pointer to a free dyn arg store object, otherwise returns nullptr.
   fmt::dynamic_format_arg_store<fmt::printf_context>* alloc()
   {
-    scoped_lock lock(m);
-    if (free_list.empty()) {
+    fmt::dynamic_format_arg_store<fmt::printf_context>* p = nullptr;
+    if (!free_list.try_pop(p)) {
       return nullptr;
     }
-
-    auto* p = free_list.back();
-    free_list.pop_back();
-
     return p;
   }
 
@@ -70,14 +67,12 @@ public:
     }
 
     p->clear();
-    scoped_lock lock(m);
-    free_list.push_back(p);
+    free_list.try_push(p);
   }
 
 private:
-  std::vector<fmt::dynamic_format_arg_store<fmt::printf_context> > pool;
-  std::vector<fmt::dynamic_format_arg_store<fmt::printf_context>*> free_list;
-  mutable mutex                                                    m;
+  std::vector<fmt::dynamic_format_arg_store<fmt::printf_context> >                        pool;
+  lockfree_ring<fmt::dynamic_format_arg_store<fmt::printf_context>*, SRSLOG_QUEUE_CAPACITY> free_list;
 };
 
 } // namespace detail
@@ -0,0 +1,160 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_DETAIL_SUPPORT_LOCKFREE_RING_H
+#define SRSLOG_DETAIL_SUPPORT_LOCKFREE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace srslog {
+
+namespace detail {
+
+/// Bounded lock-free ring of elements of type T, any number of threads may push and pop concurrently.
+///
+/// Each cell carries a sequence number that tells whether it is free for the push of a given position or holds the
+/// element for the pop of that position, so that pushers and poppers only contend on the position counters, with a
+/// single CAS each. A push that claimed a cell but has not finished writing it holds back the pops behind it.
+template <typename T, size_t capacity>
+class lockfree_ring
+{
+  static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "Ring capacity must be a power of two");
+
+  static constexpr size_t mask       = capacity - 1;
+  static constexpr size_t cache_line = 64;
+
+  struct cell {
+    std::atomic<size_t>                                        seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T* get() { return reinterpret_cast<T*>(&storage); }
+  };
+
+  std::unique_ptr<cell[]> cells;
+  // Pushers and poppers work on different cache lines.
+  std::atomic<size_t> tail{0};
+  char                pad0[cache_line - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> head{0};
+  char                pad1[cache_line - sizeof(std::atomic<size_t>)];
+
+public:
+  lockfree_ring() : cells(new cell[capacity])
+  {
+    for (size_t i = 0; i != capacity; ++i) {
+      cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  lockfree_ring(const lockfree_ring&) = delete;
+  lockfree_ring& operator=(const lockfree_ring&) = delete;
+
+  ~lockfree_ring()
+  {
+    size_t pos = head.load(std::memory_order_relaxed);
+    while (cells[pos & mask].seq.load(std::memory_order_acquire) == pos + 1) {
+      cells[pos & mask].get()->~T();
+      ++pos;
+    }
+  }
+
+  /// Inserts a new element into the back of the ring. Returns false when the ring is full, the value is then left
+  /// untouched.
+  template <typename U>
+  bool try_push(U&& value)
+  {
+    cell*  c   = nullptr;
+    size_t pos = tail.load(std::memory_order_relaxed);
+    while (true) {
+      c                 = &cells[pos & mask];
+      size_t   seq      = c->seq.load(std::memory_order_acquire);
+      intptr_t distance = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (distance == 0) {
+        if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (distance < 0) {
+        // The cell still holds the element pushed one lap ago.
+        return false;
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (c->get()) T(std::forward<U>(value));
+    c->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Extracts the front element of the ring into value. Returns false when the ring is empty.
+  bool try_pop(T& value)
+  {
+    cell*  c   = nullptr;
+    size_t pos = head.load(std::memory_order_relaxed);
+    while (true) {
+      c                 = &cells[pos & mask];
+      size_t   seq      = c->seq.load(std::memory_order_acquire);
+      intptr_t distance = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (distance == 0) {
+        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (distance < 0) {
+        return false;
+      } else {
+        pos = head.load(std::memory_order_relaxed);
+      }
+    }
+
+    value = std::move(*c->get());
+    c->get()->~T();
+    c->seq.store(pos + capacity, std::memory_order_release);
+    return true;
+  }
+
+  /// Returns true when the front element is not ready to be popped.
+  bool empty() const
+  {
+    size_t pos = head.load(std::memory_order_relaxed);
+    return cells[pos & mask].seq.load(std::memory_order_acquire) != pos + 1;
+  }
+
+  /// Approximate number of elements in the ring, exact when no push or pop is under way.
+  size_t size() const
+  {
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t = tail.load(std::memory_order_relaxed);
+    return t > h ? t - h : 0;
+  }
+
+  static constexpr size_t get_capacity() { return capacity; }
+};
+
+} // namespace detail
+
+} // namespace srslog
+
+#endif // SRSLOG_DETAIL_SUPPORT_LOCKFREE_RING_H
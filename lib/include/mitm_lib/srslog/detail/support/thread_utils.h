@@ -22,7 +22,17 @@
 #ifndef SRSLOG_DETAIL_SUPPORT_THREAD_UTILS_H
 #define SRSLOG_DETAIL_SUPPORT_THREAD_UTILS_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <pthread.h>
+#include <thread>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace srslog {
 
@@ -173,6 +183,38 @@ public:
   ~cond_var_scoped_lock() { cond_var.unlock(); }
 };
 
+/// Blocks the calling thread while word holds the expected value, up to the specified timeout in us. The call may
+/// also return spuriously.
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, unsigned timeout_us)
+{
+#if defined(__linux__)
+  timespec ts = {static_cast<time_t>(timeout_us / 1000000), static_cast<long>((timeout_us % 1000000) * 1000)};
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, &ts, nullptr, 0);
+#else
+  if (word.load() == expected) {
+    std::this_thread::sleep_for(std::chrono::microseconds(std::min(timeout_us, 100u)));
+  }
+#endif
+}
+
+/// Unblocks the threads blocked in futex_wait on word.
+inline void futex_wake_all(std::atomic<uint32_t>& word)
+{
+#if defined(__linux__)
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+/// Spin loop hint for the CPU.
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
 } // namespace detail
 
 } // namespace srslog
@@ -22,26 +22,53 @@
 #ifndef SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 #define SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 
-#include "mitm_lib/adt/circular_buffer.h"
 #include "mitm_lib/srslog/detail/support/backend_capacity.h"
+#include "mitm_lib/srslog/detail/support/lockfree_ring.h"
 #include "mitm_lib/srslog/detail/support/thread_utils.h"
 
 namespace srslog {
 
 namespace detail {
 
-//: TODO: this is a temp work queue.
-
-/// Thread safe generic data type work queue.
+/// Thread safe generic data type work queue, for many producers and a single consumer.
+///
+/// Pushing never blocks nor takes a lock. The consumer waits for new elements in wait(), spinning for a while and
+/// then sleeping on a futex that producers only signal when the consumer sleeps, so that an idle consumer costs
+/// nothing and a busy one is not woken up by syscalls.
 template <typename T, size_t capacity = SRSLOG_QUEUE_CAPACITY>
 class work_queue
 {
-  srsran::dyn_circular_buffer<T> queue;
-  mutable mutex                  m;
-  static constexpr size_t        threshold = capacity * 0.98;
+  lockfree_ring<T, capacity> queue;
+  static constexpr size_t    threshold = capacity * 0.98;
+
+  /// Spin iterations of the consumer before sleeping, adapted to how often spinning finds new elements. There is no
+  /// spinning on a single CPU, where it would only delay the producers.
+  static constexpr uint32_t min_spins  = 64;
+  const uint32_t            max_spins  = std::thread::hardware_concurrency() > 1 ? 16384 : 0;
+  uint32_t                  spin_limit = std::min(1024u, max_spins);
+  /// Upper bound of a sleep, wakeups are not lost but this bounds the damage if one was.
+  static constexpr unsigned max_sleep_us = 100000;
+
+  /// Set by the consumer while sleeping, so that producers know they have to wake it up.
+  std::atomic<uint32_t> consumer_sleeping{0};
+  /// Futex word, bumped on every wakeup.
+  std::atomic<uint32_t> wakeup_seq{0};
+  /// Set by notify() until the consumer sees it.
+  std::atomic<bool> notified{false};
+
+  void wake_consumer()
+  {
+    // Pairs with the fence of the consumer between announcing its sleep and checking the queue: either the consumer
+    // sees the new element or this sees the consumer asleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumer_sleeping.load(std::memory_order_relaxed) && consumer_sleeping.exchange(0)) {
+      wakeup_seq.fetch_add(1, std::memory_order_release);
+      futex_wake_all(wakeup_seq);
+    }
+  }
 
 public:
-  work_queue() : queue(capacity) {}
+  work_queue() = default;
 
   work_queue(const work_queue&) = delete;
   work_queue& operator=(const work_queue&) = delete;
@@ -50,31 +77,23 @@ public:
   /// queue is full, otherwise true.
   bool push(const T& value)
   {
-    m.lock();
     // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
+    if (!queue.try_push(value)) {
       return false;
     }
-    queue.push(value);
-    m.unlock();
-
+    wake_consumer();
     return true;
   }
 
   /// Inserts a new element into the back of the queue. Returns false when the
-  /// queue is full, otherwise true.
+  /// queue is full, otherwise true. The value is left untouched when the queue is full.
   bool push(T&& value)
   {
-    m.lock();
     // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
+    if (!queue.try_push(std::move(value))) {
       return false;
     }
-    queue.push(std::move(value));
-    m.unlock();
-
+    wake_consumer();
     return true;
   }
 
@@ -82,32 +101,46 @@ public:
   /// Returns a pair with a bool indicating if the pop has been successful.
   std::pair<bool, T> try_pop()
   {
-    m.lock();
+    std::pair<bool, T> item{false, T()};
+    item.first = queue.try_pop(item.second);
+    return item;
+  }
 
-    if (queue.empty()) {
-      m.unlock();
-      return {false, T()};
+  /// Blocks the consumer until the queue may have new elements or notify() is called. The call may also return
+  /// spuriously.
+  void wait()
+  {
+    for (uint32_t i = 0; i != spin_limit; ++i) {
+      if (!queue.empty()) {
+        spin_limit = std::min(spin_limit * 2, max_spins);
+        return;
+      }
+      cpu_relax();
     }
+    spin_limit = std::min(std::max(spin_limit / 2, min_spins), max_spins);
 
-    // Here we have been woken up normally.
-    T Item = std::move(queue.top());
-    queue.pop();
-
-    m.unlock();
+    uint32_t seq = wakeup_seq.load(std::memory_order_acquire);
+    consumer_sleeping.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (queue.empty() && !notified.exchange(false)) {
+      futex_wait(wakeup_seq, seq, max_sleep_us);
+    }
+    consumer_sleeping.store(0, std::memory_order_relaxed);
+  }
 
-    return {true, std::move(Item)};
+  /// Wakes the consumer up from wait(), or makes its next call return right away.
+  void notify()
+  {
+    notified = true;
+    wakeup_seq.fetch_add(1, std::memory_order_release);
+    futex_wake_all(wakeup_seq);
   }
 
   /// Capacity of the queue.
   size_t get_capacity() const { return capacity; }
 
   /// Returns true when the queue is almost full, otherwise returns false.
-  bool is_almost_full() const
-  {
-    scoped_lock lock(m);
-
-    return queue.size() > threshold;
-  }
+  bool is_almost_full() const { return queue.size() > threshold; }
 };
 
 } // namespace detail
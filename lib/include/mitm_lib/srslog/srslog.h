@@ -25,6 +25,7 @@
 #include "mitm_lib/srslog/detail/support/any.h"
 #include "mitm_lib/srslog/logger.h"
 #include "mitm_lib/srslog/shared_types.h"
+#include <cstdio>
 
 namespace srslog {
 
@@ -203,6 +204,20 @@ sink& fetch_syslog_sink(const std::string&             preamble_  = "",
                         syslog_local_type              log_local_ = syslog_local_type::local0,
                         std::unique_ptr<log_formatter> f          = get_default_log_formatter());
 
+/// Returns an instance of a sink that keeps log entries unformatted in a
+/// memory mapped file in the specified path. The file holds the most recent
+/// ring_size bytes of log entries, format strings and log channel names are
+/// stored once in a table of string_size bytes. The file is rendered offline
+/// with the srslog_decode tool or with decode_binary_ring_file().
+sink& fetch_binary_ring_sink(const std::string& path,
+                             size_t             ring_size   = 64 * 1024 * 1024,
+                             size_t             string_size = 1024 * 1024);
+
+/// Renders the log entries of the binary ring file in the specified path, from
+/// the oldest one, with the given formatter and writes them into out. Returns
+/// false and fills in error when the file cannot be decoded.
+bool decode_binary_ring_file(const std::string& path, log_formatter& f, std::FILE* out, std::string& error);
+
 /// Installs a custom user defined sink in the framework getting associated to
 /// the specified id. Returns true on success, otherwise false.
 /// WARNING: This function is an advanced feature and users should really know
@@ -169,12 +169,27 @@ protected:
 
   srsran::as_security_config_t sec_cfg = {};
 
+  // EEA2/EIA2 key schedules of the keys in sec_cfg, rebuilt by config_security()
+  srsran::security_128_eia2_ctx_t rrc_eia2_ctx, up_eia2_ctx;
+  srsran::security_128_eea2_ctx_t rrc_eea2_ctx, up_eea2_ctx;
+
   // Security functions
   void integrity_generate(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
   bool integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
   void cipher_encrypt(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* ct);
   void cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t count, uint8_t* msg);
 
+  // Batched security functions, for a burst of PDUs of this bearer that each carry their COUNT. The algorithm and key
+  // schedule are resolved once per call. For integrity_verify_batch() the out field of every PDU points to the
+  // received MAC and is_valid receives one flag per PDU. Returns true if all the MACs are valid.
+  void integrity_generate_batch(span<const security_pdu_t> pdus);
+  bool integrity_verify_batch(span<const security_pdu_t> pdus, bool* is_valid);
+  void cipher_encrypt_batch(span<const security_pdu_t> pdus);
+  void cipher_decrypt_batch(span<const security_pdu_t> pdus);
+
+  void integrity_batch(span<const security_pdu_t> pdus, uint8_t direction);
+  void cipher_batch(span<const security_pdu_t> pdus, uint8_t direction);
+
   // Common packing functions
   bool            is_control_pdu(const unique_byte_buffer_t& pdu);
   pdcp_pdu_type_t get_control_pdu_type(const unique_byte_buffer_t& pdu);
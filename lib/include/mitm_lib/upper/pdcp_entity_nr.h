@@ -23,6 +23,7 @@
 #define SRSRAN_PDCP_ENTITY_NR_H
 
 #include "pdcp_entity_base.h"
+#include "mitm_lib/adt/circular_map.h"
 #include "mitm_lib/common/buffer_pool.h"
 #include "mitm_lib/common/common.h"
 #include "mitm_lib/common/interfaces_common.h"
@@ -33,8 +34,53 @@
 #include "mitm_lib/interfaces/ue_interfaces.h"
 #include "mitm_lib/interfaces/ue_rlc_interfaces.h"
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace srsran {
+
+/****************************************************************************
+ * NR PDCP reception window
+ * Holds the PDUs waiting for reordering, indexed by COUNT. The buffered COUNTs
+ * always lie in [RX_DELIV, RX_DELIV + Window_Size), so a ring of Window_Size
+ * slots holds them without collisions.
+ ***************************************************************************/
+struct pdcp_nr_rx_window_base {
+  virtual ~pdcp_nr_rx_window_base()                                              = default;
+  virtual bool                 has_count(uint32_t count) const                   = 0;
+  virtual void                 add_pdu(uint32_t count, unique_byte_buffer_t pdu) = 0;
+  virtual unique_byte_buffer_t take_pdu(uint32_t count)                          = 0;
+  virtual size_t               size() const                                      = 0;
+  virtual bool                 empty() const                                     = 0;
+  virtual void                 clear()                                           = 0;
+};
+
+template <std::size_t WINDOW_SIZE>
+struct pdcp_nr_rx_window_t final : public pdcp_nr_rx_window_base {
+  bool has_count(uint32_t count) const override { return window.contains(count); }
+  void add_pdu(uint32_t count, unique_byte_buffer_t pdu) override
+  {
+    srsran_expect(not has_count(count), "The same COUNT=%d should not be added twice", count);
+    window.overwrite(count, std::move(pdu));
+  }
+  // Removes the PDU with the given COUNT from the window, nullptr if it wasn't received
+  unique_byte_buffer_t take_pdu(uint32_t count) override
+  {
+    if (not window.contains(count)) {
+      return nullptr;
+    }
+    unique_byte_buffer_t pdu = std::move(window[count]);
+    window.erase(count);
+    return pdu;
+  }
+  size_t size() const override { return window.size(); }
+  bool   empty() const override { return window.empty(); }
+  void   clear() override { window.clear(); }
+
+private:
+  srsran::static_circular_map<uint32_t, unique_byte_buffer_t, WINDOW_SIZE> window;
+};
+
 /****************************************************************************
  * NR PDCP Entity
  * PDCP entity for 5G NR
@@ -55,6 +101,11 @@ public:
 
   // RRC interface
   void write_sdu(unique_byte_buffer_t sdu, int sn = -1) final;
+  // Same as write_sdu() and write_pdu() for a run of SDUs or PDUs of this bearer, whose ciphering and integrity are
+  // processed max_batch_len at a time by the batched security functions. The buffers are consumed
+  void write_sdus(span<unique_byte_buffer_t> sdus);
+  void write_pdus(span<unique_byte_buffer_t> pdus);
+  static const uint32_t max_batch_len = 64;
 
   // RLC interface
   void write_pdu(unique_byte_buffer_t pdu) final;
@@ -71,7 +122,7 @@ public:
   std::map<uint32_t, srsran::unique_byte_buffer_t> get_buffered_pdus() override { return {}; }
 
   // State variable getters (useful for testing)
-  uint32_t nof_discard_timers() { return discard_timers_map.size(); }
+  uint32_t nof_discard_timers() { return nof_pending_discards; }
   bool     is_reordering_timer_running() { return reordering_timer.is_running(); }
 
   // State variable setters (should be used only for testing)
@@ -99,8 +150,21 @@ private:
   uint32_t window_size = 0;
 
   // Reordering Queue / Timers
-  std::map<uint32_t, unique_byte_buffer_t> reorder_queue;
-  timer_handler::unique_timer              reordering_timer;
+  std::unique_ptr<pdcp_nr_rx_window_base> rx_window;
+  timer_handler::unique_timer             reordering_timer;
+
+  // Steps of write_sdu() and write_pdu() around the security processing, shared with write_sdus() and write_pdus().
+  // tx_prepare() writes the header of TX_NEXT, rx_prepare() reads the SN and estimates the COUNT. Both return false if
+  // the SDU or PDU is dropped
+  bool     tx_prepare(const unique_byte_buffer_t& sdu);
+  void     tx_deliver(unique_byte_buffer_t pdu, uint32_t count);
+  bool     rx_prepare(const unique_byte_buffer_t& pdu, uint32_t& rcvd_sn, uint32_t& rcvd_count);
+  uint32_t rx_count(uint32_t rcvd_sn);
+  void     rx_store(unique_byte_buffer_t pdu, uint32_t rcvd_count);
+  bool     has_mac()
+  {
+    return is_srb() || (is_drb() && (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX));
+  }
 
   // Pass to Upper Layers Helper function
   void deliver_all_consecutive_counts();
@@ -111,8 +175,20 @@ private:
   std::unique_ptr<reordering_callback> reordering_fnc;
 
   // Discard callback (discardTimer)
+  // All SDUs share the same discardTimer, so they expire in COUNT order: a single timer, armed for the oldest pending
+  // SDU, serves all of them. The TX times of the SDUs in [discard_head, TX_NEXT) are kept in a ring indexed by COUNT.
+  struct discard_entry_t {
+    uint32_t tx_time = 0; // timer wheel tick at which the SDU was transmitted
+    bool     pending = false;
+  };
   class discard_callback;
-  std::map<uint32_t, timer_handler::unique_timer> discard_timers_map;
+  std::vector<discard_entry_t> discard_window;
+  timer_handler::unique_timer  discard_timer;
+  uint32_t                     discard_head         = 0; // COUNT of the oldest SDU that may still be pending
+  uint32_t                     discard_time_ref     = 0; // timer wheel tick at which discard_timer was last started
+  uint32_t                     nof_pending_discards = 0;
+  void                         start_discard_timer(uint32_t count);
+  void                         discard_expired(uint32_t now);
 
   // COUNT overflow protection
   bool tx_overflow = false;
@@ -142,16 +218,11 @@ private:
 class pdcp_entity_nr::discard_callback
 {
 public:
-  discard_callback(pdcp_entity_nr* parent_, uint32_t sn_)
-  {
-    parent     = parent_;
-    discard_sn = sn_;
-  };
+  discard_callback(pdcp_entity_nr* parent_) { parent = parent_; };
   void operator()(uint32_t timer_id);
 
 private:
   pdcp_entity_nr* parent;
-  uint32_t        discard_sn;
 };
 
 /*
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "mitm_lib/asn1/asn1_container.h"
+
+namespace asn1 {
+
+bool container_registry::add(type_desc_fn root, const char* path, const container_desc* content, const char* variant)
+{
+  entry e = {nullptr, 0, path, variant, content, false};
+  if (root != nullptr) {
+    field_path p = field_path::compile(root(), path);
+    if (not p.valid() or p.leaf != desc_of<dyn_octstring>() or p.hops.back().type->kind == type_desc::sequence_of) {
+      log_error("Container \"%s\" is not an OCTET STRING field", path);
+      return false;
+    }
+    e.holder = p.hops.back().type;
+    e.idx    = p.hops.back().idx;
+  }
+  // JSON looks the content up by the name of the field alone
+  size_t dot = e.fieldname.rfind('.');
+  if (dot != std::string::npos) {
+    e.fieldname.erase(0, dot + 1);
+  }
+  entries.push_back(std::move(e));
+  return true;
+}
+
+bool container_registry::subscribe(const std::string& names)
+{
+  size_t pos = 0;
+  while (pos <= names.size()) {
+    size_t end = names.find(',', pos);
+    if (end == std::string::npos) {
+      end = names.size();
+    }
+    std::string name  = names.substr(pos, end - pos);
+    bool        found = false;
+    for (entry& e : entries) {
+      if (name == "all" or name == e.content->name) {
+        e.subscribed = true;
+        found        = true;
+      }
+    }
+    if (not found) {
+      log_error("Unknown container type \"%s\"", name.c_str());
+      return false;
+    }
+    pos = end + 1;
+  }
+  return true;
+}
+
+void container_registry::unsubscribe_all()
+{
+  for (entry& e : entries) {
+    e.subscribed = false;
+  }
+}
+
+bool container_registry::any_subscribed() const
+{
+  for (const entry& e : entries) {
+    if (e.subscribed) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const container_desc* container_registry::find(const type_desc* holder, uint32_t idx) const
+{
+  for (const entry& e : entries) {
+    // field paths can't tell the variant of a field, so they don't cross those
+    if (e.holder == holder and e.idx == idx and e.variant == nullptr) {
+      return e.content;
+    }
+  }
+  return nullptr;
+}
+
+bool container_registry::write(json_writer&       j,
+                               const std::string& fieldname,
+                               const char*        variant,
+                               const uint8_t*     ptr,
+                               uint32_t           N) const
+{
+  const entry* found = nullptr;
+  for (const entry& e : entries) {
+    if (e.subscribed and e.fieldname == fieldname and
+        (e.variant == nullptr ? variant == nullptr : variant != nullptr and strcmp(e.variant, variant) == 0)) {
+      found = &e;
+      break;
+    }
+  }
+  if (found == nullptr) {
+    return false;
+  }
+  void* content = found->content->create();
+  bool  ret     = found->content->unpack(content, ptr, N);
+  if (ret) {
+    j.write_fieldname(fieldname);
+    found->content->to_json(content, j);
+  }
+  found->content->destroy(content);
+  return ret;
+}
+
+} // namespace asn1
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "mitm_lib/asn1/asn1_field_path.h"
+#include "mitm_lib/asn1/asn1_container.h"
+
+namespace asn1 {
+
+int type_desc::find_field(const char* name, size_t len) const
+{
+  for (uint32_t i = 0; i < nof_fields; ++i) {
+    if (strncmp(fields[i].name, name, len) == 0 and fields[i].name[len] == '\0') {
+      return i;
+    }
+  }
+  return -1;
+}
+
+field_path field_path::compile(const type_desc* root, const std::string& path, const container_registry* containers)
+{
+  field_path       ret;
+  const type_desc* t   = root;
+  size_t           pos = 0;
+  while (pos <= path.size()) {
+    size_t end = path.find('.', pos);
+    if (end == std::string::npos) {
+      end = path.size();
+    }
+    const char* name = &path[pos];
+    size_t      len  = end - pos;
+    switch (t->kind) {
+      case type_desc::sequence:
+      case type_desc::choice: {
+        int idx = t->find_field(name, len);
+        if (idx < 0) {
+          log_error("Field path \"%s\": no field \"%.*s\"", path.c_str(), (int)len, name);
+          return {};
+        }
+        ret.hops.push_back({t, (uint32_t)idx});
+        t = t->fields[idx].type();
+        break;
+      }
+      case type_desc::sequence_of: {
+        char*    num_end = nullptr;
+        uint32_t idx     = strtoul(name, &num_end, 10);
+        if (len == 0 or num_end != name + len) {
+          log_error("Field path \"%s\": \"%.*s\" is not a list index", path.c_str(), (int)len, name);
+          return {};
+        }
+        ret.hops.push_back({t, idx});
+        t = t->elem_type();
+        break;
+      }
+      case type_desc::leaf: {
+        const container_desc* content = nullptr;
+        if (containers != nullptr and not ret.hops.empty() and ret.hops.back().type->kind != type_desc::sequence_of) {
+          content = containers->find(ret.hops.back().type, ret.hops.back().idx);
+        }
+        if (content == nullptr) {
+          log_error("Field path \"%s\": \"%.*s\" is past a leaf field", path.c_str(), (int)len, name);
+          return {};
+        }
+        field_path inner = compile(content->type(), path.substr(pos), containers);
+        if (not inner.valid()) {
+          return {};
+        }
+        ret.root      = root;
+        ret.leaf      = t;
+        ret.path      = path;
+        ret.container = content;
+        ret.inner     = std::make_shared<const field_path>(std::move(inner));
+        return ret;
+      }
+    }
+    pos = end + 1;
+  }
+  if (t->kind != type_desc::leaf) {
+    log_error("Field path \"%s\" does not end at a leaf field", path.c_str());
+    return {};
+  }
+  ret.root = root;
+  ret.leaf = t;
+  ret.path = path;
+  return ret;
+}
+
+bool field_path::check_root(const type_desc* d) const
+{
+  if (root != d) {
+    log_error("Field path \"%s\" %s", path.c_str(), valid() ? "was compiled for another type" : "is not valid");
+    return false;
+  }
+  return true;
+}
+
+void* field_path::walk(void* obj, bool create) const
+{
+  for (const hop& h : hops) {
+    if (h.type->kind == type_desc::sequence_of) {
+      obj = h.type->elem(obj, h.idx, create);
+    } else {
+      obj = h.type->fields[h.idx].access(obj, create);
+    }
+    if (obj == nullptr) {
+      return nullptr;
+    }
+  }
+  return obj;
+}
+
+bool field_path::get(const void* obj, field_value& v) const
+{
+  // walking without create never modifies the message
+  const void* p = walk(const_cast<void*>(obj), false);
+  if (p == nullptr) {
+    return false;
+  }
+  if (container == nullptr) {
+    return leaf->get(p, v);
+  }
+  const dyn_octstring& octs    = *static_cast<const dyn_octstring*>(p);
+  void*                content = container->create();
+  bool                 ret     = container->unpack(content, octs.data(), octs.size()) and
+                                 inner->get(static_cast<const void*>(content), v);
+  container->destroy(content);
+  return ret;
+}
+
+bool field_path::set(void* obj, const field_value& v) const
+{
+  void* p = walk(obj, true);
+  if (p == nullptr) {
+    return false;
+  }
+  if (container == nullptr) {
+    return leaf->set(p, v);
+  }
+  // an empty container is filled from a default constructed value
+  dyn_octstring& octs    = *static_cast<dyn_octstring*>(p);
+  void*          content = container->create();
+  bool           ret     = (octs.size() == 0 or container->unpack(content, octs.data(), octs.size())) and
+               inner->set(content, v) and container->pack(content, octs);
+  container->destroy(content);
+  return ret;
+}
+
+} // namespace asn1
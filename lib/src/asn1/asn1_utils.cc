@@ -20,6 +20,11 @@
  */
 
 #include "mitm_lib/asn1/asn1_utils.h"
+#include "mitm_lib/asn1/asn1_container.h"
+
+#ifdef LV_HAVE_SSE
+#include <immintrin.h>
+#endif // LV_HAVE_SSE
 
 namespace asn1 {
 
@@ -983,9 +988,155 @@ void number_to_octstring(uint8_t* ptr, uint64_t number, uint32_t nbytes)
   }
 }
 
-void to_hex(char* cstr, uint8_t val)
+namespace {
+
+const char hex_digits[] = "0123456789abcdef";
+
+/// Maps an ASCII character to its hex nibble value, or -1 if it is not a hex digit.
+struct hex_decode_table {
+  int8_t val[256];
+  hex_decode_table()
+  {
+    for (int c = 0; c < 256; ++c) {
+      val[c] = -1;
+    }
+    for (int c = 0; c < 10; ++c) {
+      val['0' + c] = c;
+    }
+    for (int c = 0; c < 6; ++c) {
+      val['a' + c] = 10 + c;
+      val['A' + c] = 10 + c;
+    }
+  }
+};
+const hex_decode_table hex_lut;
+
+// Legacy parser for a pair that is not made of two hex digits, so malformed input decodes as before.
+uint8_t parse_invalid_hex_pair(const char* str)
 {
-  sprintf(cstr, "%02x", val);
+  char cstr[] = "\0\0\0";
+  memcpy(&cstr[0], str, 2);
+  return strtoul(cstr, nullptr, 16);
+}
+
+#ifdef LV_HAVE_SSE
+inline void hex_encode_sse(char* dst, __m128i in)
+{
+  const __m128i lut  = _mm_loadu_si128((const __m128i*)hex_digits);
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  __m128i       hi   = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+  __m128i       lo   = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+  _mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(hi, lo));
+  _mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi8(hi, lo));
+}
+
+// Converts 16 hex characters into their nibble values. Returns false if any of them is not a hex digit.
+inline bool hex_nibbles_sse(__m128i c, __m128i& nibbles)
+{
+  __m128i lower    = _mm_or_si128(c, _mm_set1_epi8(0x20));
+  __m128i is_digit =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+  __m128i is_alpha =
+      _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+  if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xffff) {
+    return false;
+  }
+  __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  __m128i alpha = _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10));
+  nibbles       = _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_andnot_si128(is_digit, alpha));
+  return true;
+}
+#endif // LV_HAVE_SSE
+
+#ifdef LV_HAVE_AVX2
+inline bool hex_nibbles_avx2(__m256i c, __m256i& nibbles)
+{
+  __m256i lower    = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+  __m256i is_digit = _mm256_andnot_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('9')),
+                                         _mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)));
+  __m256i is_alpha = _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')),
+                                         _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+  if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha)) != -1) {
+    return false;
+  }
+  __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+  __m256i alpha = _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10));
+  nibbles       = _mm256_blendv_epi8(alpha, digit, is_digit);
+  return true;
+}
+#endif // LV_HAVE_AVX2
+
+} // namespace
+
+void octstring_to_hex(char* dst, const uint8_t* ptr, uint32_t N)
+{
+  uint32_t i = 0;
+#ifdef LV_HAVE_AVX2
+  const __m256i lut  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)hex_digits));
+  const __m256i mask = _mm256_set1_epi8(0x0f);
+  for (; i + 32 <= N; i += 32) {
+    __m256i in = _mm256_loadu_si256((const __m256i*)(ptr + i));
+    __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+    __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask));
+    // unpack works per 128-bit lane, so swap the middle halves back into byte order
+    __m256i a = _mm256_unpacklo_epi8(hi, lo);
+    __m256i b = _mm256_unpackhi_epi8(hi, lo);
+    _mm256_storeu_si256((__m256i*)(dst + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256((__m256i*)(dst + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+  }
+#endif // LV_HAVE_AVX2
+#ifdef LV_HAVE_SSE
+  for (; i + 16 <= N; i += 16) {
+    hex_encode_sse(dst + 2 * i, _mm_loadu_si128((const __m128i*)(ptr + i)));
+  }
+#endif // LV_HAVE_SSE
+  for (; i < N; i++) {
+    dst[2 * i]     = hex_digits[ptr[i] >> 4u];
+    dst[2 * i + 1] = hex_digits[ptr[i] & 0x0fu];
+  }
+}
+
+bool hex_to_octstring(uint8_t* ptr, const char* str, uint32_t nof_chars)
+{
+  uint32_t N     = nof_chars / 2;
+  uint32_t i     = 0;
+  bool     valid = true;
+#ifdef LV_HAVE_AVX2
+  const __m256i weights = _mm256_set1_epi16(0x0110);
+  for (; i + 32 <= N; i += 32) {
+    __m256i n0, n1;
+    if (not hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*)(str + 2 * i)), n0) or
+        not hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*)(str + 2 * i + 32)), n1)) {
+      break;
+    }
+    // (hi * 16 + lo) per character pair, then narrow the 16-bit results and undo the per-lane pack order
+    __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(n0, weights), _mm256_maddubs_epi16(n1, weights));
+    _mm256_storeu_si256((__m256i*)(ptr + i), _mm256_permute4x64_epi64(packed, 0xd8));
+  }
+#endif // LV_HAVE_AVX2
+#ifdef LV_HAVE_SSE
+  const __m128i weights128 = _mm_set1_epi16(0x0110);
+  for (; i + 16 <= N; i += 16) {
+    __m128i n0, n1;
+    if (not hex_nibbles_sse(_mm_loadu_si128((const __m128i*)(str + 2 * i)), n0) or
+        not hex_nibbles_sse(_mm_loadu_si128((const __m128i*)(str + 2 * i + 16)), n1)) {
+      break;
+    }
+    __m128i packed = _mm_packus_epi16(_mm_maddubs_epi16(n0, weights128), _mm_maddubs_epi16(n1, weights128));
+    _mm_storeu_si128((__m128i*)(ptr + i), packed);
+  }
+#endif // LV_HAVE_SSE
+  for (; i < N; i++) {
+    int8_t hi = hex_lut.val[(uint8_t)str[2 * i]];
+    int8_t lo = hex_lut.val[(uint8_t)str[2 * i + 1]];
+    if ((hi | lo) < 0) {
+      valid  = false;
+      ptr[i] = parse_invalid_hex_pair(&str[2 * i]);
+    } else {
+      ptr[i] = (uint8_t)((hi << 4u) | lo);
+    }
+  }
+  return valid;
 }
 
 // helper functions
@@ -993,11 +1144,7 @@ std::string octstring_to_string(const uint8_t* ptr, uint32_t N)
 {
   std::string s;
   s.resize(N * 2);
-  char cstr[3];
-  for (uint32_t i = 0; i < N; i++) {
-    to_hex(cstr, ptr[i]);
-    s.replace(i * 2, 2, cstr);
-  }
+  octstring_to_hex(&s[0], ptr, N);
   return s;
 }
 
@@ -1006,10 +1153,8 @@ void string_to_octstring(uint8_t* ptr, const std::string& str)
   if (str.size() % 2 != 0) {
     log_warning("The provided hex string size=%zd is not a multiple of 2.", str.size());
   }
-  char cstr[] = "\0\0\0";
-  for (uint32_t i = 0; i < str.size(); i += 2) {
-    memcpy(&cstr[0], &str[i], 2);
-    ptr[i / 2] = strtoul(cstr, nullptr, 16);
+  if (not hex_to_octstring(ptr, str.data(), str.size())) {
+    log_warning("The provided hex string contains non-hex characters.");
   }
 }
 
@@ -1421,41 +1566,55 @@ SRSASN_CODE ext_groups_unpacker_guard::unpack(cbit_ref& bref)
      Open Field
 *********************/
 
-varlength_field_pack_guard::varlength_field_pack_guard(bit_ref& bref, bool align_) :
-  buffer_ptr(srsran::make_buffer_pool_obj<byte_array_t>())
+varlength_field_pack_guard::varlength_field_pack_guard(bit_ref& bref, bool align_)
 {
-  if (buffer_ptr == nullptr) {
-    // failed to allocate from global byte buffer pool. Fallback to malloc
-    buffer_ptr = std::unique_ptr<byte_array_t>(new byte_array_t());
+  align = align_;
+  if (align) {
+    bref.align_bytes_zero();
   }
-  brefstart    = bref;
-  bref         = bit_ref(buffer_ptr->data(), buffer_ptr->size());
+  brefstart = bref;
+  // reserve the short form of the length determinant (< 128 octets)
+  bref.pack(0, 8);
   bref_tracker = &bref;
-  align        = align_;
 }
 
 varlength_field_pack_guard::~varlength_field_pack_guard()
 {
+  bit_ref field_start = brefstart;
+  field_start.advance_bits(8);
+
   // fill the spare bits
-  uint32_t leftover = 7 - ((bref_tracker->distance() - (uint32_t)1) % (uint32_t)8);
+  uint32_t leftover = 7 - ((bref_tracker->distance(field_start) - (uint32_t)1) % (uint32_t)8);
   bref_tracker->pack(0, leftover);
 
   // check how many bytes were written in total
-  uint32_t nof_bytes = bref_tracker->distance() / (uint32_t)8;
-  if (nof_bytes > buffer_ptr->size()) {
-    log_error("The packed variable sized field is too long for the reserved buffer (%zd > %zd)",
-              (size_t)nof_bytes,
-              buffer_ptr->size());
+  uint32_t nof_bytes = bref_tracker->distance(field_start) / (uint32_t)8;
+
+  // the long forms of the length determinant take 2 or 3 octets. Make room for them by shifting the field
+  uint32_t extra_len_bytes = (nof_bytes < 128) ? 0 : ((nof_bytes < ASN_16K) ? 1 : 2);
+  if (extra_len_bytes > 0) {
+    if (bref_tracker->distance_bytes_end() < (int)extra_len_bytes) {
+      log_error("The packed variable sized field is too long for the reserved buffer (%zd > %zd)",
+                (size_t)nof_bytes + extra_len_bytes,
+                (size_t)field_start.distance_bytes_end());
+      return;
+    }
+    uint32_t nof_touched_bytes = nof_bytes + ((field_start.offset != 0) ? 1 : 0);
+    memmove(field_start.ptr + extra_len_bytes, field_start.ptr, nof_touched_bytes);
   }
 
-  // go back in time to pack length
-  pack_length(brefstart, nof_bytes, align);
-
-  // pack encoded bytes
-  for (uint32_t i = 0; i < nof_bytes; ++i) {
-    brefstart.pack((*buffer_ptr)[i], 8);
+  // go back in time to pack length. The last octet of the length may be shared with the first bits of the field
+  uint8_t* shared_octet = field_start.ptr + extra_len_bytes;
+  uint8_t  field_bits   = (field_start.offset != 0) ? *shared_octet : 0;
+  bit_ref  bref_len     = brefstart;
+  pack_length(bref_len, nof_bytes, align);
+  if (field_start.offset != 0) {
+    uint8_t field_mask = (uint8_t)((1u << (8u - field_start.offset)) - 1u);
+    *shared_octet      = (*shared_octet & ~field_mask) | (field_bits & field_mask);
   }
-  *bref_tracker = brefstart;
+
+  bref_len.advance_bits(nof_bytes * 8);
+  *bref_tracker = bref_len;
 }
 
 varlength_field_unpack_guard::varlength_field_unpack_guard(cbit_ref& bref, bool align)
@@ -1533,6 +1692,25 @@ void json_writer::write_null()
   write_null("");
 }
 
+void json_writer::write_octstring(const std::string& fieldname, const uint8_t* ptr, uint32_t N, const char* variant)
+{
+  if (containers != nullptr and not fieldname.empty() and containers->write(*this, fieldname, variant, ptr, N)) {
+    return;
+  }
+  write_fieldname(fieldname);
+  // encode straight into the output buffer instead of going through a temporary std::string
+  size_t pos = buffer.size();
+  buffer.resize(pos + 2 * N + 2);
+  buffer[pos] = '"';
+  octstring_to_hex(&buffer[pos + 1], ptr, N);
+  buffer[pos + 2 * N + 1] = '"';
+  sep                     = COMMA;
+}
+void json_writer::write_octstring(const uint8_t* ptr, uint32_t N)
+{
+  write_octstring("", ptr, N);
+}
+
 void json_writer::start_obj(const std::string& fieldname)
 {
   write_fieldname(fieldname);
@@ -1566,6 +1744,27 @@ std::string json_writer::to_string() const
   return std::string(buffer.data(), buffer.size());
 }
 
+void json_writer::copy_since(const mark_t& m, json_fragment& frag) const
+{
+  frag.text.assign(buffer.data() + m.pos, buffer.size() - m.pos);
+  frag.ident_begin = m.ident;
+  frag.sep_begin   = m.sep;
+  frag.ident_end   = ident.size();
+  frag.sep_end     = sep;
+}
+
+bool json_writer::write_fragment(const json_fragment& frag)
+{
+  // the separators and indentation baked into the fragment are only valid at the position it was captured from
+  if (ident.size() != frag.ident_begin or sep != frag.sep_begin) {
+    return false;
+  }
+  buffer.append(frag.text.data(), frag.text.data() + frag.text.size());
+  ident.assign(frag.ident_end, ' ');
+  sep = (separator_t)frag.sep_end;
+  return true;
+}
+
 /************************
    General Layer Types
 ************************/
@@ -0,0 +1,586 @@
+#!/usr/bin/env python3
+#
+# Copyright 2013-2022 Software Radio Systems Limited
+#
+# This file is part of srsRAN
+#
+# srsRAN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as
+# published by the Free Software Foundation, either version 3 of
+# the License, or (at your option) any later version.
+#
+# srsRAN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Affero General Public License for more details.
+#
+# A copy of the GNU Affero General Public License can be found in
+# the LICENSE file in the top-level directory of this distribution
+# and at http://www.gnu.org/licenses/.
+#
+
+# Generates the type descriptors of <module>_field_path.{h,cc} from the to_json() methods of a generated ASN.1 module,
+# so that field paths use the same names as the JSON the controller prints and parses.
+#
+#   gen_field_path.py [--check] <module>.cc <namespace> <header> <source> <include guard>
+#
+# With --check, nothing is written: the exit status tells whether the header and the source are up to date.
+# The rrc_nr_field_path target of lib/src/asn1 regenerates rrc_nr, the rrc_nr_field_path_check test checks it.
+import re
+import sys
+
+check = sys.argv[1:2] == ['--check']
+src_cc, ns, out_h, out_cc, guard = sys.argv[1 + check:6 + check]
+
+LICENSE = """/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+"""
+
+text = open(src_cc).read()
+funcs = [(re.sub(r'\s', '', n), b) for n, b in
+         re.findall(r'\nvoid ([\w:\s]+?)::to_json\(\s*json_writer& j\) const\n\{\n(.*?)\n\}\n', text, re.S)]
+
+
+def statements(body):
+    out = []
+    cur = ''
+    for line in body.split('\n'):
+        l = line.strip()
+        if not l:
+            continue
+        cur = (cur + ' ' + l).strip() if cur else l
+        if cur.endswith(';') or cur.endswith('{') or cur.endswith('}') or re.match(r'^(case .*|default):$', cur):
+            out.append(cur)
+            cur = ''
+    assert not cur, cur
+    return out
+
+
+def split_args(e):
+    args = ['']
+    depth = 0
+    for ch in e:
+        if ch in '<([':
+            depth += 1
+        elif ch in '>)]':
+            depth -= 1
+        if depth == 0 and ch == ',':
+            args.append('')
+        else:
+            args[-1] += ch
+    return [a.strip() for a in args]
+
+
+def split_expr(e):
+    """Splits a member access expression into components. '->' becomes a '*' component."""
+    comps = []
+    depth = 0
+    cur = ''
+    i = 0
+    while i < len(e):
+        ch = e[i]
+        if ch in '<(':
+            depth += 1
+        elif ch in '>)':
+            if not (ch == '>' and i > 0 and e[i - 1] == '-'):
+                depth -= 1
+        if depth == 0 and ch == '.':
+            comps.append(cur)
+            cur = ''
+        elif depth == 0 and e.startswith('->', i):
+            comps.append(cur)
+            comps.append('*')
+            cur = ''
+            i += 1
+        else:
+            cur += ch
+        i += 1
+    comps.append(cur)
+    return comps
+
+
+def norm(e, alt):
+    e = e.strip()
+    if e.startswith('*'):
+        comps = split_expr(e[1:])
+        comps.append('*')
+    else:
+        comps = split_expr(e)
+    if alt is not None and comps[0] == 'c':
+        if len(comps) > 1 and comps[1].startswith('get<'):
+            comps = [alt + '()'] + comps[2:]
+        else:
+            comps = [alt + '()'] + comps[1:]
+    return comps
+
+
+# items:
+#  ('leaf', name, expr, gates)        typed through desc_of<reflected_t<decltype(expr)>>
+#  ('flag', name, expr, gates)        presence flag, bool
+#  ('null', name, alt)                NULL choice alternative
+#  ('obj', name, children, gates)     inline SEQUENCE
+#  ('array', name, expr, elem, gates) elem: None for generic, or ('obj', children, var)
+class Parser:
+    def __init__(self, stmts, fname):
+        self.s = stmts
+        self.i = 0
+        self.fname = fname
+
+    def peek(self):
+        return self.s[self.i]
+
+    def next(self):
+        st = self.s[self.i]
+        self.i += 1
+        return st
+
+    def fail(self, msg):
+        raise Exception('%s: %s at %r' % (self.fname, msg, self.s[self.i - 1:self.i + 2]))
+
+    def parse_obj_body(self, alt, gates, end='j.end_obj();'):
+        items = []
+        while True:
+            st = self.next()
+            if st == end:
+                return items
+            items += self.parse_stmt(st, alt, gates)
+
+    def parse_loop(self, alt, gates):
+        st = self.next()
+        m = re.match(r'^for \(const auto& (e\d) : (.*)\) \{$', st)
+        if not m:
+            self.fail('expected loop')
+        var, expr = m.group(1), m.group(2)
+        body = []
+        depth = 0
+        while True:
+            st = self.next()
+            if st == '}':
+                if depth == 0:
+                    break
+                depth -= 1
+            elif st.endswith('{'):
+                depth += 1
+            body.append(st)
+        if self.next() != 'j.end_array();':
+            self.fail('expected end_array')
+        return var, norm(expr, alt), body
+
+    def elem_kind(self, var, body):
+        """Returns None if the element is reflected through its own type, else an inline element node."""
+        if len(body) == 1 and re.match(r'^(%s(\.|->)to_json\(j\);|j\.write_\w+\(%s(\.to_string\(\))?\);)$' % (var, var),
+                                       body[0]):
+            return None
+        if body[0] == 'j.start_array();':
+            sub = Parser(body[1:], self.fname)
+            v2, e2, b2 = sub.parse_loop(None, [])
+            if e2 != [var] or sub.i != len(sub.s):
+                self.fail('unexpected nested array')
+            if self.elem_kind(v2, b2) is not None:
+                self.fail('nested array of inline objects')
+            return None
+        if body[0] == 'j.start_obj();' and body[-1] == 'j.end_obj();':
+            sub = Parser(body[1:], self.fname)
+            children = sub.parse_obj_body(None, [])
+            if sub.i != len(sub.s):
+                self.fail('trailing statements in element')
+            return ('obj', children, var)
+        self.fail('unknown element body')
+
+    def parse_stmt(self, st, alt, gates):
+        m = re.match(r'^j\.write_fieldname\("([^"]*)"\);$', st)
+        if m:
+            name = m.group(1)
+            nx = self.next()
+            m2 = re.match(r'^(.*?)(\.|->)to_json\(j\);$', nx)
+            if m2:
+                e = norm(m2.group(1), alt)
+                if m2.group(2) == '->':
+                    e.append('*')
+                return [('leaf', name, e, gates)]
+            m2 = re.match(r'^to_json\(j, (.*)\);$', nx)
+            if m2:
+                return [('leaf', name, norm(m2.group(1), alt), gates)]
+            if nx == 'j.start_obj();':
+                children = self.parse_obj_body(alt, [])
+                if not children:
+                    return self.empty_obj(name, alt, gates)
+                return [('obj', name, children, gates)]
+            if nx == 'j.start_array();':
+                var, e, body = self.parse_loop(alt, gates)
+                return [('array', name, e, self.elem_kind(var, body), gates)]
+            self.fail('unknown field value')
+        m = re.match(r'^j\.write_(int|bool|octstring)\("([^"]*)", (.*)\);$', st)
+        if m:
+            # Trailing arguments, like the variant of a container, are not part of the field
+            return [('leaf', m.group(2), norm(split_args(m.group(3))[0], alt), gates)]
+        m = re.match(r'^j\.write_str\("([^"]*)", "([^"]*)"\);$', st)
+        if m:
+            return self.empty_obj(m.group(1), alt, gates)
+        m = re.match(r'^j\.write_str\("([^"]*)", (.*)\.to_string\(\)\);$', st)
+        if m:
+            return [('leaf', m.group(1), norm(m.group(2), alt), gates)]
+        m = re.match(r'^j\.start_obj\("([^"]*)"\);$', st)
+        if m:
+            return [('obj', m.group(1), self.parse_obj_body(alt, []), gates)]
+        m = re.match(r'^j\.start_array\("([^"]*)"\);$', st)
+        if m:
+            var, e, body = self.parse_loop(alt, gates)
+            return [('array', m.group(1), e, self.elem_kind(var, body), gates)]
+        m = re.match(r'^if \((.*)\) \{$', st)
+        if m:
+            cond = m.group(1)
+            g = self.gate(cond, alt)
+            items = []
+            while True:
+                st2 = self.next()
+                if st2 == '}':
+                    break
+                items += self.parse_stmt(st2, alt, gates + ([g] if g else []))
+            return items
+        self.fail('unknown statement')
+
+    def gate(self, cond, alt):
+        m = re.match(r'^(.*)\.size\(\) > 0$', cond)
+        if m:
+            return None
+        m = re.match(r'^(.*)\.is_present\(\)$', cond)
+        if m:
+            return ('ptr', norm(m.group(1), alt))
+        e = norm(cond, alt)
+        if e[-1] == 'ext':
+            return ('ext', e)
+        if e[-1].endswith('_present'):
+            return ('opt', e)
+        self.fail('unknown condition ' + cond)
+
+    def empty_obj(self, name, alt, gates):
+        if gates and gates[-1][0] == 'opt':
+            return [('flag', name, gates[-1][1], gates[:-1])]
+        if not gates:
+            return []
+        self.fail('empty object under non-flag gate')
+
+    def parse_choice(self):
+        items = []
+        st = self.next()
+        assert st == 'switch (type_) {', st
+        while True:
+            st = self.next()
+            if st == '}':
+                break
+            m = re.match(r'^case types::(\w+):$', st)
+            if m:
+                alt = m.group(1)
+                body = []
+                while True:
+                    st2 = self.next()
+                    if st2 == 'break;':
+                        break
+                    body.append(st2)
+                if not body:
+                    items.append(('null', None, alt))
+                    continue
+                sub = Parser(body, self.fname)
+                got = []
+                while sub.i < len(sub.s):
+                    got += sub.parse_stmt(sub.next(), alt, [])
+                if not got:
+                    items.append(('null', None, alt))
+                for it in got:
+                    items.append(it)
+                continue
+            if st == 'default:':
+                st2 = self.next()
+                assert st2.startswith('log_invalid_choice_id'), st2
+                continue
+            self.fail('unknown choice statement')
+        return items
+
+
+def parse_function(name, body):
+    st = statements(body)
+    # unwrap top-level message wrappers: j.start_array(); j.start_obj(); ... j.end_obj(); j.end_array();
+    if st[:2] == ['j.start_array();', 'j.start_obj();'] and st[-2:] == ['j.end_obj();', 'j.end_array();']:
+        st = st[2:-2]
+        st = ['j.start_obj();'] + st + ['j.end_obj();']
+    if st[0] != 'j.start_obj();' or st[-1] != 'j.end_obj();':
+        raise Exception('%s: unexpected body %r' % (name, st[:3]))
+    p = Parser(st[1:-1], name)
+    if st[1] == 'switch (type_) {':
+        items = p.parse_choice()
+        kind = 'choice'
+    else:
+        # CHOICE with a single alternative, stored without a choice buffer
+        alt = None
+        if re.search(r'\bc\.', body):
+            alt = re.search(r'j\.write_\w+\("([\w]+)"', body).group(1)
+        items = []
+        while p.i < len(p.s):
+            items += p.parse_stmt(p.next(), alt, [])
+        kind = 'sequence'
+    return kind, items
+
+
+types = []
+for name, body in funcs:
+    kind, items = parse_function(name, body)
+    types.append((name, kind, items))
+
+
+# ---------------------------------------------------------------------------------------------------------------------
+# code generation
+
+def render(comps, base):
+    s = base
+    for c in comps:
+        if c == '*':
+            s = '(*%s)' % s
+        else:
+            s = s + '.' + c
+    return s
+
+
+def strip_star(comps):
+    return comps[:-1] if comps and comps[-1] == '*' else comps
+
+
+def child_exprs(items):
+    out = []
+    for it in items:
+        if it[0] in ('leaf', 'flag'):
+            out.append(strip_star(it[2]))
+        elif it[0] == 'obj':
+            out.append(strip_star(it[4]))
+        elif it[0] == 'array':
+            out.append(strip_star(it[2]))
+    return out
+
+
+def common_prefix(lists):
+    p = lists[0]
+    for l in lists[1:]:
+        n = 0
+        while n < len(p) and n < len(l) and p[n] == l[n]:
+            n += 1
+        p = p[:n]
+    return p
+
+
+def resolve_objects(items, base):
+    """Annotates every inline object with the expression (relative to the enclosing named type or loop variable) of
+    the C++ object it is written from. Wrapper objects that have no C++ counterpart get the parent's expression."""
+    out = []
+    for it in items:
+        if it[0] == 'obj':
+            children = resolve_objects(it[2], base)
+            exprs = child_exprs(children)
+            if not exprs:
+                raise Exception('empty inline object')
+            p = common_prefix(exprs)
+            if p in exprs:
+                p = p[:-1]
+            if len(p) < len(base):
+                p = base
+            out.append(('obj', it[1], children, it[3], p))
+        elif it[0] == 'array' and it[3] is not None:
+            _, children, var = it[3]
+            children = resolve_objects(children, [var])
+            out.append(('array', it[1], it[2], ('obj', children, var), it[4]))
+        else:
+            out.append(it)
+    return out
+
+
+def sanitize(s):
+    return re.sub(r'[^A-Za-z0-9_]', '_', s)
+
+
+class Gen:
+    def __init__(self):
+        self.nodes = []  # (fn name, alias, code)
+        self.count = 0
+
+    def rel(self, comps, base):
+        if comps[:len(base)] != base:
+            raise Exception('expression %r not under %r' % (comps, base))
+        return comps[len(base):]
+
+    def access(self, alias, kind, field_expr, gates, base, alt):
+        conds = []
+        for g in gates:
+            e = self.rel(g[1], base)
+            if g[0] == 'opt':
+                conds.append('select_opt(%s, create)' % render(e, 's'))
+            elif g[0] == 'ext':
+                conds.append('select_opt(%s, create)' % render(e, 's'))
+            elif g[0] == 'ptr':
+                conds.append('select_ptr(%s, create)' % render(e, 's'))
+        if alt is not None:
+            conds.insert(0, 'select_alt(s, %s::types::%s, create)' % (alias, alt))
+        e = self.rel(field_expr, base)
+        if e and e[-1] == '*':
+            addr = render(e[:-1], 's') + '.get()'
+        elif e:
+            addr = '&' + render(e, 's')
+        else:
+            addr = '&s'
+        if not conds:
+            if addr == '&s':
+                return '[](void* o, bool) -> void* { return o; }'
+            return '[](void* o, bool) -> void* { return %s; }' % addr.replace('&s.', '&static_cast<%s*>(o)->' % alias, 1) \
+                if addr.startswith('&s.') and '(*' not in addr else \
+                '[](void* o, bool) -> void* {\n        auto& s = *static_cast<%s*>(o);\n        return %s;\n      }' % (alias, addr)
+        return ('[](void* o, bool create) -> void* {\n        auto& s = *static_cast<%s*>(o);\n'
+                '        return %s ? %s : nullptr;\n      }') % (alias, ' and '.join(conds), addr)
+
+    def type_of(self, alias, comps, base):
+        e = strip_star(self.rel(comps, base))
+        if not e:
+            return alias
+        return 'reflected_t<decltype(%s)>' % render(e, 'std::declval<%s&>()' % alias)
+
+    def alt_of(self, kind, comps, base):
+        if kind != 'choice':
+            return None
+        e = self.rel(comps, base)
+        m = re.match(r'^(\w+)\(\)$', e[0]) if e else None
+        return m.group(1) if m else None
+
+    def node(self, hint, alias, kind, items, base, full):
+        """Emits the descriptor of a SEQUENCE or CHOICE node and returns the expression giving it."""
+        fields = []
+        for it in items:
+            if it[0] == 'null':
+                alt = it[2]
+                fields.append('{%s::types(%s::types::%s).to_string(),\n      &null_reflector::desc,\n      %s}' %
+                              (alias, alias, alt,
+                               '[](void* o, bool create) -> void* {\n        auto& s = *static_cast<%s*>(o);\n'
+                               '        return select_alt(s, %s::types::%s, create) ? o : nullptr;\n      }' %
+                               (alias, alias, alt)))
+                continue
+            name = it[1]
+            if it[0] == 'leaf':
+                t = self.type_of(alias, it[2], base)
+                fields.append('{"%s",\n      &desc_of<%s>,\n      %s}' %
+                              (name, t, self.access(alias, kind, it[2], it[3], base, self.alt_of(kind, it[2], base))))
+            elif it[0] == 'flag':
+                fields.append('{"%s",\n      &desc_of<bool>,\n      %s}' %
+                              (name, self.access(alias, kind, it[2], it[3], base, None)))
+            elif it[0] == 'obj':
+                obj = it[4]
+                sub_alias = self.type_of(full, obj, base)
+                fn = self.emit_inline(hint + '_' + sanitize(name), sub_alias, it[2], obj)
+                fields.append('{"%s",\n      &%s,\n      %s}' %
+                              (name, fn, self.access(alias, kind, obj, it[3], base, self.alt_of(kind, obj, base))))
+            elif it[0] == 'array':
+                t = self.type_of(alias, it[2], base)
+                if it[3] is None:
+                    desc = '&desc_of<%s>' % t
+                else:
+                    _, children, var = it[3]
+                    elem_alias = 'reflected_t<decltype(*std::declval<%s&>().begin())>' % self.type_of(full, it[2], base)
+                    fn = self.emit_inline(hint + '_' + sanitize(name) + '_item', elem_alias, children, [var])
+                    desc = '&seq_of_reflector<%s, &%s>::desc' % (t, fn)
+                fields.append('{"%s",\n      %s,\n      %s}' %
+                              (name, desc, self.access(alias, kind, it[2], it[4], base, self.alt_of(kind, it[2], base))))
+        return fields
+
+    def emit_inline(self, hint, alias, items, base):
+        self.count += 1
+        fn = 'desc_%s' % hint
+        # inline objects keep their own expression as base, so that children are relative to it
+        alias_name = 'obj_t'
+        fields = self.node(hint, alias_name, 'sequence', [self.rebase(it, base) for it in items], [], alias)
+        code = 'const type_desc* %s()\n{\n  using %s = %s;\n' % (fn, alias_name, alias)
+        code += self.desc_body('sequence', fields)
+        code += '}\n'
+        self.nodes.append(code)
+        return fn
+
+    def rebase(self, it, base):
+        n = len(base)
+
+        def rb(c):
+            if c[:n] != base:
+                raise Exception('expression %r not under %r' % (c, base))
+            return c[n:]
+
+        def rbg(gs):
+            return [(g[0], rb(g[1])) for g in gs]
+
+        if it[0] in ('leaf', 'flag'):
+            return (it[0], it[1], rb(it[2]), rbg(it[3]))
+        if it[0] == 'obj':
+            return ('obj', it[1], [self.rebase(c, base) for c in it[2]], rbg(it[3]), rb(it[4]))
+        if it[0] == 'array':
+            return ('array', it[1], rb(it[2]), it[3], rbg(it[4]))
+        return it
+
+    def desc_body(self, kind, fields):
+        code = ''
+        if fields:
+            code += '  static const field_desc fields[] = {\n'
+            code += ',\n'.join('    ' + f.replace('\n      ', '\n     ') for f in fields) + '};\n'
+            code += ('  static const type_desc d = {\n      type_desc::%s, fields, sizeof(fields) / sizeof(fields[0]), '
+                     'nullptr, nullptr, nullptr, nullptr};\n') % kind
+        else:
+            code += '  static const type_desc d = {type_desc::%s, nullptr, 0, nullptr, nullptr, nullptr, nullptr};\n' % kind
+        code += '  return &d;\n'
+        return code
+
+
+gen = Gen()
+named = []
+for name, kind, items in types:
+    items = resolve_objects(items, [])
+    hint = sanitize(name.replace('::', '_'))
+    fields = gen.node(hint, 'obj_t', kind, items, [], name)
+    code = 'const type_desc* type_reflector<%s>::desc()\n{\n  using obj_t = %s;\n' % (name, name)
+    code += gen.desc_body(kind, fields)
+    code += '}\n'
+    named.append(code)
+
+cc = LICENSE
+cc += '\n#include "mitm_lib/asn1/%s_field_path.h"\n\n' % ns
+cc += 'namespace asn1 {\n\nusing namespace %s;\n\nnamespace {\n\n' % ns
+cc += '\n'.join(gen.nodes)
+cc += '\n} // namespace\n\n'
+cc += '\n'.join(named)
+cc += '\n} // namespace asn1\n'
+
+h = LICENSE
+h += '\n#ifndef %s\n#define %s\n\n' % (guard, guard)
+h += '#include "asn1_field_path.h"\n#include "%s.h"\n\nnamespace asn1 {\n\n' % ns
+for name, kind, items in types:
+    h += 'template <>\nstruct type_reflector<%s::%s> {\n  static const type_desc* desc();\n};\n' % (ns, name)
+h += '\n} // namespace asn1\n\n#endif // %s\n' % guard
+
+if check:
+    stale = [path for path, content in ((out_h, h), (out_cc, cc)) if open(path).read() != content]
+    for path in stale:
+        print('%s is out of date, regenerate it with gen_field_path.py' % path)
+    sys.exit(1 if stale else 0)
+
+for path, content in ((out_h, h), (out_cc, cc)):
+    with open(path, 'w') as f:
+        f.write(content)
+print('%d types, %d inline objects' % (len(types), gen.count))
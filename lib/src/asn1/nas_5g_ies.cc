@@ -463,7 +463,7 @@ namespace srsran
       j.write_str("Protection scheme Id", protection_scheme_id.to_string());
       j.write_int("Home network public key identifier", home_network_public_key_identifier);
 
-      j.write_str("Scheme output", octstring_to_string(scheme_output.data(), scheme_output.size()));
+      j.write_octstring("Scheme output", scheme_output);
     }
 
     SRSASN_CODE mobile_identity_5gs_t::guti_5g_s::pack(asn1::bit_ref &bref, asn1::bit_ref &bref_tmp)
@@ -556,7 +556,7 @@ namespace srsran
     }
     void mobile_identity_5gs_t::imei_s::to_json(json_writer &j)
     {
-      j.write_str("IMEI", octstring_to_string(imei.data(), imei.size()));
+      j.write_octstring("IMEI", imei);
     }
 
 
@@ -637,7 +637,7 @@ namespace srsran
     }
     void mobile_identity_5gs_t::imeisv_s::to_json(json_writer &j)
     {
-      j.write_str("IMEISV", octstring_to_string(imeisv.data(), imeisv.size()));
+      j.write_octstring("IMEISV", imeisv);
     }
 
     SRSASN_CODE mobile_identity_5gs_t::mac_address_s::pack(asn1::bit_ref &bref, asn1::bit_ref &bref_tmp)
@@ -1857,7 +1857,7 @@ namespace srsran
     void eps_nas_message_container_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("EPS NAS message container", octstring_to_string(eps_nas_message_container.data(), eps_nas_message_container.size()));
+      j.write_octstring("EPS NAS message container", eps_nas_message_container);
       j.end_obj();
     }
 
@@ -2011,7 +2011,7 @@ namespace srsran
     void payload_container_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("Payload container contents", octstring_to_string(payload_container_contents.data(), payload_container_contents.size()));
+      j.write_octstring("Payload container contents", payload_container_contents);
       j.end_obj();
     }
 
@@ -2286,7 +2286,7 @@ namespace srsran
     void message_container_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("NAS message container contents", octstring_to_string(nas_message_container.data(), nas_message_container.size()));
+      j.write_octstring("NAS message container contents", nas_message_container);
       j.end_obj();
     }
 
@@ -2614,7 +2614,7 @@ namespace srsran
     void ue_radio_capability_id_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("UE radio capability ID", octstring_to_string(ue_radio_capability_id.data(), ue_radio_capability_id.size()));
+      j.write_octstring("UE radio capability ID", ue_radio_capability_id);
       j.end_obj();
     }
 
@@ -3611,7 +3611,7 @@ namespace srsran
     void eap_message_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("EAP message", octstring_to_string(eap_message.data(), eap_message.size()));
+      j.write_octstring("EAP message", eap_message);
       j.end_obj();
     }
 
@@ -4389,7 +4389,7 @@ namespace srsran
     void abba_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("ABBA content", octstring_to_string(abba_contents.data(), abba_contents.size()));
+      j.write_octstring("ABBA content", abba_contents);
       j.end_obj();
     }
 
@@ -4412,7 +4412,7 @@ namespace srsran
     void authentication_parameter_rand_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("RAND value", octstring_to_string(rand.data(), 16));
+      j.write_octstring("RAND value", rand.data(), 16);
       j.end_obj();
     }
 
@@ -4459,7 +4459,7 @@ namespace srsran
     void authentication_parameter_autn_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("AUTN", octstring_to_string(autn.data(), autn.size()));
+      j.write_octstring("AUTN", autn);
       j.end_obj();
     }
 
@@ -4506,7 +4506,7 @@ namespace srsran
     void authentication_response_parameter_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("RES", octstring_to_string(res.data(), res.size()));
+      j.write_octstring("RES", res);
       j.end_obj();
     }
 
@@ -4553,7 +4553,7 @@ namespace srsran
     void authentication_failure_parameter_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("Authentication Failure parameter", octstring_to_string(auth_failure.data(), auth_failure.size()));
+      j.write_octstring("Authentication Failure parameter", auth_failure);
       j.end_obj();
     }
 
@@ -5321,7 +5321,7 @@ namespace srsran
     void dnn_t::to_json(json_writer &j) const
     {
       j.start_obj();
-      j.write_str("DNN value", octstring_to_string(dnn_value.data(), dnn_value.size()));
+      j.write_octstring("DNN value", dnn_value);
       j.end_obj();
     }
 
@@ -4214,6 +4214,7 @@ void nas_5gs_hdr::to_json(json_writer & j) const
         }
         j.write_int("Message authentication code", message_authentication_code);
         j.write_int("Sequence number", sequence_number);
+        j.write_str("Message type", message_type.to_string());
       }
       break;
     case extended_protocol_discriminator_5gsm:
@@ -4490,78 +4491,78 @@ SRSASN_CODE nas_5gs_msg::pack(asn1::bit_ref& msg_bref)
   return SRSASN_SUCCESS;
 }
 
-void nas_5gs_msg::to_json(json_writer& j)
+void nas_5gs_msg::to_json(json_writer& j, const char* integrity_check)
 {
   j.start_array();
   j.start_obj();
   j.write_fieldname("5GS mobility management");
   j.start_obj();
   hdr.to_json(j);
+  if (integrity_check != nullptr) {
+    j.write_str("Integrity check", integrity_check);
+  }
 
-  if(hdr.security_header_type != nas_5gs_hdr::integrity_protected_and_ciphered and hdr.security_header_type != nas_5gs_hdr::integrity_protected_and_ciphered_with_new_5G_nas_context)
+  // Ciphered messages are only unpacked once they have been deciphered with the NAS security context
+  switch (hdr.message_type) 
   {
-    switch (hdr.message_type) 
-    {
-      case msg_opts::options::registration_request:
-        registration_request().to_json(j);
-        break;
-      case msg_opts::options::registration_complete:
-        registration_complete().to_json(j);
-        break;
-      case msg_opts::options::registration_accept:
-        registration_accept().to_json(j);
-        break;
-      case msg_opts::options::registration_reject:
-        registration_reject().to_json(j);
-        break;
-      case msg_opts::options::authentication_reject:
-        authentication_reject().to_json(j);
-        break;
-      case msg_opts::options::authentication_request:
-        authentication_request().to_json(j);
-        break;
-      case msg_opts::options::authentication_response:
-        authentication_response().to_json(j);
-        break;
-      case msg_opts::options::identity_request:
-        identity_request().to_json(j);
-        break;
-      case msg_opts::options::identity_response:
-        identity_response().to_json(j);
-        break;
-      case msg_opts::options::security_mode_command:
-        security_mode_command().to_json(j);
-        break;
-      case msg_opts::options::security_mode_complete:
-        security_mode_complete().to_json(j);
-        break;
-      case msg_opts::options::service_accept:
-    //     handle_service_accept(nas_msg.service_accept());
-        break;
-      case msg_opts::options::service_reject:
-        break;
-    //     handle_service_reject(nas_msg.service_reject());
-      case msg_opts::options::deregistration_accept_ue_terminated:
-    //     handle_deregistration_accept_ue_terminated(nas_msg.deregistration_accept_ue_terminated());
-        break;
-      case msg_opts::options::deregistration_request_ue_terminated:
-    //     handle_deregistration_request_ue_terminated(nas_msg.deregistration_request_ue_terminated());
-        break;
-      case msg_opts::options::dl_nas_transport:
-    //     handle_dl_nas_transport(nas_msg.dl_nas_transport());
-        break;
-      case msg_opts::options::deregistration_accept_ue_originating:
-    //     handle_deregistration_accept_ue_originating(nas_msg.deregistration_accept_ue_originating());
-        break;
-      case msg_opts::options::configuration_update_command:
-    //     handle_configuration_update_command(nas_msg.configuration_update_command());
-        break;
-      default:
-        // logger.error(
-        //     "Not handling NAS message type: %s (0x%02x)", nas_msg.hdr.message_type.to_string(), nas_msg.hdr.message_type);
-        break;
-    }
-
+    case msg_opts::options::registration_request:
+      registration_request().to_json(j);
+      break;
+    case msg_opts::options::registration_complete:
+      registration_complete().to_json(j);
+      break;
+    case msg_opts::options::registration_accept:
+      registration_accept().to_json(j);
+      break;
+    case msg_opts::options::registration_reject:
+      registration_reject().to_json(j);
+      break;
+    case msg_opts::options::authentication_reject:
+      authentication_reject().to_json(j);
+      break;
+    case msg_opts::options::authentication_request:
+      authentication_request().to_json(j);
+      break;
+    case msg_opts::options::authentication_response:
+      authentication_response().to_json(j);
+      break;
+    case msg_opts::options::identity_request:
+      identity_request().to_json(j);
+      break;
+    case msg_opts::options::identity_response:
+      identity_response().to_json(j);
+      break;
+    case msg_opts::options::security_mode_command:
+      security_mode_command().to_json(j);
+      break;
+    case msg_opts::options::security_mode_complete:
+      security_mode_complete().to_json(j);
+      break;
+    case msg_opts::options::service_accept:
+  //     handle_service_accept(nas_msg.service_accept());
+      break;
+    case msg_opts::options::service_reject:
+      break;
+  //     handle_service_reject(nas_msg.service_reject());
+    case msg_opts::options::deregistration_accept_ue_terminated:
+  //     handle_deregistration_accept_ue_terminated(nas_msg.deregistration_accept_ue_terminated());
+      break;
+    case msg_opts::options::deregistration_request_ue_terminated:
+  //     handle_deregistration_request_ue_terminated(nas_msg.deregistration_request_ue_terminated());
+      break;
+    case msg_opts::options::dl_nas_transport:
+  //     handle_dl_nas_transport(nas_msg.dl_nas_transport());
+      break;
+    case msg_opts::options::deregistration_accept_ue_originating:
+  //     handle_deregistration_accept_ue_originating(nas_msg.deregistration_accept_ue_originating());
+      break;
+    case msg_opts::options::configuration_update_command:
+  //     handle_configuration_update_command(nas_msg.configuration_update_command());
+      break;
+    default:
+      // logger.error(
+      //     "Not handling NAS message type: %s (0x%02x)", nas_msg.hdr.message_type.to_string(), nas_msg.hdr.message_type);
+      break;
   }
  
   j.end_obj();
@@ -2383,10 +2383,10 @@ void rrc_conn_recfg_v1510_ies_s::to_json(json_writer& j) const
     j.write_int("sk-Counter-r15", sk_counter_r15);
   }
   if (nr_radio_bearer_cfg1_r15_present) {
-    j.write_str("nr-RadioBearerConfig1-r15", nr_radio_bearer_cfg1_r15.to_string());
+    j.write_octstring("nr-RadioBearerConfig1-r15", nr_radio_bearer_cfg1_r15);
   }
   if (nr_radio_bearer_cfg2_r15_present) {
-    j.write_str("nr-RadioBearerConfig2-r15", nr_radio_bearer_cfg2_r15.to_string());
+    j.write_octstring("nr-RadioBearerConfig2-r15", nr_radio_bearer_cfg2_r15);
   }
   if (tdm_pattern_cfg_r15_present) {
     j.write_fieldname("tdm-PatternConfig-r15");
@@ -2423,7 +2423,7 @@ void rrc_conn_recfg_v1510_ies_s::nr_cfg_r15_c_::to_json(json_writer& j) const
       j.start_obj();
       j.write_bool("endc-ReleaseAndAdd-r15", c.endc_release_and_add_r15);
       if (c.nr_secondary_cell_group_cfg_r15_present) {
-        j.write_str("nr-SecondaryCellGroupConfig-r15", c.nr_secondary_cell_group_cfg_r15.to_string());
+        j.write_octstring("nr-SecondaryCellGroupConfig-r15", c.nr_secondary_cell_group_cfg_r15);
       }
       if (c.p_max_eutra_r15_present) {
         j.write_int("p-MaxEUTRA-r15", c.p_max_eutra_r15);
@@ -8782,10 +8782,10 @@ void rrc_conn_resume_v1510_ies_s::to_json(json_writer& j) const
     j.write_int("sk-Counter-r15", sk_counter_r15);
   }
   if (nr_radio_bearer_cfg1_r15_present) {
-    j.write_str("nr-RadioBearerConfig1-r15", nr_radio_bearer_cfg1_r15.to_string());
+    j.write_octstring("nr-RadioBearerConfig1-r15", nr_radio_bearer_cfg1_r15);
   }
   if (nr_radio_bearer_cfg2_r15_present) {
-    j.write_str("nr-RadioBearerConfig2-r15", nr_radio_bearer_cfg2_r15.to_string());
+    j.write_octstring("nr-RadioBearerConfig2-r15", nr_radio_bearer_cfg2_r15);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
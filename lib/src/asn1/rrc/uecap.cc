@@ -817,7 +817,7 @@ void ue_cap_rat_container_s::to_json(json_writer& j) const
 {
   j.start_obj();
   j.write_str("rat-Type", rat_type.to_string());
-  j.write_str("ueCapabilityRAT-Container", ue_cap_rat_container.to_string());
+  j.write_octstring("ueCapabilityRAT-Container", ue_cap_rat_container, rat_type.to_string());
   j.end_obj();
 }
 
@@ -6200,7 +6200,7 @@ void sib3_s::to_json(json_writer& j) const
     j.end_array();
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   j.end_obj();
 }
@@ -6240,7 +6240,7 @@ void sib4_s::to_json(json_writer& j) const
   }
   j.end_array();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   j.end_obj();
 }
@@ -6304,7 +6304,7 @@ void sib5_s::to_json(json_writer& j) const
     t_resel_eutra_sf.to_json(j);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   j.end_obj();
 }
@@ -6344,9 +6344,9 @@ void sib6_s::to_json(json_writer& j) const
   j.start_obj();
   j.write_str("messageIdentifier", msg_id.to_string());
   j.write_str("serialNumber", serial_num.to_string());
-  j.write_str("warningType", warning_type.to_string());
+  j.write_octstring("warningType", warning_type);
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   j.end_obj();
 }
@@ -6400,12 +6400,12 @@ void sib7_s::to_json(json_writer& j) const
   j.write_str("serialNumber", serial_num.to_string());
   j.write_str("warningMessageSegmentType", warning_msg_segment_type.to_string());
   j.write_int("warningMessageSegmentNumber", warning_msg_segment_num);
-  j.write_str("warningMessageSegment", warning_msg_segment.to_string());
+  j.write_octstring("warningMessageSegment", warning_msg_segment);
   if (data_coding_scheme_present) {
-    j.write_str("dataCodingScheme", data_coding_scheme.to_string());
+    j.write_octstring("dataCodingScheme", data_coding_scheme);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   j.end_obj();
 }
@@ -6474,15 +6474,15 @@ void sib8_s::to_json(json_writer& j) const
   j.write_str("serialNumber", serial_num.to_string());
   j.write_str("warningMessageSegmentType", warning_msg_segment_type.to_string());
   j.write_int("warningMessageSegmentNumber", warning_msg_segment_num);
-  j.write_str("warningMessageSegment", warning_msg_segment.to_string());
+  j.write_octstring("warningMessageSegment", warning_msg_segment);
   if (data_coding_scheme_present) {
-    j.write_str("dataCodingScheme", data_coding_scheme.to_string());
+    j.write_octstring("dataCodingScheme", data_coding_scheme);
   }
   if (warning_area_coordinates_segment.size() > 0) {
-    j.write_str("warningAreaCoordinatesSegment", warning_area_coordinates_segment.to_string());
+    j.write_octstring("warningAreaCoordinatesSegment", warning_area_coordinates_segment);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   j.end_obj();
 }
@@ -6568,7 +6568,7 @@ void sib9_s::to_json(json_writer& j) const
     j.end_obj();
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   j.end_obj();
 }
@@ -7247,7 +7247,7 @@ void sys_info_ies_s::to_json(json_writer& j) const
   }
   j.end_array();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -7900,7 +7900,7 @@ void sib1_s::to_json(json_writer& j) const
     j.write_str("useFullResumeID", "true");
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -9410,7 +9410,7 @@ void rrc_reject_ies_s::to_json(json_writer& j) const
     j.write_int("waitTime", wait_time);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -9453,9 +9453,9 @@ void rrc_setup_ies_s::to_json(json_writer& j) const
   j.start_obj();
   j.write_fieldname("radioBearerConfig");
   radio_bearer_cfg.to_json(j);
-  j.write_str("masterCellGroup", master_cell_group.to_string());
+  j.write_octstring("masterCellGroup", master_cell_group);
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -12348,10 +12348,10 @@ void mrdc_secondary_cell_group_cfg_s::mrdc_secondary_cell_group_c_::to_json(json
   j.start_obj();
   switch (type_) {
     case types::nr_scg:
-      j.write_str("nr-SCG", c.get<dyn_octstring>().to_string());
+      j.write_octstring("nr-SCG", c.get<dyn_octstring>());
       break;
     case types::eutra_scg:
-      j.write_str("eutra-SCG", c.get<dyn_octstring>().to_string());
+      j.write_octstring("eutra-SCG", c.get<dyn_octstring>());
       break;
     default:
       log_invalid_choice_id(type_, "mrdc_secondary_cell_group_cfg_s::mrdc_secondary_cell_group_c_");
@@ -13893,7 +13893,7 @@ void rrc_recfg_v1560_ies_s::to_json(json_writer& j) const
     mrdc_secondary_cell_group_cfg.to_json(j);
   }
   if (radio_bearer_cfg2.size() > 0) {
-    j.write_str("radioBearerConfig2", radio_bearer_cfg2.to_string());
+    j.write_octstring("radioBearerConfig2", radio_bearer_cfg2);
   }
   if (sk_counter_present) {
     j.write_int("sk-Counter", sk_counter);
@@ -14167,7 +14167,7 @@ void master_key_upd_s::to_json(json_writer& j) const
   j.write_bool("keySetChangeIndicator", key_set_change_ind);
   j.write_int("nextHopChainingCount", next_hop_chaining_count);
   if (nas_container.size() > 0) {
-    j.write_str("nas-Container", nas_container.to_string());
+    j.write_octstring("nas-Container", nas_container);
   }
   j.end_obj();
 }
@@ -14806,7 +14806,7 @@ void ue_cap_rat_request_s::to_json(json_writer& j) const
   j.start_obj();
   j.write_str("rat-Type", rat_type.to_string());
   if (cap_request_filt.size() > 0) {
-    j.write_str("capabilityRequestFilter", cap_request_filt.to_string());
+    j.write_octstring("capabilityRequestFilter", cap_request_filt);
   }
   j.end_obj();
 }
@@ -15239,7 +15239,7 @@ void rrc_recfg_v1530_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (master_cell_group.size() > 0) {
-    j.write_str("masterCellGroup", master_cell_group.to_string());
+    j.write_octstring("masterCellGroup", master_cell_group);
   }
   if (full_cfg_present) {
     j.write_str("fullConfig", "true");
@@ -15247,7 +15247,7 @@ void rrc_recfg_v1530_ies_s::to_json(json_writer& j) const
   if (ded_nas_msg_list.size() > 0) {
     j.start_array("dedicatedNAS-MessageList");
     for (const auto& e1 : ded_nas_msg_list) {
-      j.write_str(e1.to_string());
+      j.write_octstring(e1);
     }
     j.end_array();
   }
@@ -15256,10 +15256,10 @@ void rrc_recfg_v1530_ies_s::to_json(json_writer& j) const
     master_key_upd.to_json(j);
   }
   if (ded_sib1_delivery.size() > 0) {
-    j.write_str("dedicatedSIB1-Delivery", ded_sib1_delivery.to_string());
+    j.write_octstring("dedicatedSIB1-Delivery", ded_sib1_delivery);
   }
   if (ded_sys_info_delivery.size() > 0) {
-    j.write_str("dedicatedSystemInformationDelivery", ded_sys_info_delivery.to_string());
+    j.write_octstring("dedicatedSystemInformationDelivery", ded_sys_info_delivery);
   }
   if (other_cfg_present) {
     j.write_fieldname("otherConfig");
@@ -15345,7 +15345,7 @@ void rrc_resume_v1560_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (radio_bearer_cfg2.size() > 0) {
-    j.write_str("radioBearerConfig2", radio_bearer_cfg2.to_string());
+    j.write_octstring("radioBearerConfig2", radio_bearer_cfg2);
   }
   if (sk_counter_present) {
     j.write_int("sk-Counter", sk_counter);
@@ -15608,7 +15608,7 @@ void counter_check_ies_s::to_json(json_writer& j) const
   }
   j.end_array();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -15655,10 +15655,10 @@ void dl_info_transfer_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (ded_nas_msg.size() > 0) {
-    j.write_str("dedicatedNAS-Message", ded_nas_msg.to_string());
+    j.write_octstring("dedicatedNAS-Message", ded_nas_msg);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -15709,12 +15709,12 @@ void mob_from_nr_cmd_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   j.write_str("targetRAT-Type", target_rat_type.to_string());
-  j.write_str("targetRAT-MessageContainer", target_rat_msg_container.to_string());
+  j.write_octstring("targetRAT-MessageContainer", target_rat_msg_container);
   if (nas_security_param_from_nr.size() > 0) {
-    j.write_str("nas-SecurityParamFromNR", nas_security_param_from_nr.to_string());
+    j.write_octstring("nas-SecurityParamFromNR", nas_security_param_from_nr);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -15793,14 +15793,14 @@ void rrc_recfg_ies_s::to_json(json_writer& j) const
     radio_bearer_cfg.to_json(j);
   }
   if (secondary_cell_group.size() > 0) {
-    j.write_str("secondaryCellGroup", secondary_cell_group.to_string());
+    j.write_octstring("secondaryCellGroup", secondary_cell_group);
   }
   if (meas_cfg_present) {
     j.write_fieldname("measConfig");
     meas_cfg.to_json(j);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -15840,7 +15840,7 @@ void rrc_reest_ies_s::to_json(json_writer& j) const
   j.start_obj();
   j.write_int("nextHopChainingCount", next_hop_chaining_count);
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -15937,7 +15937,7 @@ void rrc_release_ies_s::to_json(json_writer& j) const
     j.end_obj();
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -16028,7 +16028,7 @@ void rrc_resume_ies_s::to_json(json_writer& j) const
     radio_bearer_cfg.to_json(j);
   }
   if (master_cell_group.size() > 0) {
-    j.write_str("masterCellGroup", master_cell_group.to_string());
+    j.write_octstring("masterCellGroup", master_cell_group);
   }
   if (meas_cfg_present) {
     j.write_fieldname("measConfig");
@@ -16038,7 +16038,7 @@ void rrc_resume_ies_s::to_json(json_writer& j) const
     j.write_str("fullConfig", "true");
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -16079,7 +16079,7 @@ void security_mode_cmd_ies_s::to_json(json_writer& j) const
   j.write_fieldname("securityConfigSMC");
   security_cfg_smc.to_json(j);
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -16131,10 +16131,10 @@ void ue_cap_enquiry_ies_s::to_json(json_writer& j) const
   }
   j.end_array();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (ue_cap_enquiry_ext.size() > 0) {
-    j.write_str("ue-CapabilityEnquiryExt", ue_cap_enquiry_ext.to_string());
+    j.write_octstring("ue-CapabilityEnquiryExt", ue_cap_enquiry_ext);
   }
   j.end_obj();
 }
@@ -17724,7 +17724,7 @@ void paging_s::to_json(json_writer& j) const
     j.end_array();
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -20478,7 +20478,7 @@ void ue_cap_rat_container_s::to_json(json_writer& j) const
 {
   j.start_obj();
   j.write_str("rat-Type", rat_type.to_string());
-  j.write_str("ue-CapabilityRAT-Container", ue_cap_rat_container.to_string());
+  j.write_octstring("ue-CapabilityRAT-Container", ue_cap_rat_container, rat_type.to_string());
   j.end_obj();
 }
 
@@ -20625,7 +20625,7 @@ void fail_report_scg_s::to_json(json_writer& j) const
     j.end_array();
   }
   if (meas_result_scg_fail.size() > 0) {
-    j.write_str("measResultSCG-Failure", meas_result_scg_fail.to_string());
+    j.write_octstring("measResultSCG-Failure", meas_result_scg_fail);
   }
   j.end_obj();
 }
@@ -20702,7 +20702,7 @@ void fail_report_scg_eutra_s::to_json(json_writer& j) const
     j.end_array();
   }
   if (meas_result_scg_fail_mrdc.size() > 0) {
-    j.write_str("measResultSCG-FailureMRDC", meas_result_scg_fail_mrdc.to_string());
+    j.write_octstring("measResultSCG-FailureMRDC", meas_result_scg_fail_mrdc);
   }
   j.end_obj();
 }
@@ -21339,7 +21339,7 @@ void scg_fail_info_v1590_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21377,7 +21377,7 @@ void scg_fail_info_eutra_v1590_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21460,7 +21460,7 @@ void counter_check_resp_ies_s::to_json(json_writer& j) const
   }
   j.end_array();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21510,7 +21510,7 @@ void fail_info_ies_s::to_json(json_writer& j) const
     fail_info_rlc_bearer.to_json(j);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21552,7 +21552,7 @@ void location_meas_ind_ies_s::to_json(json_writer& j) const
   j.write_fieldname("measurementIndication");
   meas_ind.to_json(j);
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21594,7 +21594,7 @@ void meas_report_ies_s::to_json(json_writer& j) const
   j.write_fieldname("measResults");
   meas_results.to_json(j);
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21638,7 +21638,7 @@ void rrc_recfg_complete_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21675,7 +21675,7 @@ void rrc_reest_complete_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21739,7 +21739,7 @@ void rrc_resume_complete_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (ded_nas_msg.size() > 0) {
-    j.write_str("dedicatedNAS-Message", ded_nas_msg.to_string());
+    j.write_octstring("dedicatedNAS-Message", ded_nas_msg);
   }
   if (sel_plmn_id_present) {
     j.write_int("selectedPLMN-Identity", sel_plmn_id);
@@ -21752,7 +21752,7 @@ void rrc_resume_complete_ies_s::to_json(json_writer& j) const
     j.end_array();
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -21841,13 +21841,13 @@ void rrc_setup_complete_ies_s::to_json(json_writer& j) const
     }
     j.end_array();
   }
-  j.write_str("dedicatedNAS-Message", ded_nas_msg.to_string());
+  j.write_octstring("dedicatedNAS-Message", ded_nas_msg);
   if (ng_minus5_g_s_tmsi_value_present) {
     j.write_fieldname("ng-5G-S-TMSI-Value");
     ng_minus5_g_s_tmsi_value.to_json(j);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -22112,7 +22112,7 @@ void security_mode_complete_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -22150,7 +22150,7 @@ void security_mode_fail_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -22206,7 +22206,7 @@ void ueassist_info_ies_s::to_json(json_writer& j) const
     delay_budget_report.to_json(j);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -22258,7 +22258,7 @@ void ue_cap_info_ies_s::to_json(json_writer& j) const
     j.end_array();
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -22305,10 +22305,10 @@ void ul_info_transfer_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (ded_nas_msg.size() > 0) {
-    j.write_str("dedicatedNAS-Message", ded_nas_msg.to_string());
+    j.write_octstring("dedicatedNAS-Message", ded_nas_msg);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -22364,13 +22364,13 @@ void ul_info_transfer_mrdc_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (ul_dcch_msg_nr.size() > 0) {
-    j.write_str("ul-DCCH-MessageNR", ul_dcch_msg_nr.to_string());
+    j.write_octstring("ul-DCCH-MessageNR", ul_dcch_msg_nr);
   }
   if (ul_dcch_msg_eutra.size() > 0) {
-    j.write_str("ul-DCCH-MessageEUTRA", ul_dcch_msg_eutra.to_string());
+    j.write_octstring("ul-DCCH-MessageEUTRA", ul_dcch_msg_eutra);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -52352,7 +52352,7 @@ void nrdc_params_s::to_json(json_writer& j) const
     fr2_add_ue_nrdc_cap.to_json(j);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (dummy_present) {
     j.write_fieldname("dummy");
@@ -54378,7 +54378,7 @@ void ue_mrdc_cap_v1560_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (rx_filts.size() > 0) {
-    j.write_str("receivedFilters", rx_filts.to_string());
+    j.write_octstring("receivedFilters", rx_filts);
   }
   if (meas_and_mob_params_mrdc_v1560_present) {
     j.write_fieldname("measAndMobParametersMRDC-v1560");
@@ -54566,7 +54566,7 @@ void ue_mrdc_cap_s::to_json(json_writer& j) const
     pdcp_params_mrdc_v1530.to_json(j);
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -54681,7 +54681,7 @@ void ue_nr_cap_v1560_s::to_json(json_writer& j) const
     nrdc_params.to_json(j);
   }
   if (rx_filts.size() > 0) {
-    j.write_str("receivedFilters", rx_filts.to_string());
+    j.write_octstring("receivedFilters", rx_filts);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -55414,7 +55414,7 @@ void ue_nr_cap_s::to_json(json_writer& j) const
     j.end_array();
   }
   if (late_non_crit_ext.size() > 0) {
-    j.write_str("lateNonCriticalExtension", late_non_crit_ext.to_string());
+    j.write_octstring("lateNonCriticalExtension", late_non_crit_ext);
   }
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
@@ -55585,16 +55585,16 @@ SRSASN_CODE as_cfg_s::unpack(cbit_ref& bref)
 void as_cfg_s::to_json(json_writer& j) const
 {
   j.start_obj();
-  j.write_str("rrcReconfiguration", rrc_recfg.to_string());
+  j.write_octstring("rrcReconfiguration", rrc_recfg);
   if (ext) {
     if (source_rb_sn_cfg.size() > 0) {
-      j.write_str("sourceRB-SN-Config", source_rb_sn_cfg.to_string());
+      j.write_octstring("sourceRB-SN-Config", source_rb_sn_cfg);
     }
     if (source_scg_nr_cfg.size() > 0) {
-      j.write_str("sourceSCG-NR-Config", source_scg_nr_cfg.to_string());
+      j.write_octstring("sourceSCG-NR-Config", source_scg_nr_cfg);
     }
     if (source_scg_eutra_cfg.size() > 0) {
-      j.write_str("sourceSCG-EUTRA-Config", source_scg_eutra_cfg.to_string());
+      j.write_octstring("sourceSCG-EUTRA-Config", source_scg_eutra_cfg);
     }
     if (source_scg_cfgured_present) {
       j.write_str("sourceSCG-Configured", "true");
@@ -56060,7 +56060,7 @@ void as_context_s::to_json(json_writer& j) const
       ran_notif_area_info->to_json(j);
     }
     if (ue_assist_info.size() > 0) {
-      j.write_str("ueAssistanceInformation", ue_assist_info.to_string());
+      j.write_octstring("ueAssistanceInformation", ue_assist_info);
     }
     if (sel_band_combination_sn.is_present()) {
       j.write_fieldname("selectedBandCombinationSN");
@@ -56427,10 +56427,10 @@ void cg_cfg_v1560_ies_s::to_json(json_writer& j) const
     j.write_int("pSCellFrequencyEUTRA", pscell_freq_eutra);
   }
   if (scg_cell_group_cfg_eutra.size() > 0) {
-    j.write_str("scg-CellGroupConfigEUTRA", scg_cell_group_cfg_eutra.to_string());
+    j.write_octstring("scg-CellGroupConfigEUTRA", scg_cell_group_cfg_eutra);
   }
   if (candidate_cell_info_list_sn_eutra.size() > 0) {
-    j.write_str("candidateCellInfoListSN-EUTRA", candidate_cell_info_list_sn_eutra.to_string());
+    j.write_octstring("candidateCellInfoListSN-EUTRA", candidate_cell_info_list_sn_eutra);
   }
   if (candidate_serving_freq_list_eutra.size() > 0) {
     j.start_array("candidateServingFreqListEUTRA");
@@ -57383,10 +57383,10 @@ void cg_cfg_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (scg_cell_group_cfg.size() > 0) {
-    j.write_str("scg-CellGroupConfig", scg_cell_group_cfg.to_string());
+    j.write_octstring("scg-CellGroupConfig", scg_cell_group_cfg);
   }
   if (scg_rb_cfg.size() > 0) {
-    j.write_str("scg-RB-Config", scg_rb_cfg.to_string());
+    j.write_octstring("scg-RB-Config", scg_rb_cfg);
   }
   if (cfg_restrict_mod_req_present) {
     j.write_fieldname("configRestrictModReq");
@@ -57397,7 +57397,7 @@ void cg_cfg_ies_s::to_json(json_writer& j) const
     drx_info_scg.to_json(j);
   }
   if (candidate_cell_info_list_sn.size() > 0) {
-    j.write_str("candidateCellInfoListSN", candidate_cell_info_list_sn.to_string());
+    j.write_octstring("candidateCellInfoListSN", candidate_cell_info_list_sn);
   }
   if (meas_cfg_sn_present) {
     j.write_fieldname("measConfigSN");
@@ -57888,13 +57888,13 @@ void cg_cfg_info_v1560_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (candidate_cell_info_list_mn_eutra.size() > 0) {
-    j.write_str("candidateCellInfoListMN-EUTRA", candidate_cell_info_list_mn_eutra.to_string());
+    j.write_octstring("candidateCellInfoListMN-EUTRA", candidate_cell_info_list_mn_eutra);
   }
   if (candidate_cell_info_list_sn_eutra.size() > 0) {
-    j.write_str("candidateCellInfoListSN-EUTRA", candidate_cell_info_list_sn_eutra.to_string());
+    j.write_octstring("candidateCellInfoListSN-EUTRA", candidate_cell_info_list_sn_eutra);
   }
   if (source_cfg_scg_eutra.size() > 0) {
-    j.write_str("sourceConfigSCG-EUTRA", source_cfg_scg_eutra.to_string());
+    j.write_octstring("sourceConfigSCG-EUTRA", source_cfg_scg_eutra);
   }
   if (scg_fail_info_eutra_present) {
     j.write_fieldname("scgFailureInfoEUTRA");
@@ -58282,7 +58282,7 @@ void cg_cfg_info_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
   if (ue_cap_info.size() > 0) {
-    j.write_str("ue-CapabilityInfo", ue_cap_info.to_string());
+    j.write_octstring("ue-CapabilityInfo", ue_cap_info);
   }
   if (candidate_cell_info_list_mn.size() > 0) {
     j.start_array("candidateCellInfoListMN");
@@ -58292,7 +58292,7 @@ void cg_cfg_info_ies_s::to_json(json_writer& j) const
     j.end_array();
   }
   if (candidate_cell_info_list_sn.size() > 0) {
-    j.write_str("candidateCellInfoListSN", candidate_cell_info_list_sn.to_string());
+    j.write_octstring("candidateCellInfoListSN", candidate_cell_info_list_sn);
   }
   if (meas_result_cell_list_sftd_nr.size() > 0) {
     j.start_array("measResultCellListSFTD-NR");
@@ -58321,13 +58321,13 @@ void cg_cfg_info_ies_s::to_json(json_writer& j) const
     meas_cfg_mn.to_json(j);
   }
   if (source_cfg_scg.size() > 0) {
-    j.write_str("sourceConfigSCG", source_cfg_scg.to_string());
+    j.write_octstring("sourceConfigSCG", source_cfg_scg);
   }
   if (scg_rb_cfg.size() > 0) {
-    j.write_str("scg-RB-Config", scg_rb_cfg.to_string());
+    j.write_octstring("scg-RB-Config", scg_rb_cfg);
   }
   if (mcg_rb_cfg.size() > 0) {
-    j.write_str("mcg-RB-Config", mcg_rb_cfg.to_string());
+    j.write_octstring("mcg-RB-Config", mcg_rb_cfg);
   }
   if (mrdc_assist_info_present) {
     j.write_fieldname("mrdc-AssistanceInfo");
@@ -58672,7 +58672,7 @@ SRSASN_CODE ho_cmd_ies_s::unpack(cbit_ref& bref)
 void ho_cmd_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
-  j.write_str("handoverCommandMessage", ho_cmd_msg.to_string());
+  j.write_octstring("handoverCommandMessage", ho_cmd_msg);
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
     j.start_obj();
@@ -59589,7 +59589,7 @@ SRSASN_CODE ue_radio_access_cap_info_ies_s::unpack(cbit_ref& bref)
 void ue_radio_access_cap_info_ies_s::to_json(json_writer& j) const
 {
   j.start_obj();
-  j.write_str("ue-RadioAccessCapabilityInfo", ue_radio_access_cap_info.to_string());
+  j.write_octstring("ue-RadioAccessCapabilityInfo", ue_radio_access_cap_info);
   if (non_crit_ext_present) {
     j.write_fieldname("nonCriticalExtension");
     j.start_obj();
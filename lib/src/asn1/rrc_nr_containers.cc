@@ -0,0 +1,68 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "mitm_lib/asn1/rrc_nr_containers.h"
+
+namespace asn1 {
+namespace rrc_nr {
+
+static void add_containers(container_registry& r)
+{
+  const container_desc* cell_group   = container_desc_of<cell_group_cfg_s>("CellGroupConfig");
+  const container_desc* radio_bearer = container_desc_of<radio_bearer_cfg_s>("RadioBearerConfig");
+  const container_desc* recfg        = container_desc_of<rrc_recfg_s>("RRCReconfiguration");
+  const container_desc* ue_nr_cap    = container_desc_of<ue_nr_cap_s>("UE-NR-Capability");
+  const container_desc* ue_mrdc_cap  = container_desc_of<ue_mrdc_cap_s>("UE-MRDC-Capability");
+
+  r.add(&desc_of<rrc_setup_ies_s>, "masterCellGroup", cell_group);
+  r.add(&desc_of<rrc_resume_ies_s>, "masterCellGroup", cell_group);
+  r.add(&desc_of<rrc_resume_v1560_ies_s>, "radioBearerConfig2", radio_bearer);
+  r.add(&desc_of<rrc_recfg_ies_s>, "secondaryCellGroup", cell_group);
+  r.add(&desc_of<rrc_recfg_v1530_ies_s>, "masterCellGroup", cell_group);
+  r.add(&desc_of<rrc_recfg_v1530_ies_s>, "dedicatedSIB1-Delivery", container_desc_of<sib1_s>("SIB1"));
+  r.add(&desc_of<rrc_recfg_v1530_ies_s>,
+        "dedicatedSystemInformationDelivery",
+        container_desc_of<sys_info_s>("SystemInformation"));
+  r.add(&desc_of<rrc_recfg_v1560_ies_s>, "radioBearerConfig2", radio_bearer);
+  r.add(&desc_of<rrc_recfg_v1560_ies_s>, "mrdc-SecondaryCellGroupConfig.setup.mrdc-SecondaryCellGroup.nr-SCG", recfg);
+  r.add(&desc_of<ue_cap_rat_container_s>, "ue-CapabilityRAT-Container", ue_nr_cap, "nr");
+  r.add(&desc_of<ue_cap_rat_container_s>, "ue-CapabilityRAT-Container", ue_mrdc_cap, "eutra-nr");
+
+  // EN-DC, in EUTRA RRC messages
+  r.add(nullptr, "nr-SecondaryCellGroupConfig-r15", recfg);
+  r.add(nullptr, "nr-RadioBearerConfig1-r15", radio_bearer);
+  r.add(nullptr, "nr-RadioBearerConfig2-r15", radio_bearer);
+  r.add(nullptr, "ueCapabilityRAT-Container", ue_nr_cap, "nr");
+  r.add(nullptr, "ueCapabilityRAT-Container", ue_mrdc_cap, "eutra-nr");
+}
+
+container_registry& containers()
+{
+  static container_registry r = [] {
+    container_registry ret;
+    add_containers(ret);
+    return ret;
+  }();
+  return r;
+}
+
+} // namespace rrc_nr
+} // namespace asn1
@@ -0,0 +1,172 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * 32-bit lanes for the multi-buffer ZUC and SNOW 3G keystream generators.
+ * Every lane runs an independent stream, so word t of up to KS_LANES
+ * streams is produced by one pass of the algorithm:
+ *   - AVX-512: 16 lanes
+ *   - AVX2:     8 lanes
+ *   - otherwise a single lane held in a plain uint32_t
+ * S-boxes are 256-entry uint32_t tables read with gathers.
+ */
+
+#ifndef SRSRAN_KEYSTREAM_LANES_H
+#define SRSRAN_KEYSTREAM_LANES_H
+
+#include <stdint.h>
+
+#if defined(LV_HAVE_AVX512)
+
+#include <immintrin.h>
+
+#define KS_LANES 16
+typedef __m512i ks_lane_t;
+
+static inline ks_lane_t ks_set1(uint32_t x)
+{
+  return _mm512_set1_epi32((int)x);
+}
+static inline ks_lane_t ks_load(const uint32_t* p)
+{
+  return _mm512_loadu_si512((const void*)p);
+}
+static inline void ks_store(uint32_t* p, ks_lane_t a)
+{
+  _mm512_storeu_si512((void*)p, a);
+}
+static inline ks_lane_t ks_add(ks_lane_t a, ks_lane_t b)
+{
+  return _mm512_add_epi32(a, b);
+}
+static inline ks_lane_t ks_xor(ks_lane_t a, ks_lane_t b)
+{
+  return _mm512_xor_si512(a, b);
+}
+static inline ks_lane_t ks_and(ks_lane_t a, ks_lane_t b)
+{
+  return _mm512_and_si512(a, b);
+}
+static inline ks_lane_t ks_or(ks_lane_t a, ks_lane_t b)
+{
+  return _mm512_or_si512(a, b);
+}
+static inline ks_lane_t ks_lookup(const uint32_t* table, ks_lane_t idx)
+{
+  return _mm512_i32gather_epi32(idx, (const void*)table, 4);
+}
+#define KS_SHL(a, k) _mm512_slli_epi32(a, k)
+#define KS_SHR(a, k) _mm512_srli_epi32(a, k)
+#define KS_ROT(a, k) _mm512_rol_epi32(a, k)
+
+#elif defined(LV_HAVE_AVX2)
+
+#include <immintrin.h>
+
+#define KS_LANES 8
+typedef __m256i ks_lane_t;
+
+static inline ks_lane_t ks_set1(uint32_t x)
+{
+  return _mm256_set1_epi32((int)x);
+}
+static inline ks_lane_t ks_load(const uint32_t* p)
+{
+  return _mm256_loadu_si256((const __m256i*)p);
+}
+static inline void ks_store(uint32_t* p, ks_lane_t a)
+{
+  _mm256_storeu_si256((__m256i*)p, a);
+}
+static inline ks_lane_t ks_add(ks_lane_t a, ks_lane_t b)
+{
+  return _mm256_add_epi32(a, b);
+}
+static inline ks_lane_t ks_xor(ks_lane_t a, ks_lane_t b)
+{
+  return _mm256_xor_si256(a, b);
+}
+static inline ks_lane_t ks_and(ks_lane_t a, ks_lane_t b)
+{
+  return _mm256_and_si256(a, b);
+}
+static inline ks_lane_t ks_or(ks_lane_t a, ks_lane_t b)
+{
+  return _mm256_or_si256(a, b);
+}
+static inline ks_lane_t ks_lookup(const uint32_t* table, ks_lane_t idx)
+{
+  return _mm256_i32gather_epi32((const int*)table, idx, 4);
+}
+#define KS_SHL(a, k) _mm256_slli_epi32(a, k)
+#define KS_SHR(a, k) _mm256_srli_epi32(a, k)
+#define KS_ROT(a, k) _mm256_or_si256(_mm256_slli_epi32(a, k), _mm256_srli_epi32(a, 32 - (k)))
+
+#else // scalar
+
+#define KS_LANES 1
+typedef uint32_t ks_lane_t;
+
+static inline ks_lane_t ks_set1(uint32_t x)
+{
+  return x;
+}
+static inline ks_lane_t ks_load(const uint32_t* p)
+{
+  return *p;
+}
+static inline void ks_store(uint32_t* p, ks_lane_t a)
+{
+  *p = a;
+}
+static inline ks_lane_t ks_add(ks_lane_t a, ks_lane_t b)
+{
+  return a + b;
+}
+static inline ks_lane_t ks_xor(ks_lane_t a, ks_lane_t b)
+{
+  return a ^ b;
+}
+static inline ks_lane_t ks_and(ks_lane_t a, ks_lane_t b)
+{
+  return a & b;
+}
+static inline ks_lane_t ks_or(ks_lane_t a, ks_lane_t b)
+{
+  return a | b;
+}
+static inline ks_lane_t ks_lookup(const uint32_t* table, ks_lane_t idx)
+{
+  return table[idx];
+}
+#define KS_SHL(a, k) ((a) << (k))
+#define KS_SHR(a, k) ((a) >> (k))
+#define KS_ROT(a, k) (((a) << (k)) | ((a) >> (32 - (k))))
+
+#endif
+
+// Byte i (0 is the most significant) of every lane, as a table index
+#define KS_BYTE(a, i) ks_and(KS_SHR(a, 24 - 8 * (i)), ks_set1(0xff))
+
+// Number of keystream words buffered per lane before they are copied out to the streams
+#define KS_TILE_WORDS 16
+
+#endif // SRSRAN_KEYSTREAM_LANES_H
@@ -21,8 +21,13 @@
 #include "mitm_lib/common/ssl.h"
 #include "mitm_lib/common/zuc.h"
 
+#include <algorithm>
 #include <arpa/inet.h>
 
+#ifdef LV_HAVE_PCLMUL
+#include <wmmintrin.h>
+#endif // LV_HAVE_PCLMUL
+
 /*******************************************************************************
                               LOCAL FUNCTION PROTOTYPES
 *******************************************************************************/
@@ -718,20 +723,53 @@ LIBLTE_ERROR_ENUM liblte_security_128_eia2(const uint8*           key,
   return LIBLTE_SUCCESS;
 }
 
-uint32_t GET_WORD(uint32_t* DATA, uint32_t i)
+/*********************************************************************
+    Name: liblte_security_128_eia3
+
+    Description: 128-bit integrity algorithm EIA3.
+
+    Document Reference: 33.401 v13.1.0 Annex B.2.4
+                        35.221 v13.0.0 Section 4 (128-EIA3)
+
+    Notes: T accumulates, for every set message bit i, the keystream
+           word starting at bit i. The message is taken 32 bits at a
+           time: with W = z[k] || z[k+1], the words for the 32 bits of
+           message word k are the top halves of W << 0..31, so their
+           sum is the middle word of the carry-less product of W and
+           the bit reversed message word.
+*********************************************************************/
+#define EIA3_KS_CHUNK_WORDS 64
+
+#ifdef LV_HAVE_PCLMUL
+static inline uint32 eia3_word_mac(uint32 m_rev, uint64 w)
 {
-  uint32_t WORD, ti;
-  ti = i % 32;
-  if (ti == 0)
-    WORD = DATA[i / 32];
-  else
-    WORD = (DATA[i / 32] << ti) | (DATA[i / 32 + 1] >> (32 - ti));
-  return WORD;
+  __m128i p = _mm_clmulepi64_si128(_mm_cvtsi32_si128(m_rev), _mm_cvtsi64_si128(w), 0x00);
+  return (uint32)((uint64)_mm_cvtsi128_si64(p) >> 32);
 }
+#else  // LV_HAVE_PCLMUL
+static inline uint32 eia3_word_mac(uint32 m_rev, uint64 w)
+{
+  uint32 t = 0;
+  while (m_rev != 0) {
+    t ^= (uint32)((w << __builtin_ctz(m_rev)) >> 32);
+    m_rev &= m_rev - 1;
+  }
+  return t;
+}
+#endif // LV_HAVE_PCLMUL
 
-uint8_t GET_BIT(uint8_t* DATA, uint32_t i)
+// Message word k with bit i of the result holding message bit 32 * k + i
+static inline uint32 eia3_load_word_rev(const uint8* msg)
 {
-  return (DATA[i / 8] & (1 << (7 - (i % 8)))) ? 1 : 0;
+  uint32 m;
+  memcpy(&m, msg, 4);
+  m = ((m >> 1) & 0x55555555) | ((m & 0x55555555) << 1);
+  m = ((m >> 2) & 0x33333333) | ((m & 0x33333333) << 2);
+  m = ((m >> 4) & 0x0f0f0f0f) | ((m & 0x0f0f0f0f) << 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  m = __builtin_bswap32(m);
+#endif
+  return m;
 }
 
 LIBLTE_ERROR_ENUM liblte_security_128_eia3(const uint8* key,
@@ -746,13 +784,16 @@ LIBLTE_ERROR_ENUM liblte_security_128_eia3(const uint8* key,
   LIBLTE_ERROR_ENUM err    = LIBLTE_ERROR_INVALID_INPUTS;
   uint8_t           iv[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
-  uint32* ks;
-  uint32  msg_len_block_8, msg_len_block_32, m;
+  // Keystream words base .. base + avail - 1, generated a chunk at a time
+  uint32 ks[EIA3_KS_CHUNK_WORDS + 1];
+  uint32 base;
+  uint32 avail;
+  uint32 nof_ks_words;
+  uint32 nof_msg_words;
+  uint32 k;
+  uint32 T = 0;
 
   if (key != NULL && msg != NULL && mac != NULL) {
-    msg_len_block_8  = (msg_len + 7) / 8;
-    msg_len_block_32 = (msg_len + 31) / 32;
-
     // Construct iv
     iv[0] = (count >> 24) & 0xFF;
     iv[1] = (count >> 16) & 0xFF;
@@ -776,30 +817,66 @@ LIBLTE_ERROR_ENUM liblte_security_128_eia3(const uint8* key,
     // Initialize keystream
     zuc_initialize(&zuc_state, key, iv);
 
-    // Generate keystream
-    int N = msg_len + 64;
-    int L = (N + 31) / 32;
-
-    ks = (uint32*)calloc(L, sizeof(uint32));
-
-    zuc_generate_keystream(&zuc_state, L, ks);
-
-    uint32_t T = 0;
-    for (uint32_t i = 0; i < msg_len; i++) {
-      if (GET_BIT(msg, i)) {
-        T ^= GET_WORD(ks, i);
+    // L = ceil((LENGTH + 64) / 32) keystream words
+    nof_ks_words  = (msg_len + 64 + 31) / 32;
+    nof_msg_words = (msg_len + 31) / 32;
+    avail         = std::min<uint32>(nof_ks_words, EIA3_KS_CHUNK_WORDS + 1);
+    base          = 0;
+    zuc_generate_keystream(&zuc_state, avail, ks);
+
+    // The last keystream word in the buffer is kept as the first of the next chunk
+#define EIA3_REFILL()                                                                                                  \
+  do {                                                                                                                 \
+    ks[0] = ks[avail - 1];                                                                                             \
+    base += avail - 1;                                                                                                 \
+    avail = 1 + std::min<uint32>(nof_ks_words - base - 1, EIA3_KS_CHUNK_WORDS);                                              \
+    zuc_continue_keystream(&zuc_state, avail - 1, &ks[1]);                                                             \
+  } while (0)
+
+    // Whole message words. The last one, if partial, is zero padded up to 32 bits
+    k = 0;
+    while (k < nof_msg_words) {
+      uint32 end = std::min<uint32>(nof_msg_words - 1, base + avail - 1);
+      for (; k < end; k++) {
+        uint64 w = ((uint64)ks[k - base] << 32) | ks[k - base + 1];
+        T ^= eia3_word_mac(eia3_load_word_rev(&msg[4 * k]), w);
+      }
+      if (k == nof_msg_words - 1 && k + 1 < base + avail) {
+        uint8  last[4] = {};
+        uint32 bits    = msg_len - 32 * k;
+        memcpy(last, &msg[4 * k], (bits + 7) / 8);
+        uint32 m_rev = eia3_load_word_rev(last);
+        if (bits < 32) {
+          m_rev &= (1U << bits) - 1;
+        }
+        uint64 w = ((uint64)ks[k - base] << 32) | ks[k - base + 1];
+        T ^= eia3_word_mac(m_rev, w);
+        k++;
+      } else if (k < nof_msg_words) {
+        EIA3_REFILL();
       }
     }
 
-    T ^= GET_WORD(ks, msg_len);
+    // T ^= z[LENGTH]
+    k = msg_len / 32;
+    if (msg_len % 32 == 0) {
+      T ^= ks[k - base];
+    } else {
+      T ^= (uint32)(((((uint64)ks[k - base] << 32) | ks[k - base + 1]) << (msg_len % 32)) >> 32);
+    }
 
-    uint32_t mac_tmp = T ^ ks[L - 1];
+    // MAC = T ^ z[32 * (L - 1)]
+    while (nof_ks_words - 1 >= base + avail) {
+      EIA3_REFILL();
+    }
+#undef EIA3_REFILL
+    uint32_t mac_tmp = T ^ ks[nof_ks_words - 1 - base];
     mac[0]           = (mac_tmp >> 24) & 0xFF;
     mac[1]           = (mac_tmp >> 16) & 0xFF;
     mac[2]           = (mac_tmp >> 8) & 0xFF;
     mac[3]           = mac_tmp & 0xFF;
 
-    free(ks);
+    err = LIBLTE_SUCCESS;
   }
 
   return (err);
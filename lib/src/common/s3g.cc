@@ -20,6 +20,10 @@
  */
 
 #include "mitm_lib/common/s3g.h"
+#include "keystream_lanes.h"
+
+#define SRSRAN_S3G_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define SRSRAN_S3G_MAX(a, b) ((a) > (b) ? (a) : (b))
 
 /* S-box SQ */
 static const uint8_t SQ[256] = {
@@ -565,4 +569,155 @@ uint8_t* s3g_f9(const uint8_t* key, uint32_t count, uint32_t fresh, uint32_t dir
     MAC_I[i] = ((EVAL >> (56 - (i * 8))) ^ (z[4] >> (24 - (i * 8)))) & 0xff;
 
   return MAC_I;
-}
\ No newline at end of file
+}
+/*********************************************************************
+    Multi-buffer keystream generation, KS_LANES streams in lockstep.
+
+    MULalpha/DIValpha and the two S-boxes with their MixColumn step
+    are replaced by 256-entry tables, S1/S2 as the XOR of one table
+    per input byte.
+*********************************************************************/
+typedef struct {
+  uint32_t mul_alpha[256];
+  uint32_t div_alpha[256];
+  uint32_t s1[4][256];
+  uint32_t s2[4][256];
+} s3g_mb_tables_t;
+
+// Contribution of input byte i to S1 (S, 0x1b) or S2 (SQ, 0x69): MixColumn row of 2, 3, 1, 1 rotated by i
+static void s3g_mb_fill_sbox(uint32_t t[4][256], const uint8_t box[256], uint8_t c)
+{
+  for (int x = 0; x < 256; x++) {
+    uint32_t s  = box[x];
+    uint32_t s2 = s3g_mul_x(box[x], c);
+    uint32_t s3 = s2 ^ s;
+    t[0][x]     = (s2 << 24) | (s3 << 16) | (s << 8) | s;
+    t[1][x]     = (s << 24) | (s2 << 16) | (s3 << 8) | s;
+    t[2][x]     = (s << 24) | (s << 16) | (s2 << 8) | s3;
+    t[3][x]     = (s3 << 24) | (s << 16) | (s << 8) | s2;
+  }
+}
+
+static const s3g_mb_tables_t* s3g_mb_tables()
+{
+  static const s3g_mb_tables_t tables = [] {
+    s3g_mb_tables_t t;
+    for (int x = 0; x < 256; x++) {
+      t.mul_alpha[x] = s3g_mul_alpha((uint8_t)x);
+      t.div_alpha[x] = s3g_div_alpha((uint8_t)x);
+    }
+    s3g_mb_fill_sbox(t.s1, S, 0x1b);
+    s3g_mb_fill_sbox(t.s2, SQ, 0x69);
+    return t;
+  }();
+  return &tables;
+}
+
+typedef struct {
+  ks_lane_t lfsr[16]; // ring, lfsr[(p + i) & 15] holds s_i
+  uint32_t  p;
+  ks_lane_t fsm[3];
+} s3g_mb_state_t;
+
+#define S3G_MB_S(st, i) ((st)->lfsr[((st)->p + (i)) & 15])
+
+static inline ks_lane_t s3g_mb_sbox(const uint32_t t[4][256], ks_lane_t w)
+{
+  return ks_xor(ks_xor(ks_lookup(t[0], KS_BYTE(w, 0)), ks_lookup(t[1], KS_BYTE(w, 1))),
+                ks_xor(ks_lookup(t[2], KS_BYTE(w, 2)), ks_lookup(t[3], KS_BYTE(w, 3))));
+}
+
+static inline void s3g_mb_clock_lfsr(const s3g_mb_tables_t* t, s3g_mb_state_t* st, ks_lane_t f)
+{
+  ks_lane_t s0  = S3G_MB_S(st, 0);
+  ks_lane_t s11 = S3G_MB_S(st, 11);
+  ks_lane_t v   = ks_xor(KS_SHL(s0, 8), ks_lookup(t->mul_alpha, KS_SHR(s0, 24)));
+  v             = ks_xor(v, ks_xor(S3G_MB_S(st, 2), KS_SHR(s11, 8)));
+  v             = ks_xor(v, ks_xor(ks_lookup(t->div_alpha, ks_and(s11, ks_set1(0xff))), f));
+  S3G_MB_S(st, 0) = v;
+  st->p           = (st->p + 1) & 15;
+}
+
+static inline ks_lane_t s3g_mb_clock_fsm(const s3g_mb_tables_t* t, s3g_mb_state_t* st)
+{
+  ks_lane_t f = ks_xor(ks_add(S3G_MB_S(st, 15), st->fsm[0]), st->fsm[1]);
+  ks_lane_t r = ks_add(st->fsm[1], ks_xor(st->fsm[2], S3G_MB_S(st, 5)));
+  st->fsm[2]  = s3g_mb_sbox(t->s2, st->fsm[1]);
+  st->fsm[1]  = s3g_mb_sbox(t->s1, st->fsm[0]);
+  st->fsm[0]  = r;
+  return f;
+}
+
+static void s3g_mb_generate_group(const s3g_mb_job_t* jobs, uint32_t nof_jobs)
+{
+  const s3g_mb_tables_t* t = s3g_mb_tables();
+  s3g_mb_state_t         st;
+  uint32_t               lanes[16][KS_LANES] = {};
+  uint32_t               tile[KS_TILE_WORDS][KS_LANES];
+  uint32_t               max_len = 0;
+  uint32_t               i, l;
+
+  // Same loading as s3g_initialize(), idle lanes run on an all zero state
+  for (l = 0; l < nof_jobs; l++) {
+    const uint32_t* k  = jobs[l].k;
+    const uint32_t* iv = jobs[l].iv;
+    lanes[15][l]       = k[3] ^ iv[0];
+    lanes[14][l]       = k[2];
+    lanes[13][l]       = k[1];
+    lanes[12][l]       = k[0] ^ iv[1];
+    lanes[11][l]       = k[3] ^ 0xffffffff;
+    lanes[10][l]       = k[2] ^ 0xffffffff ^ iv[2];
+    lanes[9][l]        = k[1] ^ 0xffffffff ^ iv[3];
+    lanes[8][l]        = k[0] ^ 0xffffffff;
+    lanes[7][l]        = k[3];
+    lanes[6][l]        = k[2];
+    lanes[5][l]        = k[1];
+    lanes[4][l]        = k[0];
+    lanes[3][l]        = k[3] ^ 0xffffffff;
+    lanes[2][l]        = k[2] ^ 0xffffffff;
+    lanes[1][l]        = k[1] ^ 0xffffffff;
+    lanes[0][l]        = k[0] ^ 0xffffffff;
+    max_len            = SRSRAN_S3G_MAX(max_len, jobs[l].n);
+  }
+  for (i = 0; i < 16; i++) {
+    st.lfsr[i] = ks_load(lanes[i]);
+  }
+  st.p = 0;
+  for (i = 0; i < 3; i++) {
+    st.fsm[i] = ks_set1(0);
+  }
+
+  for (i = 0; i < 32; i++) {
+    s3g_mb_clock_lfsr(t, &st, s3g_mb_clock_fsm(t, &st));
+  }
+
+  // Clock FSM once and discard the output, then the LFSR in keystream mode
+  s3g_mb_clock_fsm(t, &st);
+  s3g_mb_clock_lfsr(t, &st, ks_set1(0));
+
+  for (uint32_t t0 = 0; t0 < max_len; t0 += KS_TILE_WORDS) {
+    uint32_t n = SRSRAN_S3G_MIN(max_len - t0, KS_TILE_WORDS);
+    for (i = 0; i < n; i++) {
+      ks_lane_t f = s3g_mb_clock_fsm(t, &st);
+      ks_store(tile[i], ks_xor(f, S3G_MB_S(&st, 0)));
+      s3g_mb_clock_lfsr(t, &st, ks_set1(0));
+    }
+    for (l = 0; l < nof_jobs; l++) {
+      for (i = 0; i < n && t0 + i < jobs[l].n; i++) {
+        jobs[l].ks[t0 + i] = tile[i][l];
+      }
+    }
+  }
+}
+
+uint32_t s3g_mb_lanes()
+{
+  return KS_LANES;
+}
+
+void s3g_generate_keystream_mb(const s3g_mb_job_t* jobs, uint32_t nof_jobs)
+{
+  for (uint32_t first = 0; first < nof_jobs; first += KS_LANES) {
+    s3g_mb_generate_group(&jobs[first], SRSRAN_S3G_MIN(nof_jobs - first, (uint32_t)KS_LANES));
+  }
+}
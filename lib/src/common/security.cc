@@ -23,8 +23,16 @@
 #include "mitm_lib/common/liblte_security.h"
 #include "mitm_lib/common/s3g.h"
 #include "mitm_lib/common/ssl.h"
+#include "mitm_lib/common/zuc.h"
 #include "mitm_lib/config.h"
+#include <algorithm>
 #include <arpa/inet.h>
+#include <mutex>
+
+#ifdef LV_HAVE_AESNI
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#endif // LV_HAVE_AESNI
 
 #ifdef HAVE_MBEDTLS
 #include "mbedtls/md5.h"
@@ -67,6 +75,23 @@ namespace srsran {
  * Key Generation
  *****************************************************************************/
 
+// Overwrites key material with stores the compiler cannot drop
+static void secure_wipe(void* p, size_t len)
+{
+  volatile uint8_t* v = (volatile uint8_t*)p;
+  while (len-- > 0) {
+    *v++ = 0;
+  }
+}
+
+// Algorithm key derivation, P0 = algorithm type distinguisher, P1 = algorithm identity (TS 33.501 A.8)
+static int kdf_5g_algorithm_key(const uint8_t* key, uint8_t distinguisher, uint8_t alg_id, uint8_t* output)
+{
+  const uint8_t p0[1] = {distinguisher};
+  const uint8_t p1[1] = {alg_id};
+  return kdf_common(FC_5G_ALGORITHM_KEY_DERIVATION, key, {p0, p1}, output);
+}
+
 uint8_t security_generate_k_asme(const uint8_t* ck,
                                  const uint8_t* ik,
                                  const uint8_t* ak_xor_sqn_,
@@ -124,29 +149,21 @@ uint8_t security_generate_k_ausf(const uint8_t* ck,
     return SRSRAN_ERROR;
   }
 
-  std::array<uint8_t, 32> key;
-
   // The input key Key shall be equal to the concatenation CK || IK of CK and IK.
-  memcpy(key.data(), ck, 16);
-  memcpy(key.data() + 16, ik, 16);
-
-  // Serving Network Name
-  std::vector<uint8_t> ssn;
-  ssn.resize(strlen(serving_network_name));
-  memcpy(ssn.data(), serving_network_name, ssn.size());
+  uint8_t key[32];
+  memcpy(key, ck, 16);
+  memcpy(key + 16, ik, 16);
 
-  // AK XOR SQN
-  std::vector<uint8_t> ak_xor_sqn;
-  ak_xor_sqn.resize(AK_LEN);
-  memcpy(ak_xor_sqn.data(), ak_xor_sqn_, ak_xor_sqn.size());
+  // P0 = serving network name, P1 = SQN XOR AK
+  span<const uint8_t> ssn((const uint8_t*)serving_network_name, strlen(serving_network_name));
+  span<const uint8_t> ak_xor_sqn(ak_xor_sqn_, AK_LEN);
 
-  uint8_t output[32];
-  if (kdf_common(FC_5G_KAUSF_DERIVATION, key, ssn, ak_xor_sqn, output) != SRSRAN_SUCCESS) {
+  int ret = kdf_common(FC_5G_KAUSF_DERIVATION, key, {ssn, ak_xor_sqn}, k_ausf);
+  secure_wipe(key, sizeof(key));
+  if (ret != SRSRAN_SUCCESS) {
     log_error("Failed to run kdf_common");
     return SRSRAN_ERROR;
   }
-  memcpy(k_ausf, output, 32);
-
   return SRSRAN_SUCCESS;
 }
 
@@ -211,17 +228,13 @@ uint8_t security_generate_k_gnb(const as_key_t& k_amf, const uint32_t nas_count_
   }
 
   // NAS Count
-  std::vector<uint8_t> nas_count;
-  nas_count.resize(4);
-  nas_count[0] = (nas_count_ >> 24) & 0xFF;
-  nas_count[1] = (nas_count_ >> 16) & 0xFF;
-  nas_count[2] = (nas_count_ >> 8) & 0xFF;
-  nas_count[3] = nas_count_ & 0xFF;
+  const uint8_t nas_count[4] = {
+      (uint8_t)(nas_count_ >> 24), (uint8_t)(nas_count_ >> 16), (uint8_t)(nas_count_ >> 8), (uint8_t)nas_count_};
 
   // Access Type Distinguisher 3GPP access = 0x01 (TS 33501 Annex A.9)
-  std::vector<uint8_t> access_type_distinguisher = {1};
+  const uint8_t access_type_distinguisher[1] = {1};
 
-  if (kdf_common(FC_5G_KGNB_KN3IWF_DERIVATION, k_amf, nas_count, access_type_distinguisher, k_gnb.data()) !=
+  if (kdf_common(FC_5G_KGNB_KN3IWF_DERIVATION, k_amf.data(), {nas_count, access_type_distinguisher}, k_gnb.data()) !=
       SRSRAN_SUCCESS) {
     log_error("Failed to run kdf_common");
     return SRSRAN_ERROR;
@@ -389,39 +402,10 @@ uint8_t security_generate_k_nas_5g(const uint8_t*                    k_amf,
     log_error("Invalid inputs");
     return SRSRAN_ERROR;
   }
-  std::array<uint8_t, 32> key;
-
-  memcpy(key.data(), k_amf, 32);
-
-  // Derive NAS ENC
-  // algorithm type distinguisher
-  std::vector<uint8_t> algo_distinguisher;
-  algo_distinguisher.resize(1);
-  algo_distinguisher[0] = ALGO_5G_DISTINGUISHER_NAS_ENC_ALG;
-
-  // algorithm type distinguisher
-  std::vector<uint8_t> algorithm_identity;
-  algorithm_identity.resize(1);
-  algorithm_identity[0] = enc_alg_id;
-
-  if (kdf_common(FC_5G_ALGORITHM_KEY_DERIVATION, key, algo_distinguisher, algorithm_identity, k_nas_enc) !=
-      SRSRAN_SUCCESS) {
-    log_error("Failed to run kdf_common");
-    return SRSRAN_ERROR;
-  }
 
-  // Derive NAS INT
-  // algorithm type distinguisher
-  algo_distinguisher.resize(1);
-  algo_distinguisher[0] = ALGO_5G_DISTINGUISHER_NAS_INT_ALG;
-
-  // algorithm type distinguisher
-  algorithm_identity.resize(1);
-  algorithm_identity[0] = int_alg_id;
-
-  // Derive NAS int
-  if (kdf_common(FC_5G_ALGORITHM_KEY_DERIVATION, key, algo_distinguisher, algorithm_identity, k_nas_int) !=
-      SRSRAN_SUCCESS) {
+  // Derive NAS ENC and NAS INT
+  if (kdf_5g_algorithm_key(k_amf, ALGO_5G_DISTINGUISHER_NAS_ENC_ALG, enc_alg_id, k_nas_enc) != SRSRAN_SUCCESS ||
+      kdf_5g_algorithm_key(k_amf, ALGO_5G_DISTINGUISHER_NAS_INT_ALG, int_alg_id, k_nas_int) != SRSRAN_SUCCESS) {
     log_error("Failed to run kdf_common");
     return SRSRAN_ERROR;
   }
@@ -563,39 +547,10 @@ uint8_t security_generate_k_nr_rrc(const uint8_t*                    k_gnb,
     log_error("Invalid inputs");
     return SRSRAN_ERROR;
   }
-  std::array<uint8_t, 32> key;
 
-  memcpy(key.data(), k_gnb, 32);
-
-  // Derive RRC ENC
-  // algorithm type distinguisher
-  std::vector<uint8_t> algo_distinguisher;
-  algo_distinguisher.resize(1);
-  algo_distinguisher[0] = ALGO_5G_DISTINGUISHER_RRC_ENC_ALG;
-
-  // algorithm type distinguisher
-  std::vector<uint8_t> algorithm_identity;
-  algorithm_identity.resize(1);
-  algorithm_identity[0] = enc_alg_id;
-
-  if (kdf_common(FC_5G_ALGORITHM_KEY_DERIVATION, key, algo_distinguisher, algorithm_identity, k_rrc_enc) !=
-      SRSRAN_SUCCESS) {
-    log_error("Failed to run kdf_common");
-    return SRSRAN_ERROR;
-  }
-
-  // Derive RRC INT
-  // algorithm type distinguisher
-  algo_distinguisher.resize(1);
-  algo_distinguisher[0] = ALGO_5G_DISTINGUISHER_RRC_INT_ALG;
-
-  // algorithm type distinguisher
-  algorithm_identity.resize(1);
-  algorithm_identity[0] = int_alg_id;
-
-  // Derive RRC int
-  if (kdf_common(FC_5G_ALGORITHM_KEY_DERIVATION, key, algo_distinguisher, algorithm_identity, k_rrc_int) !=
-      SRSRAN_SUCCESS) {
+  // Derive RRC ENC and RRC INT
+  if (kdf_5g_algorithm_key(k_gnb, ALGO_5G_DISTINGUISHER_RRC_ENC_ALG, enc_alg_id, k_rrc_enc) != SRSRAN_SUCCESS ||
+      kdf_5g_algorithm_key(k_gnb, ALGO_5G_DISTINGUISHER_RRC_INT_ALG, int_alg_id, k_rrc_int) != SRSRAN_SUCCESS) {
     log_error("Failed to run kdf_common");
     return SRSRAN_ERROR;
   }
@@ -612,39 +567,10 @@ uint8_t security_generate_k_nr_up(const uint8_t*                    k_gnb,
     log_error("Invalid inputs");
     return SRSRAN_ERROR;
   }
-  std::array<uint8_t, 32> key;
-
-  memcpy(key.data(), k_gnb, 32);
 
-  // Derive UP ENC
-  // algorithm type distinguisher
-  std::vector<uint8_t> algo_distinguisher;
-  algo_distinguisher.resize(1);
-  algo_distinguisher[0] = ALGO_5G_DISTINGUISHER_UP_ENC_ALG;
-
-  // algorithm type distinguisher
-  std::vector<uint8_t> algorithm_identity;
-  algorithm_identity.resize(1);
-  algorithm_identity[0] = enc_alg_id;
-
-  if (kdf_common(FC_5G_ALGORITHM_KEY_DERIVATION, key, algo_distinguisher, algorithm_identity, k_up_enc) !=
-      SRSRAN_SUCCESS) {
-    log_error("Failed to run kdf_common");
-    return SRSRAN_ERROR;
-  }
-
-  // Derive UP INT
-  // algorithm type distinguisher
-  algo_distinguisher.resize(1);
-  algo_distinguisher[0] = ALGO_5G_DISTINGUISHER_UP_INT_ALG;
-
-  // algorithm type distinguisher
-  algorithm_identity.resize(1);
-  algorithm_identity[0] = int_alg_id;
-
-  // Derive UP int
-  if (kdf_common(FC_5G_ALGORITHM_KEY_DERIVATION, key, algo_distinguisher, algorithm_identity, k_up_int) !=
-      SRSRAN_SUCCESS) {
+  // Derive UP ENC and UP INT
+  if (kdf_5g_algorithm_key(k_gnb, ALGO_5G_DISTINGUISHER_UP_ENC_ALG, enc_alg_id, k_up_enc) != SRSRAN_SUCCESS ||
+      kdf_5g_algorithm_key(k_gnb, ALGO_5G_DISTINGUISHER_UP_INT_ALG, int_alg_id, k_up_int) != SRSRAN_SUCCESS) {
     log_error("Failed to run kdf_common");
     return SRSRAN_ERROR;
   }
@@ -663,29 +589,20 @@ uint8_t security_generate_res_star(const uint8_t* ck,
     log_error("Invalid inputs");
     return SRSRAN_ERROR;
   }
-  std::array<uint8_t, 32> key;
-
   // The input key Key shall be equal to the concatenation CK || IK of CK and IK.
-  memcpy(key.data(), ck, 16);
-  memcpy(key.data() + 16, ik, 16);
-
-  // Serving Network Name
-  std::vector<uint8_t> ssn;
-  ssn.resize(strlen(serving_network_name));
-  memcpy(ssn.data(), serving_network_name, strlen(serving_network_name));
+  uint8_t key[32];
+  memcpy(key, ck, 16);
+  memcpy(key + 16, ik, 16);
 
-  // RAND
-  std::vector<uint8_t> rand;
-  rand.resize(AKA_RAND_LEN);
-  memcpy(rand.data(), rand_, rand.size());
-
-  // RES
-  std::vector<uint8_t> res;
-  res.resize(res_len_);
-  memcpy(res.data(), res_, res.size());
+  // P0 = serving network name, P1 = RAND, P2 = RES
+  span<const uint8_t> ssn((const uint8_t*)serving_network_name, strlen(serving_network_name));
+  span<const uint8_t> rand(rand_, AKA_RAND_LEN);
+  span<const uint8_t> res(res_, res_len_);
 
   uint8_t output[32];
-  if (kdf_common(FC_5G_RES_STAR_DERIVATION, key, ssn, rand, res, output) != SRSRAN_SUCCESS) {
+  int     ret = kdf_common(FC_5G_RES_STAR_DERIVATION, key, {ssn, rand, res}, output);
+  secure_wipe(key, sizeof(key));
+  if (ret != SRSRAN_SUCCESS) {
     log_error("Failed to run kdf_common");
     return SRSRAN_ERROR;
   }
@@ -694,122 +611,438 @@ uint8_t security_generate_res_star(const uint8_t* ck,
   return SRSRAN_SUCCESS;
 }
 
-int kdf_common(const uint8_t fc, const std::array<uint8_t, 32>& key, const std::vector<uint8_t>& P0, uint8_t* output)
+/******************************************************************************
+ * KDF Cache
+ *****************************************************************************/
+
+namespace {
+
+// Set associative, least recently used entry of the set is replaced. Keyed by the KDF key and S, which are compared in
+// full on a hit
+class kdf_cache
 {
-  uint8_t* s;
-  uint32_t s_len = 1 + P0.size() + 2;
+public:
+  static const uint32_t nof_sets  = 64;
+  static const uint32_t nof_ways  = 4;
+  static const uint32_t max_s_len = 32;
+
+  ~kdf_cache() { clear(); }
+
+  bool find(const uint8_t* key, const uint8_t* s, uint32_t s_len, uint8_t* output)
+  {
+    uint64_t                    h = hash(key, s, s_len);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (entry_t& e : sets[h % nof_sets]) {
+      if (e.valid && e.hash == h && e.s_len == s_len && memcmp(e.key, key, 32) == 0 && memcmp(e.s, s, s_len) == 0) {
+        e.last_use = ++tick;
+        memcpy(output, e.output, 32);
+        metrics.hits++;
+        return true;
+      }
+    }
+    metrics.misses++;
+    return false;
+  }
 
-  s = (uint8_t*)calloc(s_len, sizeof(uint8_t));
+  void insert(const uint8_t* key, const uint8_t* s, uint32_t s_len, const uint8_t* output)
+  {
+    uint64_t                    h = hash(key, s, s_len);
+    std::lock_guard<std::mutex> lock(mutex);
+    entry_t*                    victim = &sets[h % nof_sets][0];
+    for (entry_t& e : sets[h % nof_sets]) {
+      if (not e.valid) {
+        victim = &e;
+        break;
+      }
+      if (e.last_use < victim->last_use) {
+        victim = &e;
+      }
+    }
+    secure_wipe(victim, sizeof(entry_t));
+    victim->valid    = true;
+    victim->hash     = h;
+    victim->last_use = ++tick;
+    victim->s_len    = s_len;
+    memcpy(victim->key, key, 32);
+    memcpy(victim->s, s, s_len);
+    memcpy(victim->output, output, 32);
+  }
 
-  if (s == nullptr) {
-    log_error("Unable to allocate memory in %s()", __FUNCTION__);
-    return SRSRAN_ERROR;
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    secure_wipe(sets, sizeof(sets));
   }
 
-  uint32_t i = 0;
-  s[i]       = fc; // FC
-  i++;
+  kdf_cache_metrics_t get_metrics()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return metrics;
+  }
 
-  // P0
-  memcpy(&s[i], P0.data(), P0.size());
-  i += P0.size();
-  uint16_t p0_length_value = htons(P0.size());
-  memcpy(&s[i], &p0_length_value, sizeof(p0_length_value));
-  i += sizeof(p0_length_value);
+private:
+  struct entry_t {
+    bool     valid;
+    uint64_t hash;
+    uint64_t last_use;
+    uint32_t s_len;
+    uint8_t  key[32];
+    uint8_t  s[max_s_len];
+    uint8_t  output[32];
+  };
+
+  // FNV-1a over key || S
+  static uint64_t hash(const uint8_t* key, const uint8_t* s, uint32_t s_len)
+  {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < 32; i++) {
+      h = (h ^ key[i]) * 0x100000001b3ULL;
+    }
+    for (uint32_t i = 0; i < s_len; i++) {
+      h = (h ^ s[i]) * 0x100000001b3ULL;
+    }
+    return h ^ (h >> 32);
+  }
+
+  std::mutex          mutex;
+  entry_t             sets[nof_sets][nof_ways] = {};
+  uint64_t            tick                     = 0;
+  kdf_cache_metrics_t metrics                  = {};
+};
+
+kdf_cache kdf_cache_instance;
 
-  sha256(key.data(), key.size(), s, i, output, 0);
-  free(s);
+} // namespace
+
+void kdf_cache_clear()
+{
+  kdf_cache_instance.clear();
+}
+
+kdf_cache_metrics_t kdf_cache_get_metrics()
+{
+  return kdf_cache_instance.get_metrics();
+}
+
+int kdf_common(const uint8_t fc, const uint8_t* key, std::initializer_list<span<const uint8_t> > params, uint8_t* output)
+{
+  // S = FC || P0 || L0 || P1 || L1 || ...
+  uint8_t  s[KDF_MAX_S_LEN];
+  uint32_t i = 0;
+  s[i++]     = fc;
+  for (const span<const uint8_t>& p : params) {
+    if (i + p.size() + 2 > sizeof(s)) {
+      log_error("KDF input S exceeds %d bytes", KDF_MAX_S_LEN);
+      secure_wipe(s, i);
+      return SRSRAN_ERROR;
+    }
+    if (not p.empty()) {
+      memcpy(&s[i], p.data(), p.size());
+    }
+    i += p.size();
+    uint16_t length_value = htons(p.size());
+    memcpy(&s[i], &length_value, sizeof(length_value));
+    i += sizeof(length_value);
+  }
+
+  bool cacheable = i <= kdf_cache::max_s_len;
+  if (not cacheable || not kdf_cache_instance.find(key, s, i, output)) {
+    sha256(key, 32, s, i, output, 0);
+    if (cacheable) {
+      kdf_cache_instance.insert(key, s, i, output);
+    }
+  }
+  secure_wipe(s, i);
 
   return SRSRAN_SUCCESS;
 }
 
+int kdf_common(const uint8_t fc, const std::array<uint8_t, 32>& key, const std::vector<uint8_t>& P0, uint8_t* output)
+{
+  return kdf_common(fc, key.data(), {P0}, output);
+}
+
+int kdf_common(const uint8_t                  fc,
+               const std::array<uint8_t, 32>& key,
+               const std::vector<uint8_t>&    P0,
+               const std::vector<uint8_t>&    P1,
+               uint8_t*                       output)
+{
+  return kdf_common(fc, key.data(), {P0, P1}, output);
+}
+
 int kdf_common(const uint8_t                  fc,
                const std::array<uint8_t, 32>& key,
                const std::vector<uint8_t>&    P0,
                const std::vector<uint8_t>&    P1,
+               const std::vector<uint8_t>&    P2,
                uint8_t*                       output)
 {
-  uint8_t* s;
-  uint32_t s_len = 1 + P0.size() + 2 + P1.size() + 2;
+  return kdf_common(fc, key.data(), {P0, P1, P2}, output);
+}
+
+/******************************************************************************
+ * Keyed Contexts
+ *****************************************************************************/
 
-  s = (uint8_t*)calloc(s_len, sizeof(uint8_t));
+#ifdef LV_HAVE_AESNI
 
-  if (s == nullptr) {
-    log_error("Unable to allocate memory in %s()", __FUNCTION__);
-    return SRSRAN_ERROR;
+#define AES128_EXPAND_ROUND(i, rcon)                                                                                   \
+  do {                                                                                                                 \
+    __m128i t = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k, rcon), 0xff);                                          \
+    k         = _mm_xor_si128(k, _mm_slli_si128(k, 4));                                                                \
+    k         = _mm_xor_si128(k, _mm_slli_si128(k, 4));                                                                \
+    k         = _mm_xor_si128(k, _mm_slli_si128(k, 4));                                                                \
+    k         = _mm_xor_si128(k, t);                                                                                   \
+    _mm_store_si128((__m128i*)aes.rk[i], k);                                                                           \
+  } while (0)
+
+static void aes128_set_key(security_aes128_key_t& aes, const uint8_t* key)
+{
+  __m128i k = _mm_loadu_si128((const __m128i*)key);
+  _mm_store_si128((__m128i*)aes.rk[0], k);
+  AES128_EXPAND_ROUND(1, 0x01);
+  AES128_EXPAND_ROUND(2, 0x02);
+  AES128_EXPAND_ROUND(3, 0x04);
+  AES128_EXPAND_ROUND(4, 0x08);
+  AES128_EXPAND_ROUND(5, 0x10);
+  AES128_EXPAND_ROUND(6, 0x20);
+  AES128_EXPAND_ROUND(7, 0x40);
+  AES128_EXPAND_ROUND(8, 0x80);
+  AES128_EXPAND_ROUND(9, 0x1b);
+  AES128_EXPAND_ROUND(10, 0x36);
+}
+
+#undef AES128_EXPAND_ROUND
+
+static inline __m128i aes128_encrypt(const security_aes128_key_t& aes, __m128i b)
+{
+  b = _mm_xor_si128(b, _mm_load_si128((const __m128i*)aes.rk[0]));
+  for (uint32_t r = 1; r < 10; r++) {
+    b = _mm_aesenc_si128(b, _mm_load_si128((const __m128i*)aes.rk[r]));
   }
+  return _mm_aesenclast_si128(b, _mm_load_si128((const __m128i*)aes.rk[10]));
+}
 
-  uint32_t i = 0;
-  s[i]       = fc; // FC
-  i++;
+// Four independent blocks, so that the AES rounds of consecutive counters overlap in the pipeline
+static inline void aes128_encrypt_x4(const security_aes128_key_t& aes, __m128i* b)
+{
+  __m128i rk = _mm_load_si128((const __m128i*)aes.rk[0]);
+  for (uint32_t j = 0; j < 4; j++) {
+    b[j] = _mm_xor_si128(b[j], rk);
+  }
+  for (uint32_t r = 1; r < 10; r++) {
+    rk = _mm_load_si128((const __m128i*)aes.rk[r]);
+    for (uint32_t j = 0; j < 4; j++) {
+      b[j] = _mm_aesenc_si128(b[j], rk);
+    }
+  }
+  rk = _mm_load_si128((const __m128i*)aes.rk[10]);
+  for (uint32_t j = 0; j < 4; j++) {
+    b[j] = _mm_aesenclast_si128(b[j], rk);
+  }
+}
 
-  // P0
-  memcpy(&s[i], P0.data(), P0.size());
-  i += P0.size();
-  uint16_t p0_length_value = htons(P0.size());
-  memcpy(&s[i], &p0_length_value, sizeof(p0_length_value));
-  i += sizeof(p0_length_value);
+static void aes128_encrypt_block(const security_aes128_key_t& aes, const uint8_t* in, uint8_t* out)
+{
+  _mm_storeu_si128((__m128i*)out, aes128_encrypt(aes, _mm_loadu_si128((const __m128i*)in)));
+}
+
+#else // LV_HAVE_AESNI
+
+static void aes128_set_key(security_aes128_key_t& aes, const uint8_t* key)
+{
+  aes_setkey_enc(&aes.ctx, key, 128);
+}
 
-  // P1
-  memcpy(&s[i], P1.data(), P1.size());
-  i += P1.size();
-  uint16_t p1_length_value = htons(P1.size());
-  memcpy(&s[i], &p1_length_value, sizeof(p1_length_value));
-  i += sizeof(p1_length_value);
+static void aes128_encrypt_block(const security_aes128_key_t& aes, const uint8_t* in, uint8_t* out)
+{
+  aes_crypt_ecb(&aes.ctx, AES_ENCRYPT, in, out);
+}
 
-  sha256(key.data(), key.size(), s, i, output, 0);
-  free(s);
+#endif // LV_HAVE_AESNI
 
+// Doubling in GF(2^128), RFC 4493 subkey generation
+static void cmac_subkey_shift(const uint8_t* in, uint8_t* out)
+{
+  for (uint32_t i = 0; i < 15; i++) {
+    out[i] = (in[i] << 1) | (in[i + 1] >> 7);
+  }
+  out[15] = in[15] << 1;
+  if (in[0] & 0x80) {
+    out[15] ^= 0x87;
+  }
+}
+
+uint8_t security_128_eia2_init(security_128_eia2_ctx_t& ctx, const uint8_t* key)
+{
+  const uint8_t zero[16] = {};
+  uint8_t       L[16];
+
+  if (key == nullptr) {
+    return SRSRAN_ERROR;
+  }
+  aes128_set_key(ctx.aes, key);
+  aes128_encrypt_block(ctx.aes, zero, L);
+  cmac_subkey_shift(L, ctx.k1);
+  cmac_subkey_shift(ctx.k1, ctx.k2);
   return SRSRAN_SUCCESS;
 }
 
-int kdf_common(const uint8_t                  fc,
-               const std::array<uint8_t, 32>& key,
-               const std::vector<uint8_t>&    P0,
-               const std::vector<uint8_t>&    P1,
-               const std::vector<uint8_t>&    P2,
-               uint8_t*                       output)
+uint8_t security_128_eea2_init(security_128_eea2_ctx_t& ctx, const uint8_t* key)
+{
+  if (key == nullptr) {
+    return SRSRAN_ERROR;
+  }
+  aes128_set_key(ctx.aes, key);
+  return SRSRAN_SUCCESS;
+}
+
+// Copies len bytes of M = COUNT || BEARER || DIRECTION || 0^26 || MESSAGE from offset off, without materialising M
+static void eia2_copy_m(const uint8_t* hdr, const uint8_t* msg, uint32_t off, uint32_t len, uint8_t* out)
 {
-  uint8_t* s;
-  uint32_t s_len = 1 + P0.size() + 2 + P1.size() + 2 + P2.size() + 2;
+  for (; len > 0 && off < 8; off++, len--) {
+    *out++ = hdr[off];
+  }
+  memcpy(out, msg + off - 8, len);
+}
 
-  s = (uint8_t*)calloc(s_len, sizeof(uint8_t));
+// Builds the first block of M (which holds the header) and the last one, padded and XORed with its subkey. Returns
+// the number of blocks; blocks 0 < i < n - 1 are read from the message itself
+static uint32_t eia2_prepare(const security_128_eia2_ctx_t& ctx,
+                             uint32_t                       count,
+                             uint32_t                       bearer,
+                             uint8_t                        direction,
+                             const uint8_t*                 msg,
+                             uint32_t                       msg_len,
+                             uint8_t*                       first,
+                             uint8_t*                       last)
+{
+  uint8_t hdr[8] = {};
+  hdr[0]         = (count >> 24) & 0xff;
+  hdr[1]         = (count >> 16) & 0xff;
+  hdr[2]         = (count >> 8) & 0xff;
+  hdr[3]         = count & 0xff;
+  hdr[4]         = ((bearer & 0x1f) << 3) | ((direction & 0x01) << 2);
+
+  // The last block is complete (K1) or padded with 10* (K2)
+  uint32_t m_len    = msg_len + 8;
+  uint32_t n        = (m_len + 15) / 16;
+  uint32_t last_len = m_len - 16 * (n - 1);
+  memset(last, 0, 16);
+  eia2_copy_m(hdr, msg, 0, std::min(m_len, 16U), first);
+  eia2_copy_m(hdr, msg, 16 * (n - 1), last_len, last);
+  const uint8_t* k = ctx.k1;
+  if (last_len < 16) {
+    last[last_len] = 0x80;
+    k              = ctx.k2;
+  }
+  for (uint32_t j = 0; j < 16; j++) {
+    last[j] ^= k[j];
+  }
+  return n;
+}
 
-  if (s == nullptr) {
-    log_error("Unable to allocate memory in %s()", __FUNCTION__);
+uint8_t security_128_eia2(const security_128_eia2_ctx_t& ctx,
+                          uint32_t                       count,
+                          uint32_t                       bearer,
+                          uint8_t                        direction,
+                          const uint8_t*                 msg,
+                          uint32_t                       msg_len,
+                          uint8_t*                       mac)
+{
+  if ((msg == nullptr && msg_len > 0) || mac == nullptr) {
     return SRSRAN_ERROR;
   }
 
-  uint32_t i = 0;
-  s[i]       = fc; // FC
-  i++;
+  uint8_t  first[16];
+  uint8_t  last[16];
+  uint32_t n = eia2_prepare(ctx, count, bearer, direction, msg, msg_len, first, last);
 
-  // P0
-  memcpy(&s[i], P0.data(), P0.size());
-  i += P0.size();
-  uint16_t p0_length_value = htons(P0.size());
-  memcpy(&s[i], &p0_length_value, sizeof(p0_length_value));
-  i += sizeof(p0_length_value);
+#ifdef LV_HAVE_AESNI
+  __m128i T = _mm_setzero_si128();
+  for (uint32_t i = 0; i + 1 < n; i++) {
+    const uint8_t* blk = (i == 0) ? first : msg + 16 * i - 8;
+    T                  = aes128_encrypt(ctx.aes, _mm_xor_si128(T, _mm_loadu_si128((const __m128i*)blk)));
+  }
+  T = aes128_encrypt(ctx.aes, _mm_xor_si128(T, _mm_loadu_si128((const __m128i*)last)));
+  uint8_t t[16];
+  _mm_storeu_si128((__m128i*)t, T);
+#else  // LV_HAVE_AESNI
+  uint8_t t[16] = {};
+  uint8_t tmp[16];
+  for (uint32_t i = 0; i + 1 < n; i++) {
+    const uint8_t* blk = (i == 0) ? first : msg + 16 * i - 8;
+    for (uint32_t j = 0; j < 16; j++) {
+      tmp[j] = t[j] ^ blk[j];
+    }
+    aes128_encrypt_block(ctx.aes, tmp, t);
+  }
+  for (uint32_t j = 0; j < 16; j++) {
+    tmp[j] = t[j] ^ last[j];
+  }
+  aes128_encrypt_block(ctx.aes, tmp, t);
+#endif // LV_HAVE_AESNI
 
-  // P1
-  memcpy(&s[i], P1.data(), P1.size());
-  i += P1.size();
-  uint16_t p1_length_value = htons(P1.size());
-  memcpy(&s[i], &p1_length_value, sizeof(p1_length_value));
-  i += sizeof(p1_length_value);
+  memcpy(mac, t, 4);
+  return SRSRAN_SUCCESS;
+}
 
-  // P2
-  memcpy(&s[i], P2.data(), P2.size());
-  i += P2.size();
-  uint16_t p2_length_value = htons(P2.size());
-  memcpy(&s[i], &p2_length_value, sizeof(p2_length_value));
-  i += sizeof(p2_length_value);
+uint8_t security_128_eea2(const security_128_eea2_ctx_t& ctx,
+                          uint32_t                       count,
+                          uint8_t                        bearer,
+                          uint8_t                        direction,
+                          const uint8_t*                 msg,
+                          uint32_t                       msg_len,
+                          uint8_t*                       msg_out)
+{
+  if ((msg == nullptr || msg_out == nullptr) && msg_len > 0) {
+    return SRSRAN_ERROR;
+  }
 
-  sha256(key.data(), key.size(), s, i, output, 0);
-  free(s);
+  // Initial counter block: COUNT || BEARER || DIRECTION || 0^26, followed by a 64-bit block counter
+  uint8_t nonce_cnt[16] = {};
+  nonce_cnt[0]          = (count >> 24) & 0xff;
+  nonce_cnt[1]          = (count >> 16) & 0xff;
+  nonce_cnt[2]          = (count >> 8) & 0xff;
+  nonce_cnt[3]          = count & 0xff;
+  nonce_cnt[4]          = ((bearer & 0x1f) << 3) | ((direction & 0x01) << 2);
+
+#ifdef LV_HAVE_AESNI
+  const __m128i nonce = _mm_loadu_si128((const __m128i*)nonce_cnt);
+  uint64_t      blk   = 0;
+  uint32_t      i     = 0;
+  for (; i + 64 <= msg_len; i += 64, blk += 4) {
+    __m128i ks[4];
+    for (uint32_t j = 0; j < 4; j++) {
+      ks[j] = _mm_insert_epi64(nonce, (int64_t)__builtin_bswap64(blk + j), 1);
+    }
+    aes128_encrypt_x4(ctx.aes, ks);
+    for (uint32_t j = 0; j < 4; j++) {
+      __m128i m = _mm_loadu_si128((const __m128i*)(msg + i + 16 * j));
+      _mm_storeu_si128((__m128i*)(msg_out + i + 16 * j), _mm_xor_si128(m, ks[j]));
+    }
+  }
+  for (; i < msg_len; i += 16, blk++) {
+    uint8_t ks[16];
+    __m128i ctr = _mm_insert_epi64(nonce, (int64_t)__builtin_bswap64(blk), 1);
+    _mm_storeu_si128((__m128i*)ks, aes128_encrypt(ctx.aes, ctr));
+    uint32_t len = std::min(msg_len - i, 16U);
+    for (uint32_t j = 0; j < len; j++) {
+      msg_out[i + j] = msg[i + j] ^ ks[j];
+    }
+  }
+#else  // LV_HAVE_AESNI
+  uint8_t stream_blk[16] = {};
+  size_t  nc_off         = 0;
+  if (aes_crypt_ctr(&ctx.aes.ctx, msg_len, &nc_off, nonce_cnt, stream_blk, msg, msg_out) != 0) {
+    return SRSRAN_ERROR;
+  }
+#endif // LV_HAVE_AESNI
 
   return SRSRAN_SUCCESS;
 }
+
 /******************************************************************************
  * Integrity Protection
  *****************************************************************************/
@@ -833,7 +1066,11 @@ uint8_t security_128_eia2(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac)
 {
-  return liblte_security_128_eia2(key, count, bearer, direction, msg, msg_len, mac);
+  security_128_eia2_ctx_t ctx;
+  if (security_128_eia2_init(ctx, key) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  return security_128_eia2(ctx, count, bearer, direction, msg, msg_len, mac);
 }
 
 uint8_t security_128_eia3(const uint8_t* key,
@@ -882,7 +1119,11 @@ uint8_t security_128_eea2(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out)
 {
-  return liblte_security_encryption_eea2(key, count, bearer, direction, msg, msg_len * 8, msg_out);
+  security_128_eea2_ctx_t ctx;
+  if (security_128_eea2_init(ctx, key) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  return security_128_eea2(ctx, count, bearer, direction, msg, msg_len, msg_out);
 }
 
 uint8_t security_128_eea3(uint8_t* key,
@@ -896,6 +1137,281 @@ uint8_t security_128_eea3(uint8_t* key,
   return liblte_security_encryption_eea3(key, count, bearer, direction, msg, msg_len * 8, msg_out);
 }
 
+/******************************************************************************
+ * Batched Processing
+ *****************************************************************************/
+
+// PDUs handed to the multi-buffer keystream generators at a time
+#define SECURITY_BATCH_CHUNK 64
+
+static bool security_batch_valid(span<const security_pdu_t> pdus)
+{
+  for (const security_pdu_t& pdu : pdus) {
+    if ((pdu.msg == nullptr && pdu.msg_len > 0) || pdu.out == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint8_t security_128_eia1_batch(const uint8_t* key, uint32_t bearer, uint8_t direction, span<const security_pdu_t> pdus)
+{
+  if (key == nullptr || not security_batch_valid(pdus)) {
+    return SRSRAN_ERROR;
+  }
+  for (const security_pdu_t& pdu : pdus) {
+    security_128_eia1(key, pdu.count, bearer, direction, (uint8_t*)pdu.msg, pdu.msg_len, pdu.out);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+uint8_t security_128_eia2_batch(const security_128_eia2_ctx_t& ctx,
+                                uint32_t                       bearer,
+                                uint8_t                        direction,
+                                span<const security_pdu_t>     pdus)
+{
+  if (not security_batch_valid(pdus)) {
+    return SRSRAN_ERROR;
+  }
+
+#ifdef LV_HAVE_AESNI
+  // CBC-MAC is sequential within a PDU, so four PDUs are chained side by side. A lane takes the next PDU of the batch
+  // as soon as its MAC is done
+  struct lane_t {
+    const security_pdu_t* pdu;
+    uint32_t              blk;
+    uint32_t              n;
+    __m128i               T;
+    uint8_t               first[16];
+    uint8_t               last[16];
+  };
+  lane_t lanes[4] = {};
+  size_t next     = 0;
+  while (true) {
+    bool    busy = false;
+    __m128i b[4];
+    for (uint32_t j = 0; j < 4; j++) {
+      lane_t& l = lanes[j];
+      if (l.pdu == nullptr && next < pdus.size()) {
+        l.pdu = &pdus[next++];
+        l.blk = 0;
+        l.n   = eia2_prepare(ctx, l.pdu->count, bearer, direction, l.pdu->msg, l.pdu->msg_len, l.first, l.last);
+        l.T   = _mm_setzero_si128();
+      }
+      if (l.pdu == nullptr) {
+        b[j] = _mm_setzero_si128();
+        continue;
+      }
+      const uint8_t* blk = (l.blk + 1 == l.n) ? l.last : (l.blk == 0) ? l.first : l.pdu->msg + 16 * l.blk - 8;
+      b[j]               = _mm_xor_si128(l.T, _mm_loadu_si128((const __m128i*)blk));
+      busy               = true;
+    }
+    if (not busy) {
+      break;
+    }
+    aes128_encrypt_x4(ctx.aes, b);
+    for (uint32_t j = 0; j < 4; j++) {
+      lane_t& l = lanes[j];
+      if (l.pdu == nullptr) {
+        continue;
+      }
+      l.T = b[j];
+      if (++l.blk == l.n) {
+        uint8_t t[16];
+        _mm_storeu_si128((__m128i*)t, l.T);
+        memcpy(l.pdu->out, t, 4);
+        l.pdu = nullptr;
+      }
+    }
+  }
+#else  // LV_HAVE_AESNI
+  for (const security_pdu_t& pdu : pdus) {
+    security_128_eia2(ctx, pdu.count, bearer, direction, pdu.msg, pdu.msg_len, pdu.out);
+  }
+#endif // LV_HAVE_AESNI
+
+  return SRSRAN_SUCCESS;
+}
+
+uint8_t security_128_eia3_batch(const uint8_t* key, uint32_t bearer, uint8_t direction, span<const security_pdu_t> pdus)
+{
+  if (key == nullptr || not security_batch_valid(pdus)) {
+    return SRSRAN_ERROR;
+  }
+  for (const security_pdu_t& pdu : pdus) {
+    security_128_eia3(key, pdu.count, bearer, direction, (uint8_t*)pdu.msg, pdu.msg_len, pdu.out);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// XORs a keystream of 32-bit words, most significant byte first, into the PDU
+static void security_xor_keystream(const security_pdu_t& pdu, const uint32_t* ks)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= pdu.msg_len; i += 4) {
+    uint32_t m;
+    memcpy(&m, pdu.msg + i, 4);
+    m ^= htonl(ks[i / 4]);
+    memcpy(pdu.out + i, &m, 4);
+  }
+  for (; i < pdu.msg_len; i++) {
+    pdu.out[i] = pdu.msg[i] ^ (uint8_t)(ks[i / 4] >> (24 - 8 * (i % 4)));
+  }
+}
+
+uint8_t security_128_eea1_batch(const uint8_t* key, uint8_t bearer, uint8_t direction, span<const security_pdu_t> pdus)
+{
+  if (key == nullptr || not security_batch_valid(pdus)) {
+    return SRSRAN_ERROR;
+  }
+
+  // Key and IV words as taken by s3g_initialize() (TS 33.401 B.1.2)
+  uint32_t k[4];
+  for (uint32_t i = 0; i < 4; i++) {
+    k[3 - i] = ((uint32_t)key[4 * i] << 24) | (key[4 * i + 1] << 16) | (key[4 * i + 2] << 8) | key[4 * i + 3];
+  }
+  uint32_t              iv[SECURITY_BATCH_CHUNK][4];
+  s3g_mb_job_t          jobs[SECURITY_BATCH_CHUNK];
+  std::vector<uint32_t> ks;
+  for (size_t first = 0; first < pdus.size(); first += SECURITY_BATCH_CHUNK) {
+    uint32_t nof_pdus = std::min(pdus.size() - first, (size_t)SECURITY_BATCH_CHUNK);
+    uint32_t nof_ks   = 0;
+    for (uint32_t j = 0; j < nof_pdus; j++) {
+      nof_ks += (pdus[first + j].msg_len + 3) / 4;
+    }
+    ks.resize(nof_ks);
+    nof_ks = 0;
+    for (uint32_t j = 0; j < nof_pdus; j++) {
+      const security_pdu_t& pdu = pdus[first + j];
+      iv[j][3]                  = pdu.count;
+      iv[j][2]                  = ((bearer & 0x1f) << 27) | ((direction & 0x01) << 26);
+      iv[j][1]                  = iv[j][3];
+      iv[j][0]                  = iv[j][2];
+      jobs[j]                   = {k, iv[j], ks.data() + nof_ks, (pdu.msg_len + 3) / 4};
+      nof_ks += jobs[j].n;
+    }
+    s3g_generate_keystream_mb(jobs, nof_pdus);
+    for (uint32_t j = 0; j < nof_pdus; j++) {
+      security_xor_keystream(pdus[first + j], jobs[j].ks);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+uint8_t security_128_eea2_batch(const security_128_eea2_ctx_t& ctx,
+                                uint8_t                        bearer,
+                                uint8_t                        direction,
+                                span<const security_pdu_t>     pdus)
+{
+  if (not security_batch_valid(pdus)) {
+    return SRSRAN_ERROR;
+  }
+
+#ifdef LV_HAVE_AESNI
+  // Whole groups of four counter blocks are encrypted as for a single PDU. The remaining blocks at the tail of each PDU
+  // are queued across PDUs, so that short PDUs and the tails of long ones still fill the AES pipeline
+  struct ctr_blk_t {
+    const uint8_t* in;
+    uint8_t*       out;
+    uint32_t       len;
+  };
+  __m128i   tail_ks[4];
+  ctr_blk_t tail[4];
+  uint32_t  nof_tail = 0;
+  auto      flush    = [&]() {
+    for (uint32_t j = nof_tail; j < 4; j++) {
+      tail_ks[j] = _mm_setzero_si128();
+    }
+    aes128_encrypt_x4(ctx.aes, tail_ks);
+    for (uint32_t j = 0; j < nof_tail; j++) {
+      if (tail[j].len == 16) {
+        __m128i m = _mm_loadu_si128((const __m128i*)tail[j].in);
+        _mm_storeu_si128((__m128i*)tail[j].out, _mm_xor_si128(m, tail_ks[j]));
+      } else {
+        uint8_t k[16];
+        _mm_storeu_si128((__m128i*)k, tail_ks[j]);
+        for (uint32_t i = 0; i < tail[j].len; i++) {
+          tail[j].out[i] = tail[j].in[i] ^ k[i];
+        }
+      }
+    }
+    nof_tail = 0;
+  };
+  for (const security_pdu_t& pdu : pdus) {
+    // COUNT || BEARER || DIRECTION || 0^26, followed by the 64-bit block counter
+    const __m128i nonce =
+        _mm_set_epi32(0, 0, ((bearer & 0x1f) << 3) | ((direction & 0x01) << 2), (int)__builtin_bswap32(pdu.count));
+    uint64_t blk = 0;
+    uint32_t i   = 0;
+    for (; i + 64 <= pdu.msg_len; i += 64, blk += 4) {
+      __m128i ks[4];
+      for (uint32_t j = 0; j < 4; j++) {
+        ks[j] = _mm_insert_epi64(nonce, (int64_t)__builtin_bswap64(blk + j), 1);
+      }
+      aes128_encrypt_x4(ctx.aes, ks);
+      for (uint32_t j = 0; j < 4; j++) {
+        __m128i m = _mm_loadu_si128((const __m128i*)(pdu.msg + i + 16 * j));
+        _mm_storeu_si128((__m128i*)(pdu.out + i + 16 * j), _mm_xor_si128(m, ks[j]));
+      }
+    }
+    for (; i < pdu.msg_len; i += 16, blk++) {
+      tail_ks[nof_tail] = _mm_insert_epi64(nonce, (int64_t)__builtin_bswap64(blk), 1);
+      tail[nof_tail]    = {pdu.msg + i, pdu.out + i, std::min(pdu.msg_len - i, 16U)};
+      if (++nof_tail == 4) {
+        flush();
+      }
+    }
+  }
+  if (nof_tail > 0) {
+    flush();
+  }
+#else  // LV_HAVE_AESNI
+  for (const security_pdu_t& pdu : pdus) {
+    security_128_eea2(ctx, pdu.count, bearer, direction, pdu.msg, pdu.msg_len, pdu.out);
+  }
+#endif // LV_HAVE_AESNI
+
+  return SRSRAN_SUCCESS;
+}
+
+uint8_t security_128_eea3_batch(const uint8_t* key, uint8_t bearer, uint8_t direction, span<const security_pdu_t> pdus)
+{
+  if (key == nullptr || not security_batch_valid(pdus)) {
+    return SRSRAN_ERROR;
+  }
+
+  // IV = COUNT || BEARER || DIRECTION || 0^26, twice (TS 33.401 B.1.4)
+  uint8_t               iv[SECURITY_BATCH_CHUNK][16];
+  zuc_mb_job_t          jobs[SECURITY_BATCH_CHUNK];
+  std::vector<uint32_t> ks;
+  for (size_t first = 0; first < pdus.size(); first += SECURITY_BATCH_CHUNK) {
+    uint32_t nof_pdus = std::min(pdus.size() - first, (size_t)SECURITY_BATCH_CHUNK);
+    uint32_t nof_ks   = 0;
+    for (uint32_t j = 0; j < nof_pdus; j++) {
+      nof_ks += (pdus[first + j].msg_len + 3) / 4;
+    }
+    ks.resize(nof_ks);
+    nof_ks = 0;
+    for (uint32_t j = 0; j < nof_pdus; j++) {
+      const security_pdu_t& pdu = pdus[first + j];
+      memset(iv[j], 0, 16);
+      iv[j][0] = (pdu.count >> 24) & 0xff;
+      iv[j][1] = (pdu.count >> 16) & 0xff;
+      iv[j][2] = (pdu.count >> 8) & 0xff;
+      iv[j][3] = pdu.count & 0xff;
+      iv[j][4] = ((bearer & 0x1f) << 3) | ((direction & 0x01) << 2);
+      memcpy(&iv[j][8], iv[j], 8);
+      jobs[j] = {key, iv[j], ks.data() + nof_ks, (int)((pdu.msg_len + 3) / 4)};
+      nof_ks += jobs[j].key_stream_len;
+    }
+    zuc_generate_keystream_mb(jobs, nof_pdus);
+    for (uint32_t j = 0; j < nof_pdus; j++) {
+      security_xor_keystream(pdus[first + j], jobs[j].ks);
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
@@ -967,4 +1483,146 @@ int security_xor_f1(uint8_t* k, uint8_t* rand, uint8_t* sqn, uint8_t* amf, uint8
   return SRSRAN_SUCCESS;
 }
 
+/******************************************************************************
+ * Authentication Vector Generation
+ *****************************************************************************/
+
+// Encrypts four blocks in place, each under its own key schedule
+static void aes128_encrypt_4(const security_aes128_key_t* const aes[4], uint8_t blk[4][16])
+{
+#ifdef LV_HAVE_AESNI
+  __m128i b[4];
+  for (uint32_t j = 0; j < 4; j++) {
+    b[j] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)blk[j]), _mm_load_si128((const __m128i*)aes[j]->rk[0]));
+  }
+  for (uint32_t r = 1; r < 10; r++) {
+    for (uint32_t j = 0; j < 4; j++) {
+      b[j] = _mm_aesenc_si128(b[j], _mm_load_si128((const __m128i*)aes[j]->rk[r]));
+    }
+  }
+  for (uint32_t j = 0; j < 4; j++) {
+    _mm_storeu_si128((__m128i*)blk[j], _mm_aesenclast_si128(b[j], _mm_load_si128((const __m128i*)aes[j]->rk[10])));
+  }
+#else  // LV_HAVE_AESNI
+  uint8_t in[16];
+  for (uint32_t j = 0; j < 4; j++) {
+    memcpy(in, blk[j], 16);
+    aes128_encrypt_block(*aes[j], in, blk[j]);
+  }
+#endif // LV_HAVE_AESNI
+}
+
+uint8_t security_milenage_subscriber_init(security_milenage_subscriber_t& sub, const uint8_t* k, const uint8_t* opc)
+{
+  if (k == nullptr || opc == nullptr) {
+    return SRSRAN_ERROR;
+  }
+  aes128_set_key(sub.aes, k);
+  memcpy(sub.opc, opc, 16);
+  return SRSRAN_SUCCESS;
+}
+
+struct milenage_out_t {
+  uint8_t mac_a[8];
+  uint8_t res[8];
+  uint8_t ck[16];
+  uint8_t ik[16];
+  uint8_t ak[AK_LEN];
+};
+
+// Milenage f1 and f2 to f5 (TS 35.206 4.1) of up to four vectors
+static void milenage_x4(const security_5g_av_req_t* reqs, uint32_t nof_reqs, milenage_out_t* out)
+{
+  // TEMP = E_K(RAND XOR OPc) of every vector, unused lanes repeat the last one
+  const security_aes128_key_t* keys[4];
+  uint8_t                      temp[4][16];
+  for (uint32_t j = 0; j < 4; j++) {
+    const security_5g_av_req_t& req = reqs[std::min(j, nof_reqs - 1)];
+    keys[j]                         = &req.sub->aes;
+    for (uint32_t i = 0; i < 16; i++) {
+      temp[j][i] = req.rand[i] ^ req.sub->opc[i];
+    }
+  }
+  aes128_encrypt_4(keys, temp);
+
+  // OUTn = E_K(rot(TEMP XOR OPc, rn) XOR cn) XOR OPc, with f1 taking IN1 = SQN || AMF || SQN || AMF instead of TEMP
+  // and adding TEMP after the rotation
+  for (uint32_t j = 0; j < nof_reqs; j++) {
+    const security_5g_av_req_t&  req   = reqs[j];
+    const uint8_t*               opc   = req.sub->opc;
+    const security_aes128_key_t* k4[4] = {&req.sub->aes, &req.sub->aes, &req.sub->aes, &req.sub->aes};
+    uint8_t                      blk[4][16];
+    uint8_t                      in1[16];
+    memcpy(in1, req.sqn, 6);
+    memcpy(in1 + 6, req.amf, 2);
+    memcpy(in1 + 8, in1, 8);
+    for (uint32_t i = 0; i < 16; i++) {
+      uint8_t t             = temp[j][i] ^ opc[i];
+      blk[0][(i + 8) % 16]  = in1[i] ^ opc[i]; // r1 = 64, c1 = 0
+      blk[1][i]             = t;               // r2 = 0
+      blk[2][(i + 12) % 16] = t;               // r3 = 32
+      blk[3][(i + 8) % 16]  = t;               // r4 = 64
+    }
+    for (uint32_t i = 0; i < 16; i++) {
+      blk[0][i] ^= temp[j][i];
+    }
+    blk[1][15] ^= 1;
+    blk[2][15] ^= 2;
+    blk[3][15] ^= 4;
+    aes128_encrypt_4(k4, blk);
+    for (uint32_t b = 0; b < 4; b++) {
+      for (uint32_t i = 0; i < 16; i++) {
+        blk[b][i] ^= opc[i];
+      }
+    }
+    memcpy(out[j].mac_a, blk[0], 8);
+    memcpy(out[j].ak, blk[1], AK_LEN);
+    memcpy(out[j].res, blk[1] + 8, 8);
+    memcpy(out[j].ck, blk[2], 16);
+    memcpy(out[j].ik, blk[3], 16);
+    secure_wipe(blk, sizeof(blk));
+  }
+  secure_wipe(temp, sizeof(temp));
+}
+
+uint8_t security_generate_5g_av_batch(span<const security_5g_av_req_t> reqs, const char* serving_network_name)
+{
+  if (serving_network_name == nullptr) {
+    log_error("Invalid inputs");
+    return SRSRAN_ERROR;
+  }
+  for (const security_5g_av_req_t& req : reqs) {
+    if (req.sub == nullptr || req.rand == nullptr || req.sqn == nullptr || req.amf == nullptr || req.av == nullptr) {
+      log_error("Invalid inputs");
+      return SRSRAN_ERROR;
+    }
+  }
+
+  for (size_t first = 0; first < reqs.size(); first += 4) {
+    uint32_t       nof_reqs = std::min(reqs.size() - first, (size_t)4);
+    milenage_out_t out[4];
+    milenage_x4(&reqs[first], nof_reqs, out);
+    for (uint32_t j = 0; j < nof_reqs; j++) {
+      const security_5g_av_req_t& req = reqs[first + j];
+      security_5g_av_t&           av  = *req.av;
+      memcpy(av.rand, req.rand, AKA_RAND_LEN);
+      // AUTN = SQN XOR AK || AMF || MAC-A
+      for (uint32_t i = 0; i < AK_LEN; i++) {
+        av.autn[i] = req.sqn[i] ^ out[j].ak[i];
+      }
+      memcpy(av.autn + 6, req.amf, 2);
+      memcpy(av.autn + 8, out[j].mac_a, 8);
+      if (security_generate_res_star(
+              out[j].ck, out[j].ik, serving_network_name, av.rand, out[j].res, sizeof(out[j].res), av.xres_star) !=
+              SRSRAN_SUCCESS ||
+          security_generate_k_ausf(out[j].ck, out[j].ik, av.autn, serving_network_name, av.k_ausf) != SRSRAN_SUCCESS) {
+        secure_wipe(out, sizeof(out));
+        return SRSRAN_ERROR;
+      }
+    }
+    secure_wipe(out, sizeof(out));
+  }
+  return SRSRAN_SUCCESS;
+}
+
 } // namespace srsran
@@ -19,6 +19,11 @@
  *
  */
 
+// CPU_ZERO() and friends are GNU extensions of sched.h
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <errno.h>
 #include <pthread.h>
 #include <stdbool.h>
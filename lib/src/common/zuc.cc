@@ -30,6 +30,7 @@
 ---------------------------------------------------------*/
 
 #include "mitm_lib/common/zuc.h"
+#include "keystream_lanes.h"
 
 #define MAKEU32(a, b, c, d) (((u32)(a) << 24) | ((u32)(b) << 16) | ((u32)(c) << 8) | ((u32)(d)))
 #define MulByPow2(x, k) ((((x) << k) | ((x) >> (31 - k))) & 0x7FFFFFFF)
@@ -240,15 +241,168 @@ void zuc_initialize(zuc_state_t* state, const u8* k, u8* iv)
 
 void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream)
 {
-  int i;
   {
     BitReorganization(state);
     F(state); /* discard the output of F */
     LFSRWithWorkMode(state);
   }
+  zuc_continue_keystream(state, key_stream_len, p_keystream);
+}
+
+void zuc_continue_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream)
+{
+  int i;
   for (i = 0; i < key_stream_len; i++) {
     BitReorganization(state);
     p_keystream[i] = F(state) ^ state->BRC_X3;
     LFSRWithWorkMode(state);
   }
 }
+
+/* ——————————————————————- */
+/* Multi-buffer keystream generation, KS_LANES streams in lockstep */
+
+/* S0 << 24, S1 << 16, S0 << 8 and S1, so that the S-box layer is four lookups ORed together */
+typedef struct {
+  u32 sbox[4][256];
+} zuc_mb_tables_t;
+
+static const zuc_mb_tables_t* zuc_mb_tables()
+{
+  static const zuc_mb_tables_t tables = [] {
+    zuc_mb_tables_t t;
+    for (int i = 0; i < 256; i++) {
+      t.sbox[0][i] = (u32)S0[i] << 24;
+      t.sbox[1][i] = (u32)S1[i] << 16;
+      t.sbox[2][i] = (u32)S0[i] << 8;
+      t.sbox[3][i] = (u32)S1[i];
+    }
+    return t;
+  }();
+  return &tables;
+}
+
+typedef struct {
+  ks_lane_t s[16]; /* LFSR as a ring, s[(p + i) & 15] holds s_i */
+  u32       p;
+  ks_lane_t r1;
+  ks_lane_t r2;
+  ks_lane_t x[4];
+} zuc_mb_state_t;
+
+#define ZUC_MB_S(st, i) ((st)->s[((st)->p + (i)) & 15])
+#define ZUC_MB_MULBYPOW2(x, k) ks_and(ks_or(KS_SHL(x, k), KS_SHR(x, 31 - (k))), ks_set1(0x7FFFFFFF))
+
+static inline ks_lane_t zuc_mb_addm(ks_lane_t a, ks_lane_t b)
+{
+  ks_lane_t c = ks_add(a, b);
+  return ks_add(ks_and(c, ks_set1(0x7FFFFFFF)), KS_SHR(c, 31));
+}
+
+static inline ks_lane_t zuc_mb_lfsr_feedback(zuc_mb_state_t* st)
+{
+  ks_lane_t f = ZUC_MB_S(st, 0);
+  f           = zuc_mb_addm(f, ZUC_MB_MULBYPOW2(ZUC_MB_S(st, 0), 8));
+  f           = zuc_mb_addm(f, ZUC_MB_MULBYPOW2(ZUC_MB_S(st, 4), 20));
+  f           = zuc_mb_addm(f, ZUC_MB_MULBYPOW2(ZUC_MB_S(st, 10), 21));
+  f           = zuc_mb_addm(f, ZUC_MB_MULBYPOW2(ZUC_MB_S(st, 13), 17));
+  f           = zuc_mb_addm(f, ZUC_MB_MULBYPOW2(ZUC_MB_S(st, 15), 15));
+  return f;
+}
+
+/* s_0 leaves the register and f becomes s_15 */
+static inline void zuc_mb_lfsr_shift(zuc_mb_state_t* st, ks_lane_t f)
+{
+  ZUC_MB_S(st, 0) = f;
+  st->p           = (st->p + 1) & 15;
+}
+
+static inline void zuc_mb_bit_reorganization(zuc_mb_state_t* st)
+{
+  const ks_lane_t lo16 = ks_set1(0xFFFF);
+  st->x[0] = ks_or(KS_SHL(ks_and(ZUC_MB_S(st, 15), ks_set1(0x7FFF8000)), 1), ks_and(ZUC_MB_S(st, 14), lo16));
+  st->x[1] = ks_or(KS_SHL(ks_and(ZUC_MB_S(st, 11), lo16), 16), KS_SHR(ZUC_MB_S(st, 9), 15));
+  st->x[2] = ks_or(KS_SHL(ks_and(ZUC_MB_S(st, 7), lo16), 16), KS_SHR(ZUC_MB_S(st, 5), 15));
+  st->x[3] = ks_or(KS_SHL(ks_and(ZUC_MB_S(st, 2), lo16), 16), KS_SHR(ZUC_MB_S(st, 0), 15));
+}
+
+static inline ks_lane_t zuc_mb_sbox(const zuc_mb_tables_t* t, ks_lane_t x)
+{
+  return ks_or(ks_or(ks_lookup(t->sbox[0], KS_BYTE(x, 0)), ks_lookup(t->sbox[1], KS_BYTE(x, 1))),
+               ks_or(ks_lookup(t->sbox[2], KS_BYTE(x, 2)), ks_lookup(t->sbox[3], KS_BYTE(x, 3))));
+}
+
+static inline ks_lane_t zuc_mb_f(const zuc_mb_tables_t* t, zuc_mb_state_t* st)
+{
+  ks_lane_t w  = ks_add(ks_xor(st->x[0], st->r1), st->r2);
+  ks_lane_t w1 = ks_add(st->r1, st->x[1]);
+  ks_lane_t w2 = ks_xor(st->r2, st->x[2]);
+  ks_lane_t u  = ks_or(KS_SHL(w1, 16), KS_SHR(w2, 16));
+  ks_lane_t v  = ks_or(KS_SHL(w2, 16), KS_SHR(w1, 16));
+  u            = ks_xor(ks_xor(ks_xor(u, KS_ROT(u, 2)), ks_xor(KS_ROT(u, 10), KS_ROT(u, 18))), KS_ROT(u, 24));
+  v            = ks_xor(ks_xor(ks_xor(v, KS_ROT(v, 8)), ks_xor(KS_ROT(v, 14), KS_ROT(v, 22))), KS_ROT(v, 30));
+  st->r1       = zuc_mb_sbox(t, u);
+  st->r2       = zuc_mb_sbox(t, v);
+  return w;
+}
+
+static void zuc_mb_generate_group(const zuc_mb_job_t* jobs, int nof_jobs)
+{
+  const zuc_mb_tables_t* t = zuc_mb_tables();
+  zuc_mb_state_t         st;
+  u32                    lanes[16][KS_LANES] = {};
+  u32                    tile[KS_TILE_WORDS][KS_LANES];
+  int                    max_len = 0;
+  int                    i, l;
+
+  /* expand key, idle lanes run on an all zero state */
+  for (l = 0; l < nof_jobs; l++) {
+    for (i = 0; i < 16; i++) {
+      lanes[i][l] = MAKEU31(jobs[l].k[i], EK_d[i], jobs[l].iv[i]);
+    }
+    max_len = jobs[l].key_stream_len > max_len ? jobs[l].key_stream_len : max_len;
+  }
+  for (i = 0; i < 16; i++) {
+    st.s[i] = ks_load(lanes[i]);
+  }
+  st.p  = 0;
+  st.r1 = ks_set1(0);
+  st.r2 = ks_set1(0);
+
+  for (i = 0; i < 32; i++) {
+    zuc_mb_bit_reorganization(&st);
+    ks_lane_t w = zuc_mb_f(t, &st);
+    zuc_mb_lfsr_shift(&st, zuc_mb_addm(zuc_mb_lfsr_feedback(&st), KS_SHR(w, 1)));
+  }
+
+  /* discard the first output of F */
+  zuc_mb_bit_reorganization(&st);
+  zuc_mb_f(t, &st);
+  zuc_mb_lfsr_shift(&st, zuc_mb_lfsr_feedback(&st));
+
+  for (int t0 = 0; t0 < max_len; t0 += KS_TILE_WORDS) {
+    int n = max_len - t0 < KS_TILE_WORDS ? max_len - t0 : KS_TILE_WORDS;
+    for (i = 0; i < n; i++) {
+      zuc_mb_bit_reorganization(&st);
+      ks_store(tile[i], ks_xor(zuc_mb_f(t, &st), st.x[3]));
+      zuc_mb_lfsr_shift(&st, zuc_mb_lfsr_feedback(&st));
+    }
+    for (l = 0; l < nof_jobs; l++) {
+      for (i = 0; i < n && t0 + i < jobs[l].key_stream_len; i++) {
+        jobs[l].ks[t0 + i] = tile[i][l];
+      }
+    }
+  }
+}
+
+int zuc_mb_lanes(void)
+{
+  return KS_LANES;
+}
+
+void zuc_generate_keystream_mb(const zuc_mb_job_t* jobs, int nof_jobs)
+{
+  for (int first = 0; first < nof_jobs; first += KS_LANES) {
+    zuc_mb_generate_group(&jobs[first], nof_jobs - first < KS_LANES ? nof_jobs - first : KS_LANES);
+  }
+}
@@ -122,25 +122,37 @@ bool gtpu_read_ext_header(srsran::byte_buffer_t* pdu,
   }
 
   // TODO: Iterate over next headers until no more extension headers
+  size_t ext_len;
   switch (header->next_ext_hdr_type) {
     case GTPU_EXT_HEADER_PDCP_PDU_NUMBER:
-      pdu->msg += HEADER_PDCP_PDU_NUMBER_SIZE;
-      pdu->N_bytes -= HEADER_PDCP_PDU_NUMBER_SIZE;
-      header->ext_buffer.resize(HEADER_PDCP_PDU_NUMBER_SIZE);
-      for (size_t i = 0; i < HEADER_PDCP_PDU_NUMBER_SIZE; ++i) {
-        header->ext_buffer[i] = **ptr;
-        (*ptr)++;
-      }
+      ext_len = HEADER_PDCP_PDU_NUMBER_SIZE;
       break;
     case GTPU_EXT_HEADER_PDU_SESSION_CONTAINER:
-      pdu->msg += GTPU_EXT_HEADER_PDU_SESSION_CONTAINER_LEN;
-      pdu->N_bytes -= GTPU_EXT_HEADER_PDU_SESSION_CONTAINER_LEN;
-      // TODO: Save Header Extension
+      // The first octet gives the length of the extension header in 4 octet units
+      ext_len = pdu->N_bytes > 0 ? 4 * (size_t)**ptr : GTPU_EXT_HEADER_PDU_SESSION_CONTAINER_LEN;
+      if (ext_len == 0) {
+        logger.error("gtpu_read_header - Invalid PDU Session Container length");
+        return false;
+      }
       break;
     default:
       logger.error("gtpu_read_header - Unhandled GTP-U Extension Header Type: 0x%x", header->next_ext_hdr_type);
       return false;
   }
+  if (pdu->N_bytes < ext_len) {
+    logger.error("gtpu_read_header - PDU too short for extension header. Length: %d", pdu->N_bytes);
+    return false;
+  }
+  // Saved, so that the header can be written back with gtpu_write_header()
+  header->ext_buffer.assign(*ptr, *ptr + ext_len);
+  if (header->ext_buffer.back() != GTPU_EXT_NO_MORE_EXTENSION_HEADERS) {
+    logger.error("gtpu_read_header - Unhandled GTP-U Extension Header chain. Next Type: 0x%x",
+                 header->ext_buffer.back());
+    return false;
+  }
+  *ptr += ext_len;
+  pdu->msg += ext_len;
+  pdu->N_bytes -= ext_len;
   return true;
 }
 
@@ -148,6 +160,11 @@ bool gtpu_read_header(srsran::byte_buffer_t* pdu, gtpu_header_t* header, srslog:
 {
   uint8_t* ptr = pdu->msg;
 
+  if (pdu->N_bytes < GTPU_BASE_HEADER_LEN) {
+    logger.error("gtpu_read_header - PDU too short for header. Length: %d", pdu->N_bytes);
+    return false;
+  }
+
   header->flags = *ptr;
   ptr++;
   header->message_type = *ptr;
@@ -170,7 +187,13 @@ bool gtpu_read_header(srsran::byte_buffer_t* pdu, gtpu_header_t* header, srslog:
   }
 
   // If E, S or PN are set, header is longer
+  header->next_ext_hdr_type = 0;
+  header->ext_buffer.clear();
   if (header->flags & (GTPU_FLAGS_EXTENDED_HDR | GTPU_FLAGS_SEQUENCE | GTPU_FLAGS_PACKET_NUM)) {
+    if (pdu->N_bytes < GTPU_EXTENDED_HEADER_LEN) {
+      logger.error("gtpu_read_header - PDU too short for extended header. Length: %d", pdu->N_bytes);
+      return false;
+    }
     pdu->msg += GTPU_EXTENDED_HEADER_LEN;
     pdu->N_bytes -= GTPU_EXTENDED_HEADER_LEN;
 
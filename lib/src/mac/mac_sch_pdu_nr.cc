@@ -23,6 +23,8 @@
 
 namespace srsran {
 
+mac_sch_subpdu_nr::mac_sch_subpdu_nr(mac_sch_pdu_nr* parent_) : parent(parent_), logger(&parent_->get_logger()) {}
+
 mac_sch_subpdu_nr::nr_lcid_sch_t mac_sch_subpdu_nr::get_type()
 {
   if (lcid >= 32) {
@@ -297,7 +299,6 @@ mac_sch_subpdu_nr::lcg_bsr_t mac_sch_subpdu_nr::get_sbsr() const
 mac_sch_subpdu_nr::lbsr_t mac_sch_subpdu_nr::get_lbsr() const
 {
   lbsr_t lbsr = {};
-  lbsr.list.reserve(mac_sch_subpdu_nr::max_num_lcg_lbsr);
 
   if (parent->is_ulsch() && (lcid == LONG_BSR || lcid == LONG_TRUNC_BSR)) {
     const uint8_t* ptr = sdu.ptr();
@@ -471,6 +472,10 @@ void mac_sch_pdu_nr::pack()
 {
   // SDU and CEs are written in-place, only add padding if needed
   if (remaining_len) {
+    if (subpdus.full()) {
+      logger.error("Too many subPDUs to add padding to PDU (max %d)", max_num_subpdus);
+      return;
+    }
     mac_sch_subpdu_nr padding_subpdu(this);
     padding_subpdu.set_padding(remaining_len);
     padding_subpdu.write_subpdu(buffer->msg + buffer->N_bytes);
@@ -486,6 +491,10 @@ int mac_sch_pdu_nr::unpack(const uint8_t* payload, const uint32_t& len)
 {
   uint32_t offset = 0;
   while (offset < len) {
+    if (subpdus.full()) {
+      logger.error("Malformed MAC PDU, more than %d subPDUs (len=%d, offset=%d)", max_num_subpdus, len, offset);
+      return SRSRAN_ERROR;
+    }
     mac_sch_subpdu_nr sch_pdu(this);
     if (sch_pdu.read_subheader(payload + offset) == SRSRAN_ERROR) {
       logger.error("Malformed MAC PDU (len=%d, offset=%d)", len, offset);
@@ -510,12 +519,12 @@ int mac_sch_pdu_nr::unpack(const uint8_t* payload, const uint32_t& len)
 
 const mac_sch_subpdu_nr& mac_sch_pdu_nr::get_subpdu(const uint32_t& index) const
 {
-  return subpdus.at(index);
+  return subpdus[index];
 }
 
 mac_sch_subpdu_nr& mac_sch_pdu_nr::get_subpdu(uint32_t index)
 {
-  return subpdus.at(index);
+  return subpdus[index];
 }
 
 bool mac_sch_pdu_nr::is_ulsch()
@@ -608,6 +617,14 @@ uint32_t mac_sch_pdu_nr::add_ue_con_res_id_ce(const mac_sch_subpdu_nr::ue_con_re
   return add_sudpdu(ce);
 }
 
+uint32_t mac_sch_pdu_nr::add_subpdu(const mac_sch_subpdu_nr& subpdu_)
+{
+  mac_sch_subpdu_nr subpdu(subpdu_);
+  subpdu.parent = this;
+  subpdu.logger = &logger;
+  return add_sudpdu(subpdu);
+}
+
 uint32_t mac_sch_pdu_nr::add_sudpdu(mac_sch_subpdu_nr& subpdu)
 {
   uint32_t subpdu_len = subpdu.get_total_length();
@@ -615,6 +632,10 @@ uint32_t mac_sch_pdu_nr::add_sudpdu(mac_sch_subpdu_nr& subpdu)
     logger.warning("Not enough space to add subPDU to PDU (%d > %d)", subpdu_len, remaining_len);
     return SRSRAN_ERROR;
   }
+  if (subpdus.full()) {
+    logger.warning("Too many subPDUs in PDU (max %d)", max_num_subpdus);
+    return SRSRAN_ERROR;
+  }
 
   // Write subPDU straigt into provided buffer
   subpdu.write_subpdu(buffer->msg + buffer->N_bytes);
@@ -22,6 +22,7 @@
 #include "mitm_lib/upper/pdcp_entity_base.h"
 #include "mitm_lib/common/int_helpers.h"
 #include "mitm_lib/common/security.h"
+#include <algorithm>
 #include <inttypes.h>
 
 namespace srsran {
@@ -36,6 +37,15 @@ void pdcp_entity_base::config_security(const as_security_config_t& sec_cfg_)
 {
   sec_cfg = sec_cfg_;
 
+  if (sec_cfg.integ_algo == INTEGRITY_ALGORITHM_ID_128_EIA2) {
+    security_128_eia2_init(rrc_eia2_ctx, &sec_cfg.k_rrc_int[16]);
+    security_128_eia2_init(up_eia2_ctx, &sec_cfg.k_up_int[16]);
+  }
+  if (sec_cfg.cipher_algo == CIPHERING_ALGORITHM_ID_128_EEA2) {
+    security_128_eea2_init(rrc_eea2_ctx, &sec_cfg.k_rrc_enc[16]);
+    security_128_eea2_init(up_eea2_ctx, &sec_cfg.k_up_enc[16]);
+  }
+
   logger.info("Configuring security with %s and %s",
               integrity_algorithm_id_text[sec_cfg.integ_algo],
               ciphering_algorithm_id_text[sec_cfg.cipher_algo]);
@@ -67,7 +77,8 @@ void pdcp_entity_base::integrity_generate(uint8_t* msg, uint32_t msg_len, uint32
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
+      security_128_eia2(
+          is_srb() ? rrc_eia2_ctx : up_eia2_ctx, count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
@@ -105,7 +116,8 @@ bool pdcp_entity_base::integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
+      security_128_eia2(
+          is_srb() ? rrc_eia2_ctx : up_eia2_ctx, count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
@@ -162,8 +174,8 @@ void pdcp_entity_base::cipher_encrypt(uint8_t* msg, uint32_t msg_len, uint32_t c
       memcpy(ct, ct_tmp, msg_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
-      memcpy(ct, ct_tmp, msg_len);
+      security_128_eea2(
+          is_srb() ? rrc_eea2_ctx : up_eea2_ctx, count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
@@ -202,8 +214,8 @@ void pdcp_entity_base::cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t cou
       memcpy(msg, msg_tmp, ct_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
-      memcpy(msg, msg_tmp, ct_len);
+      security_128_eea2(
+          is_srb() ? rrc_eea2_ctx : up_eea2_ctx, count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
@@ -215,6 +227,121 @@ void pdcp_entity_base::cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t cou
   logger.debug(msg, ct_len, "Cipher decrypt output msg");
 }
 
+void pdcp_entity_base::integrity_generate_batch(span<const security_pdu_t> pdus)
+{
+  integrity_batch(pdus, cfg.tx_direction);
+}
+
+bool pdcp_entity_base::integrity_verify_batch(span<const security_pdu_t> pdus, bool* is_valid)
+{
+  const uint32_t chunk_len = 64;
+  security_pdu_t chunk[chunk_len];
+  uint8_t        mac_exp[chunk_len][4];
+  bool           all_valid = true;
+
+  for (size_t first = 0; first < pdus.size(); first += chunk_len) {
+    uint32_t nof_pdus = std::min(pdus.size() - first, (size_t)chunk_len);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      chunk[i]            = pdus[first + i];
+      chunk[i].out        = mac_exp[i];
+      is_valid[first + i] = true;
+    }
+    if (sec_cfg.integ_algo == INTEGRITY_ALGORITHM_ID_EIA0) {
+      continue;
+    }
+    integrity_batch(span<const security_pdu_t>(chunk, nof_pdus), cfg.rx_direction);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      const security_pdu_t& pdu = pdus[first + i];
+      if (memcmp(pdu.out, mac_exp[i], 4) != 0) {
+        is_valid[first + i] = false;
+        all_valid           = false;
+        logger.warning("Integrity check failed - COUNT %" PRIu32 ", Bearer ID %d", pdu.count, cfg.bearer_id);
+        logger.warning(mac_exp[i], 4, "MAC mismatch (expected):");
+        logger.warning(pdu.out, 4, "MAC mismatch (found):");
+      }
+    }
+  }
+
+  return all_valid;
+}
+
+void pdcp_entity_base::cipher_encrypt_batch(span<const security_pdu_t> pdus)
+{
+  cipher_batch(pdus, cfg.tx_direction);
+}
+
+void pdcp_entity_base::cipher_decrypt_batch(span<const security_pdu_t> pdus)
+{
+  cipher_batch(pdus, cfg.rx_direction);
+}
+
+void pdcp_entity_base::integrity_batch(span<const security_pdu_t> pdus, uint8_t direction)
+{
+  if (pdus.empty()) {
+    return;
+  }
+  const uint8_t* k_int = is_srb() ? sec_cfg.k_rrc_int.data() : sec_cfg.k_up_int.data();
+
+  switch (sec_cfg.integ_algo) {
+    case INTEGRITY_ALGORITHM_ID_EIA0:
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA1:
+      security_128_eia1_batch(&k_int[16], cfg.bearer_id - 1, direction, pdus);
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA2:
+      security_128_eia2_batch(is_srb() ? rrc_eia2_ctx : up_eia2_ctx, cfg.bearer_id - 1, direction, pdus);
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA3:
+      security_128_eia3_batch(&k_int[16], cfg.bearer_id - 1, direction, pdus);
+      break;
+    default:
+      break;
+  }
+
+  logger.debug("Integrity batch: %zd PDUs, COUNT %" PRIu32 "..%" PRIu32 ", Bearer ID %d, Direction %s",
+               pdus.size(),
+               pdus.front().count,
+               pdus.back().count,
+               cfg.bearer_id,
+               direction == SECURITY_DIRECTION_DOWNLINK ? "Downlink" : "Uplink");
+}
+
+void pdcp_entity_base::cipher_batch(span<const security_pdu_t> pdus, uint8_t direction)
+{
+  if (pdus.empty()) {
+    return;
+  }
+  const uint8_t* k_enc = is_srb() ? sec_cfg.k_rrc_enc.data() : sec_cfg.k_up_enc.data();
+
+  switch (sec_cfg.cipher_algo) {
+    case CIPHERING_ALGORITHM_ID_EEA0:
+      for (const security_pdu_t& pdu : pdus) {
+        if (pdu.out != pdu.msg) {
+          memcpy(pdu.out, pdu.msg, pdu.msg_len);
+        }
+      }
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA1:
+      security_128_eea1_batch(&k_enc[16], cfg.bearer_id - 1, direction, pdus);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2:
+      security_128_eea2_batch(is_srb() ? rrc_eea2_ctx : up_eea2_ctx, cfg.bearer_id - 1, direction, pdus);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA3:
+      security_128_eea3_batch(&k_enc[16], cfg.bearer_id - 1, direction, pdus);
+      break;
+    default:
+      break;
+  }
+
+  logger.debug("Cipher batch: %zd PDUs, COUNT %" PRIu32 "..%" PRIu32 ", Bearer ID %d, Direction %s",
+               pdus.size(),
+               pdus.front().count,
+               pdus.back().count,
+               cfg.bearer_id,
+               direction == SECURITY_DIRECTION_DOWNLINK ? "Downlink" : "Uplink");
+}
+
 /****************************************************************************
  * Common pack functions
  ***************************************************************************/
@@ -21,6 +21,7 @@
 
 #include "mitm_lib/upper/pdcp_entity_nr.h"
 #include "mitm_lib/common/security.h"
+#include <algorithm>
 
 namespace srsran {
 
@@ -56,6 +57,19 @@ bool pdcp_entity_nr::configure(const pdcp_config_t& cnfg_)
   rb_name     = cfg.get_rb_name();
   window_size = 1 << (cfg.sn_len - 1);
 
+  // Reception window, sized by the reordering window
+  switch (cfg.sn_len) {
+    case PDCP_SN_LEN_12:
+      rx_window = std::unique_ptr<pdcp_nr_rx_window_base>(new pdcp_nr_rx_window_t<1 << (PDCP_SN_LEN_12 - 1)>);
+      break;
+    case PDCP_SN_LEN_18:
+      rx_window = std::unique_ptr<pdcp_nr_rx_window_base>(new pdcp_nr_rx_window_t<1 << (PDCP_SN_LEN_18 - 1)>);
+      break;
+    default:
+      logger.error("%s unsupported PDCP-NR SN length %d", rb_name.c_str(), cfg.sn_len);
+      return false;
+  }
+
   rlc_mode = rlc->rb_is_um(lcid) ? rlc_mode_t::UM : rlc_mode_t::AM;
 
   // t-Reordering timer
@@ -82,6 +96,13 @@ bool pdcp_entity_nr::configure(const pdcp_config_t& cnfg_)
   if (rlc_mode == rlc_mode_t::UM) {
     cfg.discard_timer = pdcp_discard_timer_t::infinity;
   }
+
+  // discardTimer
+  if (cfg.discard_timer != pdcp_discard_timer_t::infinity) {
+    discard_window.assign(window_size, discard_entry_t{});
+    discard_timer = task_sched.get_unique_timer();
+    discard_timer.set(static_cast<uint32_t>(cfg.discard_timer), discard_callback(this));
+  }
   return true;
 }
 
@@ -101,6 +122,82 @@ void pdcp_entity_nr::reset()
 
 // SDAP/RRC interface
 void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
+{
+  if (not tx_prepare(sdu)) {
+    return;
+  }
+
+  // TS 38.323, section 5.9: Integrity protection
+  // The data unit that is integrity protected is the PDU header
+  // and the data part of the PDU before ciphering.
+  uint8_t mac[4] = {};
+  if (has_mac()) {
+    integrity_generate(sdu->msg, sdu->N_bytes, tx_next, mac);
+  }
+  // Append MAC-I
+  if (has_mac()) {
+    append_mac(sdu, mac);
+  }
+
+  // TS 38.323, section 5.8: Ciphering
+  // The data unit that is ciphered is the MAC-I and the
+  // data part of the PDCP Data PDU except the
+  // SDAP header and the SDAP Control PDU if included in the PDCP SDU.
+  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+    cipher_encrypt(
+        &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_next, &sdu->msg[cfg.hdr_len_bytes]);
+  }
+
+  tx_deliver(std::move(sdu), tx_next);
+
+  // Increment TX_NEXT
+  tx_next++;
+}
+
+void pdcp_entity_nr::write_sdus(span<unique_byte_buffer_t> sdus)
+{
+  for (size_t first = 0; first < sdus.size(); first += max_batch_len) {
+    size_t                last = std::min(sdus.size(), first + max_batch_len);
+    unique_byte_buffer_t* run[max_batch_len];
+    uint32_t              count[max_batch_len];
+    uint8_t               mac[max_batch_len][4] = {};
+    security_pdu_t        sec[max_batch_len];
+    uint32_t              nof_sdus = 0;
+
+    // COUNTs are assigned in order, as write_sdu() would
+    for (size_t i = first; i < last; i++) {
+      if (tx_prepare(sdus[i])) {
+        run[nof_sdus]   = &sdus[i];
+        count[nof_sdus] = tx_next++;
+        nof_sdus++;
+      }
+    }
+
+    // TS 38.323, section 5.9: Integrity protection, then 5.8: Ciphering, as in write_sdu()
+    if (has_mac()) {
+      for (uint32_t i = 0; i < nof_sdus; i++) {
+        sec[i] = {(*run[i])->msg, (*run[i])->N_bytes, count[i], mac[i]};
+      }
+      integrity_generate_batch(span<const security_pdu_t>(sec, nof_sdus));
+      for (uint32_t i = 0; i < nof_sdus; i++) {
+        append_mac(*run[i], mac[i]);
+      }
+    }
+    if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+      for (uint32_t i = 0; i < nof_sdus; i++) {
+        uint8_t* payload = &(*run[i])->msg[cfg.hdr_len_bytes];
+        sec[i]           = {payload, (*run[i])->N_bytes - cfg.hdr_len_bytes, count[i], payload};
+      }
+      cipher_encrypt_batch(span<const security_pdu_t>(sec, nof_sdus));
+    }
+
+    for (uint32_t i = 0; i < nof_sdus; i++) {
+      tx_deliver(std::move(*run[i]), count[i]);
+    }
+  }
+}
+
+bool pdcp_entity_nr::tx_prepare(const unique_byte_buffer_t& sdu)
 {
   // Log SDU
   logger.info(sdu->msg,
@@ -113,13 +210,13 @@ void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
 
   if (rlc->sdu_queue_is_full(lcid)) {
     logger.info(sdu->msg, sdu->N_bytes, "Dropping %s SDU due to full queue", rb_name.c_str());
-    return;
+    return false;
   }
 
   // Check for COUNT overflow
   if (tx_overflow) {
     logger.warning("TX_NEXT has overflowed. Dropping packet");
-    return;
+    return false;
   }
   if (tx_next + 1 == 0) {
     tx_overflow = true;
@@ -127,63 +224,158 @@ void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
 
   // Start discard timer
   if (cfg.discard_timer != pdcp_discard_timer_t::infinity) {
-    timer_handler::unique_timer discard_timer = task_sched.get_unique_timer();
-    discard_callback            discard_fnc(this, tx_next);
-    discard_timer.set(static_cast<uint32_t>(cfg.discard_timer), discard_fnc);
-    discard_timer.run();
-    discard_timers_map.insert(std::make_pair(tx_next, std::move(discard_timer)));
-    logger.debug("Discard Timer set for SN %u. Timeout: %ums", tx_next, static_cast<uint32_t>(cfg.discard_timer));
+    start_discard_timer(tx_next);
   }
 
   // Perform header compression TODO
 
   // Write PDCP header info
   write_data_header(sdu, tx_next);
+  return true;
+}
 
-  // TS 38.323, section 5.9: Integrity protection
-  // The data unit that is integrity protected is the PDU header
-  // and the data part of the PDU before ciphering.
-  uint8_t mac[4] = {};
-  if (is_srb() || (is_drb() && (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX))) {
-    integrity_generate(sdu->msg, sdu->N_bytes, tx_next, mac);
-  }
-  // Append MAC-I
-  if (is_srb() || (is_drb() && (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX))) {
-    append_mac(sdu, mac);
-  }
-
-  // TS 38.323, section 5.8: Ciphering
-  // The data unit that is ciphered is the MAC-I and the
-  // data part of the PDCP Data PDU except the
-  // SDAP header and the SDAP Control PDU if included in the PDCP SDU.
-  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
-    cipher_encrypt(
-        &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_next, &sdu->msg[cfg.hdr_len_bytes]);
-  }
-
+void pdcp_entity_nr::tx_deliver(unique_byte_buffer_t pdu, uint32_t count)
+{
   // Set meta-data for RLC AM
-  sdu->md.pdcp_sn = tx_next;
+  pdu->md.pdcp_sn = count;
 
-  logger.info(sdu->msg,
-              sdu->N_bytes,
+  logger.info(pdu->msg,
+              pdu->N_bytes,
               "TX %s PDU (%dB), HFN=%d, SN=%d, integrity=%s, encryption=%s",
               rb_name.c_str(),
-              sdu->N_bytes,
-              HFN(tx_next),
-              SN(tx_next),
+              pdu->N_bytes,
+              HFN(count),
+              SN(count),
               srsran_direction_text[integrity_direction],
               srsran_direction_text[encryption_direction]);
 
   // Check if PDCP is associated with more than on RLC entity TODO
   // Write to lower layers
-  rlc->write_sdu(lcid, std::move(sdu));
-
-  // Increment TX_NEXT
-  tx_next++;
+  rlc->write_sdu(lcid, std::move(pdu));
 }
 
 // RLC interface
 void pdcp_entity_nr::write_pdu(unique_byte_buffer_t pdu)
+{
+  uint32_t rcvd_sn, rcvd_count;
+  if (not rx_prepare(pdu, rcvd_sn, rcvd_count)) {
+    return;
+  }
+
+  /*
+   * TS 38.323, section 5.8: Deciphering
+   *
+   * The data unit that is ciphered is the MAC-I and the
+   * data part of the PDCP Data PDU except the
+   * SDAP header and the SDAP Control PDU if included in the PDCP SDU.
+   */
+  if (encryption_direction == DIRECTION_RX || encryption_direction == DIRECTION_TXRX) {
+    cipher_decrypt(
+        &pdu->msg[cfg.hdr_len_bytes], pdu->N_bytes - cfg.hdr_len_bytes, rcvd_count, &pdu->msg[cfg.hdr_len_bytes]);
+  }
+
+  /*
+   * Extract MAC-I:
+   * Always extract from SRBs, only extract from DRBs if integrity is enabled
+   */
+  uint8_t mac[4] = {};
+  if (has_mac()) {
+    extract_mac(pdu, mac);
+  }
+
+  /*
+   * TS 38.323, section 5.9: Integrity verification
+   *
+   * The data unit that is integrity protected is the PDU header
+   * and the data part of the PDU before ciphering.
+   */
+  if (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX) {
+    bool is_valid = integrity_verify(pdu->msg, pdu->N_bytes, rcvd_count, mac);
+    if (!is_valid) {
+      logger.error(pdu->msg, pdu->N_bytes, "%s Dropping PDU", rb_name.c_str());
+      rrc->notify_pdcp_integrity_error(lcid);
+      return; // Invalid packet, drop.
+    } else {
+      logger.debug(pdu->msg, pdu->N_bytes, "%s: Integrity verification successful", rb_name.c_str());
+    }
+  }
+
+  rx_store(std::move(pdu), rcvd_count);
+}
+
+void pdcp_entity_nr::write_pdus(span<unique_byte_buffer_t> pdus)
+{
+  bool decipher = encryption_direction == DIRECTION_RX || encryption_direction == DIRECTION_TXRX;
+  bool verify   = integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX;
+
+  for (size_t first = 0; first < pdus.size(); first += max_batch_len) {
+    size_t                last = std::min(pdus.size(), first + max_batch_len);
+    unique_byte_buffer_t* run[max_batch_len];
+    uint32_t              rcvd_sn[max_batch_len], rcvd_count[max_batch_len];
+    uint8_t               mac[max_batch_len][4] = {};
+    bool                  is_valid[max_batch_len];
+    security_pdu_t        sec[max_batch_len];
+    uint32_t              nof_pdus = 0;
+
+    // The COUNTs are estimated from RX_DELIV before any PDU of the run is stored
+    for (size_t i = first; i < last; i++) {
+      if (rx_prepare(pdus[i], rcvd_sn[nof_pdus], rcvd_count[nof_pdus])) {
+        run[nof_pdus++] = &pdus[i];
+      }
+    }
+
+    // TS 38.323, section 5.8: Deciphering, then 5.9: Integrity verification, as in write_pdu()
+    if (decipher) {
+      for (uint32_t i = 0; i < nof_pdus; i++) {
+        uint8_t* payload = &(*run[i])->msg[cfg.hdr_len_bytes];
+        sec[i]           = {payload, (*run[i])->N_bytes - cfg.hdr_len_bytes, rcvd_count[i], payload};
+      }
+      cipher_decrypt_batch(span<const security_pdu_t>(sec, nof_pdus));
+    }
+    if (has_mac()) {
+      for (uint32_t i = 0; i < nof_pdus; i++) {
+        extract_mac(*run[i], mac[i]);
+      }
+    }
+    if (verify) {
+      for (uint32_t i = 0; i < nof_pdus; i++) {
+        sec[i] = {(*run[i])->msg, (*run[i])->N_bytes, rcvd_count[i], mac[i]};
+      }
+      integrity_verify_batch(span<const security_pdu_t>(sec, nof_pdus), is_valid);
+    }
+
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      unique_byte_buffer_t& pdu = *run[i];
+      if (rx_count(rcvd_sn[i]) != rcvd_count[i]) {
+        // The PDUs stored before moved RX_DELIV far enough to change the COUNT of this one: undo the security
+        // processing, the keystream cancels out, and start over with the right COUNT
+        if (has_mac()) {
+          append_mac(pdu, mac[i]);
+        }
+        if (decipher) {
+          cipher_decrypt(&pdu->msg[cfg.hdr_len_bytes],
+                         pdu->N_bytes - cfg.hdr_len_bytes,
+                         rcvd_count[i],
+                         &pdu->msg[cfg.hdr_len_bytes]);
+        }
+        write_pdu(std::move(pdu));
+        continue;
+      }
+      if (rx_overflow) {
+        logger.warning("Rx PDCP COUNTs have overflowed. Discarding SDU.");
+        continue;
+      }
+      if (verify and not is_valid[i]) {
+        logger.error(pdu->msg, pdu->N_bytes, "%s Dropping PDU", rb_name.c_str());
+        rrc->notify_pdcp_integrity_error(lcid);
+        continue; // Invalid packet, drop.
+      }
+      rx_store(std::move(pdu), rcvd_count[i]);
+    }
+  }
+}
+
+bool pdcp_entity_nr::rx_prepare(const unique_byte_buffer_t& pdu, uint32_t& rcvd_sn, uint32_t& rcvd_count)
 {
   // Log PDU
   logger.info(pdu->msg,
@@ -196,18 +388,23 @@ void pdcp_entity_nr::write_pdu(unique_byte_buffer_t pdu)
 
   if (rx_overflow) {
     logger.warning("Rx PDCP COUNTs have overflowed. Discarding SDU.");
-    return;
+    return false;
   }
 
   // Sanity check
   if (pdu->N_bytes <= cfg.hdr_len_bytes) {
-    return;
+    return false;
   }
   logger.debug("Rx PDCP state - RX_NEXT=%u, RX_DELIV=%u, RX_REORD=%u", rx_next, rx_deliv, rx_reord);
 
   // Extract RCVD_SN from header
-  uint32_t rcvd_sn = read_data_header(pdu);
+  rcvd_sn    = read_data_header(pdu);
+  rcvd_count = rx_count(rcvd_sn);
+  return true;
+}
 
+uint32_t pdcp_entity_nr::rx_count(uint32_t rcvd_sn)
+{
   /*
    * Calculate RCVD_COUNT:
    *
@@ -230,45 +427,11 @@ void pdcp_entity_nr::write_pdu(unique_byte_buffer_t pdu)
   rcvd_count = COUNT(rcvd_hfn, rcvd_sn);
 
   logger.debug("Estimated RCVD_HFN=%u, RCVD_SN=%u, RCVD_COUNT=%u", rcvd_hfn, rcvd_sn, rcvd_count);
+  return rcvd_count;
+}
 
-  /*
-   * TS 38.323, section 5.8: Deciphering
-   *
-   * The data unit that is ciphered is the MAC-I and the
-   * data part of the PDCP Data PDU except the
-   * SDAP header and the SDAP Control PDU if included in the PDCP SDU.
-   */
-  if (encryption_direction == DIRECTION_RX || encryption_direction == DIRECTION_TXRX) {
-    cipher_decrypt(
-        &pdu->msg[cfg.hdr_len_bytes], pdu->N_bytes - cfg.hdr_len_bytes, rcvd_count, &pdu->msg[cfg.hdr_len_bytes]);
-  }
-
-  /*
-   * Extract MAC-I:
-   * Always extract from SRBs, only extract from DRBs if integrity is enabled
-   */
-  uint8_t mac[4] = {};
-  if (is_srb() || (is_drb() && (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX))) {
-    extract_mac(pdu, mac);
-  }
-
-  /*
-   * TS 38.323, section 5.9: Integrity verification
-   *
-   * The data unit that is integrity protected is the PDU header
-   * and the data part of the PDU before ciphering.
-   */
-  if (integrity_direction == DIRECTION_TX || integrity_direction == DIRECTION_TXRX) {
-    bool is_valid = integrity_verify(pdu->msg, pdu->N_bytes, rcvd_count, mac);
-    if (!is_valid) {
-      logger.error(pdu->msg, pdu->N_bytes, "%s Dropping PDU", rb_name.c_str());
-      rrc->notify_pdcp_integrity_error(lcid);
-      return; // Invalid packet, drop.
-    } else {
-      logger.debug(pdu->msg, pdu->N_bytes, "%s: Integrity verification successful", rb_name.c_str());
-    }
-  }
-
+void pdcp_entity_nr::rx_store(unique_byte_buffer_t pdu, uint32_t rcvd_count)
+{
   // After checking the integrity, we can discard the header.
   discard_data_header(pdu);
 
@@ -285,14 +448,19 @@ void pdcp_entity_nr::write_pdu(unique_byte_buffer_t pdu)
     return; // Invalid count, drop.
   }
 
+  if (rcvd_count - rx_deliv >= window_size) {
+    logger.debug("RCVD_COUNT %u outside of the reception window, RX_DELIV %u", rcvd_count, rx_deliv);
+    return; // Invalid count, drop.
+  }
+
   // Check if PDU has been received
-  if (reorder_queue.find(rcvd_count) != reorder_queue.end()) {
+  if (rx_window->has_count(rcvd_count)) {
     logger.debug("Duplicate PDU, dropping");
     return; // PDU already present, drop.
   }
 
   // Store PDU in reception buffer
-  reorder_queue[rcvd_count] = std::move(pdu);
+  rx_window->add_pdu(rcvd_count, std::move(pdu));
 
   // Update RX_NEXT
   if (rcvd_count >= rx_next) {
@@ -327,10 +495,24 @@ void pdcp_entity_nr::write_pdu(unique_byte_buffer_t pdu)
 void pdcp_entity_nr::notify_delivery(const pdcp_sn_vector_t& pdcp_sns)
 {
   logger.debug("Received delivery notification from RLC. Nof SNs=%ld", pdcp_sns.size());
+  if (discard_window.empty()) {
+    return;
+  }
   for (uint32_t sn : pdcp_sns) {
-    // Remove timer from map
-    logger.debug("Stopping discard timer for SN=%ld", sn);
-    discard_timers_map.erase(sn);
+    // The SDU no longer expires. Its slot is released when the head of the discard window moves past it
+    if (sn - discard_head >= tx_next - discard_head) {
+      continue;
+    }
+    discard_entry_t& entry = discard_window[sn & (window_size - 1)];
+    if (entry.pending) {
+      logger.debug("Stopping discard timer for SN=%ld", sn);
+      entry.pending = false;
+      nof_pending_discards--;
+    }
+  }
+  if (nof_pending_discards == 0) {
+    discard_timer.stop();
+    discard_head = tx_next;
   }
 }
 
@@ -347,10 +529,8 @@ void pdcp_entity_nr::notify_failure(const pdcp_sn_vector_t& pdcp_sns)
 // Update RX_NEXT after submitting to higher layers
 void pdcp_entity_nr::deliver_all_consecutive_counts()
 {
-  for (std::map<uint32_t, unique_byte_buffer_t>::iterator it = reorder_queue.begin();
-       it != reorder_queue.end() && it->first == rx_deliv;
-       reorder_queue.erase(it++)) {
-    logger.debug("Delivering SDU with RCVD_COUNT %u", it->first);
+  while (rx_window->has_count(rx_deliv)) {
+    logger.debug("Delivering SDU with RCVD_COUNT %u", rx_deliv);
 
     // Check RX_DELIV overflow
     if (rx_overflow) {
@@ -362,7 +542,7 @@ void pdcp_entity_nr::deliver_all_consecutive_counts()
     }
 
     // Pass PDCP SDU to the next layers
-    pass_to_upper_layers(std::move(it->second));
+    pass_to_upper_layers(rx_window->take_pdu(rx_deliv));
 
     // Update RX_DELIV
     rx_deliv = rx_deliv + 1;
@@ -376,14 +556,15 @@ void pdcp_entity_nr::deliver_all_consecutive_counts()
 void pdcp_entity_nr::reordering_callback::operator()(uint32_t timer_id)
 {
   parent->logger.info(
-      "Reordering timer expired. RX_REORD=%u, re-order queue size=%ld", parent->rx_reord, parent->reorder_queue.size());
+      "Reordering timer expired. RX_REORD=%u, re-order queue size=%ld", parent->rx_reord, parent->rx_window->size());
 
   // Deliver all PDCP SDU(s) with associated COUNT value(s) < RX_REORD
-  for (std::map<uint32_t, unique_byte_buffer_t>::iterator it = parent->reorder_queue.begin();
-       it != parent->reorder_queue.end() && it->first < parent->rx_reord;
-       parent->reorder_queue.erase(it++)) {
-    // Deliver to upper layers
-    parent->pass_to_upper_layers(std::move(it->second));
+  for (uint32_t count = parent->rx_deliv; count != parent->rx_reord and not parent->rx_window->empty(); count++) {
+    unique_byte_buffer_t sdu = parent->rx_window->take_pdu(count);
+    if (sdu != nullptr) {
+      // Deliver to upper layers
+      parent->pass_to_upper_layers(std::move(sdu));
+    }
   }
 
   // Update RX_DELIV to the first PDCP SDU not delivered to the upper layers
@@ -405,14 +586,69 @@ void pdcp_entity_nr::reordering_callback::operator()(uint32_t timer_id)
 // Discard Timer Callback (discardTimer)
 void pdcp_entity_nr::discard_callback::operator()(uint32_t timer_id)
 {
-  parent->logger.debug("Discard timer expired for PDU with SN=%d", discard_sn);
+  // The timer has just expired at the tick it was started for
+  parent->discard_expired(parent->discard_time_ref + parent->discard_timer.duration());
+}
 
-  // Notify the RLC of the discard. It's the RLC to actually discard, if no segment was transmitted yet.
-  parent->rlc->discard_sdu(parent->lcid, discard_sn);
+void pdcp_entity_nr::start_discard_timer(uint32_t count)
+{
+  uint32_t duration = static_cast<uint32_t>(cfg.discard_timer);
+  uint32_t now      = 0;
+  if (discard_timer.is_running()) {
+    now = discard_time_ref + discard_timer.time_elapsed();
+  } else {
+    // Nothing pending: the ticks restart from 0 with the timer
+    discard_time_ref = 0;
+    discard_head     = count;
+    discard_timer.set(duration);
+    discard_timer.run();
+  }
 
-  // Remove timer from map
-  // NOTE: this will delete the callback. It *must* be the last instruction.
-  parent->discard_timers_map.erase(discard_sn);
+  // The ring covers Window_Size COUNTs. SDUs that old would be ambiguous for the peer anyway
+  while (count - discard_head >= window_size) {
+    discard_entry_t& oldest = discard_window[discard_head & (window_size - 1)];
+    if (oldest.pending) {
+      logger.warning("%s discard window full, discarding SN=%d early", rb_name.c_str(), discard_head);
+      oldest.pending = false;
+      nof_pending_discards--;
+      rlc->discard_sdu(lcid, discard_head);
+    }
+    discard_head++;
+  }
+
+  discard_entry_t& entry = discard_window[count & (window_size - 1)];
+  entry.tx_time          = now;
+  entry.pending          = true;
+  nof_pending_discards++;
+  logger.debug("Discard Timer set for SN %u. Timeout: %ums", count, duration);
+}
+
+void pdcp_entity_nr::discard_expired(uint32_t now)
+{
+  uint32_t duration = static_cast<uint32_t>(cfg.discard_timer);
+  for (; discard_head != tx_next; discard_head++) {
+    discard_entry_t& entry = discard_window[discard_head & (window_size - 1)];
+    if (not entry.pending) {
+      continue;
+    }
+    if (now - entry.tx_time < duration) {
+      break;
+    }
+    logger.debug("Discard timer expired for PDU with SN=%d", discard_head);
+    entry.pending = false;
+    nof_pending_discards--;
+
+    // Notify the RLC of the discard. It's the RLC to actually discard, if no segment was transmitted yet.
+    rlc->discard_sdu(lcid, discard_head);
+  }
+
+  if (nof_pending_discards > 0) {
+    // The callback runs before the timer wheel moves to the current tick, and a timer started now counts from the
+    // previous one
+    discard_time_ref = now - 1;
+    discard_timer.set(discard_window[discard_head & (window_size - 1)].tx_time + duration - discard_time_ref);
+    discard_timer.run();
+  }
 }
 
 void pdcp_entity_nr::get_bearer_state(pdcp_lte_state_t* state)
@@ -27,7 +27,7 @@
 #include "mitm_lib/rlc/rlc_am_nr_packing.h"
 #include "mitm_lib/srslog/event_trace.h"
 #include <iostream>
-#include <set>
+#include <algorithm>
 
 namespace srsran {
 
@@ -75,6 +75,9 @@ bool rlc_am_nr_tx::configure(const rlc_config_t& cfg_)
 
   max_hdr_size = min_hdr_size + so_size;
 
+  tx_status = std::unique_ptr<rlc_am_nr_status_pdu_t>(new rlc_am_nr_status_pdu_t(cfg.rx_sn_field_length));
+  rx_status = std::unique_ptr<rlc_am_nr_status_pdu_t>(new rlc_am_nr_status_pdu_t(cfg.tx_sn_field_length));
+
   // make sure Tx queue is empty before attempting to resize
   empty_queue_no_lock();
   tx_sdu_queue.resize(cfg_.tx_queue_length);
@@ -127,15 +130,11 @@ uint32_t rlc_am_nr_tx::read_pdu(uint8_t* payload, uint32_t nof_bytes)
 
   // Tx STATUS if requested
   if (do_status()) {
-    unique_byte_buffer_t tx_pdu = srsran::make_byte_buffer();
-    if (tx_pdu == nullptr) {
-      RlcError("Couldn't allocate PDU in %s().", __FUNCTION__);
-      return 0;
-    }
-    build_status_pdu(tx_pdu.get(), nof_bytes);
-    memcpy(payload, tx_pdu->msg, tx_pdu->N_bytes);
-    RlcDebug("Status PDU built - %d bytes", tx_pdu->N_bytes);
-    return tx_pdu->N_bytes;
+    status_buf.clear();
+    build_status_pdu(&status_buf, nof_bytes);
+    memcpy(payload, status_buf.msg, status_buf.N_bytes);
+    RlcDebug("Status PDU built - %d bytes", status_buf.N_bytes);
+    return status_buf.N_bytes;
   }
 
   // Retransmit if required
@@ -208,8 +207,9 @@ uint32_t rlc_am_nr_tx::build_new_pdu(uint8_t* payload, uint32_t nof_bytes)
   // insert newly assigned SN into window and use reference for in-place operations
   // NOTE: from now on, we can't return from this function anymore before increasing tx_next
   rlc_amd_tx_pdu_nr& tx_pdu = tx_window->add_pdu(st.tx_next);
-  tx_pdu.pdcp_sn            = tx_sdu->md.pdcp_sn;
-  tx_pdu.sdu_buf            = srsran::make_byte_buffer();
+  tx_pdu.segment_list.set_pool(&segment_pool);
+  tx_pdu.pdcp_sn = tx_sdu->md.pdcp_sn;
+  tx_pdu.sdu_buf = srsran::make_byte_buffer();
   if (tx_pdu.sdu_buf == nullptr) {
     RlcError("Couldn't allocate PDU in %s().", __FUNCTION__);
     return 0;
@@ -675,7 +675,7 @@ uint32_t rlc_am_nr_tx::build_retx_pdu_with_segmentation(rlc_amd_retx_nr_t& retx,
   } else {
     // Retx is already a segment
     // Find current segment in segment list.
-    std::list<rlc_amd_tx_pdu_nr::pdu_segment>::iterator it;
+    rlc_amd_tx_pdu_nr::segment_list_t::iterator it;
     for (it = tx_pdu.segment_list.begin(); it != tx_pdu.segment_list.end(); ++it) {
       if (it->so == retx.current_so) {
         break;
@@ -689,9 +689,9 @@ uint32_t rlc_am_nr_tx::build_retx_pdu_with_segmentation(rlc_amd_retx_nr_t& retx,
       seg2.so                             = it->so + retx_pdu_payload_size;
       seg2.payload_len                    = it->payload_len - retx_pdu_payload_size;
 
-      std::list<rlc_amd_tx_pdu_nr::pdu_segment>::iterator begin_it   = tx_pdu.segment_list.erase(it);
-      std::list<rlc_amd_tx_pdu_nr::pdu_segment>::iterator insert_it  = tx_pdu.segment_list.insert(begin_it, seg2);
-      std::list<rlc_amd_tx_pdu_nr::pdu_segment>::iterator insert_it2 = tx_pdu.segment_list.insert(insert_it, seg1);
+      // The segment is split in place
+      *it = seg1;
+      tx_pdu.segment_list.insert_after(it, seg2);
       RlcDebug("Old segment SN=%d, SO=%d len=%d", retx.sn, retx.current_so, retx.segment_length);
       RlcDebug("New segment SN=%d, SO=%d len=%d", retx.sn, seg1.so, seg1.payload_len);
       RlcDebug("New segment SN=%d, SO=%d len=%d", retx.sn, seg2.so, seg2.payload_len);
@@ -762,8 +762,8 @@ uint32_t rlc_am_nr_tx::get_retx_expected_hdr_len(const rlc_amd_retx_nr_t& retx)
 uint32_t rlc_am_nr_tx::build_status_pdu(byte_buffer_t* payload, uint32_t nof_bytes)
 {
   RlcInfo("generating status PDU. Bytes available:%d", nof_bytes);
-  rlc_am_nr_status_pdu_t status(cfg.rx_sn_field_length); // carries status of RX entity, hence use SN length of RX
-  int                    pdu_len = rx->get_status_pdu(&status, nof_bytes);
+  rlc_am_nr_status_pdu_t& status  = *tx_status; // carries status of RX entity, hence uses SN length of RX
+  int                     pdu_len = rx->get_status_pdu(&status, nof_bytes);
   if (pdu_len == SRSRAN_ERROR) {
     RlcDebug("deferred status PDU. Cause: Failed to acquire rx lock");
     pdu_len = 0;
@@ -786,7 +786,7 @@ void rlc_am_nr_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
   }
 
   std::lock_guard<std::mutex> lock(mutex);
-  rlc_am_nr_status_pdu_t      status(cfg.tx_sn_field_length);
+  rlc_am_nr_status_pdu_t&     status = *rx_status;
   RlcHexDebug(payload, nof_bytes, "%s Rx control PDU", parent->rb_name);
   rlc_am_nr_read_status_pdu(payload, nof_bytes, cfg.tx_sn_field_length, &status);
   log_rlc_am_nr_status_pdu_to_string(logger.info, "RX status PDU: %s", &status, parent->rb_name);
@@ -857,7 +857,7 @@ void rlc_am_nr_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
   RlcDebug("Processed status report ACKs. ACK_SN=%d. Tx_Next_Ack=%d", status.ack_sn, st.tx_next_ack);
 
   // Process N_nacks
-  std::set<uint32_t> retx_sn_set; // Set of PDU SNs added for retransmission (no duplicates)
+  retx_sn_list.clear(); // PDU SNs added for retransmission
   for (uint32_t nack_idx = 0; nack_idx < status.nacks.size(); nack_idx++) {
     if (status.nacks[nack_idx].has_nack_range) {
       for (uint32_t range_sn = status.nacks[nack_idx].nack_sn;
@@ -877,15 +877,19 @@ void rlc_am_nr_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
           // Enable has_so only if the offsets do not span the whole SDU
           nack.has_so = (nack.so_start != 0) || (nack.so_end != rlc_status_nack_t::so_end_of_sdu);
         }
-        handle_nack(nack, retx_sn_set);
+        handle_nack(nack, retx_sn_list);
       }
     } else {
-      handle_nack(status.nacks[nack_idx], retx_sn_set);
+      handle_nack(status.nacks[nack_idx], retx_sn_list);
     }
   }
 
+  // Remove duplicates
+  std::sort(retx_sn_list.begin(), retx_sn_list.end());
+  retx_sn_list.erase(std::unique(retx_sn_list.begin(), retx_sn_list.end()), retx_sn_list.end());
+
   // Process retx_count and inform upper layers if needed
-  for (uint32_t retx_sn : retx_sn_set) {
+  for (uint32_t retx_sn : retx_sn_list) {
     auto& pdu = (*tx_window)[retx_sn];
     // Increment retx_count
     if (pdu.retx_count == RETX_COUNT_NOT_STARTED) {
@@ -907,7 +911,7 @@ void rlc_am_nr_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
   notify_info_vec.clear();
 }
 
-void rlc_am_nr_tx::handle_nack(const rlc_status_nack_t& nack, std::set<uint32_t>& retx_sn_set)
+void rlc_am_nr_tx::handle_nack(const rlc_status_nack_t& nack, std::vector<uint32_t>& retx_sn_list)
 {
   if (tx_mod_base_nr(st.tx_next_ack) <= tx_mod_base_nr(nack.nack_sn) &&
       tx_mod_base_nr(nack.nack_sn) <= tx_mod_base_nr(st.tx_next)) {
@@ -931,7 +935,7 @@ void rlc_am_nr_tx::handle_nack(const rlc_status_nack_t& nack, std::set<uint32_t>
               retx.so_start           = segm.so;
               retx.current_so         = segm.so;
               retx.segment_length     = segm.payload_len;
-              retx_sn_set.insert(nack.nack_sn);
+              retx_sn_list.push_back(nack.nack_sn);
               RlcInfo("Scheduled RETX of SDU segment SN=%d, so_start=%d, segment_length=%d",
                       retx.sn,
                       retx.so_start,
@@ -966,11 +970,11 @@ void rlc_am_nr_tx::handle_nack(const rlc_status_nack_t& nack, std::set<uint32_t>
             retx.so_start           = 0;
             retx.current_so         = 0;
             retx.segment_length     = pdu.sdu_buf->N_bytes;
-            retx_sn_set.insert(nack.nack_sn);
+            retx_sn_list.push_back(nack.nack_sn);
             RlcInfo("Scheduled RETX of SDU SN=%d", retx.sn);
           } else {
             RlcInfo("Scheduled RETX of SDU SN=%d", nack.nack_sn);
-            retx_sn_set.insert(nack.nack_sn);
+            retx_sn_list.push_back(nack.nack_sn);
             for (auto segm : (*tx_window)[nack.nack_sn].segment_list) {
               rlc_amd_retx_nr_t& retx = retx_queue.push();
               retx.sn                 = nack.nack_sn;
@@ -1404,6 +1408,7 @@ bool rlc_am_nr_rx::configure(const rlc_config_t& cfg_)
       RlcError("attempt to configure unsupported rx_sn_field_length %s", to_string(cfg.rx_sn_field_length));
       return false;
   }
+  length_status = std::unique_ptr<rlc_am_nr_status_pdu_t>(new rlc_am_nr_status_pdu_t(cfg.rx_sn_field_length));
 
   RlcDebug("RLC AM NR configured rx entity.");
 
@@ -1679,6 +1684,7 @@ int rlc_am_nr_rx::handle_segment_data_sdu(const rlc_am_nr_pdu_header_t& header,
 
   // Add a new SDU to the RX window if necessary
   rlc_amd_rx_sdu_nr_t& rx_sdu = rx_window->has_sn(header.sn) ? (*rx_window)[header.sn] : rx_window->add_pdu(header.sn);
+  rx_sdu.segments.set_pool(&segment_pool);
 
   // Create PDU segment info, to be stored later
   rlc_amd_rx_pdu_nr pdu_segment = {};
@@ -1733,6 +1739,10 @@ uint32_t rlc_am_nr_rx::get_status_pdu(rlc_am_nr_status_pdu_t* status, uint32_t m
    */
   RlcDebug("Generating status PDU");
   for (uint32_t i = st.rx_next; rx_mod_base_nr(i) < rx_mod_base_nr(st.rx_highest_status); i = (i + 1) % mod_nr) {
+    if (status->has_dropped_nacks()) {
+      RlcWarning("NACK list full, stopping status PDU at SN=%d", i);
+      break;
+    }
     if ((rx_window->has_sn(i) && (*rx_window)[i].fully_received)) {
       RlcDebug("SDU SN=%d is fully received", i);
     } else {
@@ -1809,8 +1819,8 @@ uint32_t rlc_am_nr_rx::get_status_pdu(rlc_am_nr_status_pdu_t* status, uint32_t m
    */
   status->ack_sn = st.rx_highest_status;
 
-  // trim PDU if necessary
-  if (status->packed_size > max_len) {
+  // trim PDU if necessary, this also moves ACK_SN back to the NACKs that did not fit into the NACK list
+  if (status->packed_size > max_len || status->has_dropped_nacks()) {
     RlcInfo("Trimming status PDU with %d NACKs and packed_size=%d into max_len=%d",
             status->nacks.size(),
             status->packed_size,
@@ -1834,9 +1844,9 @@ uint32_t rlc_am_nr_rx::get_status_pdu(rlc_am_nr_status_pdu_t* status, uint32_t m
 
 uint32_t rlc_am_nr_rx::get_status_pdu_length()
 {
-  rlc_am_nr_status_pdu_t tmp_status(cfg.rx_sn_field_length);
-  get_status_pdu(&tmp_status, UINT32_MAX);
-  return tmp_status.get_packed_size();
+  // Only called by the TX entity, under its lock
+  get_status_pdu(length_status.get(), UINT32_MAX);
+  return length_status->get_packed_size();
 }
 
 bool rlc_am_nr_rx::get_do_status()
@@ -1919,10 +1929,10 @@ void rlc_am_nr_rx::write_to_upper_layers(uint32_t lcid, unique_byte_buffer_t sdu
 /*
  * Segment Helpers
  */
-void rlc_am_nr_rx::insert_received_segment(rlc_amd_rx_pdu_nr                                   segment,
-                                           std::set<rlc_amd_rx_pdu_nr, rlc_amd_rx_pdu_nr_cmp>& segment_list) const
+void rlc_am_nr_rx::insert_received_segment(rlc_amd_rx_pdu_nr                     segment,
+                                           rlc_amd_rx_sdu_nr_t::segment_list_t& segment_list) const
 {
-  segment_list.insert(std::move(segment));
+  segment_list.insert_sorted(std::move(segment), rlc_amd_rx_pdu_nr_cmp{});
 }
 
 void rlc_am_nr_rx::update_segment_inventory(rlc_amd_rx_sdu_nr_t& rx_sdu) const
@@ -31,7 +31,6 @@ namespace srsran {
 rlc_am_nr_status_pdu_t::rlc_am_nr_status_pdu_t(rlc_am_nr_sn_size_t sn_size) :
   sn_size(sn_size), mod_nr(cardinality(sn_size))
 {
-  nacks_.reserve(RLC_AM_NR_TYP_NACKS);
 }
 
 void rlc_am_nr_status_pdu_t::reset()
@@ -40,6 +39,7 @@ void rlc_am_nr_status_pdu_t::reset()
   ack_sn = INVALID_RLC_SN;
   nacks_.clear();
   packed_size_ = rlc_am_nr_status_pdu_sizeof_header_ack_sn;
+  dropped_sn_  = INVALID_RLC_SN;
 }
 
 bool rlc_am_nr_status_pdu_t::is_continuous_sequence(const rlc_status_nack_t& left, const rlc_status_nack_t& right) const
@@ -62,19 +62,28 @@ bool rlc_am_nr_status_pdu_t::is_continuous_sequence(const rlc_status_nack_t& lef
   return true;
 }
 
-void rlc_am_nr_status_pdu_t::push_nack(const rlc_status_nack_t& nack)
+bool rlc_am_nr_status_pdu_t::push_nack(const rlc_status_nack_t& nack)
 {
+  if (has_dropped_nacks()) {
+    // NACKs are pushed in SN order, nothing after a dropped one can be reported
+    return false;
+  }
+
   if (nacks_.size() == 0) {
     nacks_.push_back(nack);
     packed_size_ += nack_size(nack);
-    return;
+    return true;
   }
 
   rlc_status_nack_t& prev = nacks_.back();
   if (is_continuous_sequence(prev, nack) == false) {
+    if (nacks_.full()) {
+      dropped_sn_ = nack.nack_sn;
+      return false;
+    }
     nacks_.push_back(nack);
     packed_size_ += nack_size(nack);
-    return;
+    return true;
   }
 
   // expand previous NACK
@@ -121,11 +130,12 @@ void rlc_am_nr_status_pdu_t::push_nack(const rlc_status_nack_t& nack)
 
   // add updated size
   packed_size_ += nack_size(prev);
+  return true;
 }
 
 bool rlc_am_nr_status_pdu_t::trim(uint32_t max_packed_size)
 {
-  if (max_packed_size >= packed_size_) {
+  if (max_packed_size >= packed_size_ && not has_dropped_nacks()) {
     // no trimming required
     return true;
   }
@@ -134,6 +144,12 @@ bool rlc_am_nr_status_pdu_t::trim(uint32_t max_packed_size)
     return false;
   }
 
+  // SDUs whose NACKs did not fit into the NACK list are not reported either
+  if (has_dropped_nacks()) {
+    ack_sn      = dropped_sn_;
+    dropped_sn_ = INVALID_RLC_SN;
+  }
+
   // remove NACKs (starting from the back) until it fits into given space
   // note: when removing a NACK for a segment, we have to remove all other NACKs with the same SN as well,
   // see TS 38.322 Sec. 5.3.4:
@@ -390,7 +406,11 @@ rlc_am_nr_read_status_pdu_12bit_sn(const uint8_t* payload, const uint32_t nof_by
       nack.nack_range     = (*ptr);
       ptr++;
     }
-    status->push_nack(nack);
+    if (not status->push_nack(nack)) {
+      // more NACKs than the list holds, the rest are considered not acknowledged
+      status->trim(UINT32_MAX);
+      break;
+    }
   }
 
   return SRSRAN_SUCCESS;
@@ -474,7 +494,11 @@ rlc_am_nr_read_status_pdu_18bit_sn(const uint8_t* payload, const uint32_t nof_by
       nack.nack_range     = (*ptr);
       ptr++;
     }
-    status->push_nack(nack);
+    if (not status->push_nack(nack)) {
+      // more NACKs than the list holds, the rest are considered not acknowledged
+      status->trim(UINT32_MAX);
+      break;
+    }
   }
 
   return SRSRAN_SUCCESS;
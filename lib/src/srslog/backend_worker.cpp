@@ -28,6 +28,7 @@ void backend_worker::stop()
 {
   // Signal the worker thread to stop.
   running_flag = false;
+  queue.notify();
   if (worker_thread.joinable()) {
     worker_thread.join();
   }
@@ -94,16 +95,12 @@ void backend_worker::start(backend_priority priority)
 
 void backend_worker::do_work()
 {
-  /// This period defines the time the worker will sleep while waiting for new entries. This is required to check the
-  /// termination variable periodically.
-  constexpr std::chrono::microseconds sleep_period{100};
-
   while (running_flag) {
     auto item = queue.try_pop();
 
-    // Spin while there are no new entries to process.
+    // Wait for new entries, stop() wakes the worker up to check the termination variable.
     if (!item.first) {
-      std::this_thread::sleep_for(sleep_period);
+      queue.wait();
       continue;
     }
 
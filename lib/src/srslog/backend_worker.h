@@ -26,6 +26,7 @@
 #include "mitm_lib/srslog/detail/support/dyn_arg_store_pool.h"
 #include "mitm_lib/srslog/detail/support/work_queue.h"
 #include "mitm_lib/srslog/shared_types.h"
+#include <atomic>
 #include <mutex>
 #include <thread>
 
@@ -113,7 +114,7 @@ private:
 private:
   detail::work_queue<detail::log_entry>& queue;
   detail::dyn_arg_store_pool&            arg_pool;
-  detail::shared_variable<bool>          running_flag;
+  std::atomic<bool>                      running_flag;
   error_handler      err_handler = [](const std::string& error) { fmt::print(stderr, "srsLog error - {}\n", error); };
   std::once_flag     start_once_flag;
   std::thread        worker_thread;
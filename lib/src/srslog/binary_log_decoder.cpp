@@ -0,0 +1,279 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_log_format.h"
+#include "mitm_lib/srslog/detail/log_entry_metadata.h"
+#include "mitm_lib/srslog/srslog.h"
+#include <unordered_map>
+
+using namespace srslog;
+
+namespace {
+
+/// Decodes the records of a binary ring file into log entries and renders them with a formatter.
+class binary_log_decoder
+{
+public:
+  binary_log_decoder(log_formatter& f, std::FILE* out) : f(f), out(out) {}
+
+  /// Decodes the file contents, returns false and fills in error if they are not valid.
+  bool decode(const std::vector<uint8_t>& file, std::string& error)
+  {
+    if (file.size() < sizeof(binary_log::file_header)) {
+      error = "File too short for a binary log header";
+      return false;
+    }
+    auto hdr = binary_log::read<binary_log::file_header>(file.data());
+    if (std::memcmp(hdr.magic, binary_log::file_magic, sizeof(hdr.magic)) != 0) {
+      error = "Not a binary log file";
+      return false;
+    }
+    if (hdr.version != binary_log::file_version) {
+      error = fmt::format("Unsupported binary log version {}", hdr.version);
+      return false;
+    }
+    if (hdr.header_size + hdr.string_size + hdr.ring_size > file.size() || hdr.string_used > hdr.string_size ||
+        hdr.ring_used > hdr.ring_size || hdr.ring_head >= hdr.ring_size) {
+      error = "Binary log header does not match the file size";
+      return false;
+    }
+
+    const uint8_t* strings = file.data() + hdr.header_size;
+    const uint8_t* ring    = strings + hdr.string_size;
+
+    // String table.
+    for (uint64_t pos = 0; pos != hdr.string_used;) {
+      auto rec = binary_log::read<binary_log::record_header>(strings + pos);
+      if (!valid_record(rec, hdr.string_used - pos) || rec.type != binary_log::string_record) {
+        error = fmt::format("Corrupted string record at offset {}", pos);
+        return false;
+      }
+      if (!decode_string(strings + pos + sizeof(rec), rec.size - sizeof(rec))) {
+        error = fmt::format("Corrupted string record at offset {}", pos);
+        return false;
+      }
+      pos += rec.size;
+    }
+
+    // Ring, from the oldest record.
+    uint64_t pos = hdr.ring_head;
+    for (uint64_t left = hdr.ring_used; left != 0;) {
+      auto rec = binary_log::read<binary_log::record_header>(ring + pos);
+      if (!valid_record(rec, std::min(left, hdr.ring_size - pos))) {
+        error = fmt::format("Corrupted record at ring offset {}", pos);
+        return false;
+      }
+      const uint8_t* data = ring + pos + sizeof(rec);
+      size_t         len  = rec.size - sizeof(rec);
+      bool           ok   = true;
+      switch (rec.type) {
+        case binary_log::entry_record:
+          ok = decode_entry(data, len);
+          break;
+        case binary_log::text_record:
+          ok = decode_text(data, len);
+          break;
+        case binary_log::wrap_record:
+          break;
+        default:
+          ok = false;
+      }
+      if (!ok) {
+        error = fmt::format("Corrupted record at ring offset {}", pos);
+        return false;
+      }
+      pos = (pos + rec.size) % hdr.ring_size;
+      left -= rec.size;
+    }
+    return true;
+  }
+
+private:
+  static bool valid_record(const binary_log::record_header& rec, uint64_t space)
+  {
+    return rec.size >= sizeof(rec) && rec.size <= space && rec.size % binary_log::record_alignment == 0;
+  }
+
+  bool decode_string(const uint8_t* data, size_t len)
+  {
+    if (len < sizeof(binary_log::string_def)) {
+      return false;
+    }
+    auto def = binary_log::read<binary_log::string_def>(data);
+    if (def.length > len - sizeof(def)) {
+      return false;
+    }
+    strings[def.id].assign(reinterpret_cast<const char*>(data + sizeof(def)), def.length);
+    return true;
+  }
+
+  /// Returns the text of a string ID, or a placeholder when its record was lost.
+  const std::string& get_string(uint32_t id)
+  {
+    auto it = strings.find(id);
+    if (it != strings.end()) {
+      return it->second;
+    }
+    std::string& str = strings[id];
+    str              = fmt::format("<string #{}>", id);
+    return str;
+  }
+
+  bool decode_text(const uint8_t* data, size_t len)
+  {
+    if (len < sizeof(uint32_t)) {
+      return false;
+    }
+    auto text_len = binary_log::read<uint32_t>(data);
+    if (text_len > len - sizeof(uint32_t)) {
+      return false;
+    }
+    std::fwrite(data + sizeof(uint32_t), 1, text_len, out);
+    return true;
+  }
+
+  bool decode_entry(const uint8_t* data, size_t len)
+  {
+    if (len < sizeof(binary_log::entry_header)) {
+      return false;
+    }
+    auto           hdr = binary_log::read<binary_log::entry_header>(data);
+    const uint8_t* ptr = data + sizeof(hdr);
+    const uint8_t* end = data + len;
+
+    store.clear();
+    for (unsigned i = 0; i != hdr.nof_args; ++i) {
+      if (!decode_arg(ptr, end)) {
+        return false;
+      }
+    }
+    if (hdr.hex_dump_len > size_t(end - ptr)) {
+      return false;
+    }
+
+    using clock = std::chrono::high_resolution_clock;
+    auto tp     = std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(hdr.tp_ns));
+
+    detail::log_entry_metadata metadata;
+    metadata.tp        = clock::time_point(tp);
+    metadata.context   = {hdr.context_value, hdr.context_enabled != 0};
+    metadata.fmtstring = hdr.fmt_id != binary_log::no_string ? get_string(hdr.fmt_id).c_str() : nullptr;
+    metadata.store     = (hdr.flags & binary_log::entry_has_store) ? &store : nullptr;
+    metadata.log_name  = hdr.name_id != binary_log::no_string ? get_string(hdr.name_id) : std::string();
+    metadata.log_tag   = hdr.log_tag;
+    metadata.hex_dump.assign(ptr, ptr + hdr.hex_dump_len);
+
+    buffer.clear();
+    f.format(std::move(metadata), buffer);
+    std::fwrite(buffer.data(), 1, buffer.size(), out);
+    return true;
+  }
+
+  /// Pushes the argument at ptr into the store and advances ptr past it.
+  bool decode_arg(const uint8_t*& ptr, const uint8_t* end)
+  {
+    if (ptr == end) {
+      return false;
+    }
+    auto type = static_cast<binary_log::arg_type>(*ptr++);
+
+    if (type == binary_log::string_arg) {
+      if (size_t(end - ptr) < sizeof(uint32_t)) {
+        return false;
+      }
+      auto str_len = binary_log::read<uint32_t>(ptr);
+      ptr += sizeof(uint32_t);
+      if (str_len > size_t(end - ptr)) {
+        return false;
+      }
+      store.push_back(std::string(reinterpret_cast<const char*>(ptr), str_len));
+      ptr += str_len;
+      return true;
+    }
+
+    if (size_t(end - ptr) < sizeof(uint64_t)) {
+      return false;
+    }
+    auto value = binary_log::read<uint64_t>(ptr);
+    ptr += sizeof(uint64_t);
+    switch (type) {
+      case binary_log::int_arg:
+        store.push_back(static_cast<int>(value));
+        break;
+      case binary_log::uint_arg:
+        store.push_back(static_cast<unsigned>(value));
+        break;
+      case binary_log::long_long_arg:
+        store.push_back(static_cast<long long>(value));
+        break;
+      case binary_log::ulong_long_arg:
+        store.push_back(static_cast<unsigned long long>(value));
+        break;
+      case binary_log::bool_arg:
+        store.push_back(value != 0);
+        break;
+      case binary_log::char_arg:
+        store.push_back(static_cast<char>(value));
+        break;
+      case binary_log::double_arg:
+        store.push_back(binary_log::read<double>(ptr - sizeof(uint64_t)));
+        break;
+      case binary_log::long_double_arg:
+        store.push_back(static_cast<long double>(binary_log::read<double>(ptr - sizeof(uint64_t))));
+        break;
+      case binary_log::pointer_arg:
+        store.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(value)));
+        break;
+      default:
+        return false;
+    }
+    return true;
+  }
+
+private:
+  log_formatter&                                     f;
+  std::FILE*                                         out;
+  std::unordered_map<uint32_t, std::string>          strings;
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  fmt::memory_buffer                                 buffer;
+};
+
+} // namespace
+
+bool srslog::decode_binary_ring_file(const std::string& path, log_formatter& f, std::FILE* out, std::string& error)
+{
+  std::FILE* in = std::fopen(path.c_str(), "rb");
+  if (!in) {
+    error = fmt::format("Unable to open binary log file \"{}\": {}", path, std::strerror(errno));
+    return false;
+  }
+
+  std::vector<uint8_t> file;
+  uint8_t              chunk[64 * 1024];
+  size_t               n;
+  while ((n = std::fread(chunk, 1, sizeof(chunk), in)) != 0) {
+    file.insert(file.end(), chunk, chunk + n);
+  }
+  std::fclose(in);
+
+  binary_log_decoder decoder(f, out);
+  return decoder.decode(file, error);
+}
@@ -0,0 +1,129 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_LOG_FORMAT_H
+#define SRSLOG_BINARY_LOG_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace srslog {
+
+/// Layout of the binary log records written by the binary formatter and of the ring file they are kept in. Values
+/// are stored in the byte order of the host that logs, the decoder runs on the same kind of host.
+namespace binary_log {
+
+/// Every record starts with this header, its size includes the header and is a multiple of record_alignment.
+struct record_header {
+  uint32_t size;
+  uint16_t type;
+  uint16_t reserved;
+};
+
+constexpr uint32_t record_alignment = 8;
+
+inline uint32_t aligned_size(uint32_t size)
+{
+  return (size + record_alignment - 1) & ~(record_alignment - 1);
+}
+
+enum record_type : uint16_t {
+  /// Text of a format string or log channel name, referred to by its ID in the log entry records. Followed by a
+  /// string_def.
+  string_record = 1,
+  /// Unformatted log entry. Followed by an entry_header, the arguments and the hex dump.
+  entry_record = 2,
+  /// Log entry already rendered to text, e.g. a context dump. Followed by the length of the text and the text.
+  text_record = 3,
+  /// Filler up to the end of the ring, the next record is at the start of the ring.
+  wrap_record = 4,
+};
+
+struct string_def {
+  uint32_t id;
+  uint32_t length;
+};
+
+/// String IDs start at 1, 0 stands for no string.
+constexpr uint32_t no_string = 0;
+
+struct entry_header {
+  int64_t  tp_ns; ///< time since the epoch of the high resolution clock
+  uint32_t fmt_id;
+  uint32_t name_id;
+  uint32_t context_value;
+  uint32_t hex_dump_len;
+  uint16_t nof_args;
+  uint8_t  context_enabled;
+  char     log_tag;
+  uint32_t flags;
+};
+
+/// The entry has an argument store, its format string is formatted with the arguments rather than written as is.
+constexpr uint32_t entry_has_store = 1;
+
+/// Each argument is its type followed by its value: 8 bytes for numbers and pointers, for strings their length as a
+/// uint32_t and their characters. Arguments of other types are stored as strings, formatted with "%s".
+enum arg_type : uint8_t {
+  int_arg = 1,
+  uint_arg,
+  long_long_arg,
+  ulong_long_arg,
+  bool_arg,
+  char_arg,
+  double_arg,
+  long_double_arg,
+  string_arg,
+  pointer_arg,
+};
+
+/// The ring file is this header, followed by the string table of string_size bytes, holding string records, and by
+/// the ring of ring_size bytes, holding the other records. Strings are never overwritten; once the table is full,
+/// new format strings are rendered as their ID. The oldest records of the ring are overwritten by new ones.
+struct file_header {
+  char     magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint64_t string_size;
+  uint64_t string_used;
+  uint64_t ring_size;
+  uint64_t ring_head; ///< offset of the oldest record
+  uint64_t ring_used; ///< bytes from ring_head up to the end of the newest record, including fillers
+  uint64_t nof_lost;  ///< log entries overwritten in the ring
+};
+
+constexpr char     file_magic[8] = {'S', 'R', 'S', 'L', 'O', 'G', 'B', '\0'};
+constexpr uint32_t file_version  = 1;
+
+/// Copies a value out of a possibly unaligned buffer.
+template <typename T>
+T read(const uint8_t* ptr)
+{
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+} // namespace binary_log
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_LOG_FORMAT_H
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_formatter.h"
+#include "../binary_log_format.h"
+#include "mitm_lib/srslog/detail/log_entry_metadata.h"
+
+using namespace srslog;
+
+std::unique_ptr<log_formatter> binary_formatter::clone() const
+{
+  // The string records were only written for the sink of this instance, a copy starts over.
+  return std::unique_ptr<log_formatter>(new binary_formatter);
+}
+
+/// Appends the raw bytes of a value to the buffer.
+template <typename T>
+static void append(fmt::memory_buffer& buffer, const T& value)
+{
+  const char* ptr = reinterpret_cast<const char*>(&value);
+  buffer.append(ptr, ptr + sizeof(T));
+}
+
+/// Starts a record of the given type, returns its offset in the buffer.
+static size_t begin_record(fmt::memory_buffer& buffer, binary_log::record_type type)
+{
+  size_t offset = buffer.size();
+  append(buffer, binary_log::record_header{0, type, 0});
+  return offset;
+}
+
+/// Pads the record starting at offset to the record alignment and sets its size.
+static void end_record(fmt::memory_buffer& buffer, size_t offset)
+{
+  size_t   unpadded = buffer.size();
+  uint32_t size     = binary_log::aligned_size(unpadded - offset);
+  buffer.resize(offset + size);
+  std::fill(buffer.data() + unpadded, buffer.data() + buffer.size(), 0);
+  std::memcpy(buffer.data() + offset, &size, sizeof(size));
+}
+
+namespace {
+
+/// Appends an argument of the store to the buffer.
+struct arg_writer {
+  fmt::memory_buffer&                               buffer;
+  const fmt::basic_format_arg<fmt::printf_context>& arg;
+
+  template <typename T>
+  void write_value(binary_log::arg_type type, T value)
+  {
+    static_assert(sizeof(T) == 8, "Argument values take 8 bytes");
+    append(buffer, static_cast<uint8_t>(type));
+    append(buffer, value);
+  }
+
+  void write_string(fmt::string_view str)
+  {
+    append(buffer, static_cast<uint8_t>(binary_log::string_arg));
+    append(buffer, static_cast<uint32_t>(str.size()));
+    buffer.append(str.data(), str.data() + str.size());
+  }
+
+  void operator()(int v) { write_value(binary_log::int_arg, static_cast<int64_t>(v)); }
+  void operator()(unsigned v) { write_value(binary_log::uint_arg, static_cast<uint64_t>(v)); }
+  void operator()(long long v) { write_value(binary_log::long_long_arg, static_cast<int64_t>(v)); }
+  void operator()(unsigned long long v) { write_value(binary_log::ulong_long_arg, static_cast<uint64_t>(v)); }
+  void operator()(bool v) { write_value(binary_log::bool_arg, static_cast<uint64_t>(v)); }
+  void operator()(char v) { write_value(binary_log::char_arg, static_cast<uint64_t>(v)); }
+  void operator()(float v) { write_value(binary_log::double_arg, static_cast<double>(v)); }
+  void operator()(double v) { write_value(binary_log::double_arg, v); }
+  // Kept with the precision of a double.
+  void operator()(long double v) { write_value(binary_log::long_double_arg, static_cast<double>(v)); }
+  void operator()(const char* v) { write_string(v ? fmt::string_view(v) : fmt::string_view("(null)")); }
+  void operator()(fmt::string_view v) { write_string(v); }
+  void operator()(const void* v) { write_value(binary_log::pointer_arg, reinterpret_cast<uint64_t>(v)); }
+
+  /// Other types, e.g. those with a custom formatter, are stored formatted.
+  template <typename T>
+  void operator()(T)
+  {
+    fmt::memory_buffer                         str;
+    fmt::basic_format_args<fmt::printf_context> one_arg(&arg, 1);
+    try {
+      fmt::vprintf(str, fmt::to_string_view("%s"), one_arg);
+    } catch (...) {
+      str.clear();
+    }
+    write_string({str.data(), str.size()});
+  }
+};
+
+} // namespace
+
+void binary_formatter::format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer)
+{
+  binary_log::entry_header hdr = {};
+
+  hdr.tp_ns           = std::chrono::duration_cast<std::chrono::nanoseconds>(metadata.tp.time_since_epoch()).count();
+  hdr.fmt_id          = metadata.fmtstring ? get_fmt_id(metadata.fmtstring, buffer) : binary_log::no_string;
+  hdr.name_id         = metadata.log_name.empty() ? binary_log::no_string : get_name_id(metadata.log_name, buffer);
+  hdr.context_value   = metadata.context.value;
+  hdr.context_enabled = metadata.context.enabled;
+  hdr.log_tag         = metadata.log_tag;
+  hdr.hex_dump_len    = metadata.hex_dump.size();
+
+  // The header goes in first and is completed once the arguments are counted.
+  size_t offset     = begin_record(buffer, binary_log::entry_record);
+  size_t hdr_offset = buffer.size();
+  append(buffer, hdr);
+
+  if (metadata.store) {
+    hdr.flags |= binary_log::entry_has_store;
+    fmt::basic_format_args<fmt::printf_context> args(*metadata.store);
+    for (int i = 0, e = args.max_size(); i != e; ++i) {
+      auto arg = args.get(i);
+      if (!arg) {
+        break;
+      }
+      fmt::visit_format_arg(arg_writer{buffer, arg}, arg);
+      ++hdr.nof_args;
+    }
+  }
+
+  const char* hex_dump = reinterpret_cast<const char*>(metadata.hex_dump.data());
+  buffer.append(hex_dump, hex_dump + metadata.hex_dump.size());
+
+  std::memcpy(buffer.data() + hdr_offset, &hdr, sizeof(hdr));
+  end_record(buffer, offset);
+}
+
+void binary_formatter::format_context_begin(const detail::log_entry_metadata& md,
+                                            fmt::string_view                  ctx_name,
+                                            unsigned                          size,
+                                            fmt::memory_buffer&               buffer)
+{
+  ctx_record_offset = begin_record(buffer, binary_log::text_record);
+  append(buffer, uint32_t(0));
+  text_formatter::format_context_begin(md, ctx_name, size, buffer);
+}
+
+void binary_formatter::format_context_end(const detail::log_entry_metadata& md,
+                                          fmt::string_view                  ctx_name,
+                                          fmt::memory_buffer&               buffer)
+{
+  text_formatter::format_context_end(md, ctx_name, buffer);
+
+  size_t   len_offset = ctx_record_offset + sizeof(binary_log::record_header);
+  uint32_t len        = buffer.size() - len_offset - sizeof(uint32_t);
+  std::memcpy(buffer.data() + len_offset, &len, sizeof(len));
+  end_record(buffer, ctx_record_offset);
+}
+
+uint32_t binary_formatter::get_fmt_id(const char* fmtstring, fmt::memory_buffer& buffer)
+{
+  auto it = fmt_ids.find(fmtstring);
+  if (it != fmt_ids.end() && it->second.second == fmtstring) {
+    return it->second.first;
+  }
+
+  // New format string, or a new one at the address of an old one.
+  uint32_t id        = add_string(fmtstring, buffer);
+  fmt_ids[fmtstring] = {id, fmtstring};
+  return id;
+}
+
+uint32_t binary_formatter::get_name_id(const std::string& name, fmt::memory_buffer& buffer)
+{
+  auto it = name_ids.find(name);
+  if (it != name_ids.end()) {
+    return it->second;
+  }
+
+  uint32_t id    = add_string(name, buffer);
+  name_ids[name] = id;
+  return id;
+}
+
+uint32_t binary_formatter::add_string(fmt::string_view str, fmt::memory_buffer& buffer)
+{
+  uint32_t id     = next_id++;
+  size_t   offset = begin_record(buffer, binary_log::string_record);
+  append(buffer, binary_log::string_def{id, static_cast<uint32_t>(str.size())});
+  buffer.append(str.data(), str.data() + str.size());
+  end_record(buffer, offset);
+  return id;
+}
@@ -0,0 +1,72 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_FORMATTER_H
+#define SRSLOG_BINARY_FORMATTER_H
+
+#include "text_formatter.h"
+#include <string>
+#include <unordered_map>
+
+namespace srslog {
+
+/// Binary formatter implementation class. Log entries are not rendered: their metadata and arguments are copied into
+/// binary records (see binary_log_format.h), with the format strings and log channel names replaced by IDs. The text
+/// of an ID is written once, in a string record in front of the first entry using it. Context dumps are rendered as
+/// plain text into text records.
+class binary_formatter : public text_formatter
+{
+public:
+  std::unique_ptr<log_formatter> clone() const override;
+
+  void format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) override;
+
+private:
+  void format_context_begin(const detail::log_entry_metadata& md,
+                            fmt::string_view                  ctx_name,
+                            unsigned                          size,
+                            fmt::memory_buffer&               buffer) override;
+
+  void format_context_end(const detail::log_entry_metadata& md,
+                          fmt::string_view                  ctx_name,
+                          fmt::memory_buffer&               buffer) override;
+
+  /// Returns the ID of the format string, writing its string record the first time.
+  uint32_t get_fmt_id(const char* fmtstring, fmt::memory_buffer& buffer);
+
+  /// Returns the ID of the log channel name, writing its string record the first time.
+  uint32_t get_name_id(const std::string& name, fmt::memory_buffer& buffer);
+
+  /// Writes the string record of a new ID.
+  uint32_t add_string(fmt::string_view str, fmt::memory_buffer& buffer);
+
+private:
+  /// Format strings are looked up by address, their text is kept to detect a reused address.
+  std::unordered_map<const char*, std::pair<uint32_t, std::string> > fmt_ids;
+  std::unordered_map<std::string, uint32_t>                           name_ids;
+  uint32_t                                                            next_id = 1;
+  /// Offset in the buffer of the text record of the context being formatted.
+  size_t ctx_record_offset = 0;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_FORMATTER_H
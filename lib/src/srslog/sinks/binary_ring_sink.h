@@ -0,0 +1,201 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_RING_SINK_H
+#define SRSLOG_BINARY_RING_SINK_H
+
+#include "../binary_log_format.h"
+#include "file_utils.h"
+#include "mitm_lib/srslog/sink.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace srslog {
+
+/// This sink keeps the records of the binary formatter in a memory mapped file, laid out as described in
+/// binary_log_format.h. Writing a log entry is a copy into the mapping. Once the ring is full the oldest entries are
+/// overwritten, so that the file always holds the most recent ones. The file is created on the first write.
+class binary_ring_sink : public sink
+{
+public:
+  binary_ring_sink(std::string path, size_t ring_size, size_t string_size, std::unique_ptr<log_formatter> f) :
+    sink(std::move(f)),
+    path(std::move(path)),
+    ring_size(std::max<size_t>(ring_size, 4 * 1024) & ~size_t(binary_log::record_alignment - 1)),
+    string_size(std::max<size_t>(string_size, 4 * 1024) & ~size_t(binary_log::record_alignment - 1))
+  {}
+
+  binary_ring_sink(const binary_ring_sink& other) = delete;
+  binary_ring_sink& operator=(const binary_ring_sink& other) = delete;
+
+  ~binary_ring_sink() override { close_file(); }
+
+  detail::error_string write(detail::memory_buffer buffer) override
+  {
+    // Create the file the first time we hit this method, do not retry after an error.
+    if (!mapping && !failed) {
+      if (auto err_str = create_file()) {
+        failed = true;
+        return err_str;
+      }
+    }
+    if (!mapping) {
+      return {};
+    }
+
+    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(buffer.data());
+    const uint8_t* end = ptr + buffer.size();
+    while (ptr != end) {
+      auto hdr = binary_log::read<binary_log::record_header>(ptr);
+      if (size_t(end - ptr) < sizeof(hdr) || hdr.size < sizeof(hdr) || hdr.size > size_t(end - ptr)) {
+        return "Malformed binary log record, is the sink using the binary formatter?";
+      }
+      if (hdr.type == binary_log::string_record) {
+        append_string(ptr, hdr.size);
+      } else {
+        append_ring(ptr, hdr.size);
+      }
+      ptr += hdr.size;
+    }
+    return {};
+  }
+
+  detail::error_string flush() override
+  {
+    if (mapping && ::msync(mapping, map_size, MS_ASYNC) != 0) {
+      return file_utils::format_error(fmt::format("Unable to flush binary log file \"{}\"", path), errno);
+    }
+    return {};
+  }
+
+private:
+  /// Creates the file, maps it and writes an empty header.
+  detail::error_string create_file()
+  {
+    map_size = sizeof(binary_log::file_header) + string_size + ring_size;
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      return file_utils::format_error(fmt::format("Unable to create binary log file \"{}\"", path), errno);
+    }
+    if (::ftruncate(fd, map_size) != 0) {
+      auto err_str = file_utils::format_error(fmt::format("Unable to size binary log file \"{}\"", path), errno);
+      close_file();
+      return err_str;
+    }
+    void* ptr = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      auto err_str = file_utils::format_error(fmt::format("Unable to map binary log file \"{}\"", path), errno);
+      close_file();
+      return err_str;
+    }
+
+    mapping = static_cast<uint8_t*>(ptr);
+    header  = reinterpret_cast<binary_log::file_header*>(mapping);
+    strings = mapping + sizeof(binary_log::file_header);
+    ring    = strings + string_size;
+
+    *header = {};
+    std::memcpy(header->magic, binary_log::file_magic, sizeof(header->magic));
+    header->version     = binary_log::file_version;
+    header->header_size = sizeof(binary_log::file_header);
+    header->string_size = string_size;
+    header->ring_size   = ring_size;
+    return {};
+  }
+
+  void close_file()
+  {
+    if (mapping) {
+      ::msync(mapping, map_size, MS_SYNC);
+      ::munmap(mapping, map_size);
+      mapping = nullptr;
+    }
+    if (fd >= 0) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+
+  /// String records are kept for the lifetime of the file, those that don't fit are lost.
+  void append_string(const uint8_t* record, uint32_t size)
+  {
+    if (header->string_used + size > string_size) {
+      return;
+    }
+    std::memcpy(strings + header->string_used, record, size);
+    header->string_used += size;
+  }
+
+  /// Appends the record to the ring, a record never wraps around: when it does not fit before the end of the ring a
+  /// filler takes the rest and the record starts over at the beginning.
+  void append_ring(const uint8_t* record, uint32_t size)
+  {
+    if (size > ring_size / 2) {
+      header->nof_lost++;
+      return;
+    }
+
+    uint64_t tail = (header->ring_head + header->ring_used) % ring_size;
+    if (ring_size - tail < size) {
+      uint32_t fill = ring_size - tail;
+      make_room(fill);
+      binary_log::record_header filler = {fill, binary_log::wrap_record, 0};
+      std::memcpy(ring + tail, &filler, sizeof(filler));
+      header->ring_used += fill;
+      tail = 0;
+    }
+
+    make_room(size);
+    std::memcpy(ring + tail, record, size);
+    header->ring_used += size;
+  }
+
+  /// Drops the oldest records until there are n free bytes after the newest one.
+  void make_room(uint32_t n)
+  {
+    while (ring_size - header->ring_used < n) {
+      auto oldest = binary_log::read<binary_log::record_header>(ring + header->ring_head);
+      if (oldest.type != binary_log::wrap_record) {
+        header->nof_lost++;
+      }
+      header->ring_head = (header->ring_head + oldest.size) % ring_size;
+      header->ring_used -= oldest.size;
+    }
+  }
+
+private:
+  const std::string        path;
+  const size_t             ring_size;
+  const size_t             string_size;
+  size_t                   map_size = 0;
+  int                      fd       = -1;
+  bool                     failed   = false;
+  uint8_t*                 mapping  = nullptr;
+  binary_log::file_header* header   = nullptr;
+  uint8_t*                 strings  = nullptr;
+  uint8_t*                 ring     = nullptr;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_RING_SINK_H
@@ -20,7 +20,9 @@
  */
 
 #include "mitm_lib/srslog/srslog.h"
+#include "formatters/binary_formatter.h"
 #include "formatters/json_formatter.h"
+#include "sinks/binary_ring_sink.h"
 #include "sinks/file_sink.h"
 #include "sinks/syslog_sink.h"
 #include "srslog_instance.h"
@@ -197,6 +199,25 @@ sink& srslog::fetch_syslog_sink(const std::string&             preamble_,
   return *s;
 }
 
+sink& srslog::fetch_binary_ring_sink(const std::string& path, size_t ring_size, size_t string_size)
+{
+  assert(!path.empty() && "Empty path string");
+
+  if (auto* s = find_sink(path)) {
+    return *s;
+  }
+
+  //: TODO: GCC5 or lower versions emits an error if we use the new() expression
+  // directly, use redundant piecewise_construct instead.
+  auto& s = srslog_instance::get().get_sink_repo().emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple(path),
+      std::forward_as_tuple(new binary_ring_sink(
+          path, ring_size, string_size, std::unique_ptr<log_formatter>(new binary_formatter))));
+
+  return *s;
+}
+
 bool srslog::install_custom_sink(const std::string& id, std::unique_ptr<sink> s)
 {
   assert(!id.empty() && "Empty path string");
@@ -0,0 +1,61 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/// Renders a file written by the binary ring sink as text, or as JSON, to stdout.
+
+#include "mitm_lib/srslog/srslog.h"
+#include <getopt.h>
+
+static void usage(const char* prog)
+{
+  printf("Usage: %s [-j] file\n", prog);
+  printf("\t-j Render the log entries as JSON instead of text\n");
+  printf("\t-h show this message\n");
+}
+
+int main(int argc, char** argv)
+{
+  bool json = false;
+  int  opt;
+  while ((opt = getopt(argc, argv, "jh")) != -1) {
+    switch (opt) {
+      case 'j':
+        json = true;
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        return 0;
+    }
+  }
+  if (optind >= argc) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  auto        formatter = json ? srslog::create_json_formatter() : srslog::create_text_formatter();
+  std::string error;
+  if (!srslog::decode_binary_ring_file(argv[optind], *formatter, stdout, error)) {
+    fprintf(stderr, "%s: %s\n", argv[optind], error.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,150 @@
+#include "decode_cache.h"
+
+#include <cstring>
+
+#include "mitm_lib/srslog/bundled/fmt/format.h"
+
+decode_cache::decode_cache(size_t max_entries_, size_t max_bytes_, size_t max_pdu_size_) :
+    max_entries(max_entries_), max_bytes(max_bytes_), max_pdu_size(max_pdu_size_)
+{
+    index.reserve(max_entries);
+}
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+// Word-at-a-time multiplicative hash with a murmur3 finalizer. Collisions are resolved by comparing the PDU bytes.
+uint64_t decode_cache::hash_pdu(uint32_t direction, const uint8_t *buf, size_t n)
+{
+    const uint64_t k = 0x9e3779b97f4a7c15ULL;
+    uint64_t       h = ((uint64_t)direction << 32 | (uint32_t)n) * k;
+
+    for (; n >= 8; buf += 8, n -= 8)
+    {
+        uint64_t w;
+        memcpy(&w, buf, 8);
+        h = (rotl64(h, 5) ^ w) * k;
+    }
+    if (n > 0)
+    {
+        uint64_t w = 0;
+        memcpy(&w, buf, n);
+        h = (rotl64(h, 5) ^ w) * k;
+    }
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+int decode_cache::decode(uint32_t direction, uint8_t *buf, int n, asn1::json_writer &json_buffer, decode_fn decoder)
+{
+    if (not enabled or n <= 0 or (size_t)n > max_pdu_size or max_entries == 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            metrics.bypassed++;
+        }
+        return decoder(buf, n, json_buffer);
+    }
+
+    uint64_t                  hash      = hash_pdu(direction, buf, n);
+    asn1::json_writer::mark_t mark      = json_buffer.mark();
+    bool                      known_pdu = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto                        it = index.find(hash);
+        if (it != index.end())
+        {
+            entry_t &e = *it->second;
+            if (e.direction == direction and e.pdu.size() == (size_t)n and memcmp(e.pdu.data(), buf, n) == 0)
+            {
+                if (json_buffer.write_fragment(e.json))
+                {
+                    lru.splice(lru.begin(), lru, it->second);
+                    metrics.hits++;
+                    return e.result;
+                }
+                // cached, but the writer is not where the fragment was captured from
+                metrics.bypassed++;
+                known_pdu = true;
+            }
+        }
+    }
+
+    if (known_pdu)
+    {
+        return decoder(buf, n, json_buffer);
+    }
+
+    // decode outside of the lock, the cache only stores the outcome
+    int result = decoder(buf, n, json_buffer);
+
+    entry_t e;
+    e.hash      = hash;
+    e.direction = direction;
+    e.pdu.assign(buf, buf + n);
+    e.result = result;
+    json_buffer.copy_since(mark, e.json);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    metrics.misses++;
+    if (entry_bytes(e) > max_bytes)
+    {
+        return result;
+    }
+
+    // a colliding or concurrently inserted entry under the same hash is replaced
+    auto it = index.find(hash);
+    if (it != index.end())
+    {
+        evict(it->second);
+    }
+    while (not lru.empty() and (lru.size() >= max_entries or metrics.nof_bytes + entry_bytes(e) > max_bytes))
+    {
+        evict(std::prev(lru.end()));
+        metrics.evictions++;
+    }
+
+    metrics.nof_bytes += entry_bytes(e);
+    lru.push_front(std::move(e));
+    index.emplace(hash, lru.begin());
+    metrics.nof_entries = lru.size();
+
+    return result;
+}
+
+void decode_cache::evict(lru_list_t::iterator it)
+{
+    metrics.nof_bytes -= entry_bytes(*it);
+    index.erase(it->hash);
+    lru.erase(it);
+    metrics.nof_entries = lru.size();
+}
+
+decode_cache::metrics_t decode_cache::get_metrics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return metrics;
+}
+
+std::string decode_cache::metrics_to_string() const
+{
+    metrics_t m = get_metrics();
+    return fmt::format("Decode cache: hits={} misses={} hit rate={:.1f}% evictions={} bypassed={} entries={} bytes={}",
+                       m.hits, m.misses, m.hit_rate() * 100, m.evictions, m.bypassed, m.nof_entries, m.nof_bytes);
+}
+
+void decode_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    lru.clear();
+    index.clear();
+    metrics.nof_entries = 0;
+    metrics.nof_bytes   = 0;
+}
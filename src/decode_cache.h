@@ -0,0 +1,72 @@
+#ifndef __DECODE_CACHE__
+#define __DECODE_CACHE__
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mitm_lib/asn1/asn1_utils.h"
+
+// Bounded LRU cache of decoded datagrams, placed in front of UE::decode_packet/gNB::decode_packet.
+// Entries are keyed by (direction, datagram bytes), the datagram already starting with its channel, and keep the JSON
+// the decoder rendered together with its return code, so a repeated PDU skips unpack and to_json altogether.
+class decode_cache
+{
+public:
+    typedef int (*decode_fn)(uint8_t *buf, int n, asn1::json_writer &json_buffer);
+
+    struct metrics_t
+    {
+        uint64_t hits        = 0;
+        uint64_t misses      = 0;
+        uint64_t evictions   = 0;
+        uint64_t bypassed    = 0; // cache disabled, writer not in a replayable state, or PDU too large to cache
+        size_t   nof_entries = 0;
+        size_t   nof_bytes   = 0;
+
+        double hit_rate() const { return hits + misses > 0 ? (double)hits / (hits + misses) : 0; }
+    };
+
+    explicit decode_cache(size_t max_entries_ = 1024, size_t max_bytes_ = 16 * 1024 * 1024, size_t max_pdu_size_ = 4096);
+
+    // Appends the JSON of the datagram to json_buffer, from the cache or by calling decode
+    int decode(uint32_t direction, uint8_t *buf, int n, asn1::json_writer &json_buffer, decode_fn decoder);
+    // A disabled cache calls the decoder for every datagram, for decoders whose side effects must not be skipped
+    void set_enabled(bool enabled_) { enabled = enabled_; }
+
+    metrics_t   get_metrics() const;
+    std::string metrics_to_string() const;
+    void        clear();
+
+private:
+    struct entry_t
+    {
+        uint64_t             hash;
+        uint32_t             direction;
+        std::vector<uint8_t> pdu;
+        int                  result;
+        asn1::json_fragment  json;
+    };
+    typedef std::list<entry_t> lru_list_t;
+
+    static uint64_t hash_pdu(uint32_t direction, const uint8_t *buf, size_t n);
+    size_t          entry_bytes(const entry_t &e) const { return e.pdu.size() + e.json.text.size(); }
+    void            evict(lru_list_t::iterator it);
+
+    const size_t max_entries;
+    const size_t max_bytes;
+    const size_t max_pdu_size;
+
+    std::atomic<bool> enabled{true};
+
+    mutable std::mutex                                 mutex;
+    lru_list_t                                         lru; // most recently used first
+    std::unordered_map<uint64_t, lru_list_t::iterator> index;
+    metrics_t                                          metrics;
+};
+
+#endif
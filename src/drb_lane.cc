@@ -0,0 +1,364 @@
+#include "drb_lane.h"
+#include "mac_tap.h"
+#include "pdcp_relay.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "mitm_lib/common/common_nr.h"
+#include "mitm_lib/srslog/bundled/fmt/format.h"
+
+drb_lane::drb_lane(int src_sock_, int dst_sock_, peer_addr *src_addr_, const peer_addr *dst_addr_) :
+    src_sock(src_sock_), dst_sock(dst_sock_), src_addr(src_addr_), dst_addr(dst_addr_),
+    rx_buf(batch_size * max_datagram)
+{
+    pdcp_sdus.reserve(batch_size);
+    pdcp_pdus.reserve(batch_size);
+}
+
+void drb_lane::set_sampling(uint32_t period, int sample_sock_, const sockaddr_in &scenario_addr)
+{
+    sample_period = period;
+    sample_sock   = sample_sock_;
+    sample_addr   = scenario_addr;
+}
+
+bool drb_lane::is_drb(const uint8_t *buf, int n, uint32_t first_drb_lcid_)
+{
+    if (n < (int)sizeof(uint32_t))
+    {
+        return false;
+    }
+    uint32_t lcid;
+    memcpy(&lcid, buf, sizeof(lcid));
+    return is_drb_lcid(lcid, first_drb_lcid_);
+}
+
+bool drb_lane::is_drb_lcid(uint32_t lcid, uint32_t first_drb_lcid_)
+{
+    return lcid >= first_drb_lcid_ and srsran::is_nr_lcid(lcid);
+}
+
+void drb_lane::to_json(const uint8_t *buf, int n, asn1::json_writer &json_buffer)
+{
+    uint32_t lcid;
+    memcpy(&lcid, buf, sizeof(lcid));
+    to_json(lcid, buf + sizeof(lcid), n - sizeof(lcid), json_buffer);
+}
+
+void drb_lane::to_json(uint32_t lcid, const uint8_t *data, uint32_t len, asn1::json_writer &json_buffer)
+{
+    json_buffer.start_obj();
+    json_buffer.start_obj("DRB");
+    json_buffer.write_int("LCID", lcid);
+    json_buffer.write_int("Length", len);
+    json_buffer.write_octstring("Data", data, std::min(len, sample_bytes));
+    json_buffer.end_obj();
+    json_buffer.end_obj();
+}
+
+void drb_lane::run()
+{
+    mmsghdr     rx[batch_size];
+    iovec       rx_iov[batch_size];
+    sockaddr_in rx_addr[batch_size];
+
+    for (uint32_t i = 0; i < batch_size; i++)
+    {
+        rx_iov[i].iov_base = &rx_buf[i * max_datagram];
+        rx_iov[i].iov_len  = max_datagram;
+    }
+
+    while (running)
+    {
+        memset(rx, 0, sizeof(rx));
+        for (uint32_t i = 0; i < batch_size; i++)
+        {
+            rx[i].msg_hdr.msg_iov     = &rx_iov[i];
+            rx[i].msg_hdr.msg_iovlen  = 1;
+            rx[i].msg_hdr.msg_name    = &rx_addr[i];
+            rx[i].msg_hdr.msg_namelen = sizeof(rx_addr[i]);
+        }
+
+        // Blocks for the first datagram only, then takes whatever else is already queued
+        int nof_rx = recvmmsg(src_sock, rx, batch_size, MSG_WAITFORONE, nullptr);
+        if (nof_rx <= 0)
+        {
+            if (nof_rx < 0 and errno != EINTR and errno != EAGAIN and running)
+            {
+                perror("DRB lane recvmmsg");
+            }
+            continue;
+        }
+        if (not running)
+        {
+            // woken up by stop()
+            break;
+        }
+
+        metrics_t batch_metrics;
+        batch_metrics.batches++;
+        if (pdcp != nullptr)
+        {
+            pdcp->update_security();
+        }
+        for (int i = 0; i < nof_rx; i++)
+        {
+            uint8_t *buf = (uint8_t *)rx_iov[i].iov_base;
+            int      n   = rx[i].msg_len;
+            if (rx[i].msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                batch_metrics.dropped++;
+                continue;
+            }
+            if (mac != nullptr)
+            {
+                relay_mac(buf, n, batch_metrics);
+                continue;
+            }
+            if (not is_drb(buf, n, first_drb_lcid))
+            {
+                push_control(buf, n, batch_metrics);
+                continue;
+            }
+            uint32_t lcid;
+            memcpy(&lcid, buf, sizeof(lcid));
+            if (pdcp != nullptr)
+            {
+                if (nof_pdcp_run > 0 and lcid != pdcp_run_lcid)
+                {
+                    relay_pdcp(batch_metrics);
+                }
+                pdcp_run_lcid                   = lcid;
+                pdcp_run[nof_pdcp_run].iov_base = buf + sizeof(lcid);
+                pdcp_run[nof_pdcp_run].iov_len  = n - sizeof(lcid);
+                nof_pdcp_run++;
+                continue;
+            }
+            if (sample_period > 0 and ++nof_drb % sample_period == 0)
+            {
+                sample(lcid, buf + sizeof(lcid), n - sizeof(lcid), batch_metrics);
+            }
+            // Sent from the receive slot itself
+            queue_tx(buf, n, batch_metrics);
+        }
+        if (nof_pdcp_run > 0)
+        {
+            relay_pdcp(batch_metrics);
+        }
+        src_addr->store(rx_addr[nof_rx - 1]);
+        send_tx(batch_metrics);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        metrics.forwarded += batch_metrics.forwarded;
+        metrics.batches += batch_metrics.batches;
+        metrics.sampled += batch_metrics.sampled;
+        metrics.control += batch_metrics.control;
+        metrics.dropped += batch_metrics.dropped;
+        if (pdcp != nullptr)
+        {
+            pdcp_metrics = pdcp->metrics_to_string();
+        }
+    }
+}
+
+void drb_lane::relay_pdcp(metrics_t &batch_metrics)
+{
+    pdcp->terminate(pdcp_run_lcid, pdcp_run, nof_pdcp_run);
+    nof_pdcp_run = 0;
+
+    // SDUs released by t-Reordering may be of other LCIDs: they are re-originated in runs of one LCID too
+    uint32_t lcid = 0, run_lcid = 0;
+    for (srsran::unique_byte_buffer_t sdu = pdcp->pop_sdu(lcid); sdu != nullptr; sdu = pdcp->pop_sdu(lcid))
+    {
+        if (not pdcp_sdus.empty() and lcid != run_lcid)
+        {
+            reoriginate_pdcp(run_lcid, batch_metrics);
+        }
+        if (sample_period > 0 and ++nof_drb % sample_period == 0)
+        {
+            sample(lcid, sdu->msg, sdu->N_bytes, batch_metrics);
+        }
+        run_lcid = lcid;
+        pdcp_sdus.push_back(std::move(sdu));
+    }
+    if (not pdcp_sdus.empty())
+    {
+        reoriginate_pdcp(run_lcid, batch_metrics);
+    }
+}
+
+void drb_lane::reoriginate_pdcp(uint32_t lcid, metrics_t &batch_metrics)
+{
+    pdcp_pdus.clear();
+    pdcp->reoriginate(lcid, pdcp_sdus, pdcp_pdus);
+    batch_metrics.dropped += pdcp_sdus.size() - pdcp_pdus.size();
+    pdcp_sdus.clear();
+    for (srsran::unique_byte_buffer_t &tx_buf : pdcp_pdus)
+    {
+        if (nof_tx == batch_size)
+        {
+            send_tx(batch_metrics);
+        }
+        tx_lcid[nof_tx]                 = lcid;
+        tx_iov[2 * nof_tx].iov_base     = &tx_lcid[nof_tx];
+        tx_iov[2 * nof_tx].iov_len      = sizeof(lcid);
+        tx_iov[2 * nof_tx + 1].iov_base = tx_buf->msg;
+        tx_iov[2 * nof_tx + 1].iov_len  = tx_buf->N_bytes;
+        memset(&tx[nof_tx], 0, sizeof(tx[nof_tx]));
+        tx[nof_tx].msg_hdr.msg_iov    = &tx_iov[2 * nof_tx];
+        tx[nof_tx].msg_hdr.msg_iovlen = 2;
+        tx_pdu[nof_tx]                = std::move(tx_buf);
+        nof_tx++;
+    }
+}
+
+void drb_lane::relay_mac(const uint8_t *tb, uint32_t n, metrics_t &batch_metrics)
+{
+    // Malformed TBs are left to the worker too, which reports them
+    if (mac->unpack(tb, n) != SRSRAN_SUCCESS or mac->needs_verdict())
+    {
+        push_control(tb, n, batch_metrics);
+        return;
+    }
+    if (sample_period > 0 and ++nof_drb % sample_period == 0)
+    {
+        for (uint32_t i = 0; i < mac->nof_subpdus(); i++)
+        {
+            const srsran::mac_sch_subpdu_nr &subpdu = mac->get_subpdu(i);
+            if (subpdu.is_sdu())
+            {
+                sample(subpdu.get_lcid(), subpdu.get_sdu(), subpdu.get_sdu_length(), batch_metrics);
+                break;
+            }
+        }
+    }
+    queue_tx(tb, n, batch_metrics);
+}
+
+void drb_lane::queue_tx(const uint8_t *buf, uint32_t n, metrics_t &batch_metrics)
+{
+    if (nof_tx == batch_size)
+    {
+        send_tx(batch_metrics);
+    }
+    tx_iov[2 * nof_tx].iov_base = (void *)buf;
+    tx_iov[2 * nof_tx].iov_len  = n;
+    memset(&tx[nof_tx], 0, sizeof(tx[nof_tx]));
+    tx[nof_tx].msg_hdr.msg_iov    = &tx_iov[2 * nof_tx];
+    tx[nof_tx].msg_hdr.msg_iovlen = 1;
+    nof_tx++;
+}
+
+void drb_lane::send_tx(metrics_t &batch_metrics)
+{
+    sockaddr_in dst = dst_addr->load();
+    if (nof_tx > 0 and dst.sin_port > 0)
+    {
+        for (uint32_t i = 0; i < nof_tx; i++)
+        {
+            tx[i].msg_hdr.msg_name    = &dst;
+            tx[i].msg_hdr.msg_namelen = sizeof(dst);
+        }
+        for (uint32_t sent = 0; sent < nof_tx;)
+        {
+            int ret = sendmmsg(dst_sock, tx + sent, nof_tx - sent, 0);
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                // the failed datagram is dropped, the rest of the batch is still sent
+                batch_metrics.dropped++;
+                ret = 1;
+            }
+            else
+            {
+                batch_metrics.forwarded += ret;
+            }
+            sent += ret;
+        }
+    }
+    else
+    {
+        batch_metrics.dropped += nof_tx;
+    }
+    for (uint32_t i = 0; i < nof_tx; i++)
+    {
+        tx_pdu[i].reset();
+    }
+    nof_tx = 0;
+}
+
+void drb_lane::stop()
+{
+    running = false;
+    // wakes up a blocked recvmmsg, also on an unconnected socket
+    shutdown(src_sock, SHUT_RD);
+    control_cvar.notify_all();
+}
+
+void drb_lane::push_control(const uint8_t *buf, int n, metrics_t &batch_metrics)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (control_queue.size() >= max_control_queue)
+        {
+            batch_metrics.dropped++;
+            return;
+        }
+        control_queue.emplace_back(buf, buf + n);
+    }
+    batch_metrics.control++;
+    control_cvar.notify_one();
+}
+
+int drb_lane::pop_control(uint8_t *buf, int size)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    control_cvar.wait(lock, [this] { return not control_queue.empty() or not running; });
+    if (control_queue.empty())
+    {
+        return -1;
+    }
+    std::vector<uint8_t> pdu = std::move(control_queue.front());
+    control_queue.pop_front();
+    lock.unlock();
+
+    int n = std::min((int)pdu.size(), size);
+    memcpy(buf, pdu.data(), n);
+    return n;
+}
+
+void drb_lane::sample(uint32_t lcid, const uint8_t *data, uint32_t len, metrics_t &batch_metrics)
+{
+    asn1::json_writer json_buffer;
+    json_buffer.start_array();
+    to_json(lcid, data, len, json_buffer);
+    json_buffer.end_array();
+    std::string s = json_buffer.to_string();
+    sendto(sample_sock, s.c_str(), s.length(), MSG_DONTWAIT, (const sockaddr *)&sample_addr, sizeof(sample_addr));
+    batch_metrics.sampled++;
+}
+
+drb_lane::metrics_t drb_lane::get_metrics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return metrics;
+}
+
+std::string drb_lane::metrics_to_string() const
+{
+    metrics_t   m = get_metrics();
+    std::string s = fmt::format("DRB lane: forwarded={} batches={} avg batch={:.1f} sampled={} control={} dropped={}",
+                       m.forwarded, m.batches, m.batches > 0 ? (double)(m.forwarded + m.control) / m.batches : 0,
+                       m.sampled, m.control, m.dropped);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (not pdcp_metrics.empty())
+    {
+        s += "\n" + pdcp_metrics;
+    }
+    return s;
+}
@@ -0,0 +1,126 @@
+#ifndef __DRB_LANE__
+#define __DRB_LANE__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "mitm_lib/asn1/asn1_utils.h"
+#include "mitm_lib/common/byte_buffer.h"
+#include "peer_addr.h"
+
+class mac_tap;
+class pdcp_relay;
+
+// User-plane relay lane of one direction.
+//
+// Datagrams on the relay sockets start with the LCID of their channel. Only SRB traffic needs a verdict from the
+// scenario handler: the lane owns the receive socket, forwards DRB datagrams to the destination as soon as they arrive,
+// straight from its receive buffers and in batches of up to batch_size datagrams per system call, and queues SRB
+// datagrams for the control-plane worker. A worker waiting on the scenario handler therefore never holds up user data.
+// Every sample_period-th DRB datagram is also reported to the scenario handler, without waiting for an answer.
+// With a PDCP relay the DRB PDUs are terminated and re-originated on the way, in runs of consecutive PDUs of one LCID,
+// and the samples show the deciphered SDUs.
+// With a MAC tap the datagrams are transport blocks: those with nothing but DRB SDUs and padding are forwarded, those
+// with an SRB SDU or a MAC CE go to the worker.
+class drb_lane
+{
+public:
+    struct metrics_t
+    {
+        uint64_t forwarded = 0; // DRB datagrams relayed
+        uint64_t batches   = 0; // receive calls that returned datagrams
+        uint64_t sampled   = 0; // DRB datagrams reported to the scenario handler
+        uint64_t control   = 0; // SRB datagrams handed to the control-plane worker
+        uint64_t dropped   = 0; // truncated datagrams and SRB datagrams that found the control queue full
+    };
+
+    static const uint32_t batch_size        = 16;
+    static const uint32_t max_datagram      = 4 + 32768; // LCID and the largest PDU the decoders take
+    static const size_t   max_control_queue = 1024;
+    static const uint32_t sample_bytes      = 64;
+    static const uint32_t nr_first_drb_lcid = 4; // after SRB3, LTE DRBs start at 3
+
+    // The peer addresses are shared with the control-plane workers: the lane learns the source address from what it
+    // receives, and sends to whatever the destination address is at the time
+    drb_lane(int src_sock_, int dst_sock_, peer_addr *src_addr_, const peer_addr *dst_addr_);
+
+    // Reports every period-th DRB datagram to scenario_addr through sample_sock_. A period of 0 disables sampling
+    void set_sampling(uint32_t period, int sample_sock_, const sockaddr_in &scenario_addr);
+    // Passes the DRB PDUs through pdcp_, which is used from the lane thread only
+    void set_pdcp_relay(pdcp_relay *pdcp_) { pdcp = pdcp_; }
+    // Classifies the datagrams as transport blocks with mac_, which is used from the lane thread only
+    void set_mac_tap(mac_tap *mac_) { mac = mac_; }
+    // LCIDs from lcid on are DRBs, as set by the RAT of the session
+    void set_first_drb_lcid(uint32_t lcid) { first_drb_lcid = lcid; }
+
+    // Thread body: receives and dispatches datagrams until stop() is called
+    void run();
+    void stop();
+
+    // Copies the next SRB datagram into buf, blocking until there is one. Returns its length, or -1 once stopped
+    int pop_control(uint8_t *buf, int size);
+
+    static bool is_drb(const uint8_t *buf, int n, uint32_t first_drb_lcid_ = nr_first_drb_lcid);
+    static bool is_drb_lcid(uint32_t lcid, uint32_t first_drb_lcid_ = nr_first_drb_lcid);
+    // Summary of a user-plane datagram: its LCID, length and first bytes
+    static void to_json(const uint8_t *buf, int n, asn1::json_writer &json_buffer);
+    static void to_json(uint32_t lcid, const uint8_t *data, uint32_t len, asn1::json_writer &json_buffer);
+
+    metrics_t   get_metrics() const;
+    std::string metrics_to_string() const;
+
+private:
+    void push_control(const uint8_t *buf, int n, metrics_t &batch_metrics);
+    void sample(uint32_t lcid, const uint8_t *data, uint32_t len, metrics_t &batch_metrics);
+    void relay_pdcp(metrics_t &batch_metrics);
+    void reoriginate_pdcp(uint32_t lcid, metrics_t &batch_metrics);
+    void relay_mac(const uint8_t *tb, uint32_t n, metrics_t &batch_metrics);
+    void queue_tx(const uint8_t *buf, uint32_t n, metrics_t &batch_metrics);
+    void send_tx(metrics_t &batch_metrics);
+
+    const int        src_sock;
+    const int        dst_sock;
+    peer_addr       *src_addr;
+    const peer_addr *dst_addr;
+
+    uint32_t    sample_period = 0;
+    uint64_t    nof_drb       = 0;
+    int         sample_sock   = -1;
+    sockaddr_in sample_addr   = {};
+
+    pdcp_relay *pdcp           = nullptr;
+    mac_tap    *mac            = nullptr;
+    uint32_t    first_drb_lcid = nr_first_drb_lcid;
+
+    std::vector<uint8_t> rx_buf; // batch_size slots of max_datagram bytes
+    // Datagrams to send: straight from rx_buf, or the LCID and a PDU re-originated by the PDCP relay
+    mmsghdr                      tx[batch_size];
+    iovec                        tx_iov[2 * batch_size];
+    uint32_t                     tx_lcid[batch_size];
+    srsran::unique_byte_buffer_t tx_pdu[batch_size];
+    uint32_t                     nof_tx = 0;
+    // Run of received DRB PDUs on one LCID for the PDCP relay, and the SDUs it delivered and their PDUs
+    iovec                                     pdcp_run[batch_size];
+    uint32_t                                  pdcp_run_lcid = 0;
+    uint32_t                                  nof_pdcp_run  = 0;
+    std::vector<srsran::unique_byte_buffer_t> pdcp_sdus;
+    std::vector<srsran::unique_byte_buffer_t> pdcp_pdus;
+
+    std::atomic<bool> running{true};
+
+    mutable std::mutex                mutex;
+    std::condition_variable           control_cvar;
+    std::deque<std::vector<uint8_t> > control_queue;
+    metrics_t                         metrics;
+    std::string                       pdcp_metrics;
+};
+
+#endif
@@ -1,5 +1,8 @@
 #include "gnb_packet_handler.h"
 #include "nas_packet_handler.h"
+#include "drb_lane.h"
+#include "nas_security.h"
+#include "pdcp_relay.h"
 
 #include "mitm_lib/asn1/rrc_nr.h"
 #include "mitm_lib/common/byte_buffer.h"
@@ -11,27 +14,37 @@ int decode_dl_ccch(uint8_t *buf, int n, asn1::json_writer & json_buffer);
 
 int gNB::decode_packet(uint8_t *buf, int n, asn1::json_writer & json_buffer)
 {
-    struct from_gnb_struct
+    uint32_t channel;
+    if (n < (int)sizeof(channel))
     {
-        uint32_t channel;
-        uint8_t buf[32768];
-    } buffer;
-
-    memcpy(&buffer, buf, n);
+        std::cerr << "Datagram too short for its channel" << std::endl;
+        return SRSRAN_ERROR;
+    }
+    memcpy(&channel, buf, sizeof(channel));
+    return decode_sdu(channel, buf + sizeof(channel), n - sizeof(channel), json_buffer);
+}
 
-    switch (static_cast<srsran::nr_srb>(buffer.channel))
+int gNB::decode_sdu(uint32_t channel, uint8_t *sdu, int n, asn1::json_writer & json_buffer)
+{
+    switch (static_cast<srsran::nr_srb>(channel))
     {
     case srsran::nr_srb::srb0:
         // ccch
-        return decode_dl_ccch(buffer.buf, n - sizeof(buffer.channel), json_buffer);
+        return decode_dl_ccch(sdu, n, json_buffer);
         break;
     case srsran::nr_srb::srb1:
     case srsran::nr_srb::srb2:
         // dcch
-        return decode_dl_dcch(buffer.buf, n - sizeof(buffer.channel), json_buffer);
+        return decode_dl_dcch(sdu, n, json_buffer);
         break;
     default:
-        std::string errcause = fmt::format("Invalid LCID=%d", buffer.channel);
+        if (drb_lane::is_drb_lcid(channel))
+        {
+            // Sampled by the DRB lane, user data is not decoded
+            drb_lane::to_json(channel, sdu, n, json_buffer);
+            break;
+        }
+        std::string errcause = fmt::format("Invalid LCID=%d", channel);
         std::cerr << errcause << std::endl;
         break;
     }
@@ -87,7 +100,25 @@ int decode_dl_dcch(uint8_t *buf, int n, asn1::json_writer & json_buffer)
             pdu->N_bytes = dl_info_transfer.crit_exts.dl_info_transfer().ded_nas_msg.size();
             memcpy(pdu->msg, dl_info_transfer.crit_exts.dl_info_transfer().ded_nas_msg.data(), pdu->N_bytes);
 
-            handle_nas_msg(std::move(pdu), json_buffer);
+            handle_nas_msg(std::move(pdu), json_buffer, srsran::SECURITY_DIRECTION_DOWNLINK);
+            break;
+        }
+        case dl_dcch_msg_type_c::c1_c_::types::security_mode_cmd:
+        {
+            security_mode_cmd_s &smc = dl_dcch_msg.msg.c1().security_mode_cmd();
+            if (smc.crit_exts.type().value == security_mode_cmd_s::crit_exts_c_::types::security_mode_cmd and
+                nas_sec_ctx.is_active())
+            {
+                const security_algorithm_cfg_s &algos =
+                    smc.crit_exts.security_mode_cmd().security_cfg_smc.security_algorithm_cfg;
+                INTEGRITY_ALGORITHM_ID_ENUM integ_algo = INTEGRITY_ALGORITHM_ID_EIA0;
+                if (algos.integrity_prot_algorithm_present)
+                {
+                    integ_algo = (INTEGRITY_ALGORITHM_ID_ENUM)algos.integrity_prot_algorithm.value;
+                }
+                as_sec_ctx.observe_security_mode_command((CIPHERING_ALGORITHM_ID_ENUM)algos.ciphering_algorithm.value,
+                                                         integ_algo);
+            }
             break;
         }
         case dl_dcch_msg_type_c::c1_c_::types::rrc_recfg:
@@ -100,7 +131,7 @@ int decode_dl_dcch(uint8_t *buf, int n, asn1::json_writer & json_buffer)
                     pdu->N_bytes = e1.size();
                     memcpy(pdu->msg, e1.data(), pdu->N_bytes);
 
-                    handle_nas_msg(std::move(pdu), json_buffer);
+                    handle_nas_msg(std::move(pdu), json_buffer, srsran::SECURITY_DIRECTION_DOWNLINK);
                 }
             }
             break;
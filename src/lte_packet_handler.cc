@@ -0,0 +1,292 @@
+#include "lte_packet_handler.h"
+#include "nas_packet_handler.h"
+#include "drb_lane.h"
+
+#include <cstring>
+#include <vector>
+
+#include "mitm_lib/asn1/rrc.h"
+#include "mitm_lib/common/common_lte.h"
+#include "rapidjson/document.h"
+
+typedef std::vector<asn1::dyn_octstring *> nas_list_t;
+
+// NAS PDUs of the RRC messages that carry some, in the order of the message
+static void find_nas_pdus(asn1::rrc::ul_ccch_msg_s &msg, nas_list_t &nas) {}
+static void find_nas_pdus(asn1::rrc::dl_ccch_msg_s &msg, nas_list_t &nas) {}
+
+static void find_nas_pdus(asn1::rrc::ul_dcch_msg_s &msg, nas_list_t &nas)
+{
+    using namespace asn1::rrc;
+
+    switch (msg.msg.c1().type().value)
+    {
+    case ul_dcch_msg_type_c::c1_c_::types::rrc_conn_setup_complete:
+    {
+        rrc_conn_setup_complete_s &complete = msg.msg.c1().rrc_conn_setup_complete();
+        if (complete.crit_exts.type().value == rrc_conn_setup_complete_s::crit_exts_c_::types::c1 and
+            complete.crit_exts.c1().type().value ==
+                rrc_conn_setup_complete_s::crit_exts_c_::c1_c_::types::rrc_conn_setup_complete_r8)
+        {
+            nas.push_back(&complete.crit_exts.c1().rrc_conn_setup_complete_r8().ded_info_nas);
+        }
+        break;
+    }
+    case ul_dcch_msg_type_c::c1_c_::types::ul_info_transfer:
+    {
+        ul_info_transfer_s &transfer = msg.msg.c1().ul_info_transfer();
+        if (transfer.crit_exts.type().value == ul_info_transfer_s::crit_exts_c_::types::c1 and
+            transfer.crit_exts.c1().type().value == ul_info_transfer_s::crit_exts_c_::c1_c_::types::ul_info_transfer_r8)
+        {
+            ul_info_transfer_r8_ies_s &ies = transfer.crit_exts.c1().ul_info_transfer_r8();
+            if (ies.ded_info_type.type().value == ul_info_transfer_r8_ies_s::ded_info_type_c_::types::ded_info_nas)
+            {
+                nas.push_back(&ies.ded_info_type.ded_info_nas());
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void find_nas_pdus(asn1::rrc::dl_dcch_msg_s &msg, nas_list_t &nas)
+{
+    using namespace asn1::rrc;
+
+    switch (msg.msg.c1().type().value)
+    {
+    case dl_dcch_msg_type_c::c1_c_::types::dl_info_transfer:
+    {
+        dl_info_transfer_s &transfer = msg.msg.c1().dl_info_transfer();
+        if (transfer.crit_exts.type().value == dl_info_transfer_s::crit_exts_c_::types::c1 and
+            transfer.crit_exts.c1().type().value == dl_info_transfer_s::crit_exts_c_::c1_c_::types::dl_info_transfer_r8)
+        {
+            dl_info_transfer_r8_ies_s &ies = transfer.crit_exts.c1().dl_info_transfer_r8();
+            if (ies.ded_info_type.type().value == dl_info_transfer_r8_ies_s::ded_info_type_c_::types::ded_info_nas)
+            {
+                nas.push_back(&ies.ded_info_type.ded_info_nas());
+            }
+        }
+        break;
+    }
+    case dl_dcch_msg_type_c::c1_c_::types::rrc_conn_recfg:
+    {
+        rrc_conn_recfg_s &recfg = msg.msg.c1().rrc_conn_recfg();
+        if (recfg.crit_exts.type().value == rrc_conn_recfg_s::crit_exts_c_::types::c1 and
+            recfg.crit_exts.c1().type().value == rrc_conn_recfg_s::crit_exts_c_::c1_c_::types::rrc_conn_recfg_r8 and
+            recfg.crit_exts.c1().rrc_conn_recfg_r8().ded_info_nas_list_present)
+        {
+            for (asn1::dyn_octstring &nas_pdu : recfg.crit_exts.c1().rrc_conn_recfg_r8().ded_info_nas_list)
+            {
+                nas.push_back(&nas_pdu);
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+template <class RrcMsg>
+static int unpack_msg(RrcMsg &msg, const uint8_t *sdu, int n)
+{
+    typedef decltype(msg.msg) msg_type_c;
+
+    asn1::cbit_ref bref(sdu, n);
+    if (msg.unpack(bref) != asn1::SRSASN_SUCCESS or msg.msg.type().value != msg_type_c::types_opts::c1)
+    {
+        return SRSRAN_ERROR;
+    }
+    return SRSRAN_SUCCESS;
+}
+
+template <class RrcMsg>
+static int decode_msg(const char *name, uint8_t *sdu, int n, asn1::json_writer &json_buffer)
+{
+    RrcMsg msg;
+    if (unpack_msg(msg, sdu, n) != SRSRAN_SUCCESS)
+    {
+        std::cerr << "Failed to unpack " << name << " message" << std::endl;
+        return SRSRAN_ERROR;
+    }
+    msg.to_json(json_buffer);
+
+    nas_list_t nas;
+    find_nas_pdus(msg, nas);
+    for (const asn1::dyn_octstring *nas_pdu : nas)
+    {
+        handle_eps_nas_msg(nas_pdu->data(), nas_pdu->size(), json_buffer);
+    }
+    return 0;
+}
+
+static int decode_drb(uint32_t channel, uint8_t *sdu, int n, asn1::json_writer &json_buffer)
+{
+    if (drb_lane::is_drb_lcid(channel, (uint32_t)srsran::lte_srb::count))
+    {
+        // Sampled by the DRB lane, user data is not decoded
+        drb_lane::to_json(channel, sdu, n, json_buffer);
+    }
+    else
+    {
+        std::cerr << "Invalid LCID=" << channel << std::endl;
+    }
+    return 0;
+}
+
+static int decode_datagram(uint8_t *buf, int n, asn1::json_writer &json_buffer,
+                           int (*decode_sdu)(uint32_t, uint8_t *, int, asn1::json_writer &))
+{
+    uint32_t channel;
+    if (n < (int)sizeof(channel))
+    {
+        std::cerr << "Datagram too short for its channel" << std::endl;
+        return SRSRAN_ERROR;
+    }
+    memcpy(&channel, buf, sizeof(channel));
+    return decode_sdu(channel, buf + sizeof(channel), n - sizeof(channel), json_buffer);
+}
+
+int LTE::UE::decode_packet(uint8_t *buf, int n, asn1::json_writer &json_buffer)
+{
+    return decode_datagram(buf, n, json_buffer, decode_sdu);
+}
+
+int LTE::UE::decode_sdu(uint32_t channel, uint8_t *sdu, int n, asn1::json_writer &json_buffer)
+{
+    switch (static_cast<srsran::lte_srb>(channel))
+    {
+    case srsran::lte_srb::srb0:
+        return decode_msg<asn1::rrc::ul_ccch_msg_s>("UL-CCCH", sdu, n, json_buffer);
+    case srsran::lte_srb::srb1:
+    case srsran::lte_srb::srb2:
+        return decode_msg<asn1::rrc::ul_dcch_msg_s>("UL-DCCH", sdu, n, json_buffer);
+    default:
+        return decode_drb(channel, sdu, n, json_buffer);
+    }
+}
+
+int LTE::eNB::decode_packet(uint8_t *buf, int n, asn1::json_writer &json_buffer)
+{
+    return decode_datagram(buf, n, json_buffer, decode_sdu);
+}
+
+int LTE::eNB::decode_sdu(uint32_t channel, uint8_t *sdu, int n, asn1::json_writer &json_buffer)
+{
+    switch (static_cast<srsran::lte_srb>(channel))
+    {
+    case srsran::lte_srb::srb0:
+        return decode_msg<asn1::rrc::dl_ccch_msg_s>("DL-CCCH", sdu, n, json_buffer);
+    case srsran::lte_srb::srb1:
+    case srsran::lte_srb::srb2:
+        return decode_msg<asn1::rrc::dl_dcch_msg_s>("DL-DCCH", sdu, n, json_buffer);
+    default:
+        return decode_drb(channel, sdu, n, json_buffer);
+    }
+}
+
+// Spoofed datagrams, used under the worker lock as the NR ones
+static uint8_t spoofed_bytes[65535];
+static int     spoofed_len = 0;
+
+// Replaces the NAS PDUs of the RRC message and packs it behind the channel, already in spoofed_bytes
+template <class RrcMsg>
+static int spoof_nas(const rapidjson::Value &nas_value, const uint8_t *sdu, int n)
+{
+    RrcMsg msg;
+    if (unpack_msg(msg, sdu, n) != SRSRAN_SUCCESS)
+    {
+        return SRSRAN_ERROR;
+    }
+    nas_list_t nas;
+    find_nas_pdus(msg, nas);
+
+    std::vector<std::vector<uint8_t> > spoofed_nas;
+    if (not verdict_nas_pdus(nas_value, nas.size(), spoofed_nas))
+    {
+        return SRSRAN_ERROR;
+    }
+    for (uint32_t i = 0; i < spoofed_nas.size(); i++)
+    {
+        nas[i]->resize(spoofed_nas[i].size());
+        std::copy(spoofed_nas[i].begin(), spoofed_nas[i].end(), nas[i]->data());
+    }
+
+    asn1::bit_ref bref(spoofed_bytes + sizeof(uint32_t), sizeof(spoofed_bytes) - sizeof(uint32_t));
+    if (msg.pack(bref) != asn1::SRSASN_SUCCESS)
+    {
+        std::cerr << "Failed to pack spoofed RRC message" << std::endl;
+        return SRSRAN_ERROR;
+    }
+    bref.align_bytes_zero();
+    spoofed_len = sizeof(uint32_t) + bref.distance_bytes();
+    return SRSRAN_SUCCESS;
+}
+
+template <class CcchMsg, class DcchMsg>
+static uint8_t *json_to_packet(const std::string &buf, uint8_t *original_msg, int size, int &packet_size)
+{
+    // Unless the verdict can be applied, the original message goes out unchanged
+    memcpy(spoofed_bytes, original_msg, size);
+    spoofed_len = size;
+    packet_size = size;
+
+    rapidjson::Document d;
+    d.Parse(buf.c_str());
+    uint32_t channel;
+    if (d.HasParseError() or not d.IsObject() or size < (int)sizeof(channel))
+    {
+        std::cerr << "Spoofing verdicts of LTE messages must be JSON objects" << std::endl;
+        return spoofed_bytes;
+    }
+    memcpy(&channel, original_msg, sizeof(channel));
+    const uint8_t *sdu = original_msg + sizeof(channel);
+    int            n   = size - sizeof(channel);
+
+    std::vector<uint8_t> bytes;
+    if (d.HasMember("PDU"))
+    {
+        if (verdict_hex_to_bytes(d["PDU"], bytes) and bytes.size() <= sizeof(spoofed_bytes) - sizeof(channel))
+        {
+            memcpy(spoofed_bytes + sizeof(channel), bytes.data(), bytes.size());
+            spoofed_len = sizeof(channel) + bytes.size();
+        }
+    }
+    else if (d.HasMember("NAS-PDU"))
+    {
+        int ret = SRSRAN_ERROR;
+        if (channel == (uint32_t)srsran::lte_srb::srb0)
+        {
+            ret = spoof_nas<CcchMsg>(d["NAS-PDU"], sdu, n);
+        }
+        else if (channel < (uint32_t)srsran::lte_srb::count)
+        {
+            ret = spoof_nas<DcchMsg>(d["NAS-PDU"], sdu, n);
+        }
+        if (ret != SRSRAN_SUCCESS)
+        {
+            // a failed pack may have written over the copy
+            memcpy(spoofed_bytes, original_msg, size);
+            spoofed_len = size;
+        }
+    }
+    else
+    {
+        std::cerr << "Spoofing verdict without PDU or NAS-PDU" << std::endl;
+    }
+    packet_size = spoofed_len;
+    return spoofed_bytes;
+}
+
+uint8_t *LTE::UE::json_to_packet(std::string buf, uint8_t *original_msg, int size, int &packet_size)
+{
+    return ::json_to_packet<asn1::rrc::ul_ccch_msg_s, asn1::rrc::ul_dcch_msg_s>(buf, original_msg, size, packet_size);
+}
+
+uint8_t *LTE::eNB::json_to_packet(std::string buf, uint8_t *original_msg, int size, int &packet_size)
+{
+    return ::json_to_packet<asn1::rrc::dl_ccch_msg_s, asn1::rrc::dl_dcch_msg_s>(buf, original_msg, size, packet_size);
+}
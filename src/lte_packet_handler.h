@@ -0,0 +1,34 @@
+#ifndef __LTE_PACKET_HANDLER__
+#define __LTE_PACKET_HANDLER__
+
+#include <iostream>
+#include <unistd.h>
+#include <string>
+
+#include "mitm_lib/asn1/asn1_utils.h"
+
+// LTE counterparts of the UE and gNB handlers, for srsRAN 4G UE/eNB pairs: EUTRA RRC on SRB0-2, EPS NAS inside it.
+// The datagrams start with the LCID of their channel as on NR, LCIDs from 3 on are DRBs.
+namespace LTE
+{
+    // Messages from the UE
+    namespace UE
+    {
+        int decode_packet(uint8_t * buf, int n, asn1::json_writer & json_buffer);
+        int decode_sdu(uint32_t channel, uint8_t * sdu, int n, asn1::json_writer & json_buffer);
+        // Builds the datagram of a spoofing verdict: {"NAS-PDU": hex string or array of them} replaces the NAS PDUs of
+        // the RRC message in order, {"PDU": hex string} the whole RRC message. A verdict that can't be applied leaves
+        // the datagram unchanged
+        uint8_t* json_to_packet(std::string buf, uint8_t* original_msg, int size, int& packet_size);
+    }
+
+    // Messages from the eNB
+    namespace eNB
+    {
+        int decode_packet(uint8_t * buf, int n, asn1::json_writer & json_buffer);
+        int decode_sdu(uint32_t channel, uint8_t * sdu, int n, asn1::json_writer & json_buffer);
+        uint8_t* json_to_packet(std::string buf, uint8_t* original_msg, int size, int& packet_size);
+    }
+}
+
+#endif
@@ -0,0 +1,262 @@
+#include "mac_tap.h"
+#include "json_packet_maker.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "mitm_lib/common/common_nr.h"
+#include "mitm_lib/srslog/bundled/fmt/format.h"
+
+using namespace srsran;
+
+mac_tap::mac_tap(bool ulsch_, decode_sdu_fn decoder_) :
+    ulsch(ulsch_), decoder(decoder_), pdu(ulsch_), tx_pdu(ulsch_)
+{
+    datagram.reserve(sizeof(uint32_t) + SRSRAN_MAX_BUFFER_SIZE_BYTES);
+}
+
+int mac_tap::unpack(const uint8_t *tb, uint32_t len)
+{
+    pdu.init_rx(ulsch);
+    tb_len = len;
+    metrics.tbs++;
+    if (len == 0 or pdu.unpack(tb, len) != SRSRAN_SUCCESS)
+    {
+        metrics.malformed++;
+        pdu.init_rx(ulsch);
+        tb_len = 0;
+        return SRSRAN_ERROR;
+    }
+    return SRSRAN_SUCCESS;
+}
+
+// The UL-CCCH SDUs have LCIDs of their own, they are SRB0 SDUs all the same
+uint32_t mac_tap::sdu_lcid(const mac_sch_subpdu_nr &subpdu) const
+{
+    return subpdu.is_ul_ccch() ? (uint32_t)nr_srb::srb0 : subpdu.get_lcid();
+}
+
+bool mac_tap::needs_verdict() const
+{
+    for (uint32_t i = 0; i < pdu.get_num_subpdus(); i++)
+    {
+        const mac_sch_subpdu_nr &subpdu = pdu.get_subpdu(i);
+        if (subpdu.is_sdu() ? subpdu.get_lcid() < (uint32_t)nr_srb::count
+                            : subpdu.get_lcid() != mac_sch_subpdu_nr::PADDING)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int mac_tap::find_srb_sdu() const
+{
+    for (uint32_t i = 0; i < pdu.get_num_subpdus(); i++)
+    {
+        const mac_sch_subpdu_nr &subpdu = pdu.get_subpdu(i);
+        if ((subpdu.is_sdu() and subpdu.get_lcid() < (uint32_t)nr_srb::count) or subpdu.is_ul_ccch())
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int mac_tap::decode(uint8_t *tb, int len, asn1::json_writer &json_buffer)
+{
+    if (len <= 0 or unpack(tb, len) != SRSRAN_SUCCESS)
+    {
+        std::cerr << "Failed to unpack " << (ulsch ? "UL-SCH" : "DL-SCH") << " MAC PDU" << std::endl;
+        return SRSRAN_ERROR;
+    }
+
+    int result = 0;
+    for (uint32_t i = 0; i < pdu.get_num_subpdus(); i++)
+    {
+        mac_sch_subpdu_nr &subpdu = pdu.get_subpdu(i);
+        if (subpdu.is_sdu() or subpdu.is_ul_ccch())
+        {
+            metrics.sdus++;
+            int ret = decoder(sdu_lcid(subpdu), subpdu.get_sdu(), subpdu.get_sdu_length(), json_buffer);
+            if (result == 0)
+            {
+                result = ret;
+            }
+        }
+        else if (subpdu.get_lcid() != mac_sch_subpdu_nr::PADDING)
+        {
+            metrics.ces++;
+            ce_to_json(subpdu, json_buffer);
+        }
+    }
+    return result;
+}
+
+void mac_tap::ce_to_json(mac_sch_subpdu_nr &subpdu, asn1::json_writer &json_buffer)
+{
+    json_buffer.start_obj();
+    json_buffer.start_obj("MAC CE");
+    json_buffer.write_int("LCID", subpdu.get_lcid());
+    // The same LCIDs denote different CEs in the UL-SCH and the DL-SCH
+    bool known = true;
+    if (ulsch)
+    {
+        switch (subpdu.get_lcid())
+        {
+        case mac_sch_subpdu_nr::CRNTI:
+            json_buffer.write_str("Type", "C-RNTI");
+            json_buffer.write_int("C-RNTI", subpdu.get_c_rnti());
+            break;
+        case mac_sch_subpdu_nr::SHORT_BSR:
+        case mac_sch_subpdu_nr::SHORT_TRUNC_BSR:
+        {
+            mac_sch_subpdu_nr::lcg_bsr_t sbsr = subpdu.get_sbsr();
+            json_buffer.write_str("Type", subpdu.get_lcid() == mac_sch_subpdu_nr::SHORT_BSR ? "Short BSR"
+                                                                                           : "Short Truncated BSR");
+            json_buffer.write_int("LCG", sbsr.lcg_id);
+            json_buffer.write_int("BufferSize", sbsr.buffer_size);
+            break;
+        }
+        case mac_sch_subpdu_nr::LONG_BSR:
+        case mac_sch_subpdu_nr::LONG_TRUNC_BSR:
+        {
+            mac_sch_subpdu_nr::lbsr_t lbsr = subpdu.get_lbsr();
+            json_buffer.write_str("Type", subpdu.get_lcid() == mac_sch_subpdu_nr::LONG_BSR ? "Long BSR"
+                                                                                          : "Long Truncated BSR");
+            json_buffer.write_int("Bitmap", lbsr.bitmap);
+            json_buffer.start_array("BufferSizes");
+            for (const mac_sch_subpdu_nr::lcg_bsr_t &bsr : lbsr.list)
+            {
+                json_buffer.start_obj();
+                json_buffer.write_int("LCG", bsr.lcg_id);
+                json_buffer.write_int("BufferSize", bsr.buffer_size);
+                json_buffer.end_obj();
+            }
+            json_buffer.end_array();
+            break;
+        }
+        case mac_sch_subpdu_nr::SE_PHR:
+            json_buffer.write_str("Type", "Single Entry PHR");
+            json_buffer.write_int("PH", subpdu.get_phr());
+            json_buffer.write_int("PCMAX", subpdu.get_pcmax());
+            break;
+        default:
+            known = false;
+            break;
+        }
+    }
+    else
+    {
+        switch (subpdu.get_lcid())
+        {
+        case mac_sch_subpdu_nr::TA_CMD:
+        {
+            mac_sch_subpdu_nr::ta_t ta = subpdu.get_ta();
+            json_buffer.write_str("Type", "Timing Advance Command");
+            json_buffer.write_int("TAG", ta.tag_id);
+            json_buffer.write_int("TA", ta.ta_command);
+            break;
+        }
+        case mac_sch_subpdu_nr::CON_RES_ID:
+        {
+            mac_sch_subpdu_nr::ue_con_res_id_t id = subpdu.get_ue_con_res_id_ce();
+            json_buffer.write_str("Type", "UE Contention Resolution Identity");
+            json_buffer.write_octstring("Identity", id.data(), id.size());
+            break;
+        }
+        case mac_sch_subpdu_nr::DRX_CMD:
+            json_buffer.write_str("Type", "DRX Command");
+            break;
+        default:
+            known = false;
+            break;
+        }
+    }
+    if (not known)
+    {
+        json_buffer.write_octstring("Data", subpdu.get_sdu(), subpdu.get_sdu_length());
+    }
+    json_buffer.end_obj();
+    json_buffer.end_obj();
+}
+
+int mac_tap::repack(uint32_t index, const uint8_t *sdu, uint32_t sdu_len, byte_buffer_t &buf)
+{
+    buf.clear();
+    if (index >= pdu.get_num_subpdus() or tb_len > buf.get_tailroom() or
+        tx_pdu.init_tx(&buf, tb_len, ulsch) != SRSRAN_SUCCESS)
+    {
+        return SRSRAN_ERROR;
+    }
+
+    // Each sub-PDU is written straight into buf, the padding is recomputed by pack()
+    for (uint32_t i = 0; i < pdu.get_num_subpdus(); i++)
+    {
+        const mac_sch_subpdu_nr &subpdu = pdu.get_subpdu(i);
+        uint32_t                 ret;
+        if (i == index)
+        {
+            // add_sdu() picks the UL-CCCH LCID that fits the new SDU
+            ret = tx_pdu.add_sdu(subpdu.is_ul_ccch() ? (uint32_t)mac_sch_subpdu_nr::CCCH_SIZE_64 : subpdu.get_lcid(),
+                                 sdu,
+                                 sdu_len);
+        }
+        else if (subpdu.get_lcid() == mac_sch_subpdu_nr::PADDING)
+        {
+            continue;
+        }
+        else
+        {
+            ret = tx_pdu.add_subpdu(subpdu);
+        }
+        if (ret != SRSRAN_SUCCESS)
+        {
+            return SRSRAN_ERROR;
+        }
+    }
+    tx_pdu.pack();
+    if (buf.N_bytes != tb_len)
+    {
+        return SRSRAN_ERROR;
+    }
+    metrics.repacked++;
+    return SRSRAN_SUCCESS;
+}
+
+const uint8_t *mac_tap::spoof(const std::string &json, uint8_t *tb, int len, int &spoofed_len)
+{
+    if (len <= 0 or unpack(tb, len) != SRSRAN_SUCCESS)
+    {
+        return nullptr;
+    }
+    int index = find_srb_sdu();
+    if (index < 0)
+    {
+        std::cerr << "MAC tap: no SRB SDU to spoof in the TB" << std::endl;
+        return nullptr;
+    }
+
+    const mac_sch_subpdu_nr &subpdu = pdu.get_subpdu(index);
+    uint32_t                 lcid   = sdu_lcid(subpdu);
+    datagram.resize(sizeof(lcid) + subpdu.get_sdu_length());
+    memcpy(datagram.data(), &lcid, sizeof(lcid));
+    memcpy(datagram.data() + sizeof(lcid), subpdu.get_sdu(), subpdu.get_sdu_length());
+
+    int      n   = 0;
+    uint8_t *msg = jsonPacketMaker::json_to_packet(json, datagram.data(), datagram.size(), n);
+    if (msg == nullptr or n < (int)sizeof(lcid) or
+        repack(index, msg + sizeof(lcid), n - sizeof(lcid), tx_buf) != SRSRAN_SUCCESS)
+    {
+        std::cerr << "MAC tap: the spoofed SDU does not fit in the " << tb_len << " B TB" << std::endl;
+        return nullptr;
+    }
+    spoofed_len = tx_buf.N_bytes;
+    return tx_buf.msg;
+}
+
+std::string mac_tap::metrics_to_string() const
+{
+    return fmt::format("MAC tap {}: TBs={} SDUs={} CEs={} malformed={} repacked={}", ulsch ? "UL-SCH" : "DL-SCH",
+                       metrics.tbs, metrics.sdus, metrics.ces, metrics.malformed, metrics.repacked);
+}
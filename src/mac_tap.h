@@ -0,0 +1,74 @@
+#ifndef __MAC_TAP__
+#define __MAC_TAP__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mitm_lib/asn1/asn1_utils.h"
+#include "mitm_lib/common/byte_buffer.h"
+#include "mitm_lib/mac/mac_sch_pdu_nr.h"
+
+// MAC-level tap of one direction.
+//
+// In MAC mode the datagrams on the relay sockets carry whole NR transport blocks, DL-SCH from the gNB and UL-SCH from
+// the UE, instead of LCID-prefixed PDUs. A TB is parsed into its sub-PDUs in place, the sub-PDUs pointing into the
+// datagram. Each MAC SDU is decoded as a datagram on its LCID would be, and the MAC CEs (C-RNTI, BSR, PHR, TA, UE
+// contention resolution identity) are rendered for the scenario handler. A spoofed SDU goes back out in a TB of the
+// original size, packed straight into the transmit buffer with the other sub-PDUs unchanged.
+class mac_tap
+{
+public:
+    typedef int (*decode_sdu_fn)(uint32_t lcid, uint8_t *sdu, int n, asn1::json_writer &json_buffer);
+
+    struct metrics_t
+    {
+        uint64_t tbs       = 0; // TBs unpacked
+        uint64_t sdus      = 0; // MAC SDUs decoded
+        uint64_t ces       = 0; // MAC CEs rendered, padding excluded
+        uint64_t malformed = 0; // TBs that could not be unpacked
+        uint64_t repacked  = 0; // TBs rebuilt around a spoofed SDU
+    };
+
+    mac_tap(bool ulsch_, decode_sdu_fn decoder_);
+
+    // Parses the TB, whose bytes must stay in place while its sub-PDUs are in use. Returns SRSRAN_ERROR if malformed
+    int unpack(const uint8_t *tb, uint32_t len);
+    uint32_t                         nof_subpdus() const { return pdu.get_num_subpdus(); }
+    const srsran::mac_sch_subpdu_nr &get_subpdu(uint32_t i) const { return pdu.get_subpdu(i); }
+    // Whether the last TB has something for the scenario handler to judge: an SRB SDU or a MAC CE
+    bool needs_verdict() const;
+    // Index of the first SRB SDU of the last TB, or -1 if there is none
+    int find_srb_sdu() const;
+
+    // Unpacks the TB and renders its sub-PDUs in order. Takes the place of UE::decode_packet/gNB::decode_packet
+    int decode(uint8_t *tb, int len, asn1::json_writer &json_buffer);
+
+    // Packs the last TB into buf, with the SDU of sub-PDU index replaced by sdu. The TB keeps its length, padding
+    // making up for a shorter SDU. Returns SRSRAN_ERROR if the SDU does not fit
+    int repack(uint32_t index, const uint8_t *sdu, uint32_t sdu_len, srsran::byte_buffer_t &buf);
+
+    // Applies a spoofing verdict to the first SRB SDU of the TB, as jsonPacketMaker does to a datagram outside of MAC
+    // mode. Returns the rebuilt TB, valid until the next call, or nullptr if the TB cannot be rebuilt
+    const uint8_t *spoof(const std::string &json, uint8_t *tb, int len, int &spoofed_len);
+
+    metrics_t   get_metrics() const { return metrics; }
+    std::string metrics_to_string() const;
+
+private:
+    uint32_t sdu_lcid(const srsran::mac_sch_subpdu_nr &subpdu) const;
+    void     ce_to_json(srsran::mac_sch_subpdu_nr &subpdu, asn1::json_writer &json_buffer);
+
+    const bool          ulsch;
+    const decode_sdu_fn decoder;
+
+    srsran::mac_sch_pdu_nr pdu;
+    uint32_t               tb_len = 0;
+    srsran::mac_sch_pdu_nr tx_pdu;
+    srsran::byte_buffer_t  tx_buf;
+    std::vector<uint8_t>   datagram; // LCID and SDU handed to jsonPacketMaker
+
+    metrics_t metrics;
+};
+
+#endif
@@ -0,0 +1,625 @@
+#include "n2_relay.h"
+#include "nas_packet_handler.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <netinet/sctp.h>
+#include <unistd.h>
+
+#include "mitm_lib/asn1/ngap.h"
+#include "mitm_lib/asn1/s1ap.h"
+#include "mitm_lib/common/buffer_pool.h"
+#include "mitm_lib/common/network_utils.h"
+#include "mitm_lib/srslog/bundled/fmt/format.h"
+#include "rapidjson/document.h"
+
+typedef asn1::unbounded_octstring<true> nas_pdu_t;
+
+// NAS PDUs of the NGAP messages that carry some, in the order of the message
+static void find_nas_pdus(asn1::ngap::ngap_pdu_c &pdu, std::vector<nas_pdu_t *> &nas)
+{
+    using namespace asn1::ngap;
+    typedef ngap_elem_procs_o::init_msg_c::types_opts msg_types;
+
+    if (pdu.type().value != ngap_pdu_c::types_opts::init_msg)
+    {
+        return;
+    }
+    ngap_elem_procs_o::init_msg_c &msg = pdu.init_msg().value;
+    switch (msg.type().value)
+    {
+    case msg_types::init_ue_msg:
+        nas.push_back(&msg.init_ue_msg()->nas_pdu.value);
+        break;
+    case msg_types::ul_nas_transport:
+        nas.push_back(&msg.ul_nas_transport()->nas_pdu.value);
+        break;
+    case msg_types::dl_nas_transport:
+        nas.push_back(&msg.dl_nas_transport()->nas_pdu.value);
+        break;
+    case msg_types::nas_non_delivery_ind:
+        nas.push_back(&msg.nas_non_delivery_ind()->nas_pdu.value);
+        break;
+    case msg_types::init_context_setup_request:
+        if (msg.init_context_setup_request()->nas_pdu_present)
+        {
+            nas.push_back(&msg.init_context_setup_request()->nas_pdu.value);
+        }
+        break;
+    case msg_types::pdu_session_res_setup_request:
+    {
+        pdu_session_res_setup_request_ies_container &req = *msg.pdu_session_res_setup_request();
+        if (req.nas_pdu_present)
+        {
+            nas.push_back(&req.nas_pdu.value);
+        }
+        for (pdu_session_res_setup_item_su_req_s &item : req.pdu_session_res_setup_list_su_req.value)
+        {
+            if (item.pdu_session_nas_pdu.size() > 0)
+            {
+                nas.push_back(&item.pdu_session_nas_pdu);
+            }
+        }
+        break;
+    }
+    case msg_types::pdu_session_res_modify_request:
+        for (pdu_session_res_modify_item_mod_req_s &item :
+             msg.pdu_session_res_modify_request()->pdu_session_res_modify_list_mod_req.value)
+        {
+            if (item.nas_pdu.size() > 0)
+            {
+                nas.push_back(&item.nas_pdu);
+            }
+        }
+        break;
+    case msg_types::pdu_session_res_release_cmd:
+        if (msg.pdu_session_res_release_cmd()->nas_pdu_present)
+        {
+            nas.push_back(&msg.pdu_session_res_release_cmd()->nas_pdu.value);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// NAS PDUs of the S1AP messages that carry some, in the order of the message
+static void find_nas_pdus(asn1::s1ap::s1ap_pdu_c &pdu, std::vector<nas_pdu_t *> &nas)
+{
+    using namespace asn1::s1ap;
+    typedef s1ap_elem_procs_o::init_msg_c::types_opts msg_types;
+
+    if (pdu.type().value != s1ap_pdu_c::types_opts::init_msg)
+    {
+        return;
+    }
+    s1ap_elem_procs_o::init_msg_c &msg = pdu.init_msg().value;
+    switch (msg.type().value)
+    {
+    case msg_types::init_ue_msg:
+        nas.push_back(&msg.init_ue_msg()->nas_pdu.value);
+        break;
+    case msg_types::ul_nas_transport:
+        nas.push_back(&msg.ul_nas_transport()->nas_pdu.value);
+        break;
+    case msg_types::dl_nas_transport:
+        nas.push_back(&msg.dl_nas_transport()->nas_pdu.value);
+        break;
+    case msg_types::nas_non_delivery_ind:
+        nas.push_back(&msg.nas_non_delivery_ind()->nas_pdu.value);
+        break;
+    case msg_types::init_context_setup_request:
+        for (auto &item : msg.init_context_setup_request()->erab_to_be_setup_list_ctxt_su_req.value)
+        {
+            if (item->erab_to_be_setup_item_ctxt_su_req().nas_pdu_present)
+            {
+                nas.push_back(&item->erab_to_be_setup_item_ctxt_su_req().nas_pdu);
+            }
+        }
+        break;
+    case msg_types::erab_setup_request:
+        for (auto &item : msg.erab_setup_request()->erab_to_be_setup_list_bearer_su_req.value)
+        {
+            nas.push_back(&item->erab_to_be_setup_item_bearer_su_req().nas_pdu);
+        }
+        break;
+    case msg_types::erab_modify_request:
+        for (auto &item : msg.erab_modify_request()->erab_to_be_modified_list_bearer_mod_req.value)
+        {
+            nas.push_back(&item->erab_to_be_modified_item_bearer_mod_req().nas_pdu);
+        }
+        break;
+    case msg_types::erab_release_cmd:
+        if (msg.erab_release_cmd()->nas_pdu_present)
+        {
+            nas.push_back(&msg.erab_release_cmd()->nas_pdu.value);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+template <class Pdu>
+static int decode_pdu(const char                  *name,
+                      const uint8_t               *msg,
+                      uint32_t                     len,
+                      srsran::security_direction_t dir,
+                      bool                         nas_5gs,
+                      asn1::json_writer           &json_buffer)
+{
+    Pdu            pdu;
+    asn1::cbit_ref bref(msg, len);
+    if (pdu.unpack(bref) != asn1::SRSASN_SUCCESS)
+    {
+        std::cerr << "Failed to unpack " << name << std::endl;
+        return SRSRAN_ERROR;
+    }
+    json_buffer.start_obj();
+    json_buffer.write_fieldname(name);
+    pdu.to_json(json_buffer);
+    json_buffer.end_obj();
+
+    std::vector<nas_pdu_t *> nas;
+    find_nas_pdus(pdu, nas);
+    for (const nas_pdu_t *nas_pdu : nas)
+    {
+        if (not nas_5gs)
+        {
+            handle_eps_nas_msg(nas_pdu->data(), nas_pdu->size(), json_buffer);
+            continue;
+        }
+        srsran::unique_byte_buffer_t buf = srsran::make_byte_buffer();
+        if (buf == nullptr or buf->get_tailroom() < nas_pdu->size())
+        {
+            std::cerr << "NAS PDU too big (" << nas_pdu->size() << " B)" << std::endl;
+            continue;
+        }
+        buf->N_bytes = nas_pdu->size();
+        memcpy(buf->msg, nas_pdu->data(), buf->N_bytes);
+        handle_nas_msg(std::move(buf), json_buffer, dir);
+    }
+    return nas.size();
+}
+
+template <class Pdu>
+static int spoof_pdu(const rapidjson::Value &nas_value, const uint8_t *msg, uint32_t len, std::vector<uint8_t> &spoofed)
+{
+    Pdu            pdu;
+    asn1::cbit_ref bref(msg, len);
+    if (pdu.unpack(bref) != asn1::SRSASN_SUCCESS)
+    {
+        return SRSRAN_ERROR;
+    }
+    std::vector<nas_pdu_t *> nas;
+    find_nas_pdus(pdu, nas);
+
+    std::vector<std::vector<uint8_t> > spoofed_nas;
+    if (not verdict_nas_pdus(nas_value, nas.size(), spoofed_nas))
+    {
+        return SRSRAN_ERROR;
+    }
+    for (uint32_t i = 0; i < spoofed_nas.size(); i++)
+    {
+        nas[i]->resize(spoofed_nas[i].size());
+        std::copy(spoofed_nas[i].begin(), spoofed_nas[i].end(), nas[i]->data());
+    }
+
+    spoofed.resize(n2_sctp::max_msg);
+    asn1::bit_ref out(spoofed.data(), spoofed.size());
+    if (pdu.pack(out) != asn1::SRSASN_SUCCESS)
+    {
+        std::cerr << "Failed to pack the spoofed message" << std::endl;
+        return SRSRAN_ERROR;
+    }
+    spoofed.resize(out.distance_bytes());
+    return SRSRAN_SUCCESS;
+}
+
+n2_relay::n2_relay(protocol_t protocol_, const sockaddr_in &scenario_addr_, std::mutex &decode_mutex_, send_fn send_) :
+    protocol(protocol_), scenario_addr(scenario_addr_), decode_mutex(decode_mutex_), send(std::move(send_))
+{
+    for (std::unique_ptr<lane_t> &lane : lanes)
+    {
+        lane.reset(new lane_t);
+        lane->sock   = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+        lane->thread = std::thread([this, &lane]() { run_lane(*lane); });
+    }
+}
+
+n2_relay::~n2_relay()
+{
+    stop();
+    for (std::unique_ptr<lane_t> &lane : lanes)
+    {
+        lane->thread.join();
+        close(lane->sock);
+    }
+}
+
+uint32_t n2_relay::ppid(protocol_t protocol)
+{
+    return (uint32_t)(protocol == NGAP ? srsran::net_utils::ppid_values::NGAP : srsran::net_utils::ppid_values::S1AP);
+}
+
+uint16_t n2_relay::port(protocol_t protocol)
+{
+    return protocol == NGAP ? 38412 : 36412;
+}
+
+void n2_relay::push(direction_t dir, uint16_t stream, const uint8_t *msg, uint32_t len)
+{
+    lane_t &lane   = *lanes[stream % nof_lanes];
+    bool    queued = false;
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        if (lane.queue.size() < max_lane_queue)
+        {
+            lane.queue.push_back({dir, stream, std::vector<uint8_t>(msg, msg + len)});
+            queued = true;
+        }
+    }
+    if (not queued)
+    {
+        metrics_t m;
+        m.dropped++;
+        add_metrics(m);
+        return;
+    }
+    lane.cvar.notify_one();
+}
+
+void n2_relay::stop()
+{
+    running = false;
+    for (std::unique_ptr<lane_t> &lane : lanes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(lane->mutex);
+        }
+        lane->cvar.notify_all();
+        // wakes up a lane waiting for a verdict
+        shutdown(lane->sock, SHUT_RDWR);
+    }
+}
+
+int n2_relay::decode(direction_t dir, const uint8_t *msg, uint32_t len, asn1::json_writer &json_buffer) const
+{
+    srsran::security_direction_t nas_dir =
+        dir == FROM_RAN ? srsran::SECURITY_DIRECTION_UPLINK : srsran::SECURITY_DIRECTION_DOWNLINK;
+    if (protocol == NGAP)
+    {
+        return decode_pdu<asn1::ngap::ngap_pdu_c>("NGAP-PDU", msg, len, nas_dir, true, json_buffer);
+    }
+    return decode_pdu<asn1::s1ap::s1ap_pdu_c>("S1AP-PDU", msg, len, nas_dir, false, json_buffer);
+}
+
+int n2_relay::spoof(const std::string &json, const uint8_t *msg, uint32_t len, std::vector<uint8_t> &spoofed) const
+{
+    rapidjson::Document d;
+    d.Parse(json.c_str());
+    if (d.HasParseError() or not d.IsObject())
+    {
+        std::cerr << "Spoofing verdicts of N2 messages must be JSON objects" << std::endl;
+        return SRSRAN_ERROR;
+    }
+    if (d.HasMember("PDU"))
+    {
+        return verdict_hex_to_bytes(d["PDU"], spoofed) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+    }
+    if (not d.HasMember("NAS-PDU"))
+    {
+        std::cerr << "Spoofing verdict without PDU or NAS-PDU" << std::endl;
+        return SRSRAN_ERROR;
+    }
+    if (protocol == NGAP)
+    {
+        return spoof_pdu<asn1::ngap::ngap_pdu_c>(d["NAS-PDU"], msg, len, spoofed);
+    }
+    return spoof_pdu<asn1::s1ap::s1ap_pdu_c>(d["NAS-PDU"], msg, len, spoofed);
+}
+
+void n2_relay::run_lane(lane_t &lane)
+{
+    std::vector<uint8_t> verdict(65535);
+    std::vector<uint8_t> spoofed;
+    while (true)
+    {
+        message_t msg;
+        {
+            std::unique_lock<std::mutex> lock(lane.mutex);
+            lane.cvar.wait(lock, [this, &lane] { return not lane.queue.empty() or not running; });
+            if (not running)
+            {
+                return;
+            }
+            msg = std::move(lane.queue.front());
+            lane.queue.pop_front();
+        }
+
+        metrics_t         m;
+        asn1::json_writer json_buffer;
+        int               nof_nas;
+        json_buffer.start_array();
+        {
+            std::lock_guard<std::mutex> lock(decode_mutex);
+            nof_nas = decode(msg.dir, msg.pdu.data(), msg.pdu.size(), json_buffer);
+        }
+        json_buffer.end_array();
+        if (nof_nas < 0)
+        {
+            m.malformed++;
+        }
+        else
+        {
+            m.nas_pdus += nof_nas;
+        }
+
+        std::string to_scenario_handler = json_buffer.to_string();
+        sendto(lane.sock, to_scenario_handler.c_str(), to_scenario_handler.length(), 0,
+               (const sockaddr *)&scenario_addr, sizeof(scenario_addr));
+        int n = recv(lane.sock, verdict.data(), verdict.size(), 0);
+        if (n <= 0)
+        {
+            if (not running)
+            {
+                return;
+            }
+            m.dropped++;
+        }
+        else if (verdict[0] == 0)
+        {
+            send(msg.dir, msg.stream, msg.pdu.data(), msg.pdu.size());
+            m.relayed++;
+        }
+        else if (verdict[0] == 1)
+        {
+            // A message the verdict can't be applied to goes out unchanged
+            std::string json((const char *)verdict.data() + 1, n - 1);
+            if (spoof(json, msg.pdu.data(), msg.pdu.size(), spoofed) == SRSRAN_SUCCESS)
+            {
+                send(msg.dir, msg.stream, spoofed.data(), spoofed.size());
+                m.spoofed++;
+            }
+            else
+            {
+                send(msg.dir, msg.stream, msg.pdu.data(), msg.pdu.size());
+                m.relayed++;
+            }
+        }
+        else
+        {
+            m.dropped++;
+        }
+        add_metrics(m);
+    }
+}
+
+void n2_relay::add_metrics(const metrics_t &m)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    metrics.relayed += m.relayed;
+    metrics.spoofed += m.spoofed;
+    metrics.dropped += m.dropped;
+    metrics.malformed += m.malformed;
+    metrics.nas_pdus += m.nas_pdus;
+}
+
+n2_relay::metrics_t n2_relay::get_metrics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return metrics;
+}
+
+std::string n2_relay::metrics_to_string() const
+{
+    metrics_t m = get_metrics();
+    return fmt::format("{} relay: relayed={} spoofed={} dropped={} malformed={} NAS PDUs={}",
+                       protocol == NGAP ? "NGAP" : "S1AP", m.relayed, m.spoofed, m.dropped, m.malformed, m.nas_pdus);
+}
+
+n2_sctp::n2_sctp(n2_relay::protocol_t protocol_, const sockaddr_in &core_addr_) :
+    protocol(protocol_), core_addr(core_addr_)
+{
+}
+
+n2_sctp::~n2_sctp()
+{
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+    }
+}
+
+int n2_sctp::open_socket()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP);
+    if (fd < 0)
+    {
+        perror("N2 socket");
+        return -1;
+    }
+    // As many streams as the RAN nodes and cores we relay use for their UEs
+    sctp_initmsg init_opts        = {};
+    init_opts.sinit_num_ostreams  = max_streams;
+    init_opts.sinit_max_instreams = max_streams;
+    // The stream of each message is needed to relay it on the same one
+    sctp_event_subscribe events   = {};
+    events.sctp_data_io_event     = 1;
+    events.sctp_shutdown_event    = 1;
+    events.sctp_association_event = 1;
+    if (setsockopt(fd, IPPROTO_SCTP, SCTP_INITMSG, &init_opts, sizeof(init_opts)) != 0 or
+        setsockopt(fd, IPPROTO_SCTP, SCTP_EVENTS, &events, sizeof(events)) != 0)
+    {
+        perror("N2 setsockopt");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool n2_sctp::listen(const sockaddr_in &bind_addr)
+{
+    listen_fd = open_socket();
+    int reuse = 1;
+    if (listen_fd < 0 or setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 or
+        bind(listen_fd, (const sockaddr *)&bind_addr, sizeof(bind_addr)) != 0 or ::listen(listen_fd, 1) != 0)
+    {
+        perror("N2 listen");
+        return false;
+    }
+    return true;
+}
+
+int n2_sctp::connect_core()
+{
+    int fd = open_socket();
+    if (fd >= 0 and connect(fd, (const sockaddr *)&core_addr, sizeof(core_addr)) != 0)
+    {
+        perror("N2 connect");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static uint16_t nof_outbound_streams(int fd)
+{
+    sctp_status status = {};
+    socklen_t   len    = sizeof(status);
+    if (getsockopt(fd, IPPROTO_SCTP, SCTP_STATUS, &status, &len) != 0)
+    {
+        return 1;
+    }
+    return status.sstat_outstrms;
+}
+
+void n2_sctp::run(n2_relay &relay)
+{
+    while (running)
+    {
+        int ran_fd = accept(listen_fd, nullptr, nullptr);
+        if (ran_fd < 0)
+        {
+            if (running and errno != EINTR)
+            {
+                perror("N2 accept");
+            }
+            continue;
+        }
+        int core_fd = connect_core();
+        if (core_fd < 0)
+        {
+            close(ran_fd);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            dst_fd[n2_relay::FROM_RAN]       = core_fd;
+            dst_streams[n2_relay::FROM_RAN]  = nof_outbound_streams(core_fd);
+            dst_fd[n2_relay::FROM_CORE]      = ran_fd;
+            dst_streams[n2_relay::FROM_CORE] = nof_outbound_streams(ran_fd);
+            printf("N2: relaying with %d streams towards the core, %d towards the RAN\n",
+                   dst_streams[n2_relay::FROM_RAN], dst_streams[n2_relay::FROM_CORE]);
+        }
+
+        // Whichever association goes down first takes the other one down
+        std::thread core_thread([this, &relay, core_fd, ran_fd]() {
+            receive(n2_relay::FROM_CORE, core_fd, relay);
+            shutdown(ran_fd, SHUT_RDWR);
+        });
+        receive(n2_relay::FROM_RAN, ran_fd, relay);
+        shutdown(core_fd, SHUT_RDWR);
+        core_thread.join();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            dst_fd[n2_relay::FROM_RAN]  = -1;
+            dst_fd[n2_relay::FROM_CORE] = -1;
+        }
+        close(ran_fd);
+        close(core_fd);
+        printf("N2: association down\n");
+    }
+}
+
+void n2_sctp::receive(n2_relay::direction_t dir, int fd, n2_relay &relay)
+{
+    std::vector<uint8_t> buf(max_msg);
+    bool                 partial = false;
+    while (running)
+    {
+        sctp_sndrcvinfo sri   = {};
+        int             flags = 0;
+        int             n     = sctp_recvmsg(fd, buf.data(), buf.size(), nullptr, nullptr, &sri, &flags);
+        if (n < 0 and errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return;
+        }
+        if (flags & MSG_NOTIFICATION)
+        {
+            const sctp_notification *notif = (const sctp_notification *)buf.data();
+            if (notif->sn_header.sn_type == SCTP_SHUTDOWN_EVENT or
+                (notif->sn_header.sn_type == SCTP_ASSOC_CHANGE and
+                 (notif->sn_assoc_change.sac_state == SCTP_COMM_LOST or
+                  notif->sn_assoc_change.sac_state == SCTP_SHUTDOWN_COMP)))
+            {
+                return;
+            }
+            continue;
+        }
+        // Messages larger than the buffer are dropped, NGAP and S1AP messages are far smaller
+        if (not(flags & MSG_EOR))
+        {
+            partial = true;
+            continue;
+        }
+        if (partial)
+        {
+            partial = false;
+            continue;
+        }
+        relay.push(dir, sri.sinfo_stream, buf.data(), n);
+    }
+}
+
+void n2_sctp::send(n2_relay::direction_t dir, uint16_t stream, const uint8_t *msg, uint32_t len)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (dst_fd[dir] < 0)
+    {
+        return;
+    }
+    if (dst_streams[dir] > 0 and stream >= dst_streams[dir])
+    {
+        stream %= dst_streams[dir];
+    }
+    if (sctp_sendmsg(dst_fd[dir], msg, len, nullptr, 0, htonl(n2_relay::ppid(protocol)), 0, stream, 0, 0) < 0)
+    {
+        perror("N2 sctp_sendmsg");
+    }
+}
+
+void n2_sctp::stop()
+{
+    running = false;
+    if (listen_fd >= 0)
+    {
+        shutdown(listen_fd, SHUT_RDWR);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int fd : dst_fd)
+    {
+        if (fd >= 0)
+        {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+}
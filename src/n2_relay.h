@@ -0,0 +1,149 @@
+#ifndef __N2_RELAY__
+#define __N2_RELAY__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "mitm_lib/asn1/asn1_utils.h"
+
+// NGAP (N2) or S1AP (S1-MME) relay between a gNB or an eNB and its AMF or MME.
+//
+// Every message is decoded, the NAS PDUs it carries are handed to handle_nas_msg(), and the rendering goes to the
+// scenario handler, whose verdict is applied as on the Uu side: 0 relays, 1 spoofs, anything else drops. Messages go
+// out on the SCTP stream they came in on. The streams are spread over nof_lanes lanes, each with a thread and a socket
+// of its own to the scenario handler, so that a message waiting for its verdict holds up the messages of its lane only,
+// while the messages of a stream keep their order. Stream 0 carries the non UE-associated signalling.
+class n2_relay
+{
+public:
+    enum protocol_t
+    {
+        NGAP,
+        S1AP
+    };
+    enum direction_t
+    {
+        FROM_RAN,  // gNB or eNB to AMF or MME
+        FROM_CORE, // AMF or MME to gNB or eNB
+    };
+
+    typedef std::function<void(direction_t dir, uint16_t stream, const uint8_t *msg, uint32_t len)> send_fn;
+
+    struct metrics_t
+    {
+        uint64_t relayed   = 0; // messages relayed unchanged
+        uint64_t spoofed   = 0; // messages replaced by a spoofed one
+        uint64_t dropped   = 0; // messages dropped by a verdict, or because their lane queue was full
+        uint64_t malformed = 0; // messages that could not be decoded, relayed all the same
+        uint64_t nas_pdus  = 0; // NAS PDUs found in the messages
+    };
+
+    static const uint32_t nof_lanes      = 4;
+    static const size_t   max_lane_queue = 1024;
+
+    // Messages are sent with send_, from the lane threads. decode_mutex_ serializes the decoding with the other users
+    // of the NAS security context: the controller workers hold it while they decode and while they spoof
+    n2_relay(protocol_t protocol_, const sockaddr_in &scenario_addr_, std::mutex &decode_mutex_, send_fn send_);
+    ~n2_relay();
+
+    static uint32_t ppid(protocol_t protocol);
+    static uint16_t port(protocol_t protocol);
+
+    // Queues a message received on stream for its lane. Called from the receiving threads
+    void push(direction_t dir, uint16_t stream, const uint8_t *msg, uint32_t len);
+    void stop();
+
+    // Renders the message and the NAS PDUs it carries. Returns the number of NAS PDUs, or SRSRAN_ERROR if the message
+    // can't be decoded
+    int decode(direction_t dir, const uint8_t *msg, uint32_t len, asn1::json_writer &json_buffer) const;
+    // Builds the message of a spoofing verdict: {"NAS-PDU": hex string or array of them} replaces the NAS PDUs of the
+    // message in order, {"PDU": hex string} the whole message. Returns SRSRAN_ERROR if the verdict can't be applied
+    int spoof(const std::string &json, const uint8_t *msg, uint32_t len, std::vector<uint8_t> &spoofed) const;
+
+    metrics_t   get_metrics() const;
+    std::string metrics_to_string() const;
+
+private:
+    struct message_t
+    {
+        direction_t          dir;
+        uint16_t             stream;
+        std::vector<uint8_t> pdu;
+    };
+
+    struct lane_t
+    {
+        std::thread             thread;
+        int                     sock = -1;
+        std::mutex              mutex;
+        std::condition_variable cvar;
+        std::deque<message_t>   queue;
+    };
+
+    void run_lane(lane_t &lane);
+    void add_metrics(const metrics_t &m);
+
+    const protocol_t  protocol;
+    const sockaddr_in scenario_addr;
+    std::mutex       &decode_mutex;
+    const send_fn     send;
+
+    std::atomic<bool>       running{true};
+    std::unique_ptr<lane_t> lanes[nof_lanes];
+
+    mutable std::mutex mutex;
+    metrics_t          metrics;
+};
+
+// SCTP associations of the N2 relay.
+//
+// The gNB or eNB connects to the relay as it would to its core, upon which the relay connects to the core on its behalf
+// with as many streams. A thread per association receives the messages and pushes them to the relay, which sends them
+// on the other association. One RAN node at a time is relayed; when either association goes down the other one is shut
+// down too, and the relay waits for the RAN node to connect again.
+class n2_sctp
+{
+public:
+    static const uint16_t max_streams = 32;
+    static const uint32_t max_msg     = 65535;
+
+    n2_sctp(n2_relay::protocol_t protocol_, const sockaddr_in &core_addr_);
+    ~n2_sctp();
+
+    // Listens for the RAN node on bind_addr. Returns false if the socket can't be set up
+    bool listen(const sockaddr_in &bind_addr);
+    // Thread body: accepts the RAN node, connects to the core and relays through relay until stop() is called
+    void run(n2_relay &relay);
+    void stop();
+
+    // Sends msg to the destination of a message of dir, on stream, or on a stream it has if it has fewer
+    void send(n2_relay::direction_t dir, uint16_t stream, const uint8_t *msg, uint32_t len);
+
+private:
+    int  open_socket();
+    int  connect_core();
+    void receive(n2_relay::direction_t dir, int fd, n2_relay &relay);
+
+    const n2_relay::protocol_t protocol;
+    const sockaddr_in          core_addr;
+    int                        listen_fd = -1;
+    std::atomic<bool>          running{true};
+
+    // Association of the destination of each direction, and its number of outbound streams
+    std::mutex mutex;
+    int        dst_fd[2]      = {-1, -1};
+    uint16_t   dst_streams[2] = {0, 0};
+};
+
+#endif
@@ -1,8 +1,20 @@
 #include "nas_packet_handler.h"
+#include "nas_security.h"
 
-void write_encrypted_nas_pdu(srsran::unique_byte_buffer_t &pdu, asn1::json_writer &j);
+#include <cstring>
+#include <iostream>
+#include <memory>
 
-int handle_nas_msg(srsran::unique_byte_buffer_t pdu, asn1::json_writer &json_buf_p)
+#include "mitm_lib/asn1/liblte_mme.h"
+
+void write_encrypted_nas_pdu(srsran::unique_byte_buffer_t &pdu, asn1::json_writer &j, const char *integrity_check);
+
+// Outcomes of the MAC check of a protected PDU, as shown to the scenario handler
+static const char *integrity_passed    = "Passed";
+static const char *integrity_failed    = "Failed";
+static const char *integrity_unchecked = "No security context";
+
+int handle_nas_msg(srsran::unique_byte_buffer_t pdu, asn1::json_writer &json_buf_p, srsran::security_direction_t dir)
 {
     using namespace srsran::nas_5g;
 
@@ -14,26 +26,37 @@ int handle_nas_msg(srsran::unique_byte_buffer_t pdu, asn1::json_writer &json_buf
         return SRSRAN_ERROR;
     }
 
+    // The context only follows the messages that passed their integrity check, so that a spoofed or corrupted one
+    // can't move it. Before the context is active, nothing can be checked and every message is followed
+    const char *integrity_check = nullptr;
+    bool        new_context     = false;
     switch (nas_msg.hdr.security_header_type)
     {
     case nas_5gs_hdr::security_header_type_opts::plain_5gs_nas_message:
+        break;
     case nas_5gs_hdr::security_header_type_opts::integrity_protected:
+        if (not nas_sec_ctx.is_active())
+        {
+            integrity_check = integrity_unchecked;
+        }
+        else
+        {
+            integrity_check = nas_sec_ctx.verify(*pdu, dir) == SRSRAN_SUCCESS ? integrity_passed : integrity_failed;
+        }
+        break;
     case nas_5gs_hdr::security_header_type_opts::integrity_protected_with_new_5G_nas_context:
+        // a Security Mode Command is protected with the keys it establishes, so the MAC is checked after decoding
+        new_context = true;
         break;
     case nas_5gs_hdr::security_header_type_opts::integrity_protected_and_ciphered:
-        write_encrypted_nas_pdu(pdu, json_buf_p);
-        //fprintf(stderr, "We do not handle encrypted data\n");
-        //   if (integrity_check(pdu.get()) == false) {
-        //     fprintf(stderr,"Not handling NAS message with integrity check error");
-        //     return SRSRAN_ERROR;
-        //   } else {
-        //     cipher_decrypt(pdu.get());
-        //   }
-        return SRSRAN_ERROR;
     case nas_5gs_hdr::security_header_type_opts::integrity_protected_and_ciphered_with_new_5G_nas_context:
-        write_encrypted_nas_pdu(pdu, json_buf_p);
-        //fprintf(stderr, "We do not handle encrypted data\n");
-        return SRSRAN_ERROR;
+        if (nas_sec_ctx.unprotect(*pdu, dir) != SRSRAN_SUCCESS)
+        {
+            write_encrypted_nas_pdu(pdu, json_buf_p, nas_sec_ctx.is_active() ? integrity_failed : integrity_unchecked);
+            return SRSRAN_ERROR;
+        }
+        integrity_check = integrity_passed;
+        break;
     default:
         fprintf(stderr, "Not handling NAS message with unkown security header\n");
         break;
@@ -46,19 +69,229 @@ int handle_nas_msg(srsran::unique_byte_buffer_t pdu, asn1::json_writer &json_buf
         return SRSRAN_ERROR;
     }
 
-    nas_msg.to_json(json_buf_p);
+    if (new_context)
+    {
+        if (not nas_sec_ctx.is_configured())
+        {
+            integrity_check = integrity_unchecked;
+        }
+        else
+        {
+            integrity_check = nas_sec_ctx.verify_new_context(nas_msg, *pdu, dir) == SRSRAN_SUCCESS ? integrity_passed
+                                                                                                  : integrity_failed;
+        }
+    }
+    else if (integrity_check == integrity_passed or not nas_sec_ctx.is_active())
+    {
+        nas_sec_ctx.observe(nas_msg, dir);
+    }
+
+    nas_msg.to_json(json_buf_p, integrity_check);
 
     return 0;
 }
 
-void write_encrypted_nas_pdu(srsran::unique_byte_buffer_t &pdu, asn1::json_writer &j)
+void write_encrypted_nas_pdu(srsran::unique_byte_buffer_t &pdu, asn1::json_writer &j, const char *integrity_check)
 {
     j.start_array();
     j.start_obj();
     j.write_fieldname("Encrypted 5G NAS");
     j.start_obj();
-    j.write_str("PDU", octstring_to_string(pdu->data(), pdu->size()));
+    j.write_str("Integrity check", integrity_check);
+    j.write_octstring("PDU", pdu->data(), pdu->size());
     j.end_obj();
     j.end_obj();
     j.end_array();
-}
\ No newline at end of file
+}
+static void write_digits(const char *name, const uint8_t *digits, uint32_t nof_digits, asn1::json_writer &j)
+{
+    std::string s;
+    for (uint32_t i = 0; i < nof_digits; i++)
+    {
+        s += (char)('0' + digits[i] % 10);
+    }
+    j.write_str(name, s);
+}
+
+static void write_eps_mobile_id(const LIBLTE_MME_EPS_MOBILE_ID_STRUCT &id, asn1::json_writer &j)
+{
+    j.start_obj("EPS mobile identity");
+    switch (id.type_of_id)
+    {
+    case LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI:
+        write_digits("IMSI", id.imsi, 15, j);
+        break;
+    case LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMEI:
+        write_digits("IMEI", id.imei, 15, j);
+        break;
+    case LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI:
+        j.start_obj("GUTI");
+        j.write_int("MCC", id.guti.mcc);
+        j.write_int("MNC", id.guti.mnc);
+        j.write_int("MME group ID", id.guti.mme_group_id);
+        j.write_int("MME code", id.guti.mme_code);
+        j.write_int("M-TMSI", id.guti.m_tmsi);
+        j.end_obj();
+        break;
+    }
+    j.end_obj();
+}
+
+// Fields of the EPS NAS messages a scenario is most likely to look at, the others are shown by name only
+static void write_eps_nas_fields(uint8_t msg_type, LIBLTE_BYTE_MSG_STRUCT &msg, asn1::json_writer &j)
+{
+    switch (msg_type)
+    {
+    case LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST:
+    {
+        std::unique_ptr<LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT> attach_req(new LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT);
+        if (liblte_mme_unpack_attach_request_msg(&msg, attach_req.get()) == LIBLTE_SUCCESS)
+        {
+            j.write_int("EPS attach type", attach_req->eps_attach_type);
+            write_eps_mobile_id(attach_req->eps_mobile_id, j);
+        }
+        break;
+    }
+    case LIBLTE_MME_MSG_TYPE_ATTACH_REJECT:
+    {
+        std::unique_ptr<LIBLTE_MME_ATTACH_REJECT_MSG_STRUCT> attach_rej(new LIBLTE_MME_ATTACH_REJECT_MSG_STRUCT);
+        if (liblte_mme_unpack_attach_reject_msg(&msg, attach_rej.get()) == LIBLTE_SUCCESS)
+        {
+            j.write_int("EMM cause", attach_rej->emm_cause);
+        }
+        break;
+    }
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REQUEST:
+    {
+        LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req;
+        if (liblte_mme_unpack_authentication_request_msg(&msg, &auth_req) == LIBLTE_SUCCESS)
+        {
+            j.write_octstring("RAND", auth_req.rand, sizeof(auth_req.rand));
+            j.write_octstring("AUTN", auth_req.autn, sizeof(auth_req.autn));
+        }
+        break;
+    }
+    case LIBLTE_MME_MSG_TYPE_SECURITY_MODE_COMMAND:
+    {
+        LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT smc;
+        if (liblte_mme_unpack_security_mode_command_msg(&msg, &smc) == LIBLTE_SUCCESS)
+        {
+            j.write_int("EEA", smc.selected_nas_sec_algs.type_of_eea);
+            j.write_int("EIA", smc.selected_nas_sec_algs.type_of_eia);
+        }
+        break;
+    }
+    case LIBLTE_MME_MSG_TYPE_IDENTITY_RESPONSE:
+    {
+        LIBLTE_MME_ID_RESPONSE_MSG_STRUCT id_resp;
+        if (liblte_mme_unpack_identity_response_msg(&msg, &id_resp) == LIBLTE_SUCCESS)
+        {
+            j.start_obj("Mobile identity");
+            if (id_resp.mobile_id.type_of_id == LIBLTE_MME_MOBILE_ID_TYPE_IMSI)
+            {
+                write_digits("IMSI", id_resp.mobile_id.imsi, 15, j);
+            }
+            else if (id_resp.mobile_id.type_of_id == LIBLTE_MME_MOBILE_ID_TYPE_TMSI)
+            {
+                j.write_int("TMSI", id_resp.mobile_id.tmsi);
+            }
+            j.end_obj();
+        }
+        break;
+    }
+    }
+}
+
+int handle_eps_nas_msg(const uint8_t *pdu, uint32_t len, asn1::json_writer &json_buf_p)
+{
+    std::unique_ptr<LIBLTE_BYTE_MSG_STRUCT> msg(new LIBLTE_BYTE_MSG_STRUCT);
+    uint8_t                                 pd, sec_hdr_type, msg_type;
+    if (len < 2 or len > sizeof(msg->msg))
+    {
+        fprintf(stderr, "Unable to unpack EPS NAS header\n");
+        return SRSRAN_ERROR;
+    }
+    msg->N_bytes = len;
+    memcpy(msg->msg, pdu, len);
+    liblte_mme_parse_msg_sec_header(msg.get(), &pd, &sec_hdr_type);
+
+    json_buf_p.start_obj();
+    switch (sec_hdr_type)
+    {
+    case LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED:
+    case LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT:
+        json_buf_p.start_obj("Encrypted EPS NAS");
+        json_buf_p.write_octstring("PDU", pdu, len);
+        json_buf_p.end_obj();
+        json_buf_p.end_obj();
+        return 0;
+    case LIBLTE_MME_SECURITY_HDR_TYPE_SERVICE_REQUEST:
+        json_buf_p.start_obj("EPS NAS");
+        json_buf_p.write_str("Message type", "SERVICE_REQUEST");
+        break;
+    default:
+        json_buf_p.start_obj("EPS NAS");
+        // The plain message follows the MAC and the sequence number of an integrity protected one
+        if (sec_hdr_type != LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS and len > 6)
+        {
+            json_buf_p.write_int("Security header type", sec_hdr_type);
+            json_buf_p.write_octstring("MAC", &pdu[1], 4);
+            json_buf_p.write_int("Sequence number", pdu[5]);
+            msg->N_bytes = len - 6;
+            memmove(msg->msg, &pdu[6], msg->N_bytes);
+        }
+        if (liblte_mme_parse_msg_header(msg.get(), &pd, &msg_type) == LIBLTE_SUCCESS)
+        {
+            const char *name = liblte_nas_msg_type_to_string(msg_type);
+            // "LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST" shows as "ATTACH_REQUEST"
+            const char *prefix = "LIBLTE_MME_MSG_TYPE_";
+            if (strncmp(name, prefix, strlen(prefix)) == 0)
+            {
+                name += strlen(prefix);
+            }
+            json_buf_p.write_str("Protocol discriminator",
+                                 pd == LIBLTE_MME_PD_EPS_SESSION_MANAGEMENT ? "ESM" : "EMM");
+            json_buf_p.write_str("Message type", name);
+            // The unpack functions skip the security header themselves
+            msg->N_bytes = len;
+            memcpy(msg->msg, pdu, len);
+            write_eps_nas_fields(msg_type, *msg, json_buf_p);
+        }
+        break;
+    }
+    json_buf_p.write_octstring("PDU", pdu, len);
+    json_buf_p.end_obj();
+    json_buf_p.end_obj();
+    return 0;
+}
+
+bool verdict_hex_to_bytes(const rapidjson::Value &value, std::vector<uint8_t> &bytes)
+{
+    if (not value.IsString() or value.GetStringLength() % 2 != 0)
+    {
+        return false;
+    }
+    bytes.resize(value.GetStringLength() / 2);
+    return asn1::hex_to_octstring(bytes.data(), value.GetString(), value.GetStringLength());
+}
+
+bool verdict_nas_pdus(const rapidjson::Value &value, uint32_t nof_nas, std::vector<std::vector<uint8_t> > &pdus)
+{
+    // A single NAS PDU may be given without an array
+    uint32_t nof_spoofed = value.IsArray() ? value.Size() : 1;
+    if (nof_spoofed > nof_nas)
+    {
+        std::cerr << "Spoofing " << nof_spoofed << " NAS PDUs of a message with " << nof_nas << std::endl;
+        return false;
+    }
+    pdus.resize(nof_spoofed);
+    for (uint32_t i = 0; i < nof_spoofed; i++)
+    {
+        if (not verdict_hex_to_bytes(value.IsArray() ? value[i] : value, pdus[i]))
+        {
+            std::cerr << "Spoofed NAS PDUs must be hex strings" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
@@ -4,7 +4,21 @@
 #include "mitm_lib/asn1/nas_5g_msg.h"
 #include "mitm_lib/common/byte_buffer.h"
 #include "mitm_lib/common/common_nr.h"
+#include "mitm_lib/common/security.h"
+#include "rapidjson/document.h"
 
-int handle_nas_msg(srsran::unique_byte_buffer_t pdu, asn1::json_writer &json_buf_p);
+#include <vector>
+
+// Protected PDUs are verified and deciphered with nas_sec_ctx when it is active
+int handle_nas_msg(srsran::unique_byte_buffer_t pdu, asn1::json_writer &json_buf_p, srsran::security_direction_t dir);
+// EPS NAS of the LTE relay paths, decoded with liblte_mme. There is no EPS security context, ciphered PDUs are shown as
+// they are
+int handle_eps_nas_msg(const uint8_t *pdu, uint32_t len, asn1::json_writer &json_buf_p);
+
+// Spoofing verdicts give PDUs as hex strings. Returns false if value is not a string of hex digit pairs
+bool verdict_hex_to_bytes(const rapidjson::Value &value, std::vector<uint8_t> &bytes);
+// NAS PDUs of the "NAS-PDU" member of a spoofing verdict, a hex string or an array of them. They replace the first
+// NAS PDUs of a message carrying nof_nas, so there can't be more than that
+bool verdict_nas_pdus(const rapidjson::Value &value, uint32_t nof_nas, std::vector<std::vector<uint8_t> > &pdus);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "nas_security.h"
+
+#include <iostream>
+
+using namespace srsran;
+using namespace srsran::nas_5g;
+
+nas_security_ctx nas_sec_ctx;
+
+static bool parse_key(const std::string &hex, uint8_t *key, uint32_t len)
+{
+    return hex.size() == 2 * len and asn1::hex_to_octstring(key, hex.c_str(), hex.size());
+}
+
+bool nas_security_ctx::configure(const std::string &k_hex, const std::string &opc_hex, const std::string &supi_,
+                                 const std::string &serving_network_name_)
+{
+    if (not parse_key(k_hex, k, sizeof(k)) or not parse_key(opc_hex, opc, sizeof(opc)))
+    {
+        std::cerr << "NAS security: K and OPc must be 32 hex digits" << std::endl;
+        return false;
+    }
+    if (supi_.empty() or serving_network_name_.empty())
+    {
+        std::cerr << "NAS security: the SUPI and the serving network name are required" << std::endl;
+        return false;
+    }
+    supi                 = supi_;
+    serving_network_name = serving_network_name_;
+    configured           = true;
+    active               = false;
+    have_k_amf           = false;
+    return true;
+}
+
+void nas_security_ctx::observe(nas_5gs_msg &msg, security_direction_t dir)
+{
+    if (not configured or dir != SECURITY_DIRECTION_DOWNLINK)
+    {
+        return;
+    }
+    switch (msg.hdr.message_type)
+    {
+    case msg_types::options::authentication_request:
+        handle_authentication_request(msg.authentication_request());
+        break;
+    case msg_types::options::security_mode_command:
+        handle_security_mode_command(msg.security_mode_command(), nullptr, dir);
+        break;
+    default:
+        break;
+    }
+}
+
+int nas_security_ctx::verify_new_context(nas_5gs_msg &msg, byte_buffer_t &pdu, security_direction_t dir)
+{
+    if (not configured or dir != SECURITY_DIRECTION_DOWNLINK or
+        msg.hdr.message_type != msg_types::options::security_mode_command)
+    {
+        return SRSRAN_ERROR;
+    }
+    return handle_security_mode_command(msg.security_mode_command(), &pdu, dir);
+}
+
+void nas_security_ctx::handle_authentication_request(authentication_request_t &auth_req)
+{
+    if (not auth_req.authentication_parameter_rand_present or not auth_req.authentication_parameter_autn_present or
+        auth_req.authentication_parameter_autn.autn.size() < AKA_AUTN_LEN)
+    {
+        std::cerr << "NAS security: Authentication Request without RAND/AUTN, only 5G AKA is supported" << std::endl;
+        return;
+    }
+
+    uint8_t  res[RES_MAX_LEN], ck[CK_LEN], ik[IK_LEN], ak[AK_LEN];
+    uint8_t  k_ausf[32], k_seaf[32];
+    uint8_t *rand = auth_req.authentication_parameter_rand.rand.data();
+    // AUTN = SQN ^ AK || AMF || MAC
+    const uint8_t *sqn_xor_ak = auth_req.authentication_parameter_autn.autn.data();
+
+    security_milenage_f2345(k, opc, rand, res, ck, ik, ak);
+    if (security_generate_k_ausf(ck, ik, sqn_xor_ak, serving_network_name.c_str(), k_ausf) != SRSRAN_SUCCESS or
+        security_generate_k_seaf(k_ausf, serving_network_name.c_str(), k_seaf) != SRSRAN_SUCCESS or
+        security_generate_k_amf(k_seaf,
+                                supi.c_str(),
+                                auth_req.abba.abba_contents.data(),
+                                auth_req.abba.abba_contents.size(),
+                                k_amf) != SRSRAN_SUCCESS)
+    {
+        std::cerr << "NAS security: failed to derive K_AMF" << std::endl;
+        return;
+    }
+    have_k_amf = true;
+    ng_ksi     = auth_req.ng_ksi.nas_key_set_identifier.value;
+}
+
+int nas_security_ctx::handle_security_mode_command(security_mode_command_t &smc, byte_buffer_t *pdu,
+                                                   security_direction_t dir)
+{
+    if (not have_k_amf)
+    {
+        std::cerr << "NAS security: Security Mode Command without a preceding 5G AKA, keys unknown" << std::endl;
+        return SRSRAN_ERROR;
+    }
+
+    uint8_t ea = smc.selected_nas_security_algorithms.ciphering_algorithm.value;
+    uint8_t ia = smc.selected_nas_security_algorithms.integrity_protection_algorithm.value;
+    if (ea >= CIPHERING_ALGORITHM_ID_N_ITEMS or ia >= INTEGRITY_ALGORITHM_ID_N_ITEMS)
+    {
+        std::cerr << "NAS security: unsupported algorithms 5G-EA" << (int)ea << "/5G-IA" << (int)ia << std::endl;
+        return SRSRAN_ERROR;
+    }
+    uint8_t new_k_nas_enc[32], new_k_nas_int[32];
+    if (security_generate_k_nas_5g(k_amf, (CIPHERING_ALGORITHM_ID_ENUM)ea, (INTEGRITY_ALGORITHM_ID_ENUM)ia,
+                                   new_k_nas_enc, new_k_nas_int) != SRSRAN_SUCCESS)
+    {
+        std::cerr << "NAS security: failed to derive the NAS keys" << std::endl;
+        return SRSRAN_ERROR;
+    }
+
+    // The Security Mode Command starts a new context, which counts from 0 in both directions
+    if (pdu != nullptr)
+    {
+        security_128_eia2_ctx_t new_eia2_ctx;
+        security_128_eia2_init(new_eia2_ctx, &new_k_nas_int[16]);
+        uint8_t mac[4];
+        if (pdu->N_bytes <= msg_offset or
+            not compute_mac((INTEGRITY_ALGORITHM_ID_ENUM)ia, new_k_nas_int, new_eia2_ctx, *pdu, pdu->msg[seq_offset],
+                            dir, mac) or
+            memcmp(mac, pdu->msg + mac_offset, sizeof(mac)) != 0)
+        {
+            fprintf(stderr, "NAS security: MAC mismatch for the Security Mode Command, keeping the current context\n");
+            memset(new_k_nas_enc, 0, sizeof(new_k_nas_enc));
+            memset(new_k_nas_int, 0, sizeof(new_k_nas_int));
+            return SRSRAN_ERROR;
+        }
+    }
+
+    cipher_algo = (CIPHERING_ALGORITHM_ID_ENUM)ea;
+    integ_algo  = (INTEGRITY_ALGORITHM_ID_ENUM)ia;
+    memcpy(k_nas_enc, new_k_nas_enc, sizeof(k_nas_enc));
+    memcpy(k_nas_int, new_k_nas_int, sizeof(k_nas_int));
+    memset(new_k_nas_enc, 0, sizeof(new_k_nas_enc));
+    memset(new_k_nas_int, 0, sizeof(new_k_nas_int));
+    security_128_eia2_init(eia2_ctx, &k_nas_int[16]);
+    security_128_eea2_init(eea2_ctx, &k_nas_enc[16]);
+    for (uint32_t d = 0; d < SECURITY_DIRECTION_N_ITEMS; ++d)
+    {
+        count[d]       = 0;
+        count_valid[d] = false;
+    }
+    if (pdu != nullptr)
+    {
+        count[dir]       = pdu->msg[seq_offset];
+        count_valid[dir] = true;
+    }
+    active = true;
+    return SRSRAN_SUCCESS;
+}
+
+// NAS COUNT = overflow (16 bits) || SQN (8 bits). The overflow is advanced when the SQN wraps around
+uint32_t nas_security_ctx::estimate_count(security_direction_t dir, uint8_t sqn) const
+{
+    if (not count_valid[dir])
+    {
+        return sqn;
+    }
+    uint32_t overflow = count[dir] >> 8;
+    if (sqn < (count[dir] & 0xff))
+    {
+        overflow++;
+    }
+    return (overflow << 8) | sqn;
+}
+
+bool nas_security_ctx::compute_mac(byte_buffer_t &pdu, uint32_t count_, security_direction_t dir, uint8_t *mac)
+{
+    return compute_mac(integ_algo, k_nas_int, eia2_ctx, pdu, count_, dir, mac);
+}
+
+bool nas_security_ctx::compute_mac(INTEGRITY_ALGORITHM_ID_ENUM algo, const uint8_t *k_int,
+                                   const security_128_eia2_ctx_t &eia2, byte_buffer_t &pdu, uint32_t count_,
+                                   security_direction_t dir, uint8_t *mac)
+{
+    // The MAC covers the sequence number and the (ciphered) message
+    uint8_t *msg     = pdu.msg + seq_offset;
+    uint32_t msg_len = pdu.N_bytes - seq_offset;
+    switch (algo)
+    {
+    case INTEGRITY_ALGORITHM_ID_EIA0:
+        memset(mac, 0, 4);
+        return true;
+    case INTEGRITY_ALGORITHM_ID_128_EIA1:
+        security_128_eia1(&k_int[16], count_, nas_bearer, dir, msg, msg_len, mac);
+        return true;
+    case INTEGRITY_ALGORITHM_ID_128_EIA2:
+        security_128_eia2(eia2, count_, nas_bearer, dir, msg, msg_len, mac);
+        return true;
+    case INTEGRITY_ALGORITHM_ID_128_EIA3:
+        security_128_eia3(&k_int[16], count_, nas_bearer, dir, msg, msg_len, mac);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void nas_security_ctx::cipher(byte_buffer_t &pdu, uint32_t count_, security_direction_t dir)
+{
+    // the keystream is XORed in, so ciphering and deciphering are the same operation
+    uint8_t *msg     = pdu.msg + msg_offset;
+    uint32_t msg_len = pdu.N_bytes - msg_offset;
+    switch (cipher_algo)
+    {
+    case CIPHERING_ALGORITHM_ID_128_EEA1:
+        security_128_eea1(&k_nas_enc[16], count_, nas_bearer, dir, msg, msg_len, msg);
+        break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2:
+        security_128_eea2(eea2_ctx, count_, nas_bearer, dir, msg, msg_len, msg);
+        break;
+    case CIPHERING_ALGORITHM_ID_128_EEA3:
+        security_128_eea3(&k_nas_enc[16], count_, nas_bearer, dir, msg, msg_len, msg);
+        break;
+    default:
+        break;
+    }
+}
+
+int nas_security_ctx::verify(byte_buffer_t &pdu, security_direction_t dir)
+{
+    if (not active or pdu.N_bytes <= msg_offset)
+    {
+        return SRSRAN_ERROR;
+    }
+
+    uint32_t count_ = estimate_count(dir, pdu.msg[seq_offset]);
+    uint8_t  mac[4];
+    if (not compute_mac(pdu, count_, dir, mac) or memcmp(mac, pdu.msg + mac_offset, sizeof(mac)) != 0)
+    {
+        fprintf(stderr, "NAS security: %s MAC mismatch for COUNT=%u\n", security_direction_text[dir], count_);
+        return SRSRAN_ERROR;
+    }
+    count[dir]       = count_;
+    count_valid[dir] = true;
+    return SRSRAN_SUCCESS;
+}
+
+int nas_security_ctx::unprotect(byte_buffer_t &pdu, security_direction_t dir)
+{
+    if (verify(pdu, dir) != SRSRAN_SUCCESS)
+    {
+        return SRSRAN_ERROR;
+    }
+    cipher(pdu, count[dir], dir);
+    return SRSRAN_SUCCESS;
+}
+
+int nas_security_ctx::protect(byte_buffer_t &pdu, security_direction_t dir)
+{
+    if (not active or pdu.N_bytes <= msg_offset)
+    {
+        return SRSRAN_ERROR;
+    }
+
+    uint8_t  sht    = pdu.msg[1] & 0x0f;
+    uint32_t count_ = estimate_count(dir, pdu.msg[seq_offset]);
+    if (sht == nas_5gs_hdr::integrity_protected_and_ciphered or
+        sht == nas_5gs_hdr::integrity_protected_and_ciphered_with_new_5G_nas_context)
+    {
+        cipher(pdu, count_, dir);
+    }
+    if (not compute_mac(pdu, count_, dir, pdu.msg + mac_offset))
+    {
+        return SRSRAN_ERROR;
+    }
+    count[dir]       = count_;
+    count_valid[dir] = true;
+    return SRSRAN_SUCCESS;
+}
+
+bool nas_security_ctx::get_k_gnb(as_key_t &k_gnb) const
+{
+    if (not active)
+    {
+        return false;
+    }
+    as_key_t k_amf_;
+    memcpy(k_amf_.data(), k_amf, k_amf_.size());
+    uint32_t ul_count = count_valid[SECURITY_DIRECTION_UPLINK] ? count[SECURITY_DIRECTION_UPLINK] : 0;
+    bool     ret      = security_generate_k_gnb(k_amf_, ul_count, k_gnb) == SRSRAN_SUCCESS;
+    k_amf_.fill(0);
+    return ret;
+}
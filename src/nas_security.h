@@ -0,0 +1,104 @@
+#ifndef __NAS_SECURITY__
+#define __NAS_SECURITY__
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mitm_lib/asn1/nas_5g_msg.h"
+#include "mitm_lib/common/byte_buffer.h"
+#include "mitm_lib/common/security.h"
+
+// 5G NAS security context of the relayed UE.
+//
+// The operator provides the subscriber's K/OPc and SUPI. The context then follows the registration as it crosses the
+// relay: the Authentication Request gives RAND/AUTN/ABBA, from which K_AUSF, K_SEAF and K_AMF are derived (TS 33.501
+// Annex A), and the NAS Security Mode Command gives the selected algorithms for K_NASenc/K_NASint. From then on the
+// UL/DL NAS COUNTs are tracked, protected PDUs can be verified and deciphered for the decoder, and spoofed NAS PDUs can
+// be ciphered and integrity protected as the real peer would.
+class nas_security_ctx
+{
+public:
+    bool configure(const std::string &k_hex, const std::string &opc_hex, const std::string &supi_,
+                   const std::string &serving_network_name_);
+    bool is_configured() const { return configured; }
+    // True once the NAS keys have been derived from a Security Mode Command
+    bool is_active() const { return active; }
+
+    uint8_t                             get_ng_ksi() const { return ng_ksi; }
+    srsran::CIPHERING_ALGORITHM_ID_ENUM get_cipher_algo() const { return cipher_algo; }
+    srsran::INTEGRITY_ALGORITHM_ID_ENUM get_integ_algo() const { return integ_algo; }
+
+    // Tracks the PDUs that set up the context. Called with the decoded NAS messages that passed their integrity check,
+    // or with all of them as long as there is no active context
+    void observe(srsran::nas_5g::nas_5gs_msg &msg, srsran::security_direction_t dir);
+    // Verifies a Security Mode Command protected with the context it establishes, and only then takes that context
+    // over. Returns SRSRAN_ERROR and keeps the current context if the keys are unknown or the MAC does not match
+    int verify_new_context(srsran::nas_5g::nas_5gs_msg &msg, srsran::byte_buffer_t &pdu,
+                           srsran::security_direction_t dir);
+
+    // Verifies the MAC of a protected PDU and deciphers it in place. Returns SRSRAN_ERROR without touching the PDU if
+    // there is no active context or the MAC does not match
+    int unprotect(srsran::byte_buffer_t &pdu, srsran::security_direction_t dir);
+    // Verifies the MAC of an integrity protected, not ciphered, PDU, once the context has been updated with it
+    int verify(srsran::byte_buffer_t &pdu, srsran::security_direction_t dir);
+
+    // Sequence number for the next PDU in a direction, to be packed in the header of a spoofed message
+    uint8_t next_sequence_number(srsran::security_direction_t dir) const
+    {
+        return (count_valid[dir] ? count[dir] + 1 : 0) & 0xff;
+    }
+    // Ciphers (depending on the security header type) and integrity protects a packed NAS PDU using the next COUNT.
+    // Returns SRSRAN_ERROR without touching the PDU while there is no active context
+    int protect(srsran::byte_buffer_t &pdu, srsran::security_direction_t dir);
+
+    // K_gNB (TS 33.501 A.9) for the AS security that follows the NAS Security Mode procedure, from the last uplink NAS
+    // COUNT. Returns false while there is no active context
+    bool get_k_gnb(srsran::as_key_t &k_gnb) const;
+
+private:
+    // NAS connection identifier of 3GPP access, used as BEARER (TS 33.501 6.4.3.1)
+    static const uint8_t nas_bearer = 0;
+    // Offsets of the MAC, the sequence number and the protected message in a security protected 5GMM PDU
+    static const uint32_t mac_offset = 2;
+    static const uint32_t seq_offset = 6;
+    static const uint32_t msg_offset = 7;
+
+    void     handle_authentication_request(srsran::nas_5g::authentication_request_t &auth_req);
+    // Derives the keys of a Security Mode Command. If pdu is given, they are only taken over if its MAC matches
+    int      handle_security_mode_command(srsran::nas_5g::security_mode_command_t &smc, srsran::byte_buffer_t *pdu,
+                                          srsran::security_direction_t dir);
+    uint32_t estimate_count(srsran::security_direction_t dir, uint8_t sqn) const;
+    bool     compute_mac(srsran::byte_buffer_t &pdu, uint32_t count_, srsran::security_direction_t dir, uint8_t *mac);
+    static bool compute_mac(srsran::INTEGRITY_ALGORITHM_ID_ENUM algo, const uint8_t *k_int,
+                            const srsran::security_128_eia2_ctx_t &eia2, srsran::byte_buffer_t &pdu, uint32_t count_,
+                            srsran::security_direction_t dir, uint8_t *mac);
+    void     cipher(srsran::byte_buffer_t &pdu, uint32_t count_, srsran::security_direction_t dir);
+
+    bool        configured = false;
+    bool        active     = false;
+    uint8_t     k[16]      = {};
+    uint8_t     opc[16]    = {};
+    std::string supi;
+    std::string serving_network_name;
+
+    bool                                have_k_amf    = false;
+    uint8_t                             ng_ksi        = 0;
+    uint8_t                             k_amf[32]     = {};
+    uint8_t                             k_nas_enc[32] = {};
+    uint8_t                             k_nas_int[32] = {};
+    srsran::CIPHERING_ALGORITHM_ID_ENUM cipher_algo   = srsran::CIPHERING_ALGORITHM_ID_EEA0;
+    srsran::INTEGRITY_ALGORITHM_ID_ENUM integ_algo    = srsran::INTEGRITY_ALGORITHM_ID_EIA0;
+    // Key schedules of K_NASint/K_NASenc for 128-NIA2/128-NEA2, set up with the keys
+    srsran::security_128_eia2_ctx_t eia2_ctx;
+    srsran::security_128_eea2_ctx_t eea2_ctx;
+    // Last COUNT verified or used for protection, per direction
+    uint32_t count[srsran::SECURITY_DIRECTION_N_ITEMS]       = {};
+    bool     count_valid[srsran::SECURITY_DIRECTION_N_ITEMS] = {};
+};
+
+// The relay carries a single UE
+extern nas_security_ctx nas_sec_ctx;
+
+#endif
@@ -0,0 +1,290 @@
+#include "pdcp_relay.h"
+#include "nas_security.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "mitm_lib/srslog/bundled/fmt/format.h"
+
+using namespace srsran;
+
+as_security_ctx as_sec_ctx;
+
+void as_security_ctx::observe_security_mode_command(CIPHERING_ALGORITHM_ID_ENUM cipher_algo,
+                                                    INTEGRITY_ALGORITHM_ID_ENUM integ_algo)
+{
+    as_key_t k_gnb;
+    if (not nas_sec_ctx.get_k_gnb(k_gnb))
+    {
+        std::cerr << "AS security: RRC Security Mode Command without an active NAS security context" << std::endl;
+        return;
+    }
+
+    as_security_config_t cfg = {};
+    cfg.cipher_algo          = cipher_algo;
+    cfg.integ_algo           = integ_algo;
+    const uint8_t *k = k_gnb.data();
+    bool ok = security_generate_k_nr_rrc(k, cipher_algo, integ_algo, cfg.k_rrc_enc.data(), cfg.k_rrc_int.data()) ==
+                  SRSRAN_SUCCESS and
+              security_generate_k_nr_up(k, cipher_algo, integ_algo, cfg.k_up_enc.data(), cfg.k_up_int.data()) ==
+                  SRSRAN_SUCCESS;
+    k_gnb.fill(0);
+    if (not ok)
+    {
+        std::cerr << "AS security: failed to derive the RRC and UP keys" << std::endl;
+        return;
+    }
+
+    set_config(cfg);
+}
+
+void as_security_ctx::set_config(const as_security_config_t &cfg)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    config = cfg;
+    epoch++;
+}
+
+as_security_config_t as_security_ctx::get_config() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return config;
+}
+
+pdcp_relay::pdcp_relay(security_direction_t direction_, uint8_t drb_sn_len_) :
+    direction(direction_), drb_sn_len(drb_sn_len_), logger(srslog::fetch_basic_logger("PDCP-RELAY", false)),
+    task_sched(64, 0), last_tic(std::chrono::steady_clock::now())
+{
+    // The entities log every PDU at info level
+    logger.set_level(srslog::basic_levels::none);
+    rx_sdus.reserve(64);
+    rx_pdus.reserve(64);
+    tx_pdus.reserve(64);
+}
+
+pdcp_relay::~pdcp_relay() = default;
+
+pdcp_entity_nr *pdcp_relay::get_entity(uint32_t lcid)
+{
+    if (not has_pdcp(lcid))
+    {
+        return nullptr;
+    }
+    if (entities[lcid] == nullptr)
+    {
+        bool is_srb = lcid < (uint32_t)nr_srb::count;
+        // DRB n is carried on LCID n + 3, after the SRBs
+        pdcp_config_t cfg(is_srb ? lcid : lcid - (uint32_t)nr_srb::srb3,
+                          is_srb ? PDCP_RB_IS_SRB : PDCP_RB_IS_DRB,
+                          direction,
+                          direction,
+                          is_srb ? PDCP_SN_LEN_12 : drb_sn_len,
+                          reordering_ms,
+                          pdcp_discard_timer_t::infinity,
+                          false,
+                          srsran_rat_t::nr);
+        std::unique_ptr<pdcp_entity_nr> entity(new pdcp_entity_nr(this, this, this, &task_sched, logger, lcid));
+        if (not entity->configure(cfg))
+        {
+            return nullptr;
+        }
+        apply_security(*entity);
+        entities[lcid] = std::move(entity);
+    }
+    return entities[lcid].get();
+}
+
+void pdcp_relay::apply_security(pdcp_entity_nr &entity)
+{
+    if (not security_configured)
+    {
+        return;
+    }
+    entity.config_security(sec_cfg);
+    // Integrity protection of DRBs depends on their RRC configuration, which is not followed
+    if (entity.is_srb())
+    {
+        entity.enable_integrity(DIRECTION_TXRX);
+    }
+    if (ciphering)
+    {
+        entity.enable_encryption(DIRECTION_TXRX);
+    }
+}
+
+bool pdcp_relay::update_security(bool cipher)
+{
+    uint32_t epoch = as_sec_ctx.get_epoch();
+    if (epoch == security_epoch)
+    {
+        return false;
+    }
+    security_epoch      = epoch;
+    sec_cfg             = as_sec_ctx.get_config();
+    security_configured = true;
+    ciphering           = false;
+    for (std::unique_ptr<pdcp_entity_nr> &entity : entities)
+    {
+        if (entity != nullptr)
+        {
+            apply_security(*entity);
+        }
+    }
+    if (cipher)
+    {
+        enable_ciphering();
+    }
+    return true;
+}
+
+void pdcp_relay::enable_ciphering()
+{
+    ciphering = true;
+    for (std::unique_ptr<pdcp_entity_nr> &entity : entities)
+    {
+        if (entity != nullptr)
+        {
+            entity->enable_encryption(DIRECTION_TXRX);
+        }
+    }
+}
+
+int pdcp_relay::terminate(uint32_t lcid, const uint8_t *pdu, uint32_t n)
+{
+    rx_sdus.clear();
+    rx_head = 0;
+    run_timers();
+
+    pdcp_entity_nr      *entity = get_entity(lcid);
+    unique_byte_buffer_t buf    = make_byte_buffer(pdu, n, "pdcp_relay::terminate");
+    if (entity == nullptr or buf == nullptr or buf->N_bytes != n)
+    {
+        metrics.dropped++;
+    }
+    else
+    {
+        metrics.terminated++;
+        // Delivered SDUs come back through write_pdu()
+        entity->write_pdu(std::move(buf));
+    }
+    metrics.delivered += rx_sdus.size();
+    return rx_sdus.size();
+}
+
+int pdcp_relay::terminate(uint32_t lcid, const iovec *pdus, uint32_t nof_pdus)
+{
+    rx_sdus.clear();
+    rx_head = 0;
+    run_timers();
+
+    pdcp_entity_nr *entity = get_entity(lcid);
+    rx_pdus.clear();
+    for (uint32_t i = 0; i < nof_pdus; i++)
+    {
+        const uint8_t       *pdu = (const uint8_t *)pdus[i].iov_base;
+        unique_byte_buffer_t buf = make_byte_buffer(pdu, pdus[i].iov_len, "pdcp_relay::terminate");
+        if (entity == nullptr or buf == nullptr or buf->N_bytes != pdus[i].iov_len)
+        {
+            metrics.dropped++;
+            continue;
+        }
+        rx_pdus.push_back(std::move(buf));
+    }
+    if (not rx_pdus.empty())
+    {
+        metrics.terminated += rx_pdus.size();
+        // Delivered SDUs come back through write_pdu()
+        entity->write_pdus(rx_pdus);
+    }
+    metrics.delivered += rx_sdus.size();
+    return rx_sdus.size();
+}
+
+void pdcp_relay::run_timers()
+{
+    auto    now = std::chrono::steady_clock::now();
+    int64_t ms  = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_tic).count();
+    // Past t-Reordering, every running timer expires anyway
+    for (int64_t i = 0; i < std::min(ms, (int64_t)reordering_ms + 1); i++)
+    {
+        task_sched.tic();
+    }
+    last_tic += std::chrono::milliseconds(ms);
+}
+
+unique_byte_buffer_t pdcp_relay::pop_sdu(uint32_t &lcid)
+{
+    if (rx_head == rx_sdus.size())
+    {
+        return nullptr;
+    }
+    lcid = rx_sdus[rx_head].first;
+    return std::move(rx_sdus[rx_head++].second);
+}
+
+unique_byte_buffer_t pdcp_relay::reoriginate(uint32_t lcid, const uint8_t *sdu, uint32_t n)
+{
+    pdcp_entity_nr      *entity = get_entity(lcid);
+    unique_byte_buffer_t buf    = make_byte_buffer(sdu, n, "pdcp_relay::reoriginate");
+    if (entity == nullptr or buf == nullptr or buf->N_bytes != n)
+    {
+        metrics.dropped++;
+        return nullptr;
+    }
+    // The PDU comes back through write_sdu()
+    tx_pdus.clear();
+    entity->write_sdu(std::move(buf));
+    if (tx_pdus.empty())
+    {
+        return nullptr;
+    }
+    metrics.reoriginated++;
+    return std::move(tx_pdus.front());
+}
+
+void pdcp_relay::reoriginate(uint32_t lcid, span<unique_byte_buffer_t> sdus, std::vector<unique_byte_buffer_t> &pdus)
+{
+    pdcp_entity_nr *entity = get_entity(lcid);
+    if (entity == nullptr)
+    {
+        metrics.dropped += sdus.size();
+        return;
+    }
+    // The PDUs come back through write_sdu()
+    tx_pdus.clear();
+    entity->write_sdus(sdus);
+    metrics.reoriginated += tx_pdus.size();
+    for (unique_byte_buffer_t &pdu : tx_pdus)
+    {
+        pdus.push_back(std::move(pdu));
+    }
+}
+
+void pdcp_relay::write_sdu(uint32_t lcid, unique_byte_buffer_t sdu)
+{
+    tx_pdus.push_back(std::move(sdu));
+}
+
+void pdcp_relay::write_pdu(uint32_t lcid, unique_byte_buffer_t pdu)
+{
+    rx_sdus.emplace_back(lcid, std::move(pdu));
+}
+
+void pdcp_relay::notify_pdcp_integrity_error(uint32_t lcid)
+{
+    metrics.integrity_failures++;
+    std::cerr << "PDCP relay: " << security_direction_text[direction] << " PDU on LCID " << lcid
+              << " failed the integrity check" << std::endl;
+}
+
+const char *pdcp_relay::get_rb_name(uint32_t lcid)
+{
+    return lcid < (uint32_t)nr_srb::count ? "SRB" : "DRB";
+}
+
+std::string pdcp_relay::metrics_to_string() const
+{
+    return fmt::format("PDCP relay {}: terminated={} delivered={} reoriginated={} integrity failures={} dropped={}",
+                       security_direction_text[direction], metrics.terminated, metrics.delivered,
+                       metrics.reoriginated, metrics.integrity_failures, metrics.dropped);
+}
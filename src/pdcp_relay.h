@@ -0,0 +1,155 @@
+#ifndef __PDCP_RELAY__
+#define __PDCP_RELAY__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include "mitm_lib/common/common_nr.h"
+#include "mitm_lib/common/task_scheduler.h"
+#include "mitm_lib/upper/pdcp_entity_nr.h"
+
+// AS security of the relayed UE.
+//
+// The RRC Security Mode Command selects the algorithms and K_gNB comes from the NAS security context, from which the
+// RRC and UP keys are derived (TS 33.501 A.8). The PDCP relays pick up a new configuration whenever the epoch changes.
+class as_security_ctx
+{
+public:
+    // Called with the algorithms of every decoded RRC Security Mode Command
+    void observe_security_mode_command(srsran::CIPHERING_ALGORITHM_ID_ENUM cipher_algo,
+                                       srsran::INTEGRITY_ALGORITHM_ID_ENUM integ_algo);
+
+    // Installs a configuration whose keys were derived elsewhere
+    void set_config(const srsran::as_security_config_t &cfg);
+
+    bool     is_active() const { return epoch > 0; }
+    uint32_t get_epoch() const { return epoch; }
+    // Copy of the current configuration, which may be read from the DRB lanes while a worker updates it
+    srsran::as_security_config_t get_config() const;
+
+private:
+    mutable std::mutex           mutex;
+    srsran::as_security_config_t config = {};
+    std::atomic<uint32_t>        epoch{0};
+};
+
+// The relay carries a single UE
+extern as_security_ctx as_sec_ctx;
+
+// PDCP termination and re-origination for the bearers of one direction of the relay.
+//
+// Every LCID gets a pdcp_entity_nr that receives the PDUs of the real peer, i.e. deciphers them, verifies their MAC-I and
+// delivers their SDUs in COUNT order, and transmits the SDUs relayed, spoofed or injected by the controller with its own
+// TX_NEXT. The COUNTs the destination sees are therefore consecutive whatever the scenario handler drops, duplicates or
+// injects, and spoofed PDUs carry a valid MAC-I once AS security is active.
+//
+// A relay is used by one thread only: the controller keeps one for the SRBs, handled by the worker, and one for the DRBs,
+// handled by the DRB lane. There is no task loop: the only timer, t-Reordering, advances with the wall clock whenever a
+// PDU is terminated, so that a PDU lost before the relay holds its successors back for reordering_ms at most. SDUs and
+// PDUs live in pooled byte buffers.
+class pdcp_relay : public srsue::rlc_interface_pdcp, public srsue::rrc_interface_pdcp, public srsue::gw_interface_pdcp
+{
+public:
+    struct metrics_t
+    {
+        uint64_t terminated         = 0; // PDUs received from the source
+        uint64_t delivered          = 0; // SDUs delivered in order
+        uint64_t reoriginated       = 0; // PDUs built for the destination
+        uint64_t integrity_failures = 0; // PDUs dropped because of their MAC-I
+        uint64_t dropped            = 0; // PDUs or SDUs without a bearer or a buffer
+    };
+
+    // direction is the one of the PDUs relayed, drb_sn_len_ the PDCP SN length of the DRBs (12 or 18 bits)
+    pdcp_relay(srsran::security_direction_t direction_, uint8_t drb_sn_len_);
+    ~pdcp_relay();
+
+    // Direction of the PDUs relayed from the fake UE socket, which carries what the real gNB sends, or from the fake gNB
+    // socket, which carries what the real UE sends
+    static srsran::security_direction_t relayed_direction(bool from_fake_ue)
+    {
+        return from_fake_ue ? srsran::SECURITY_DIRECTION_DOWNLINK : srsran::SECURITY_DIRECTION_UPLINK;
+    }
+
+    // SRB0 (CCCH) has no PDCP
+    static bool has_pdcp(uint32_t lcid) { return lcid > (uint32_t)srsran::nr_srb::srb0 and srsran::is_nr_lcid(lcid); }
+
+    static const srsran::pdcp_t_reordering_t reordering_ms = srsran::pdcp_t_reordering_t::ms50;
+
+    // Strips the PDCP layer of a PDU received on lcid. Returns the number of SDUs ready for pop_sdu(), which besides
+    // those of the PDU may include SDUs of any LCID released by t-Reordering, 0 when the PDU was dropped or is held back
+    // until the PDUs before it arrive
+    int terminate(uint32_t lcid, const uint8_t *pdu, uint32_t n);
+    // Same for a run of PDUs received on lcid, whose deciphering and integrity checks are done for the whole run
+    int terminate(uint32_t lcid, const iovec *pdus, uint32_t nof_pdus);
+    // Next SDU delivered by terminate() and its LCID, nullptr once they have all been taken
+    srsran::unique_byte_buffer_t pop_sdu(uint32_t &lcid);
+
+    // Builds the PDU carrying an SDU on lcid with the next COUNT of the relay. Returns nullptr if it can't be built
+    srsran::unique_byte_buffer_t reoriginate(uint32_t lcid, const uint8_t *sdu, uint32_t n);
+    // Same for a run of SDUs on lcid, protected as a whole run. The SDU buffers are turned into the PDUs, which are
+    // appended to pdus in COUNT order
+    void reoriginate(uint32_t                                   lcid,
+                     srsran::span<srsran::unique_byte_buffer_t> sdus,
+                     std::vector<srsran::unique_byte_buffer_t> &pdus);
+
+    // Takes over the configuration of as_sec_ctx if it changed since the last call, for the existing bearers and those
+    // created later. SRBs are integrity protected from then on. Without cipher, ciphering only starts with
+    // enable_ciphering(), so that the RRC Security Mode Command can be re-originated integrity protected and not ciphered.
+    // Returns true if the configuration changed
+    bool update_security(bool cipher = true);
+    void enable_ciphering();
+
+    metrics_t   get_metrics() const { return metrics; }
+    std::string metrics_to_string() const;
+
+    // rlc_interface_pdcp
+    void write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu) override;
+    void discard_sdu(uint32_t lcid, uint32_t discard_sn) override {}
+    bool rb_is_um(uint32_t lcid) override { return false; }
+    bool sdu_queue_is_full(uint32_t lcid) override { return false; }
+    bool is_suspended(const uint32_t lcid) override { return false; }
+
+    // rrc_interface_pdcp and gw_interface_pdcp
+    void        write_pdu(uint32_t lcid, srsran::unique_byte_buffer_t pdu) override;
+    void        write_pdu_bcch_bch(srsran::unique_byte_buffer_t pdu) override {}
+    void        write_pdu_bcch_dlsch(srsran::unique_byte_buffer_t pdu) override {}
+    void        write_pdu_pcch(srsran::unique_byte_buffer_t pdu) override {}
+    void        write_pdu_mch(uint32_t lcid, srsran::unique_byte_buffer_t pdu) override {}
+    void        notify_pdcp_integrity_error(uint32_t lcid) override;
+    const char *get_rb_name(uint32_t lcid) override;
+
+private:
+    srsran::pdcp_entity_nr *get_entity(uint32_t lcid);
+    void                    apply_security(srsran::pdcp_entity_nr &entity);
+    void                    run_timers();
+
+    const srsran::security_direction_t direction;
+    const uint8_t                      drb_sn_len;
+    srslog::basic_logger              &logger;
+    srsran::task_scheduler             task_sched;
+    std::chrono::steady_clock::time_point last_tic;
+
+    std::unique_ptr<srsran::pdcp_entity_nr> entities[srsran::MAX_NR_NOF_BEARERS];
+
+    bool                         security_configured = false;
+    bool                         ciphering           = false;
+    uint32_t                     security_epoch      = 0;
+    srsran::as_security_config_t sec_cfg             = {};
+
+    // SDUs delivered by the last terminate() and the PDUs built by the last reoriginate()
+    std::vector<std::pair<uint32_t, srsran::unique_byte_buffer_t> > rx_sdus;
+    size_t                                                          rx_head = 0;
+    std::vector<srsran::unique_byte_buffer_t>                       rx_pdus;
+    std::vector<srsran::unique_byte_buffer_t>                       tx_pdus;
+
+    metrics_t metrics;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef __PEER_ADDR__
+#define __PEER_ADDR__
+
+#include <atomic>
+#include <cstdint>
+
+#include <netinet/in.h>
+
+// IPv4 address and port of a relay peer.
+//
+// The relay thread that receives from the peer learns them while other threads send to it, so both are kept in one
+// atomic 64-bit word: a reader never sees the address of one datagram with the port of another. A port of 0 means the
+// peer is not known yet.
+class peer_addr
+{
+public:
+    peer_addr() = default;
+    explicit peer_addr(const sockaddr_in &addr) { store(addr); }
+
+    void store(const sockaddr_in &addr)
+    {
+        uint64_t w = (uint64_t)addr.sin_addr.s_addr << 32 | addr.sin_port;
+        // Learned on every batch, but rarely changes: don't take the cache line from the readers for nothing
+        if (word.load(std::memory_order_relaxed) != w)
+        {
+            word.store(w, std::memory_order_relaxed);
+        }
+    }
+
+    sockaddr_in load() const
+    {
+        uint64_t    w    = word.load(std::memory_order_relaxed);
+        sockaddr_in addr = {};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = (uint32_t)(w >> 32);
+        addr.sin_port        = (uint16_t)w;
+        return addr;
+    }
+
+private:
+    std::atomic<uint64_t> word{0};
+};
+
+#endif
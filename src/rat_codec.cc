@@ -0,0 +1,40 @@
+#include "rat_codec.h"
+#include "drb_lane.h"
+#include "gnb_packet_handler.h"
+#include "json_packet_maker.h"
+#include "lte_packet_handler.h"
+#include "ue_packet_handler.h"
+
+#include "mitm_lib/common/common_lte.h"
+
+const rat_codec nr_codec = {"nr",
+                            UE::decode_packet,
+                            UE::decode_sdu,
+                            jsonPacketMaker::json_to_packet,
+                            gNB::decode_packet,
+                            gNB::decode_sdu,
+                            jsonPacketMaker::json_to_packet,
+                            drb_lane::nr_first_drb_lcid,
+                            true};
+
+const rat_codec lte_codec = {"lte",
+                             LTE::UE::decode_packet,
+                             LTE::UE::decode_sdu,
+                             LTE::UE::json_to_packet,
+                             LTE::eNB::decode_packet,
+                             LTE::eNB::decode_sdu,
+                             LTE::eNB::json_to_packet,
+                             (uint32_t)srsran::lte_srb::count,
+                             false};
+
+const rat_codec *find_rat_codec(const std::string &name)
+{
+    for (const rat_codec *codec : {&nr_codec, &lte_codec})
+    {
+        if (name == codec->name)
+        {
+            return codec;
+        }
+    }
+    return NULL;
+}
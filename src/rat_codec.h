@@ -0,0 +1,38 @@
+#ifndef __RAT_CODEC__
+#define __RAT_CODEC__
+
+#include <cstdint>
+#include <string>
+
+#include "mitm_lib/asn1/asn1_utils.h"
+
+// Decode and encode front end of a radio access technology. The controller looks its table up once per session, by
+// the name given on the command line, and the relay reaches the RRC and NAS codecs through it only.
+struct rat_codec
+{
+    typedef int (*decode_fn)(uint8_t *buf, int n, asn1::json_writer &json_buffer);
+    typedef int (*decode_sdu_fn)(uint32_t channel, uint8_t *sdu, int n, asn1::json_writer &json_buffer);
+    typedef uint8_t *(*spoof_fn)(std::string json, uint8_t *original_msg, int size, int &packet_size);
+
+    const char *name;
+    // Messages from the UE, relayed by the fake gNB or eNB
+    decode_fn     decode_ul;
+    decode_sdu_fn decode_ul_sdu;
+    spoof_fn      spoof_ul;
+    // Messages from the gNB or eNB, relayed by the fake UE
+    decode_fn     decode_dl;
+    decode_sdu_fn decode_dl_sdu;
+    spoof_fn      spoof_dl;
+    // LCIDs from this one on are DRBs
+    uint32_t first_drb_lcid;
+    // The PDCP relay and the MAC tap are NR only
+    bool nr;
+};
+
+extern const rat_codec nr_codec;
+extern const rat_codec lte_codec;
+
+// "nr" or "lte", NULL for anything else
+const rat_codec *find_rat_codec(const std::string &name);
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * Benchmark of the srslog binary ring sink.
+ *
+ * The check pass logs entries with arguments of every type through the binary ring sink and through a text sink, then
+ * decodes the binary file and verifies that it renders as the text sink did, timestamps aside. The wrap pass logs more
+ * entries than a small ring holds and verifies that the most recent ones are kept, in order. The timed pass measures
+ * the backend cost of an entry, which is formatting it and writing it into the sink, for both sinks.
+ */
+
+#include "mitm_lib/config.h"
+#include "mitm_lib/srslog/detail/log_entry_metadata.h"
+#include "mitm_lib/srslog/srslog.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <string>
+
+static uint32_t    nof_entries = 100000;
+static std::string path_prefix = "binary_log_benchmark";
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nfh]\n", prog);
+  printf("\t-n Entries of the timed pass [Default %d]\n", nof_entries);
+  printf("\t-f Prefix of the binary log files [Default %s]\n", path_prefix.c_str());
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nfh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_entries = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'f':
+        path_prefix = argv[optind];
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+/// Keeps what is written into it.
+class string_sink : public srslog::sink
+{
+public:
+  string_sink() : sink(srslog::create_text_formatter()) {}
+
+  srslog::detail::error_string write(srslog::detail::memory_buffer buffer) override
+  {
+    contents.append(buffer.data(), buffer.size());
+    return {};
+  }
+
+  srslog::detail::error_string flush() override { return {}; }
+
+  std::string contents;
+};
+
+/// Decodes a binary log file into text.
+static bool decode(const std::string& path, std::string& text)
+{
+  auto        formatter = srslog::create_text_formatter();
+  std::FILE*  out       = std::tmpfile();
+  std::string error;
+  if (!srslog::decode_binary_ring_file(path, *formatter, out, error)) {
+    fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+    std::fclose(out);
+    return false;
+  }
+  std::rewind(out);
+  char   chunk[4096];
+  size_t n;
+  text.clear();
+  while ((n = std::fread(chunk, 1, sizeof(chunk), out)) != 0) {
+    text.append(chunk, n);
+  }
+  std::fclose(out);
+  return true;
+}
+
+/// Removes the timestamps at the start of the log entry lines.
+static std::string strip_timestamps(const std::string& text)
+{
+  const size_t timestamp_len = sizeof("2022-01-01T00:00:00.000000 ") - 1;
+
+  std::string result;
+  for (size_t pos = 0; pos < text.size();) {
+    size_t end = text.find('\n', pos);
+    end        = end == std::string::npos ? text.size() : end + 1;
+    if (end - pos > timestamp_len && text[pos + 10] == 'T') {
+      pos += timestamp_len;
+    }
+    result.append(text, pos, end - pos);
+    pos = end;
+  }
+  return result;
+}
+
+/// Logs the same entries into both channels.
+template <typename... Args>
+static void log_both(srslog::log_channel& a, srslog::log_channel& b, const char* fmtstr, Args&&... args)
+{
+  a(fmtstr, args...);
+  b(fmtstr, args...);
+}
+
+static bool check_roundtrip()
+{
+  std::string          path     = path_prefix + "_check.bin";
+  srslog::sink&        bin_sink = srslog::fetch_binary_ring_sink(path);
+  string_sink          text_sink;
+  srslog::log_channel& bin  = srslog::fetch_log_channel("BIN", bin_sink, {"RLC", 'I', true});
+  srslog::log_channel& text = srslog::fetch_log_channel("TXT", text_sink, {"RLC", 'I', true});
+
+  const char*   cstr  = "a C string";
+  std::string   str   = "a std::string";
+  const uint8_t pdu[] = {0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+                         0x0f, 0x10, 0x11, 0x12, 0x13, 0xff};
+
+  for (uint32_t i = 0; i < 3; i++) {
+    bin.set_context(1000 + i);
+    text.set_context(1000 + i);
+    log_both(bin, text, "Plain message without arguments");
+    log_both(bin, text, "int %d, negative %d, unsigned %u, hex 0x%x", (int)i, -42, 4000000000u, 0xbeefu);
+    log_both(bin, text, "long long %lld, uint64 %llu", -(1LL << 40), (unsigned long long)UINT64_MAX);
+    log_both(bin, text, "char '%c', float %.2f, double %.6f, exp %e", 'x', 1.5f, 3.141592653589793, 6.02e23);
+    log_both(bin, text, "bool %d, strings \"%s\" and \"%s\"", true, cstr, str);
+    log_both(bin, text, "Padded %-8s| %08.3f | %5d", "left", 2.5, 7);
+    bin(pdu, sizeof(pdu), "PDU of %d bytes, sn=%u", (int)sizeof(pdu), i);
+    text(pdu, sizeof(pdu), "PDU of %d bytes, sn=%u", (int)sizeof(pdu), i);
+  }
+  srslog::flush();
+
+  std::string decoded;
+  if (!decode(path, decoded)) {
+    return false;
+  }
+  std::string expected = strip_timestamps(text_sink.contents);
+  if (strip_timestamps(decoded) != expected) {
+    fprintf(stderr, "Decoded binary log differs from the text log\n--- decoded\n%s--- text\n%s",
+            decoded.c_str(),
+            text_sink.contents.c_str());
+    return false;
+  }
+  printf("Check pass: %ld bytes of text decoded from the binary log\n", decoded.size());
+  return true;
+}
+
+static bool check_wrap()
+{
+  const uint32_t n    = 2000;
+  std::string    path = path_prefix + "_wrap.bin";
+
+  srslog::log_channel& channel = srslog::fetch_log_channel("WRAP", srslog::fetch_binary_ring_sink(path, 4096), {});
+  for (uint32_t i = 0; i < n; i++) {
+    channel("entry %u of the wrap pass", i);
+  }
+  srslog::flush();
+
+  std::string decoded;
+  if (!decode(path, decoded)) {
+    return false;
+  }
+  // The most recent entries are kept, without gaps.
+  uint32_t nof_kept = 0, next = 0;
+  for (size_t pos = decoded.find("entry "); pos != std::string::npos; pos = decoded.find("entry ", pos + 1)) {
+    uint32_t seq = strtoul(decoded.c_str() + pos + 6, NULL, 10);
+    if (nof_kept != 0 && seq != next) {
+      fprintf(stderr, "Wrap pass: entry %d after entry %d\n", seq, next - 1);
+      return false;
+    }
+    next = seq + 1;
+    nof_kept++;
+  }
+  if (nof_kept == 0 || nof_kept == n || next != n) {
+    fprintf(stderr, "Wrap pass: %d of %d entries kept, last one %d\n", nof_kept, n, next - 1);
+    return false;
+  }
+  printf("Wrap pass: last %d of %d entries kept\n", nof_kept, n);
+  return true;
+}
+
+/// Backend cost of an entry in the given sink, in ns.
+static double time_backend(srslog::sink& s)
+{
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  fmt::memory_buffer                                 buffer;
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_entries; i++) {
+    store.clear();
+    store.push_back(i);
+    store.push_back(i * 3);
+    store.push_back(1.0 / (i + 1));
+    store.push_back("RLC_AM");
+
+    srslog::detail::log_entry_metadata md = {std::chrono::high_resolution_clock::now(),
+                                             {i, true},
+                                             "Tx PDU sn=%u, so=%u, ratio=%.3f, bearer=%s",
+                                             &store,
+                                             "RLC",
+                                             'I',
+                                             {}};
+    buffer.clear();
+    s.get_formatter().format(std::move(md), buffer);
+    s.write({buffer.data(), buffer.size()});
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / nof_entries;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::set_error_handler([](const std::string& error) { fprintf(stderr, "%s\n", error.c_str()); });
+  srslog::init();
+
+  if (not check_roundtrip() or not check_wrap()) {
+    return SRSRAN_ERROR;
+  }
+
+  string_sink   text_sink;
+  srslog::sink& bin_sink = srslog::fetch_binary_ring_sink(path_prefix + "_timed.bin", 16 * 1024 * 1024);
+  double        text_ns  = time_backend(text_sink);
+  double        bin_ns   = time_backend(bin_sink);
+
+  printf("srslog backend cost of an entry, %d entries\n", nof_entries);
+  printf("\ttext formatter: %.1f ns\n", text_ns);
+  printf("\tbinary sink:    %.1f ns\n", bin_ns);
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/**
+ * Benchmark of the byte buffer pool in a relay pipeline.
+ *
+ * A receive thread allocates byte buffers and passes them through a decode thread to a forward thread, which frees
+ * them, so that every buffer is freed on another thread than the one that allocated it. The pipeline checks that the
+ * buffers arrive in order and that every free went back to the allocating thread. Once the threads have finished, a
+ * single thread must be able to allocate every block of the pool again. The pool metrics show how often the central
+ * cache lock was taken.
+ */
+
+#include "mitm_lib/common/buffer_pool.h"
+#include "mitm_lib/config.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <thread>
+#include <vector>
+
+static uint32_t nof_buffers = 1000000;
+static uint32_t batch_size  = 16;
+static uint32_t nof_stages  = 3;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nbsh]\n", prog);
+  printf("\t-n Buffers through the pipeline [Default %d]\n", nof_buffers);
+  printf("\t-b Batch size of the thread caches [Default %d]\n", batch_size);
+  printf("\t-s Pipeline threads, 2 or 3 [Default %d]\n", nof_stages);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nbsh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_buffers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'b':
+        batch_size = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        nof_stages = (uint32_t)strtol(argv[optind], NULL, 10) == 2 ? 2 : 3;
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+using buffer_queue = srsran::static_blocking_queue<srsran::unique_byte_buffer_t, 256>;
+
+// Returns false if a buffer could not be allocated or arrived out of order
+static bool run_pipeline()
+{
+  buffer_queue     to_decode, to_forward;
+  std::atomic<int> nof_errors{0};
+
+  std::thread receive([&]() {
+    for (uint32_t i = 0; i < nof_buffers; i++) {
+      srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+      if (pdu == nullptr) {
+        nof_errors++;
+        break;
+      }
+      memcpy(pdu->msg, &i, sizeof(i));
+      pdu->N_bytes = sizeof(i);
+      (nof_stages == 3 ? to_decode : to_forward).push_blocking(std::move(pdu));
+    }
+    (nof_stages == 3 ? to_decode : to_forward).push_blocking(srsran::unique_byte_buffer_t());
+  });
+
+  std::thread decode([&]() {
+    if (nof_stages != 3) {
+      return;
+    }
+    bool last = false;
+    while (not last) {
+      srsran::unique_byte_buffer_t pdu = to_decode.pop_blocking();
+      last                             = pdu == nullptr;
+      if (not last) {
+        pdu->msg[sizeof(uint32_t)] = 0xaa;
+        pdu->N_bytes++;
+      }
+      to_forward.push_blocking(std::move(pdu));
+    }
+  });
+
+  std::thread forward([&]() {
+    uint32_t next = 0;
+    while (true) {
+      srsran::unique_byte_buffer_t pdu = to_forward.pop_blocking();
+      if (pdu == nullptr) {
+        break;
+      }
+      uint32_t seq;
+      memcpy(&seq, pdu->msg, sizeof(seq));
+      if (seq != next++) {
+        nof_errors++;
+      }
+    }
+    if (next != nof_buffers) {
+      nof_errors++;
+    }
+  });
+
+  receive.join();
+  decode.join();
+  forward.join();
+  return nof_errors == 0;
+}
+
+// Allocates every block of the pool from this thread
+static bool check_reclaim()
+{
+  srsran::byte_buffer_pool* pool = srsran::byte_buffer_pool::get_instance();
+  std::vector<void*>        blocks;
+  for (size_t i = 0; i < pool->size(); i++) {
+    void* block = pool->allocate_node(sizeof(srsran::byte_buffer_t));
+    if (block == nullptr) {
+      break;
+    }
+    blocks.push_back(block);
+  }
+  for (void* block : blocks) {
+    pool->deallocate_node(block);
+  }
+  if (blocks.size() != pool->size()) {
+    fprintf(stderr, "Only %ld of %ld blocks allocated after the pipeline finished\n", blocks.size(), pool->size());
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srsran::byte_buffer_pool* pool = srsran::byte_buffer_pool::get_instance();
+  pool->set_cache_batch_size(batch_size);
+  srsran::byte_buffer_pool::metrics_t before = pool->get_metrics();
+
+  auto start = std::chrono::steady_clock::now();
+  if (not run_pipeline()) {
+    fprintf(stderr, "Buffers lost or reordered in the pipeline\n");
+    return SRSRAN_ERROR;
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+  srsran::byte_buffer_pool::metrics_t after = pool->get_metrics();
+
+  uint64_t remote_frees = after.remote_frees - before.remote_frees;
+  uint64_t lock_hits    = after.central_lock_hits - before.central_lock_hits;
+  if (remote_frees != nof_buffers or after.failed_allocs != 0) {
+    fprintf(stderr, "%ld of %d buffers returned to their allocator, %ld failed allocations\n",
+            remote_frees,
+            nof_buffers,
+            after.failed_allocs);
+    return SRSRAN_ERROR;
+  }
+  if (not check_reclaim()) {
+    return SRSRAN_ERROR;
+  }
+
+  printf("Byte buffer pool, %d buffers through %d threads, batch size %d\n", nof_buffers, nof_stages, batch_size);
+  printf("\tper buffer:   %.1f ns\n", elapsed.count() / nof_buffers);
+  printf("\tcentral lock: %ld hits, %.3f per 1000 buffers\n", lock_hits, 1000.0 * lock_hits / nof_buffers);
+  printf("\t%s\n", pool->metrics_to_string().c_str());
+  return SRSRAN_SUCCESS;
+}
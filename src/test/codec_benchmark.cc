@@ -0,0 +1,485 @@
+/**
+ * Codec benchmark for the relay decode path.
+ *
+ * Runs the same UE::decode_packet/gNB::decode_packet + to_json work that the controller does for every relayed
+ * datagram. The built-in corpus covers the RRC NR and 5G NAS messages seen during registration. A corpus captured from
+ * a real run can be passed with -f, where each record is a direction octet (0: from the UE, 1: from the gNB), a 16 bit
+ * big-endian length and the datagram as received by the controller.
+ *
+ * With -c the datagrams go through the controller's decode cache instead, after checking that every cached rendering
+ * matches a fresh decode.
+ *
+ * With -x the RRC containers of the given types are decoded inline, after checking that a field path through the
+ * nested cell groups of the built-in RRCReconfiguration updates them.
+ *
+ * This is also the training workload of the ENABLE_PGO=GENERATE build (see the pgo_train target).
+ */
+
+#include "src/decode_cache.h"
+#include "src/json_packet_maker.h"
+#include "src/rat_codec.h"
+
+#include "mitm_lib/asn1/nas_5g_msg.h"
+#include "mitm_lib/asn1/rrc_nr.h"
+#include "mitm_lib/asn1/rrc_nr_containers.h"
+#include "mitm_lib/common/common_nr.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <getopt.h>
+#include <memory>
+#include <vector>
+
+enum class corpus_dir_t { from_ue = 0, from_gnb = 1 };
+
+struct corpus_pdu_t {
+  corpus_dir_t         dir;
+  std::vector<uint8_t> datagram;
+};
+
+static uint32_t    nof_repetitions = 10000;
+static std::string corpus_file;
+static uint32_t    cache_size = 0;
+static std::string container_types;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nfcx]\n", prog);
+  printf("\t-n Number of passes over the corpus [Default %d]\n", nof_repetitions);
+  printf("\t-f Corpus file with captured datagrams [Default built-in corpus]\n");
+  printf("\t-c Decode through a PDU cache with this many entries [Default %d, no cache]\n", cache_size);
+  printf("\t-x Decode the RRC containers of these types inline, or all [Default none]\n");
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nfcxh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'f':
+        corpus_file = argv[optind];
+        break;
+      case 'c':
+        cache_size = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'x':
+        container_types = argv[optind];
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static void fill_pattern(asn1::dyn_octstring& octs, uint32_t len, uint8_t seed)
+{
+  octs.resize(len);
+  for (uint32_t i = 0; i < len; ++i) {
+    octs[i] = (uint8_t)(seed + i * 7);
+  }
+}
+
+template <class RrcMsg>
+static void push_rrc(std::vector<corpus_pdu_t>& corpus, corpus_dir_t dir, srsran::nr_srb srb, RrcMsg& msg)
+{
+  corpus_pdu_t pdu;
+  pdu.dir = dir;
+  pdu.datagram.resize(sizeof(uint32_t) + 4096);
+
+  uint32_t lcid = srsran::srb_to_lcid(srb);
+  memcpy(pdu.datagram.data(), &lcid, sizeof(lcid));
+  asn1::bit_ref bref(pdu.datagram.data() + sizeof(lcid), pdu.datagram.size() - sizeof(lcid));
+  msg.pack(bref);
+  bref.align_bytes_zero();
+  pdu.datagram.resize(sizeof(lcid) + bref.distance_bytes());
+
+  corpus.push_back(std::move(pdu));
+}
+
+template <class Container>
+static void pack_container(const Container& value, asn1::dyn_octstring& octs)
+{
+  octs.resize(4096);
+  asn1::bit_ref bref(octs.data(), octs.size());
+  value.pack(bref);
+  bref.align_bytes_zero();
+  octs.resize(bref.distance_bytes());
+}
+
+// Cell group with SRB1 and DRB1
+static void pack_cell_group(uint8_t cell_group_id, asn1::dyn_octstring& octs)
+{
+  using namespace asn1::rrc_nr;
+
+  cell_group_cfg_s cell_group;
+  cell_group.cell_group_id = cell_group_id;
+  cell_group.rlc_bearer_to_add_mod_list.resize(2);
+  for (uint32_t i = 0; i < 2; ++i) {
+    rlc_bearer_cfg_s& bearer           = cell_group.rlc_bearer_to_add_mod_list[i];
+    bearer.lc_ch_id                    = i == 0 ? 1 : 4;
+    bearer.served_radio_bearer_present = true;
+    if (i == 0) {
+      bearer.served_radio_bearer.set_srb_id() = 1;
+    } else {
+      bearer.served_radio_bearer.set_drb_id() = 1;
+    }
+  }
+  cell_group.mac_cell_group_cfg_present  = true;
+  cell_group.phys_cell_group_cfg_present = true;
+  cell_group.phys_cell_group_cfg.pdsch_harq_ack_codebook.value =
+      phys_cell_group_cfg_s::pdsch_harq_ack_codebook_opts::dynamic_value;
+  pack_container(cell_group, octs);
+}
+
+static void pack_nas(srsran::nas_5g::nas_5gs_msg& nas, asn1::dyn_octstring& octs)
+{
+  srsran::unique_byte_buffer_t buf = srsran::make_byte_buffer();
+  nas.pack(buf);
+  octs.resize(buf->N_bytes);
+  memcpy(octs.data(), buf->msg, buf->N_bytes);
+}
+
+static void pack_ciphered_nas(asn1::dyn_octstring& octs, uint32_t len)
+{
+  fill_pattern(octs, len, 0x5a);
+  octs[0] = 0x7e; // 5GMM
+  octs[1] = 0x02; // integrity protected and ciphered
+}
+
+static std::vector<corpus_pdu_t> make_builtin_corpus()
+{
+  using namespace asn1::rrc_nr;
+  using namespace srsran::nas_5g;
+
+  std::vector<corpus_pdu_t> corpus;
+
+  // RRCSetupRequest
+  {
+    ul_ccch_msg_s               msg;
+    rrc_setup_request_ies_s&    req = msg.msg.set_c1().set_rrc_setup_request().rrc_setup_request;
+    req.ue_id.set_random_value().from_number(0x1234567);
+    req.establishment_cause.value = establishment_cause_opts::mo_sig;
+    push_rrc(corpus, corpus_dir_t::from_ue, srsran::nr_srb::srb0, msg);
+  }
+
+  // RRCSetup
+  {
+    dl_ccch_msg_s    msg;
+    rrc_setup_s&     setup = msg.msg.set_c1().set_rrc_setup();
+    rrc_setup_ies_s& ies   = setup.crit_exts.set_rrc_setup();
+    setup.rrc_transaction_id = 0;
+    ies.radio_bearer_cfg.srb_to_add_mod_list.resize(1);
+    ies.radio_bearer_cfg.srb_to_add_mod_list[0].srb_id = 1;
+    fill_pattern(ies.master_cell_group, 300, 0x10);
+    push_rrc(corpus, corpus_dir_t::from_gnb, srsran::nr_srb::srb0, msg);
+  }
+
+  // RRCSetupComplete + Registration Request
+  {
+    ul_dcch_msg_s             msg;
+    rrc_setup_complete_s&     complete = msg.msg.set_c1().set_rrc_setup_complete();
+    rrc_setup_complete_ies_s& ies      = complete.crit_exts.set_rrc_setup_complete();
+    complete.rrc_transaction_id        = 0;
+    ies.sel_plmn_id                    = 1;
+
+    nas_5gs_msg             nas;
+    registration_request_t& reg_req = nas.set_registration_request();
+    reg_req.registration_type_5gs.follow_on_request_bit =
+        registration_type_5gs_t::follow_on_request_bit_type_::options::follow_on_request_pending;
+    reg_req.registration_type_5gs.registration_type =
+        registration_type_5gs_t::registration_type_type_::options::initial_registration;
+    mobile_identity_5gs_t::suci_s& suci = reg_req.mobile_identity_5gs.set_suci();
+    suci.supi_format                    = mobile_identity_5gs_t::suci_s::supi_format_type_::options::imsi;
+    suci.mcc                            = {0, 0, 1};
+    suci.mnc                            = {0, 1, 0xf};
+    suci.routing_indicator              = {0, 0xf, 0xf, 0xf};
+    suci.protection_scheme_id = mobile_identity_5gs_t::suci_s::protection_scheme_id_type_::options::null_scheme;
+    suci.scheme_output        = {0x21, 0x43, 0x65, 0x87, 0x09};
+    reg_req.ue_security_capability_present                = true;
+    reg_req.ue_security_capability.ea0_5g_supported       = true;
+    reg_req.ue_security_capability.ea2_128_5g_supported   = true;
+    reg_req.ue_security_capability.ia2_128_5g_supported   = true;
+    pack_nas(nas, ies.ded_nas_msg);
+    push_rrc(corpus, corpus_dir_t::from_ue, srsran::nr_srb::srb1, msg);
+  }
+
+  // DLInformationTransfer + Authentication Request
+  {
+    dl_dcch_msg_s             msg;
+    dl_info_transfer_s&       transfer = msg.msg.set_c1().set_dl_info_transfer();
+    dl_info_transfer_ies_s&   ies      = transfer.crit_exts.set_dl_info_transfer();
+    transfer.rrc_transaction_id        = 0;
+
+    nas_5gs_msg               nas;
+    authentication_request_t& auth_req = nas.set_authentication_request();
+    auth_req.abba.abba_contents        = {0x00, 0x00};
+    auth_req.authentication_parameter_rand_present = true;
+    auth_req.authentication_parameter_rand.rand.fill(0x3c);
+    auth_req.authentication_parameter_autn_present = true;
+    auth_req.authentication_parameter_autn.autn.assign(16, 0xc3);
+    pack_nas(nas, ies.ded_nas_msg);
+    push_rrc(corpus, corpus_dir_t::from_gnb, srsran::nr_srb::srb1, msg);
+  }
+
+  // ULInformationTransfer + Authentication Response
+  {
+    ul_dcch_msg_s           msg;
+    ul_info_transfer_ies_s& ies = msg.msg.set_c1().set_ul_info_transfer().crit_exts.set_ul_info_transfer();
+
+    nas_5gs_msg                nas;
+    authentication_response_t& auth_resp             = nas.set_authentication_response();
+    auth_resp.authentication_response_parameter_present = true;
+    auth_resp.authentication_response_parameter.res.assign(16, 0xa5);
+    pack_nas(nas, ies.ded_nas_msg);
+    push_rrc(corpus, corpus_dir_t::from_ue, srsran::nr_srb::srb1, msg);
+  }
+
+  // SecurityModeCommand
+  {
+    dl_dcch_msg_s            msg;
+    security_mode_cmd_s&     smc = msg.msg.set_c1().set_security_mode_cmd();
+    security_mode_cmd_ies_s& ies = smc.crit_exts.set_security_mode_cmd();
+    smc.rrc_transaction_id       = 1;
+    ies.security_cfg_smc.security_algorithm_cfg.ciphering_algorithm.value = ciphering_algorithm_opts::nea2;
+    ies.security_cfg_smc.security_algorithm_cfg.integrity_prot_algorithm_present = true;
+    ies.security_cfg_smc.security_algorithm_cfg.integrity_prot_algorithm.value  = integrity_prot_algorithm_opts::nia2;
+    push_rrc(corpus, corpus_dir_t::from_gnb, srsran::nr_srb::srb1, msg);
+  }
+
+  // SecurityModeComplete
+  {
+    ul_dcch_msg_s msg;
+    msg.msg.set_c1().set_security_mode_complete().rrc_transaction_id = 1;
+    msg.msg.c1().security_mode_complete().crit_exts.set_security_mode_complete();
+    push_rrc(corpus, corpus_dir_t::from_ue, srsran::nr_srb::srb1, msg);
+  }
+
+  // UECapabilityEnquiry
+  {
+    dl_dcch_msg_s          msg;
+    ue_cap_enquiry_s&      enquiry = msg.msg.set_c1().set_ue_cap_enquiry();
+    ue_cap_enquiry_ies_s&  ies     = enquiry.crit_exts.set_ue_cap_enquiry();
+    enquiry.rrc_transaction_id     = 2;
+    ue_cap_rat_request_s   request;
+    request.rat_type.value = rat_type_opts::nr;
+    ies.ue_cap_rat_request_list.push_back(request);
+    push_rrc(corpus, corpus_dir_t::from_gnb, srsran::nr_srb::srb1, msg);
+  }
+
+  // UECapabilityInformation
+  {
+    ul_dcch_msg_s      msg;
+    ue_cap_info_s&     info = msg.msg.set_c1().set_ue_cap_info();
+    ue_cap_info_ies_s& ies  = info.crit_exts.set_ue_cap_info();
+    info.rrc_transaction_id = 2;
+    ies.ue_cap_rat_container_list_present = true;
+    ies.ue_cap_rat_container_list.resize(1);
+    ies.ue_cap_rat_container_list[0].rat_type.value = rat_type_opts::nr;
+    fill_pattern(ies.ue_cap_rat_container_list[0].ue_cap_rat_container, 1500, 0x42);
+    push_rrc(corpus, corpus_dir_t::from_ue, srsran::nr_srb::srb1, msg);
+  }
+
+  // RRCReconfiguration + ciphered Registration Accept
+  {
+    dl_dcch_msg_s    msg;
+    rrc_recfg_s&     recfg = msg.msg.set_c1().set_rrc_recfg();
+    rrc_recfg_ies_s& ies   = recfg.crit_exts.set_rrc_recfg();
+    recfg.rrc_transaction_id = 3;
+    ies.non_crit_ext_present = true;
+    pack_cell_group(0, ies.non_crit_ext.master_cell_group);
+    // NR-DC: the SCG comes in an RRCReconfiguration of its own, with its cell group inside
+    rrc_recfg_v1560_ies_s& v1560                       = ies.non_crit_ext.non_crit_ext.non_crit_ext;
+    ies.non_crit_ext.non_crit_ext_present              = true;
+    ies.non_crit_ext.non_crit_ext.non_crit_ext_present = true;
+    v1560.mrdc_secondary_cell_group_cfg_present        = true;
+    rrc_recfg_s scg_recfg;
+    scg_recfg.crit_exts.set_rrc_recfg();
+    pack_cell_group(1, scg_recfg.crit_exts.rrc_recfg().secondary_cell_group);
+    pack_container(scg_recfg,
+                   v1560.mrdc_secondary_cell_group_cfg.set_setup().mrdc_secondary_cell_group.set_nr_scg());
+    ies.non_crit_ext.ded_nas_msg_list.resize(1);
+    pack_ciphered_nas(ies.non_crit_ext.ded_nas_msg_list[0], 120);
+    push_rrc(corpus, corpus_dir_t::from_gnb, srsran::nr_srb::srb1, msg);
+  }
+
+  // RRCReject
+  {
+    dl_ccch_msg_s      msg;
+    rrc_reject_ies_s&  reject = msg.msg.set_c1().set_rrc_reject().crit_exts.set_rrc_reject();
+    reject.wait_time_present  = true;
+    reject.wait_time          = 10;
+    push_rrc(corpus, corpus_dir_t::from_gnb, srsran::nr_srb::srb0, msg);
+  }
+
+  return corpus;
+}
+
+static bool read_corpus_file(const std::string& filename, std::vector<corpus_pdu_t>& corpus)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (not file.is_open()) {
+    fprintf(stderr, "Couldn't open corpus file %s\n", filename.c_str());
+    return false;
+  }
+
+  uint8_t hdr[3];
+  while (file.read(reinterpret_cast<char*>(hdr), sizeof(hdr))) {
+    corpus_pdu_t pdu;
+    pdu.dir = (hdr[0] == 0) ? corpus_dir_t::from_ue : corpus_dir_t::from_gnb;
+    pdu.datagram.resize(((uint32_t)hdr[1] << 8u) | hdr[2]);
+    if (not file.read(reinterpret_cast<char*>(pdu.datagram.data()), pdu.datagram.size())) {
+      fprintf(stderr, "Truncated record in corpus file %s\n", filename.c_str());
+      return false;
+    }
+    corpus.push_back(std::move(pdu));
+  }
+  return not corpus.empty();
+}
+
+static int decode_into(corpus_pdu_t& pdu, decode_cache* cache, asn1::json_writer& json_buffer)
+{
+  decode_cache::decode_fn decoder = pdu.dir == corpus_dir_t::from_ue ? nr_codec.decode_ul : nr_codec.decode_dl;
+  if (cache != nullptr) {
+    return cache->decode((uint32_t)pdu.dir, pdu.datagram.data(), pdu.datagram.size(), json_buffer, decoder);
+  }
+  return decoder(pdu.datagram.data(), pdu.datagram.size(), json_buffer);
+}
+
+static std::string decode_pdu(corpus_pdu_t& pdu, decode_cache* cache)
+{
+  asn1::json_writer json_buffer;
+  json_buffer.set_containers(container_types.empty() ? nullptr : &asn1::rrc_nr::containers());
+  json_buffer.start_array();
+  int ret = decode_into(pdu, cache, json_buffer);
+  json_buffer.end_array();
+  return std::to_string(ret) + json_buffer.to_string();
+}
+
+// Moves the master and the nested secondary cell group of the RRCReconfiguration to other cell group IDs through a
+// field path verdict, which must repack both containers
+static int check_containers(std::vector<corpus_pdu_t>& corpus)
+{
+  const std::string recfg = "DL-DCCH-Message.message.c1.rrcReconfiguration.criticalExtensions.rrcReconfiguration.";
+  const std::string mcg   = recfg + "nonCriticalExtension.masterCellGroup.cellGroupId";
+  const std::string scg   = recfg + "nonCriticalExtension.nonCriticalExtension.nonCriticalExtension."
+                                  "mrdc-SecondaryCellGroupConfig.setup.mrdc-SecondaryCellGroup.nr-SCG."
+                                  "criticalExtensions.rrcReconfiguration.secondaryCellGroup.cellGroupId";
+  asn1::field_path mcg_path = asn1::field_path::compile<asn1::rrc_nr::dl_dcch_msg_s>(mcg, &asn1::rrc_nr::containers());
+  asn1::field_path scg_path = asn1::field_path::compile<asn1::rrc_nr::dl_dcch_msg_s>(scg, &asn1::rrc_nr::containers());
+  if (not mcg_path.valid() or not scg_path.valid()) {
+    return SRSRAN_ERROR;
+  }
+
+  for (corpus_pdu_t& pdu : corpus) {
+    asn1::rrc_nr::dl_dcch_msg_s msg;
+    asn1::cbit_ref              bref(pdu.datagram.data() + sizeof(uint32_t), pdu.datagram.size() - sizeof(uint32_t));
+    asn1::field_value           mcg_id, scg_id;
+    if (pdu.dir != corpus_dir_t::from_gnb or msg.unpack(bref) != asn1::SRSASN_SUCCESS or
+        not scg_path.get(msg, scg_id)) {
+      continue;
+    }
+
+    int      size    = 0;
+    uint8_t* spoofed = jsonPacketMaker::json_to_packet(
+        "{\"set\": {\"" + mcg + "\": 2, \"" + scg + "\": 3}}", pdu.datagram.data(), pdu.datagram.size(), size);
+    bref = asn1::cbit_ref(spoofed + sizeof(uint32_t), size - sizeof(uint32_t));
+    if (msg.unpack(bref) != asn1::SRSASN_SUCCESS or not mcg_path.get(msg, mcg_id) or not scg_path.get(msg, scg_id) or
+        mcg_id.num != 2 or scg_id.num != 3) {
+      fprintf(stderr, "The cell groups were not updated through their containers\n");
+      return SRSRAN_ERROR;
+    }
+
+    corpus_pdu_t spoofed_pdu = {pdu.dir, std::vector<uint8_t>(spoofed, spoofed + size)};
+    std::string  json        = decode_pdu(spoofed_pdu, nullptr);
+    if (container_types == "all" and (json.find("\"masterCellGroup\": {") == std::string::npos or
+                                      json.find("\"cellGroupId\": 3") == std::string::npos)) {
+      fprintf(stderr, "The containers were not decoded inline:\n%s\n", json.c_str());
+      return SRSRAN_ERROR;
+    }
+    return SRSRAN_SUCCESS;
+  }
+  fprintf(stderr, "No RRCReconfiguration with an SCG in the corpus\n");
+  return SRSRAN_ERROR;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::init();
+
+  std::vector<corpus_pdu_t> corpus;
+  if (corpus_file.empty()) {
+    corpus = make_builtin_corpus();
+  } else if (not read_corpus_file(corpus_file, corpus)) {
+    return SRSRAN_ERROR;
+  }
+
+  if (not container_types.empty()) {
+    if (not asn1::rrc_nr::containers().subscribe(container_types)) {
+      return SRSRAN_ERROR;
+    }
+    if (corpus_file.empty() and check_containers(corpus) != SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  }
+
+  std::unique_ptr<decode_cache> cache;
+  if (cache_size > 0) {
+    cache.reset(new decode_cache(cache_size));
+    // two passes, so that the second one is served from the cache
+    for (uint32_t pass = 0; pass < 2; ++pass) {
+      for (corpus_pdu_t& pdu : corpus) {
+        if (decode_pdu(pdu, cache.get()) != decode_pdu(pdu, nullptr)) {
+          fprintf(stderr, "Cached decode differs from the decoder output\n");
+          return SRSRAN_ERROR;
+        }
+      }
+    }
+    // Disabled, as with the security contexts tracked, every PDU goes through the decoder
+    uint64_t hits = cache->get_metrics().hits;
+    cache->set_enabled(false);
+    for (corpus_pdu_t& pdu : corpus) {
+      decode_pdu(pdu, cache.get());
+    }
+    cache->set_enabled(true);
+    if (cache->get_metrics().hits != hits) {
+      fprintf(stderr, "A disabled cache served a PDU\n");
+      return SRSRAN_ERROR;
+    }
+  }
+
+  uint64_t nof_bytes = 0, nof_json_bytes = 0;
+  auto     tstart    = std::chrono::steady_clock::now();
+  for (uint32_t rep = 0; rep < nof_repetitions; ++rep) {
+    for (corpus_pdu_t& pdu : corpus) {
+      asn1::json_writer json_buffer;
+      json_buffer.set_containers(container_types.empty() ? nullptr : &asn1::rrc_nr::containers());
+      json_buffer.start_array();
+      decode_into(pdu, cache.get(), json_buffer);
+      json_buffer.end_array();
+      nof_bytes += pdu.datagram.size();
+      nof_json_bytes += json_buffer.to_string().size();
+    }
+  }
+  auto   tend    = std::chrono::steady_clock::now();
+  double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(tend - tstart).count() / 1e9;
+
+  uint64_t nof_pdus = (uint64_t)corpus.size() * nof_repetitions;
+  printf("Decoded %lu PDUs (%lu bytes, %lu JSON bytes) in %.3f s\n", nof_pdus, nof_bytes, nof_json_bytes, elapsed);
+  printf("  %.1f kPDU/s, %.2f us/PDU\n", nof_pdus / elapsed / 1e3, elapsed * 1e6 / nof_pdus);
+  if (cache != nullptr) {
+    printf("  %s\n", cache->metrics_to_string().c_str());
+  }
+
+  srslog::flush();
+
+  return SRSRAN_SUCCESS;
+}
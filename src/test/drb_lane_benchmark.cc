@@ -0,0 +1,360 @@
+/**
+ * Loopback benchmark for the user-plane relay lane.
+ *
+ * A sender plays the fake UE and pushes a mix of DRB and SRB datagrams to the lane, a receiver plays the fake gNB.
+ * The first pass checks that every DRB datagram arrives unchanged and in order, that the SRB datagrams are handed to
+ * the control-plane queue instead and that the sampled DRB datagrams reach the scenario handler socket. The timed pass
+ * then measures the forwarding rate over the loopback interface, with and without a PDCP relay on the DRBs.
+ *
+ * The PDCP relay itself is checked first: SDUs dropped between termination and re-origination must not leave a gap in
+ * the COUNTs the destination sees. Last, SRB SDUs are relayed both ways with AS security active between peers that,
+ * as a real UE and gNB do, protect and verify with opposite directions.
+ */
+
+#include "src/drb_lane.h"
+#include "src/pdcp_relay.h"
+
+#include "mitm_lib/common/common_nr.h"
+#include "mitm_lib/config.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static uint32_t nof_repetitions = 100;
+static uint32_t pdu_len         = 1400;
+static uint32_t sample_period   = 8;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nls]\n", prog);
+  printf("\t-n Number of bursts of %d datagrams [Default %d]\n", drb_lane::batch_size, nof_repetitions);
+  printf("\t-l DRB PDU length [Default %d]\n", pdu_len);
+  printf("\t-s DRB sampling period [Default %d]\n", sample_period);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nlsh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        pdu_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        sample_period = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+static int open_socket(sockaddr_in& addr)
+{
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+  int size = 8 * 1024 * 1024;
+  setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  timeval timeout = {1, 0};
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+  socklen_t len        = sizeof(addr);
+  if (bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0 or getsockname(sock, (sockaddr*)&addr, &len) < 0) {
+    perror("bind");
+    exit(SRSRAN_ERROR);
+  }
+  return sock;
+}
+
+static std::vector<uint8_t> make_datagram(uint32_t lcid, uint32_t seq, uint32_t len)
+{
+  std::vector<uint8_t> datagram(sizeof(lcid) + len);
+  memcpy(datagram.data(), &lcid, sizeof(lcid));
+  for (uint32_t i = 0; i < len; i++) {
+    datagram[sizeof(lcid) + i] = (uint8_t)(seq * 31 + i);
+  }
+  return datagram;
+}
+
+// The source numbers its PDUs itself, the relay drops every third SDU and the destination must still get all the others
+// in order, each delivered as soon as it arrives
+static bool check_pdcp_relay(uint32_t lcid, uint8_t drb_sn_len)
+{
+  pdcp_relay source(srsran::SECURITY_DIRECTION_UPLINK, drb_sn_len);
+  pdcp_relay relay(srsran::SECURITY_DIRECTION_UPLINK, drb_sn_len);
+  pdcp_relay destination(srsran::SECURITY_DIRECTION_UPLINK, drb_sn_len);
+
+  for (uint32_t seq = 0; seq < 3000; seq++) {
+    std::vector<uint8_t>         sdu = make_datagram(lcid, seq, 100);
+    srsran::unique_byte_buffer_t pdu = source.reoriginate(lcid, sdu.data(), sdu.size());
+    if (pdu == nullptr or relay.terminate(lcid, pdu->msg, pdu->N_bytes) != 1) {
+      fprintf(stderr, "PDCP relay did not deliver SDU %d on LCID %d\n", seq, lcid);
+      return false;
+    }
+    uint32_t                     rx_lcid;
+    srsran::unique_byte_buffer_t rx_sdu = relay.pop_sdu(rx_lcid);
+    if (seq % 3 == 0) {
+      continue;
+    }
+    pdu = relay.reoriginate(rx_lcid, rx_sdu->msg, rx_sdu->N_bytes);
+    if (pdu == nullptr or destination.terminate(lcid, pdu->msg, pdu->N_bytes) != 1) {
+      fprintf(stderr, "PDCP relay left a COUNT gap after SDU %d on LCID %d\n", seq, lcid);
+      return false;
+    }
+    rx_sdu = destination.pop_sdu(rx_lcid);
+    if (rx_sdu->N_bytes != sdu.size() or memcmp(rx_sdu->msg, sdu.data(), sdu.size()) != 0) {
+      fprintf(stderr, "PDCP relay changed SDU %d on LCID %d\n", seq, lcid);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Relays SDUs between a real gNB and UE with AS security active. The peers protect with one direction and verify with
+// the other, so the relays must use the direction of the PDUs they carry: a relay with the wrong one fails every MAC-I
+static bool check_pdcp_directions()
+{
+  const uint32_t lcid = (uint32_t)srsran::nr_srb::srb1;
+
+  srsran::as_security_config_t cfg = {};
+  for (uint32_t i = 0; i < cfg.k_rrc_int.size(); i++) {
+    cfg.k_rrc_int[i] = (uint8_t)(i * 7 + 1);
+    cfg.k_rrc_enc[i] = (uint8_t)(i * 13 + 2);
+  }
+  cfg.integ_algo  = srsran::INTEGRITY_ALGORITHM_ID_128_EIA2;
+  cfg.cipher_algo = srsran::CIPHERING_ALGORITHM_ID_128_EEA2;
+  as_sec_ctx.set_config(cfg);
+
+  // Each real peer transmits in its own direction and receives in the other one
+  pdcp_relay gnb_tx(srsran::SECURITY_DIRECTION_DOWNLINK, srsran::PDCP_SN_LEN_18);
+  pdcp_relay gnb_rx(srsran::SECURITY_DIRECTION_UPLINK, srsran::PDCP_SN_LEN_18);
+  pdcp_relay ue_tx(srsran::SECURITY_DIRECTION_UPLINK, srsran::PDCP_SN_LEN_18);
+  pdcp_relay ue_rx(srsran::SECURITY_DIRECTION_DOWNLINK, srsran::PDCP_SN_LEN_18);
+  // As created by the controller
+  pdcp_relay from_fake_ue(pdcp_relay::relayed_direction(true), srsran::PDCP_SN_LEN_18);
+  pdcp_relay from_fake_gnb(pdcp_relay::relayed_direction(false), srsran::PDCP_SN_LEN_18);
+  // A relay with the direction of the other side must fail, or the check would not tell the two apart
+  pdcp_relay swapped(pdcp_relay::relayed_direction(false), srsran::PDCP_SN_LEN_18);
+
+  pdcp_relay* all[] = {&gnb_tx, &gnb_rx, &ue_tx, &ue_rx, &from_fake_ue, &from_fake_gnb, &swapped};
+  for (pdcp_relay* r : all) {
+    r->update_security();
+  }
+
+  struct path_t {
+    const char* name;
+    pdcp_relay& source;
+    pdcp_relay& relay;
+    pdcp_relay& destination;
+  } paths[] = {{"gNB to UE", gnb_tx, from_fake_ue, ue_rx}, {"UE to gNB", ue_tx, from_fake_gnb, gnb_rx}};
+
+  for (uint32_t seq = 0; seq < 100; seq++) {
+    for (path_t& path : paths) {
+      std::vector<uint8_t>         sdu = make_datagram(lcid, seq, 40);
+      srsran::unique_byte_buffer_t pdu = path.source.reoriginate(lcid, sdu.data(), sdu.size());
+      if (pdu == nullptr) {
+        fprintf(stderr, "%s: SDU %d not protected\n", path.name, seq);
+        return false;
+      }
+      if (seq == 0 and &path.source == &gnb_tx and swapped.terminate(lcid, pdu->msg, pdu->N_bytes) != 0) {
+        fprintf(stderr, "%s: PDU %d verified with the uplink direction\n", path.name, seq);
+        return false;
+      }
+      if (path.relay.terminate(lcid, pdu->msg, pdu->N_bytes) != 1) {
+        fprintf(stderr, "%s: PDU %d failed the relay's integrity check\n", path.name, seq);
+        return false;
+      }
+      uint32_t                     rx_lcid;
+      srsran::unique_byte_buffer_t rx_sdu = path.relay.pop_sdu(rx_lcid);
+      pdu                                 = path.relay.reoriginate(rx_lcid, rx_sdu->msg, rx_sdu->N_bytes);
+      if (pdu == nullptr or path.destination.terminate(lcid, pdu->msg, pdu->N_bytes) != 1) {
+        fprintf(stderr, "%s: re-originated PDU %d failed the peer's integrity check\n", path.name, seq);
+        return false;
+      }
+      rx_sdu = path.destination.pop_sdu(rx_lcid);
+      if (rx_sdu->N_bytes != sdu.size() or memcmp(rx_sdu->msg, sdu.data(), sdu.size()) != 0) {
+        fprintf(stderr, "%s: SDU %d changed by the relay\n", path.name, seq);
+        return false;
+      }
+    }
+  }
+  printf("Relayed 100 protected SRB SDUs each way, %s, %s\n",
+         from_fake_ue.metrics_to_string().c_str(),
+         from_fake_gnb.metrics_to_string().c_str());
+  return true;
+}
+
+// Sends nof_sent datagrams, cycling through the given ones, while a receiver drains the gNB socket. Returns how many
+// arrived
+static uint32_t timed_pass(int                                       ue_sock,
+                           const sockaddr_in&                        lane_addr,
+                           int                                       gnb_sock,
+                           const std::vector<std::vector<uint8_t> >& datagrams,
+                           uint32_t                                  nof_sent,
+                           double&                                   elapsed)
+{
+  uint32_t    nof_timed = 0;
+  auto        t_start   = std::chrono::steady_clock::now();
+  auto        t_end     = t_start;
+  std::thread receiver([&]() {
+    // Datagrams lost on the loopback interface end the pass with a receive timeout, which is not counted
+    uint8_t buf[drb_lane::max_datagram];
+    while (nof_timed < nof_sent and recv(gnb_sock, buf, sizeof(buf), 0) > 0) {
+      nof_timed++;
+      t_end = std::chrono::steady_clock::now();
+    }
+  });
+  for (uint32_t i = 0; i < nof_sent; i++) {
+    const std::vector<uint8_t>& datagram = datagrams[i % datagrams.size()];
+    sendto(ue_sock, datagram.data(), datagram.size(), 0, (sockaddr*)&lane_addr, sizeof(lane_addr));
+    // Lets the lane keep up, datagrams lost on the loopback interface would stall the PDCP relay in t-Reordering
+    if (i % drb_lane::batch_size == drb_lane::batch_size - 1) {
+      std::this_thread::yield();
+    }
+  }
+  receiver.join();
+  elapsed = std::chrono::duration<double>(t_end - t_start).count();
+  return nof_timed;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  if (not check_pdcp_relay((uint32_t)srsran::nr_srb::srb1, srsran::PDCP_SN_LEN_18) or
+      not check_pdcp_relay((uint32_t)srsran::nr_srb::count + 1, srsran::PDCP_SN_LEN_12) or
+      not check_pdcp_relay((uint32_t)srsran::nr_srb::count + 1, srsran::PDCP_SN_LEN_18)) {
+    return SRSRAN_ERROR;
+  }
+
+  sockaddr_in ue_addr, lane_addr, gnb_addr, scenario_addr, tx_addr;
+  int         ue_sock       = open_socket(ue_addr);
+  int         lane_sock     = open_socket(lane_addr);
+  int         gnb_sock      = open_socket(gnb_addr);
+  int         scenario_sock = open_socket(scenario_addr);
+  int         tx_sock       = open_socket(tx_addr);
+
+  // The lane learns the UE address from the first datagram, as in the controller
+  peer_addr learnt_ue_addr;
+  peer_addr gnb_peer(gnb_addr);
+  drb_lane  lane(lane_sock, tx_sock, &learnt_ue_addr, &gnb_peer);
+  lane.set_sampling(sample_period, tx_sock, scenario_addr);
+  std::thread lane_thread([&lane]() { lane.run(); });
+
+  const uint32_t drb_lcid = (uint32_t)srsran::nr_srb::count + 1;
+  const uint32_t srb_lcid = (uint32_t)srsran::nr_srb::srb1;
+
+  // Check pass: one SRB datagram in every burst, the rest are DRB datagrams
+  uint32_t nof_drb = 0, nof_srb = 0;
+  for (uint32_t burst = 0; burst < nof_repetitions; burst++) {
+    std::vector<std::vector<uint8_t> > sent;
+    for (uint32_t i = 0; i < drb_lane::batch_size; i++) {
+      uint32_t             seq      = burst * drb_lane::batch_size + i;
+      bool                 is_srb   = i == burst % drb_lane::batch_size;
+      std::vector<uint8_t> datagram = make_datagram(is_srb ? srb_lcid : drb_lcid, seq, is_srb ? 32 : pdu_len);
+      sendto(ue_sock, datagram.data(), datagram.size(), 0, (sockaddr*)&lane_addr, sizeof(lane_addr));
+      if (is_srb) {
+        nof_srb++;
+      } else {
+        sent.push_back(std::move(datagram));
+      }
+    }
+    for (const std::vector<uint8_t>& expected : sent) {
+      uint8_t buf[drb_lane::max_datagram];
+      int     n = recv(gnb_sock, buf, sizeof(buf), 0);
+      if (n != (int)expected.size() or memcmp(buf, expected.data(), n) != 0) {
+        fprintf(stderr, "DRB datagram %d of burst %d was not relayed unchanged\n", nof_drb, burst);
+        return SRSRAN_ERROR;
+      }
+      nof_drb++;
+    }
+  }
+  for (uint32_t i = 0; i < nof_srb; i++) {
+    uint8_t buf[drb_lane::max_datagram];
+    int     n = lane.pop_control(buf, sizeof(buf));
+    if (n != (int)(sizeof(srb_lcid) + 32) or drb_lane::is_drb(buf, n)) {
+      fprintf(stderr, "SRB datagram %d was not queued for the control plane\n", i);
+      return SRSRAN_ERROR;
+    }
+  }
+  uint32_t nof_samples = 0;
+  char     json[1024];
+  int      n;
+  while (nof_samples < nof_drb / sample_period and (n = recv(scenario_sock, json, sizeof(json) - 1, 0)) > 0) {
+    json[n] = '\0';
+    if (strstr(json, "\"DRB\"") == nullptr) {
+      fprintf(stderr, "Unexpected sample %s\n", json);
+      return SRSRAN_ERROR;
+    }
+    nof_samples++;
+  }
+  if (nof_samples != nof_drb / sample_period) {
+    fprintf(stderr, "Received %d samples instead of %d\n", nof_samples, nof_drb / sample_period);
+    return SRSRAN_ERROR;
+  }
+  if (learnt_ue_addr.load().sin_port != ue_addr.sin_port) {
+    fprintf(stderr, "The lane did not learn the source address\n");
+    return SRSRAN_ERROR;
+  }
+  printf("Relayed %d DRB datagrams, queued %d SRB datagrams, sampled %d\n", nof_drb, nof_srb, nof_samples);
+
+  // Timed passes: DRB datagrams only, the receiver drains the gNB socket concurrently
+  uint32_t nof_sent  = nof_repetitions * drb_lane::batch_size * 16;
+  double   elapsed   = 0;
+  uint32_t nof_timed = timed_pass(ue_sock, lane_addr, gnb_sock, {make_datagram(drb_lcid, 0, pdu_len)}, nof_sent, elapsed);
+  lane.stop();
+  lane_thread.join();
+  printf("Forwarded %d of %d DRB datagrams of %d bytes in %.3f s\n", nof_timed, nof_sent, pdu_len, elapsed);
+  printf("  %.1f kPDU/s, %.1f Mbit/s\n", nof_timed / elapsed / 1e3, nof_timed * pdu_len * 8 / elapsed / 1e6);
+  printf("  %s\n", lane.metrics_to_string().c_str());
+
+  // Through a PDCP relay, with DRB PDUs of increasing COUNT
+  pdcp_relay source(srsran::SECURITY_DIRECTION_UPLINK, srsran::PDCP_SN_LEN_18);
+  pdcp_relay relay(srsran::SECURITY_DIRECTION_UPLINK, srsran::PDCP_SN_LEN_18);
+  int        pdcp_lane_sock = open_socket(lane_addr);
+  drb_lane   pdcp_lane(pdcp_lane_sock, tx_sock, &learnt_ue_addr, &gnb_peer);
+  pdcp_lane.set_pdcp_relay(&relay);
+  std::thread pdcp_lane_thread([&pdcp_lane]() { pdcp_lane.run(); });
+
+  std::vector<std::vector<uint8_t> > pdus;
+  for (uint32_t i = 0; i < nof_sent; i++) {
+    std::vector<uint8_t>         sdu = make_datagram(drb_lcid, i, pdu_len - sizeof(drb_lcid));
+    srsran::unique_byte_buffer_t pdu = source.reoriginate(drb_lcid, sdu.data(), sdu.size());
+    pdus.emplace_back(sizeof(drb_lcid) + pdu->N_bytes);
+    memcpy(pdus.back().data(), &drb_lcid, sizeof(drb_lcid));
+    memcpy(pdus.back().data() + sizeof(drb_lcid), pdu->msg, pdu->N_bytes);
+  }
+  nof_timed = timed_pass(ue_sock, lane_addr, gnb_sock, pdus, nof_sent, elapsed);
+  pdcp_lane.stop();
+  pdcp_lane_thread.join();
+  printf("Re-originated %d of %d DRB PDUs in %.3f s\n", nof_timed, nof_sent, elapsed);
+  printf("  %.1f kPDU/s, %.1f Mbit/s\n", nof_timed / elapsed / 1e3, nof_timed * pdu_len * 8 / elapsed / 1e6);
+  printf("  %s\n", pdcp_lane.metrics_to_string().c_str());
+
+  // Last, as it activates AS security for the relays created from then on
+  if (not check_pdcp_directions()) {
+    return SRSRAN_ERROR;
+  }
+
+  close(pdcp_lane_sock);
+  close(ue_sock);
+  close(lane_sock);
+  close(gnb_sock);
+  close(scenario_sock);
+  close(tx_sock);
+  return SRSRAN_SUCCESS;
+}
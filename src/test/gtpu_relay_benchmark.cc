@@ -0,0 +1,252 @@
+/**
+ * Loopback benchmark for the N3 GTP-U relay.
+ *
+ * A sender plays the gNB and pushes G-PDUs, an Echo Request and a malformed datagram to the relay, a receiver plays the
+ * UPF. The first pass checks that the G-PDUs of a TEID in the rewrite table arrive with the rewritten TEID and are
+ * otherwise unchanged, that the other PDUs arrive unchanged, that the malformed datagram is dropped and that the TEIDs
+ * and inner flows are counted. The timed pass then measures the forwarding rate over the loopback interface.
+ */
+
+#include "src/gtpu_relay.h"
+
+#include "mitm_lib/common/int_helpers.h"
+#include "mitm_lib/config.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static uint32_t nof_repetitions = 100;
+static uint32_t pkt_len         = 1400;
+
+static const uint32_t mapped_teid    = 0x100;
+static const uint32_t rewritten_teid = 0x2000;
+static const uint32_t unmapped_teid  = 0x300;
+static const uint32_t nof_flows      = 4;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nl]\n", prog);
+  printf("\t-n Number of bursts of %d datagrams [Default %d]\n", gtpu_relay::batch_size, nof_repetitions);
+  printf("\t-l Inner IP packet length [Default %d]\n", pkt_len);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nlh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        pkt_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+static int open_socket(sockaddr_in& addr)
+{
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+  int size = 8 * 1024 * 1024;
+  setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  timeval timeout = {1, 0};
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+  socklen_t len        = sizeof(addr);
+  if (bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0 or getsockname(sock, (sockaddr*)&addr, &len) < 0) {
+    perror("bind");
+    exit(SRSRAN_ERROR);
+  }
+  return sock;
+}
+
+// IPv4/UDP packet of the given flow, from the UE to a server
+static void write_ip_packet(uint8_t* pkt, uint32_t len, uint32_t flow, uint32_t seq)
+{
+  memset(pkt, 0, 28);
+  pkt[0] = 0x45;
+  srsran::uint16_to_uint8(len, &pkt[2]);
+  pkt[8]  = 64;
+  pkt[9]  = IPPROTO_UDP;
+  pkt[12] = 10;
+  pkt[13] = 45;
+  pkt[15] = 2;
+  pkt[16] = 192;
+  pkt[17] = 0;
+  pkt[18] = 2;
+  pkt[19] = 10 + flow;
+  srsran::uint16_to_uint8(40000 + flow, &pkt[20]);
+  srsran::uint16_to_uint8(5201, &pkt[22]);
+  srsran::uint16_to_uint8(len - 20, &pkt[24]);
+  for (uint32_t i = 28; i < len; i++) {
+    pkt[i] = (uint8_t)(seq * 31 + i);
+  }
+}
+
+// G-PDU with a PDU Session Container, as a gNB sends on N3, written with gtpu_write_header()
+static std::vector<uint8_t> make_gpdu(uint32_t teid, uint32_t flow, uint32_t seq, uint32_t len)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  write_ip_packet(pdu->msg, len, flow, seq);
+  pdu->N_bytes = len;
+
+  srsran::gtpu_header_t header;
+  header.flags             = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL | GTPU_FLAGS_EXTENDED_HDR;
+  header.message_type      = GTPU_MSG_DATA_PDU;
+  header.length            = pdu->N_bytes;
+  header.teid              = teid;
+  header.next_ext_hdr_type = GTPU_EXT_HEADER_PDU_SESSION_CONTAINER;
+  // UL PDU Session Information, QFI 9
+  header.ext_buffer = {1, 0x10, 9, GTPU_EXT_NO_MORE_EXTENSION_HEADERS};
+  srsran::gtpu_write_header(&header, pdu.get(), srslog::fetch_basic_logger("GTPU", false));
+  return std::vector<uint8_t>(pdu->msg, pdu->msg + pdu->N_bytes);
+}
+
+// G-PDU with the 8 octet header only
+static std::vector<uint8_t> make_short_gpdu(uint32_t teid, uint32_t flow, uint32_t seq, uint32_t len)
+{
+  std::vector<uint8_t> datagram(GTPU_BASE_HEADER_LEN + len);
+  datagram[0] = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
+  datagram[1] = GTPU_MSG_DATA_PDU;
+  srsran::uint16_to_uint8(len, &datagram[2]);
+  srsran::uint32_to_uint8(teid, &datagram[4]);
+  write_ip_packet(&datagram[GTPU_BASE_HEADER_LEN], len, flow, seq);
+  return datagram;
+}
+
+static std::vector<uint8_t> make_echo_request(uint16_t seq)
+{
+  std::vector<uint8_t> datagram(GTPU_EXTENDED_HEADER_LEN + 2);
+  datagram[0] = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL | GTPU_FLAGS_SEQUENCE;
+  datagram[1] = GTPU_MSG_ECHO_REQUEST;
+  srsran::uint16_to_uint8(datagram.size() - GTPU_BASE_HEADER_LEN, &datagram[2]);
+  srsran::uint16_to_uint8(seq, &datagram[8]);
+  // Recovery IE
+  datagram[12] = 14;
+  return datagram;
+}
+
+static uint32_t read_teid(const uint8_t* datagram)
+{
+  uint32_t teid;
+  srsran::uint8_to_uint32(&datagram[4], &teid);
+  return teid;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+  srslog::init();
+
+  sockaddr_in gnb_addr, relay_addr, upf_addr, tx_addr;
+  int         gnb_sock   = open_socket(gnb_addr);
+  int         relay_sock = open_socket(relay_addr);
+  int         upf_sock   = open_socket(upf_addr);
+  int         tx_sock    = open_socket(tx_addr);
+
+  // The relay learns the gNB address from the first datagram, as in the controller
+  peer_addr  learnt_gnb_addr;
+  peer_addr  upf_peer(upf_addr);
+  gtpu_relay relay(relay_sock, tx_sock, &learnt_gnb_addr, &upf_peer);
+  relay.add_teid_rewrite(mapped_teid, rewritten_teid);
+  std::thread relay_thread([&relay]() { relay.run(); });
+
+  // Check pass: G-PDUs of the mapped TEID over all flows, and in every burst one G-PDU of another TEID, one Echo
+  // Request and one truncated datagram
+  uint32_t nof_gpdus = 0, nof_other = 0;
+  for (uint32_t burst = 0; burst < nof_repetitions; burst++) {
+    std::vector<std::vector<uint8_t> > sent;
+    for (uint32_t i = 0; i < gtpu_relay::batch_size - 3; i++) {
+      sent.push_back(make_gpdu(mapped_teid, i % nof_flows, burst * gtpu_relay::batch_size + i, pkt_len));
+    }
+    sent.push_back(make_short_gpdu(unmapped_teid, 0, burst, pkt_len / 2));
+    sent.push_back(make_echo_request(burst));
+    uint8_t truncated[5] = {GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL, GTPU_MSG_DATA_PDU, 0, 0, 0};
+    sendto(gnb_sock, truncated, sizeof(truncated), 0, (sockaddr*)&relay_addr, sizeof(relay_addr));
+    for (const std::vector<uint8_t>& datagram : sent) {
+      sendto(gnb_sock, datagram.data(), datagram.size(), 0, (sockaddr*)&relay_addr, sizeof(relay_addr));
+    }
+    for (std::vector<uint8_t>& expected : sent) {
+      uint8_t buf[2048];
+      int     n = recv(upf_sock, buf, sizeof(buf), 0);
+      if (read_teid(expected.data()) == mapped_teid) {
+        srsran::uint32_to_uint8(rewritten_teid, &expected[4]);
+        nof_gpdus++;
+      } else {
+        nof_other++;
+      }
+      if (n != (int)expected.size() or memcmp(buf, expected.data(), n) != 0) {
+        fprintf(stderr,
+                "PDU of TEID 0x%x of burst %d was not relayed as expected\n",
+                read_teid(expected.data()),
+                burst);
+        return SRSRAN_ERROR;
+      }
+    }
+  }
+
+  gtpu_relay::metrics_t    metrics = relay.get_metrics();
+  gtpu_relay::teid_entry_t mapped, unmapped;
+  if (metrics.rewritten != nof_gpdus or metrics.unmapped != nof_repetitions or
+      metrics.signalling != nof_repetitions or metrics.malformed != nof_repetitions or
+      not relay.get_teid_metrics(mapped_teid, mapped) or mapped.packets != nof_gpdus or
+      mapped.bytes != (uint64_t)nof_gpdus * pkt_len or not relay.get_teid_metrics(unmapped_teid, unmapped) or
+      unmapped.rewrite or relay.nof_flows() != nof_flows) {
+    fprintf(stderr, "Unexpected metrics\n%s\n", relay.metrics_to_string().c_str());
+    return SRSRAN_ERROR;
+  }
+  if (learnt_gnb_addr.load().sin_port != gnb_addr.sin_port) {
+    fprintf(stderr, "The relay did not learn the source address\n");
+    return SRSRAN_ERROR;
+  }
+  printf("Rewrote %d G-PDUs, relayed %d other PDUs unchanged\n", nof_gpdus, nof_other);
+
+  // Timed pass: G-PDUs of the mapped TEID only, the receiver drains the UPF socket concurrently
+  std::vector<uint8_t> gpdu      = make_gpdu(mapped_teid, 0, 0, pkt_len);
+  uint32_t             nof_sent  = nof_repetitions * gtpu_relay::batch_size * 16;
+  uint32_t             nof_timed = 0;
+  auto                 t_start   = std::chrono::steady_clock::now();
+  auto                 t_end     = t_start;
+  std::thread          receiver([&]() {
+    // Datagrams lost on the loopback interface end the pass with a receive timeout, which is not counted
+    uint8_t buf[2048];
+    while (nof_timed < nof_sent and recv(upf_sock, buf, sizeof(buf), 0) > 0) {
+      nof_timed++;
+      t_end = std::chrono::steady_clock::now();
+    }
+  });
+  for (uint32_t i = 0; i < nof_sent; i++) {
+    sendto(gnb_sock, gpdu.data(), gpdu.size(), 0, (sockaddr*)&relay_addr, sizeof(relay_addr));
+    if (i % gtpu_relay::batch_size == gtpu_relay::batch_size - 1) {
+      std::this_thread::yield();
+    }
+  }
+  receiver.join();
+  relay.stop();
+  relay_thread.join();
+  double elapsed = std::chrono::duration<double>(t_end - t_start).count();
+  printf("Forwarded %d of %d G-PDUs of %d bytes in %.3f s\n", nof_timed, nof_sent, (int)gpdu.size(), elapsed);
+  printf("  %.1f kPDU/s, %.1f Mbit/s\n", nof_timed / elapsed / 1e3, nof_timed * gpdu.size() * 8 / elapsed / 1e6);
+  printf("  %s\n", relay.metrics_to_string().c_str());
+
+  close(gnb_sock);
+  close(relay_sock);
+  close(upf_sock);
+  close(tx_sock);
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,201 @@
+/**
+ * Benchmark of the hex codecs of the ASN.1 octet strings.
+ *
+ * octstring_to_hex/hex_to_octstring are first checked against sprintf/strtoul for every length up to a few AVX2 blocks,
+ * so that each length is split differently between the AVX2, SSE and scalar loops. The input is decoded in lower,
+ * upper and mixed case, and with an invalid character at every position, which must be rejected and decoded pair by
+ * pair as strtoul does. Neither codec may write past the end of its output. A failed check makes the run fail, so this
+ * also runs as a ctest.
+ *
+ * Which loops are compiled in follows the SIMD flags of the build. The _sse and _scalar variants are built from the
+ * same sources with the wider paths undefined, so that every path is checked on an AVX2 host.
+ */
+
+#include "mitm_lib/asn1/asn1_utils.h"
+#include "mitm_lib/config.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <random>
+#include <string>
+#include <vector>
+
+static uint32_t nof_repetitions = 10000;
+static uint32_t octstring_len   = 1024;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nl]\n", prog);
+  printf("\t-n Number of conversions per direction [Default %d]\n", nof_repetitions);
+  printf("\t-l Octet string length [Default %d]\n", octstring_len);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nlh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        octstring_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Output guard, which the codecs must leave untouched
+static const uint8_t guard     = 0xee;
+static const int     guard_len = 64;
+
+static std::string reference_hex(const std::vector<uint8_t>& octets)
+{
+  std::string hex;
+  for (uint8_t octet : octets) {
+    char pair[3];
+    snprintf(pair, sizeof(pair), "%02x", octet);
+    hex += pair;
+  }
+  return hex;
+}
+
+static std::vector<uint8_t> reference_octets(const std::string& hex)
+{
+  std::vector<uint8_t> octets;
+  for (uint32_t i = 0; i + 1 < hex.size(); i += 2) {
+    octets.push_back((uint8_t)strtoul(hex.substr(i, 2).c_str(), nullptr, 16));
+  }
+  return octets;
+}
+
+static bool check_encode(const std::vector<uint8_t>& octets)
+{
+  std::vector<char> hex(2 * octets.size() + guard_len, (char)guard);
+  asn1::octstring_to_hex(hex.data(), octets.data(), octets.size());
+  for (int i = 0; i < guard_len; ++i) {
+    if (hex[2 * octets.size() + i] != (char)guard) {
+      fprintf(stderr, "Encoding %zd octets wrote past the end of the output\n", octets.size());
+      return false;
+    }
+  }
+  std::string expected = reference_hex(octets);
+  if (std::string(hex.data(), 2 * octets.size()) != expected or
+      asn1::octstring_to_string(octets.data(), octets.size()) != expected) {
+    fprintf(stderr, "Encoding %zd octets differs from sprintf\n", octets.size());
+    return false;
+  }
+  return true;
+}
+
+static bool check_decode(const std::string& hex, bool expect_valid)
+{
+  std::vector<uint8_t> expected = reference_octets(hex);
+  std::vector<uint8_t> octets(expected.size() + guard_len, guard);
+  bool                 valid = asn1::hex_to_octstring(octets.data(), hex.data(), hex.size());
+  if (valid != expect_valid) {
+    fprintf(stderr, "Decoding \"%s\" was %s\n", hex.c_str(), valid ? "accepted" : "rejected");
+    return false;
+  }
+  for (int i = 0; i < guard_len; ++i) {
+    if (octets[expected.size() + i] != guard) {
+      fprintf(stderr, "Decoding %zd characters wrote past the end of the output\n", hex.size());
+      return false;
+    }
+  }
+  if (not std::equal(expected.begin(), expected.end(), octets.begin())) {
+    fprintf(stderr, "Decoding \"%s\" differs from strtoul\n", hex.c_str());
+    return false;
+  }
+  return true;
+}
+
+static bool check_codecs()
+{
+  // Characters next to the hex digits in ASCII, and octets that are negative as a signed char
+  const char invalid_chars[] = {'/', ':', '@', 'G', '`', 'g', ' ', '\0', (char)0x80, (char)0xc1, (char)0xff};
+
+  std::mt19937 rng(1234);
+  for (uint32_t len = 0; len <= 3 * 32 + 1; ++len) {
+    std::vector<uint8_t> octets(len);
+    for (uint8_t& octet : octets) {
+      octet = (uint8_t)rng();
+    }
+    if (not check_encode(octets)) {
+      return false;
+    }
+
+    std::string lower = reference_hex(octets);
+    std::string upper = lower;
+    std::string mixed = lower;
+    for (uint32_t i = 0; i < lower.size(); ++i) {
+      upper[i] = (char)toupper(lower[i]);
+      mixed[i] = (char)(i % 3 == 0 ? toupper(lower[i]) : lower[i]);
+    }
+    // A trailing odd nibble is ignored
+    if (not check_decode(lower, true) or not check_decode(upper, true) or not check_decode(mixed, true) or
+        not check_decode(mixed + "f", true)) {
+      return false;
+    }
+
+    for (uint32_t pos = 0; pos < lower.size(); ++pos) {
+      std::string invalid = mixed;
+      invalid[pos]        = invalid_chars[pos % sizeof(invalid_chars)];
+      if (not check_decode(invalid, false)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+#if defined(LV_HAVE_AVX2)
+  const char* path = "AVX2";
+#elif defined(LV_HAVE_SSE)
+  const char* path = "SSE";
+#else
+  const char* path = "scalar";
+#endif
+
+  if (not check_codecs()) {
+    return SRSRAN_ERROR;
+  }
+  printf("Checked the %s hex codecs against sprintf/strtoul\n", path);
+
+  std::vector<uint8_t> octets(octstring_len);
+  for (uint32_t i = 0; i < octets.size(); ++i) {
+    octets[i] = (uint8_t)(i * 7);
+  }
+  std::vector<char> hex(2 * octets.size());
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t rep = 0; rep < nof_repetitions; ++rep) {
+    asn1::octstring_to_hex(hex.data(), octets.data(), octets.size());
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t rep = 0; rep < nof_repetitions; ++rep) {
+    asn1::hex_to_octstring(octets.data(), hex.data(), hex.size());
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double encode_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / nof_repetitions;
+  double decode_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / nof_repetitions;
+  printf("\n%-10s %8s %12s %10s\n", "Codec", "Octets", "ns/string", "MB/s");
+  printf("%-10s %8u %12.0f %10.1f\n", "encode", octstring_len, encode_ns, octstring_len / encode_ns * 1000);
+  printf("%-10s %8u %12.0f %10.1f\n", "decode", octstring_len, decode_ns, octstring_len / decode_ns * 1000);
+
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,324 @@
+/**
+ * Codec benchmark for the LTE relay decode path.
+ *
+ * Runs the EUTRA RRC and EPS NAS decoding of the controller's LTE codec for every datagram of a corpus. The built-in
+ * corpus covers the messages of an LTE attach, a corpus captured from a real run can be passed with -f in the format of
+ * codec_benchmark.
+ *
+ * A spoofing verdict that replaces the NAS is first applied to every message of the corpus: the messages that carry
+ * NAS must render the spoofed one, the others must be left unchanged.
+ */
+
+#include "src/rat_codec.h"
+
+#include "mitm_lib/asn1/liblte_mme.h"
+#include "mitm_lib/asn1/rrc.h"
+#include "mitm_lib/common/common_lte.h"
+#include "mitm_lib/config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <getopt.h>
+#include <memory>
+#include <vector>
+
+enum class corpus_dir_t { from_ue = 0, from_enb = 1 };
+
+struct corpus_pdu_t {
+  corpus_dir_t         dir;
+  std::vector<uint8_t> datagram;
+};
+
+static uint32_t    nof_repetitions = 10000;
+static std::string corpus_file;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nf]\n", prog);
+  printf("\t-n Number of passes over the corpus [Default %d]\n", nof_repetitions);
+  printf("\t-f Corpus file with captured datagrams [Default built-in corpus]\n");
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nfh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'f':
+        corpus_file = argv[optind];
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static void fill_pattern(asn1::dyn_octstring& octs, uint32_t len, uint8_t seed)
+{
+  octs.resize(len);
+  for (uint32_t i = 0; i < len; ++i) {
+    octs[i] = (uint8_t)(seed + i * 7);
+  }
+}
+
+template <class RrcMsg>
+static void push_rrc(std::vector<corpus_pdu_t>& corpus, corpus_dir_t dir, srsran::lte_srb srb, RrcMsg& msg)
+{
+  const uint32_t lcid = (uint32_t)srb;
+  corpus_pdu_t   pdu;
+  pdu.dir = dir;
+  pdu.datagram.resize(sizeof(uint32_t) + 4096);
+
+  memcpy(pdu.datagram.data(), &lcid, sizeof(lcid));
+  asn1::bit_ref bref(pdu.datagram.data() + sizeof(lcid), pdu.datagram.size() - sizeof(lcid));
+  msg.pack(bref);
+  bref.align_bytes_zero();
+  pdu.datagram.resize(sizeof(lcid) + bref.distance_bytes());
+
+  corpus.push_back(std::move(pdu));
+}
+
+static void pack_eps_nas(LIBLTE_BYTE_MSG_STRUCT& nas, asn1::dyn_octstring& octs)
+{
+  octs.resize(nas.N_bytes);
+  memcpy(octs.data(), nas.msg, nas.N_bytes);
+}
+
+static std::vector<corpus_pdu_t> make_builtin_corpus()
+{
+  using namespace asn1::rrc;
+
+  std::vector<corpus_pdu_t>               corpus;
+  std::unique_ptr<LIBLTE_BYTE_MSG_STRUCT> nas(new LIBLTE_BYTE_MSG_STRUCT);
+  const srsran::lte_srb                   srb0 = srsran::lte_srb::srb0;
+  const srsran::lte_srb                   srb1 = srsran::lte_srb::srb1;
+
+  // RRCConnectionRequest
+  {
+    ul_ccch_msg_s              msg;
+    rrc_conn_request_r8_ies_s& req = msg.msg.set_c1().set_rrc_conn_request().crit_exts.set_rrc_conn_request_r8();
+    req.ue_id.set_random_value().from_number(0x1234567);
+    req.establishment_cause.value = establishment_cause_opts::mo_sig;
+    push_rrc(corpus, corpus_dir_t::from_ue, srb0, msg);
+  }
+
+  // RRCConnectionSetup
+  {
+    dl_ccch_msg_s     msg;
+    rrc_conn_setup_s& setup = msg.msg.set_c1().set_rrc_conn_setup();
+    setup.rrc_transaction_id = 0;
+    rrc_conn_setup_r8_ies_s& ies = setup.crit_exts.set_c1().set_rrc_conn_setup_r8();
+    ies.rr_cfg_ded.srb_to_add_mod_list_present = true;
+    ies.rr_cfg_ded.srb_to_add_mod_list.resize(1);
+    ies.rr_cfg_ded.srb_to_add_mod_list[0].srb_id = 1;
+    push_rrc(corpus, corpus_dir_t::from_enb, srb0, msg);
+  }
+
+  // RRCConnectionSetupComplete + Attach Request
+  {
+    ul_dcch_msg_s              msg;
+    rrc_conn_setup_complete_s& complete = msg.msg.set_c1().set_rrc_conn_setup_complete();
+    complete.rrc_transaction_id         = 0;
+    rrc_conn_setup_complete_r8_ies_s& ies = complete.crit_exts.set_c1().set_rrc_conn_setup_complete_r8();
+
+    std::unique_ptr<LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT> attach_req(new LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT{});
+    attach_req->eps_attach_type                      = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+    attach_req->nas_ksi.nas_ksi                      = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+    attach_req->eps_mobile_id.type_of_id             = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+    const uint8_t imsi[15]                           = {0, 0, 1, 0, 1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    memcpy(attach_req->eps_mobile_id.imsi, imsi, sizeof(imsi));
+    attach_req->ue_network_cap.eea[0] = attach_req->ue_network_cap.eea[2] = true;
+    attach_req->ue_network_cap.eia[2]                                       = true;
+    // PDN Connectivity Request
+    const uint8_t esm[] = {0x02, 0x01, 0xd0, 0x11, 0x27, 0x1a, 0x80, 0x80};
+    attach_req->esm_msg.N_bytes = sizeof(esm);
+    memcpy(attach_req->esm_msg.msg, esm, sizeof(esm));
+    liblte_mme_pack_attach_request_msg(attach_req.get(), nas.get());
+    pack_eps_nas(*nas, ies.ded_info_nas);
+    push_rrc(corpus, corpus_dir_t::from_ue, srb1, msg);
+  }
+
+  // DLInformationTransfer + Authentication Request
+  {
+    dl_dcch_msg_s       msg;
+    dl_info_transfer_s& transfer = msg.msg.set_c1().set_dl_info_transfer();
+    transfer.rrc_transaction_id  = 0;
+    dl_info_transfer_r8_ies_s& ies = transfer.crit_exts.set_c1().set_dl_info_transfer_r8();
+
+    LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req = {};
+    memset(auth_req.rand, 0x3c, sizeof(auth_req.rand));
+    memset(auth_req.autn, 0xc3, sizeof(auth_req.autn));
+    liblte_mme_pack_authentication_request_msg(&auth_req, nas.get());
+    pack_eps_nas(*nas, ies.ded_info_type.set_ded_info_nas());
+    push_rrc(corpus, corpus_dir_t::from_enb, srb1, msg);
+  }
+
+  // ULInformationTransfer + Authentication Response
+  {
+    ul_dcch_msg_s              msg;
+    ul_info_transfer_r8_ies_s& ies =
+        msg.msg.set_c1().set_ul_info_transfer().crit_exts.set_c1().set_ul_info_transfer_r8();
+    asn1::dyn_octstring& auth_resp = ies.ded_info_type.set_ded_info_nas();
+    fill_pattern(auth_resp, 11, 0xa5);
+    auth_resp[0] = 0x07; // EMM, plain
+    auth_resp[1] = LIBLTE_MME_MSG_TYPE_AUTHENTICATION_RESPONSE;
+    auth_resp[2] = 8;
+    push_rrc(corpus, corpus_dir_t::from_ue, srb1, msg);
+  }
+
+  // DLInformationTransfer + integrity protected NAS Security Mode Command
+  {
+    dl_dcch_msg_s              msg;
+    dl_info_transfer_r8_ies_s& ies =
+        msg.msg.set_c1().set_dl_info_transfer().crit_exts.set_c1().set_dl_info_transfer_r8();
+
+    LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT smc = {};
+    smc.selected_nas_sec_algs.type_of_eea           = LIBLTE_MME_TYPE_OF_CIPHERING_ALGORITHM_128_EEA2;
+    smc.selected_nas_sec_algs.type_of_eia           = LIBLTE_MME_TYPE_OF_INTEGRITY_ALGORITHM_128_EIA2;
+    smc.ue_security_cap.eea[0] = smc.ue_security_cap.eea[2] = true;
+    smc.ue_security_cap.eia[2]                              = true;
+    liblte_mme_pack_security_mode_command_msg(
+        &smc, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_WITH_NEW_EPS_SECURITY_CONTEXT, 0, nas.get());
+    pack_eps_nas(*nas, ies.ded_info_type.set_ded_info_nas());
+    push_rrc(corpus, corpus_dir_t::from_enb, srb1, msg);
+  }
+
+  // SecurityModeCommand
+  {
+    dl_dcch_msg_s              msg;
+    security_mode_cmd_r8_ies_s& ies =
+        msg.msg.set_c1().set_security_mode_cmd().crit_exts.set_c1().set_security_mode_cmd_r8();
+    ies.security_cfg_smc.security_algorithm_cfg.ciphering_algorithm.value = ciphering_algorithm_r12_opts::eea2;
+    ies.security_cfg_smc.security_algorithm_cfg.integrity_prot_algorithm.value =
+        security_algorithm_cfg_s::integrity_prot_algorithm_opts::eia2;
+    push_rrc(corpus, corpus_dir_t::from_enb, srb1, msg);
+  }
+
+  // RRCConnectionReconfiguration + ciphered Attach Accept
+  {
+    dl_dcch_msg_s            msg;
+    rrc_conn_recfg_r8_ies_s& ies = msg.msg.set_c1().set_rrc_conn_recfg().crit_exts.set_c1().set_rrc_conn_recfg_r8();
+    ies.ded_info_nas_list_present = true;
+    ies.ded_info_nas_list.resize(1);
+    fill_pattern(ies.ded_info_nas_list[0], 120, 0x5a);
+    ies.ded_info_nas_list[0][0] = 0x27; // EMM, integrity protected and ciphered
+    push_rrc(corpus, corpus_dir_t::from_enb, srb1, msg);
+  }
+
+  return corpus;
+}
+
+static bool read_corpus_file(const std::string& filename, std::vector<corpus_pdu_t>& corpus)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (not file.is_open()) {
+    fprintf(stderr, "Couldn't open corpus file %s\n", filename.c_str());
+    return false;
+  }
+
+  uint8_t hdr[3];
+  while (file.read(reinterpret_cast<char*>(hdr), sizeof(hdr))) {
+    corpus_pdu_t pdu;
+    pdu.dir = (hdr[0] == 0) ? corpus_dir_t::from_ue : corpus_dir_t::from_enb;
+    pdu.datagram.resize(((uint32_t)hdr[1] << 8u) | hdr[2]);
+    if (not file.read(reinterpret_cast<char*>(pdu.datagram.data()), pdu.datagram.size())) {
+      fprintf(stderr, "Truncated record in corpus file %s\n", filename.c_str());
+      return false;
+    }
+    corpus.push_back(std::move(pdu));
+  }
+  return not corpus.empty();
+}
+
+static int decode_into(corpus_pdu_t& pdu, asn1::json_writer& json_buffer)
+{
+  rat_codec::decode_fn decoder = pdu.dir == corpus_dir_t::from_ue ? lte_codec.decode_ul : lte_codec.decode_dl;
+  return decoder(pdu.datagram.data(), pdu.datagram.size(), json_buffer);
+}
+
+static std::string decode_pdu(corpus_pdu_t& pdu)
+{
+  asn1::json_writer json_buffer;
+  json_buffer.start_array();
+  decode_into(pdu, json_buffer);
+  json_buffer.end_array();
+  return json_buffer.to_string();
+}
+
+// Replaces the NAS of every message that carries some with a Detach Request, which the rendering of the spoofed
+// datagram must show
+static int check_spoofing(std::vector<corpus_pdu_t>& corpus)
+{
+  const std::string detach_request = "0745090bf600f110000201030003e6";
+  for (corpus_pdu_t& pdu : corpus) {
+    rat_codec::spoof_fn spoof   = pdu.dir == corpus_dir_t::from_ue ? lte_codec.spoof_ul : lte_codec.spoof_dl;
+    std::string         verdict = "{\"NAS-PDU\": \"" + detach_request + "\"}";
+    int                 size    = 0;
+    uint8_t*            spoofed = spoof(verdict, pdu.datagram.data(), pdu.datagram.size(), size);
+    bool                carries_nas = decode_pdu(pdu).find("EPS NAS") != std::string::npos;
+    if (not carries_nas) {
+      // left unchanged
+      if (size != (int)pdu.datagram.size() or memcmp(spoofed, pdu.datagram.data(), size) != 0) {
+        fprintf(stderr, "A message without NAS was spoofed\n");
+        return SRSRAN_ERROR;
+      }
+      continue;
+    }
+    corpus_pdu_t spoofed_pdu = {pdu.dir, std::vector<uint8_t>(spoofed, spoofed + size)};
+    std::string  json        = decode_pdu(spoofed_pdu);
+    if (json.find("DETACH_REQUEST") == std::string::npos or json.find("Encrypted EPS NAS") != std::string::npos) {
+      fprintf(stderr, "The NAS of a message was not spoofed:\n%s\n", json.c_str());
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::init();
+
+  std::vector<corpus_pdu_t> corpus;
+  if (corpus_file.empty()) {
+    corpus = make_builtin_corpus();
+  } else if (not read_corpus_file(corpus_file, corpus)) {
+    return SRSRAN_ERROR;
+  }
+
+  if (check_spoofing(corpus) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  uint64_t nof_bytes = 0, nof_json_bytes = 0;
+  auto     tstart    = std::chrono::steady_clock::now();
+  for (uint32_t rep = 0; rep < nof_repetitions; ++rep) {
+    for (corpus_pdu_t& pdu : corpus) {
+      asn1::json_writer json_buffer;
+      json_buffer.start_array();
+      decode_into(pdu, json_buffer);
+      json_buffer.end_array();
+      nof_bytes += pdu.datagram.size();
+      nof_json_bytes += json_buffer.to_string().size();
+    }
+  }
+  auto   tend    = std::chrono::steady_clock::now();
+  double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(tend - tstart).count() / 1e9;
+
+  uint64_t nof_pdus = (uint64_t)corpus.size() * nof_repetitions;
+  printf("Decoded %lu PDUs (%lu bytes, %lu JSON bytes) in %.3f s\n", nof_pdus, nof_bytes, nof_json_bytes, elapsed);
+  printf("  %.1f kPDU/s, %.2f us/PDU\n", nof_pdus / elapsed / 1e3, elapsed * 1e6 / nof_pdus);
+  printf("Checked that a NAS spoofing verdict replaces the NAS of every message that carries some\n");
+
+  srslog::flush();
+
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,282 @@
+/**
+ * Benchmark of the MAC-level tap.
+ *
+ * Transport blocks are built with mac_sch_pdu_nr as a UE and a gNB would: UL-SCH TBs with C-RNTI, BSR and PHR CEs in
+ * front of an SRB and a DRB SDU, DRB-only TBs and DL-SCH TBs with a contention resolution identity. The check pass
+ * verifies that the tap tells the TBs for the scenario handler from the user-plane ones, renders the CEs and hands
+ * every SDU to the decoder unchanged, that a TB rebuilt around a spoofed SDU keeps its length and its other sub-PDUs,
+ * and that malformed TBs are rejected. The timed pass measures the lane classification, the worker decode and the
+ * rebuild per TB.
+ */
+
+#include "src/mac_tap.h"
+
+#include "mitm_lib/common/common_nr.h"
+#include "mitm_lib/config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+
+static uint32_t nof_repetitions = 100000;
+static uint32_t tb_len          = 1500;
+
+static const uint32_t srb_sdu_len = 40;
+static const uint16_t crnti       = 0x4601;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nlh]\n", prog);
+  printf("\t-n Number of TBs per pass [Default %d]\n", nof_repetitions);
+  printf("\t-l TB length [Default %d]\n", tb_len);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nlh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        tb_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+// SDUs the tap handed to the decoder
+struct decoded_sdu_t {
+  uint32_t             lcid;
+  std::vector<uint8_t> sdu;
+};
+static std::vector<decoded_sdu_t> decoded;
+static uint64_t                   nof_decoded = 0;
+
+static int record_sdu(uint32_t lcid, uint8_t* sdu, int n, asn1::json_writer& json_buffer)
+{
+  decoded.push_back({lcid, std::vector<uint8_t>(sdu, sdu + n)});
+  return 0;
+}
+
+static int count_sdu(uint32_t lcid, uint8_t* sdu, int n, asn1::json_writer& json_buffer)
+{
+  nof_decoded++;
+  return 0;
+}
+
+static std::vector<uint8_t> make_sdu(uint32_t len, uint8_t seed)
+{
+  std::vector<uint8_t> sdu(len);
+  for (uint32_t i = 0; i < len; i++) {
+    sdu[i] = (uint8_t)(seed + i * 7);
+  }
+  return sdu;
+}
+
+// UL-SCH TB with C-RNTI, short BSR and PHR CEs, then an SRB1 SDU unless drb_only, then a DRB SDU filling most of the TB
+static srsran::unique_byte_buffer_t make_ul_tb(bool drb_only, const std::vector<uint8_t>& srb_sdu,
+                                               const std::vector<uint8_t>& drb_sdu)
+{
+  srsran::unique_byte_buffer_t tb = srsran::make_byte_buffer();
+  srsran::mac_sch_pdu_nr       pdu(true);
+  pdu.init_tx(tb.get(), tb_len, true);
+  if (not drb_only) {
+    pdu.add_crnti_ce(crnti);
+    pdu.add_sbsr_ce({2, 17});
+    pdu.add_se_phr_ce(40, 50);
+    pdu.add_sdu((uint32_t)srsran::nr_srb::srb1, srb_sdu.data(), srb_sdu.size());
+  }
+  pdu.add_sdu(4, drb_sdu.data(), drb_sdu.size());
+  pdu.pack();
+  return tb;
+}
+
+static bool check_sdu(const decoded_sdu_t& d, uint32_t lcid, const std::vector<uint8_t>& sdu)
+{
+  if (d.lcid != lcid or d.sdu != sdu) {
+    fprintf(stderr, "SDU on LCID %d decoded as %zd B on LCID %d\n", lcid, d.sdu.size(), d.lcid);
+    return false;
+  }
+  return true;
+}
+
+static bool check_ulsch(const std::vector<uint8_t>& srb_sdu, const std::vector<uint8_t>& drb_sdu)
+{
+  mac_tap                      tap(true, record_sdu);
+  srsran::unique_byte_buffer_t tb = make_ul_tb(false, srb_sdu, drb_sdu);
+  if (tb->N_bytes != tb_len) {
+    fprintf(stderr, "UL-SCH TB of %d B built, expected %d\n", tb->N_bytes, tb_len);
+    return false;
+  }
+
+  asn1::json_writer json_buffer;
+  decoded.clear();
+  json_buffer.start_array();
+  if (tap.decode(tb->msg, tb->N_bytes, json_buffer) != 0 or not tap.needs_verdict() or tap.find_srb_sdu() != 3) {
+    fprintf(stderr, "UL-SCH TB with an SRB SDU not decoded for the scenario handler\n");
+    return false;
+  }
+  json_buffer.end_array();
+  std::string json = json_buffer.to_string();
+  for (const char* field :
+       {"\"C-RNTI\": 17921", "\"Short BSR\"", "\"BufferSize\": 17", "\"PH\": 40", "\"PCMAX\": 50"}) {
+    if (json.find(field) == std::string::npos) {
+      fprintf(stderr, "%s missing from the rendered CEs: %s\n", field, json.c_str());
+      return false;
+    }
+  }
+  if (decoded.size() != 2 or not check_sdu(decoded[0], 1, srb_sdu) or not check_sdu(decoded[1], 4, drb_sdu)) {
+    return false;
+  }
+
+  // A longer spoofed SDU eats into the padding, the rest of the TB is unchanged
+  std::vector<uint8_t>  spoofed = make_sdu(srb_sdu_len + 20, 99);
+  srsran::byte_buffer_t rebuilt;
+  if (tap.repack(3, spoofed.data(), spoofed.size(), rebuilt) != SRSRAN_SUCCESS or rebuilt.N_bytes != tb_len) {
+    fprintf(stderr, "UL-SCH TB not rebuilt around the spoofed SDU\n");
+    return false;
+  }
+  decoded.clear();
+  if (tap.decode(rebuilt.msg, rebuilt.N_bytes, json_buffer) != 0 or decoded.size() != 2 or
+      not check_sdu(decoded[0], 1, spoofed) or not check_sdu(decoded[1], 4, drb_sdu) or
+      tap.get_subpdu(0).get_c_rnti() != crnti) {
+    fprintf(stderr, "Rebuilt UL-SCH TB does not carry the spoofed SDU and the original sub-PDUs\n");
+    return false;
+  }
+
+  // A spoofed SDU that does not fit is refused
+  std::vector<uint8_t> too_long = make_sdu(tb_len, 1);
+  if (tap.repack(3, too_long.data(), too_long.size(), rebuilt) == SRSRAN_SUCCESS) {
+    fprintf(stderr, "Spoofed SDU larger than the TB accepted\n");
+    return false;
+  }
+
+  // A TB of DRB SDUs and padding stays on the lane
+  tb = make_ul_tb(true, srb_sdu, drb_sdu);
+  if (tap.unpack(tb->msg, tb->N_bytes) != SRSRAN_SUCCESS or tap.needs_verdict() or tap.find_srb_sdu() != -1) {
+    fprintf(stderr, "DRB-only UL-SCH TB sent to the scenario handler\n");
+    return false;
+  }
+  return true;
+}
+
+static bool check_dlsch(const std::vector<uint8_t>& srb_sdu)
+{
+  mac_tap                      tap(false, record_sdu);
+  srsran::unique_byte_buffer_t tb = srsran::make_byte_buffer();
+  srsran::mac_sch_pdu_nr       pdu(false);
+  pdu.init_tx(tb.get(), 100, false);
+  pdu.add_ue_con_res_id_ce({1, 2, 3, 4, 5, 6});
+  pdu.add_sdu((uint32_t)srsran::nr_srb::srb0, srb_sdu.data(), srb_sdu.size());
+  pdu.pack();
+
+  asn1::json_writer json_buffer;
+  decoded.clear();
+  json_buffer.start_array();
+  if (tap.decode(tb->msg, tb->N_bytes, json_buffer) != 0 or decoded.size() != 1 or
+      not check_sdu(decoded[0], 0, srb_sdu)) {
+    fprintf(stderr, "DL-SCH TB not decoded\n");
+    return false;
+  }
+  json_buffer.end_array();
+  std::string json = json_buffer.to_string();
+  if (json.find("UE Contention Resolution Identity") == std::string::npos or
+      json.find("010203040506") == std::string::npos) {
+    fprintf(stderr, "Contention resolution identity missing from the rendered CEs: %s\n", json.c_str());
+    return false;
+  }
+  return true;
+}
+
+static bool check_malformed()
+{
+  mac_tap              tap(true, record_sdu);
+  std::vector<uint8_t> srb_sdu = make_sdu(srb_sdu_len, 3);
+  std::vector<uint8_t> drb_sdu = make_sdu(tb_len / 2, 5);
+
+  // Truncated in the middle of the DRB SDU
+  srsran::unique_byte_buffer_t tb = make_ul_tb(false, srb_sdu, drb_sdu);
+  if (tap.unpack(tb->msg, 60) != SRSRAN_ERROR) {
+    fprintf(stderr, "Truncated TB accepted\n");
+    return false;
+  }
+
+  // More sub-PDUs than are kept in place: short BSRs, 2 B each
+  std::vector<uint8_t> bsrs(2 * (srsran::mac_sch_pdu_nr::max_num_subpdus + 1));
+  for (uint32_t i = 0; i < bsrs.size(); i += 2) {
+    bsrs[i] = srsran::mac_sch_subpdu_nr::SHORT_BSR;
+  }
+  if (tap.unpack(bsrs.data(), bsrs.size()) != SRSRAN_ERROR or
+      tap.unpack(bsrs.data(), bsrs.size() - 2) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "TB with too many sub-PDUs accepted, or one with the maximum refused\n");
+    return false;
+  }
+  return tap.get_metrics().malformed == 2;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::fetch_basic_logger("MAC-NR", false).set_level(srslog::basic_levels::none);
+
+  std::vector<uint8_t> srb_sdu = make_sdu(srb_sdu_len, 3);
+  std::vector<uint8_t> drb_sdu = make_sdu(tb_len / 2, 5);
+  if (not check_ulsch(srb_sdu, drb_sdu) or not check_dlsch(srb_sdu) or not check_malformed()) {
+    return SRSRAN_ERROR;
+  }
+
+  // Every other TB carries CEs and an SRB SDU
+  srsran::unique_byte_buffer_t tbs[2] = {make_ul_tb(false, srb_sdu, drb_sdu), make_ul_tb(true, srb_sdu, drb_sdu)};
+  mac_tap                      tap(true, count_sdu);
+
+  uint32_t nof_verdicts = 0;
+  auto     start        = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; i++) {
+    srsran::byte_buffer_t& tb = *tbs[i % 2];
+    if (tap.unpack(tb.msg, tb.N_bytes) != SRSRAN_SUCCESS or tap.needs_verdict()) {
+      nof_verdicts++;
+    }
+  }
+  std::chrono::duration<double, std::nano> classify_time = std::chrono::high_resolution_clock::now() - start;
+
+  asn1::json_writer json_buffer;
+  start = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; i++) {
+    json_buffer = asn1::json_writer();
+    json_buffer.start_array();
+    tap.decode(tbs[0]->msg, tbs[0]->N_bytes, json_buffer);
+    json_buffer.end_array();
+  }
+  std::chrono::duration<double, std::nano> decode_time = std::chrono::high_resolution_clock::now() - start;
+
+  srsran::byte_buffer_t rebuilt;
+  uint32_t              nof_rebuilt = 0;
+  start                             = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; i++) {
+    nof_rebuilt += tap.repack(3, srb_sdu.data(), srb_sdu.size(), rebuilt) == SRSRAN_SUCCESS ? 1 : 0;
+  }
+  std::chrono::duration<double, std::nano> repack_time = std::chrono::high_resolution_clock::now() - start;
+
+  if (nof_verdicts != (nof_repetitions + 1) / 2 or nof_decoded != 2 * (uint64_t)nof_repetitions or
+      nof_rebuilt != nof_repetitions or rebuilt.N_bytes != tb_len) {
+    fprintf(
+        stderr, "Timed pass: %d verdicts, %ld SDUs decoded, %d TBs rebuilt\n", nof_verdicts, nof_decoded, nof_rebuilt);
+    return SRSRAN_ERROR;
+  }
+
+  printf("MAC tap, %d B UL-SCH TBs, %d TBs per pass\n", tb_len, nof_repetitions);
+  printf("\tclassify: %.1f ns/TB\n", classify_time.count() / nof_repetitions);
+  printf("\tdecode:   %.1f ns/TB (3 CEs rendered, 2 SDUs)\n", decode_time.count() / nof_repetitions);
+  printf("\trepack:   %.1f ns/TB\n", repack_time.count() / nof_repetitions);
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,532 @@
+/**
+ * Benchmark for the NGAP/S1AP relay of N2.
+ *
+ * The first pass checks the codec path: the NAS PDUs of an NGAP InitialUEMessage and DownlinkNASTransport and of an
+ * S1AP InitialUEMessage are found and rendered, a spoofing verdict replaces them or the whole message, and malformed
+ * messages and verdicts are refused. The second pass runs the lanes against a scenario handler on the loopback
+ * interface: while the verdict of a message of one stream is held back, the messages of another stream go through, in
+ * order, and every verdict is applied. The timed pass then measures the relay rate over 8 streams, with immediate
+ * verdicts. These passes involve no SCTP association, the relay sends into a capture. Last, a message is relayed each
+ * way between a RAN node and a core over loopback SCTP associations, if the kernel supports SCTP.
+ */
+
+#include "src/n2_relay.h"
+
+#include "mitm_lib/asn1/nas_5g_msg.h"
+#include "mitm_lib/asn1/ngap.h"
+#include "mitm_lib/asn1/s1ap.h"
+#include "mitm_lib/common/buffer_pool.h"
+#include "mitm_lib/config.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <netinet/sctp.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static uint32_t nof_repetitions = 100;
+
+static const uint32_t nof_streams = 8;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [n]\n", prog);
+  printf("\t-n Number of rounds of %d messages of the timed pass [Default %d]\n", nof_streams * 8, nof_repetitions);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+template <class Pdu>
+static std::vector<uint8_t> pack_pdu(const Pdu& pdu)
+{
+  std::vector<uint8_t> msg(4096);
+  asn1::bit_ref        bref(msg.data(), msg.size());
+  if (pdu.pack(bref) != asn1::SRSASN_SUCCESS) {
+    fprintf(stderr, "Failed to pack a test message\n");
+    exit(SRSRAN_ERROR);
+  }
+  msg.resize(bref.distance_bytes());
+  return msg;
+}
+
+static void pack_nas(srsran::nas_5g::nas_5gs_msg& nas, asn1::unbounded_octstring<true>& octs)
+{
+  srsran::unique_byte_buffer_t buf = srsran::make_byte_buffer();
+  nas.pack(buf);
+  octs.resize(buf->N_bytes);
+  memcpy(octs.data(), buf->msg, buf->N_bytes);
+}
+
+// InitialUEMessage with a Registration Request, as a gNB sends it for a new UE
+static std::vector<uint8_t> make_initial_ue_message(uint64_t ran_ue_ngap_id)
+{
+  using namespace asn1::ngap;
+  using namespace srsran::nas_5g;
+
+  ngap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_NGAP_ID_INIT_UE_MSG);
+  init_ue_msg_ies_container& msg = *pdu.init_msg().value.init_ue_msg();
+  msg.ran_ue_ngap_id.value       = ran_ue_ngap_id;
+  msg.user_location_info.value.set_user_location_info_nr();
+  msg.rrcestablishment_cause.value = rrcestablishment_cause_opts::mo_sig;
+
+  nas_5gs_msg             nas;
+  registration_request_t& reg_req = nas.set_registration_request();
+  reg_req.registration_type_5gs.registration_type =
+      registration_type_5gs_t::registration_type_type_::options::initial_registration;
+  mobile_identity_5gs_t::suci_s& suci = reg_req.mobile_identity_5gs.set_suci();
+  suci.supi_format                    = mobile_identity_5gs_t::suci_s::supi_format_type_::options::imsi;
+  suci.mcc                            = {0, 0, 1};
+  suci.mnc                            = {0, 1, 0xf};
+  suci.routing_indicator              = {0, 0xf, 0xf, 0xf};
+  suci.protection_scheme_id = mobile_identity_5gs_t::suci_s::protection_scheme_id_type_::options::null_scheme;
+  suci.scheme_output        = {0x21, 0x43, 0x65, 0x87, 0x09};
+  pack_nas(nas, msg.nas_pdu.value);
+  return pack_pdu(pdu);
+}
+
+// DownlinkNASTransport with an Authentication Request
+static std::vector<uint8_t> make_dl_nas_transport()
+{
+  using namespace asn1::ngap;
+  using namespace srsran::nas_5g;
+
+  ngap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_NGAP_ID_DL_NAS_TRANSPORT);
+  dl_nas_transport_ies_container& msg = *pdu.init_msg().value.dl_nas_transport();
+  msg.amf_ue_ngap_id.value            = 1;
+  msg.ran_ue_ngap_id.value            = 1;
+
+  nas_5gs_msg               nas;
+  authentication_request_t& auth_req             = nas.set_authentication_request();
+  auth_req.abba.abba_contents                    = {0x00, 0x00};
+  auth_req.authentication_parameter_rand_present = true;
+  auth_req.authentication_parameter_rand.rand.fill(0x3c);
+  auth_req.authentication_parameter_autn_present = true;
+  auth_req.authentication_parameter_autn.autn.assign(16, 0xc3);
+  pack_nas(nas, msg.nas_pdu.value);
+  return pack_pdu(pdu);
+}
+
+// S1AP InitialUEMessage with an EPS Attach Request, whose content does not matter to the relay
+static std::vector<uint8_t> make_s1ap_initial_ue_message()
+{
+  using namespace asn1::s1ap;
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+  init_ue_msg_ies_container& msg = *pdu.init_msg().value.init_ue_msg();
+  msg.enb_ue_s1ap_id.value       = 1;
+  msg.nas_pdu.value.from_string("0741720bf600f110000201030003e605f07000001000050215d011d1");
+  msg.rrc_establishment_cause.value = rrc_establishment_cause_opts::mo_sig;
+  return pack_pdu(pdu);
+}
+
+static std::vector<uint8_t> ngap_nas_pdu(const std::vector<uint8_t>& msg)
+{
+  asn1::ngap::ngap_pdu_c pdu;
+  asn1::cbit_ref         bref(msg.data(), msg.size());
+  if (pdu.unpack(bref) != asn1::SRSASN_SUCCESS or
+      pdu.init_msg().value.type().value != asn1::ngap::ngap_elem_procs_o::init_msg_c::types_opts::init_ue_msg) {
+    return {};
+  }
+  const asn1::unbounded_octstring<true>& nas = pdu.init_msg().value.init_ue_msg()->nas_pdu.value;
+  return std::vector<uint8_t>(nas.data(), nas.data() + nas.size());
+}
+
+static int check_codec(sockaddr_in& scenario_addr, std::mutex& decode_mutex)
+{
+  n2_relay::send_fn discard = [](n2_relay::direction_t, uint16_t, const uint8_t*, uint32_t) {};
+  n2_relay          ngap(n2_relay::NGAP, scenario_addr, decode_mutex, discard);
+  n2_relay          s1ap(n2_relay::S1AP, scenario_addr, decode_mutex, discard);
+
+  std::vector<uint8_t> init_ue = make_initial_ue_message(1);
+  std::vector<uint8_t> dl_nas  = make_dl_nas_transport();
+  std::vector<uint8_t> s1_init = make_s1ap_initial_ue_message();
+  struct {
+    const n2_relay*             relay;
+    n2_relay::direction_t       dir;
+    const std::vector<uint8_t>& msg;
+    const char*                 expected;
+  } cases[] = {{&ngap, n2_relay::FROM_RAN, init_ue, "Registration request"},
+               {&ngap, n2_relay::FROM_CORE, dl_nas, "Authentication request"},
+               {&s1ap, n2_relay::FROM_RAN, s1_init, "EPS NAS"}};
+  for (auto& c : cases) {
+    asn1::json_writer json_buffer;
+    json_buffer.start_array();
+    int nof_nas = c.relay->decode(c.dir, c.msg.data(), c.msg.size(), json_buffer);
+    json_buffer.end_array();
+    std::string json = json_buffer.to_string();
+    if (nof_nas != 1 or json.find(c.expected) == std::string::npos) {
+      fprintf(stderr, "Unexpected rendering with %d NAS PDUs, expected %s:\n%s\n", nof_nas, c.expected, json.c_str());
+      return SRSRAN_ERROR;
+    }
+  }
+
+  // The NAS PDU of a spoofed InitialUEMessage is replaced, the rest of the message is kept
+  std::vector<uint8_t> spoofed;
+  std::vector<uint8_t> expected_nas = {0x7e, 0x00, 0x41, 0x79, 0x00, 0x01, 0xf1};
+  if (ngap.spoof("{\"NAS-PDU\": [\"7e0041790001f1\"]}", init_ue.data(), init_ue.size(), spoofed) !=
+          SRSRAN_SUCCESS or
+      ngap_nas_pdu(spoofed) != expected_nas) {
+    fprintf(stderr, "The NAS PDU was not spoofed\n");
+    return SRSRAN_ERROR;
+  }
+  if (ngap.spoof("{\"NAS-PDU\": \"7E00417900\"}", init_ue.data(), init_ue.size(), spoofed) != SRSRAN_SUCCESS or
+      ngap_nas_pdu(spoofed).size() != 5) {
+    fprintf(stderr, "The NAS PDU was not spoofed from a single string\n");
+    return SRSRAN_ERROR;
+  }
+  if (ngap.spoof("{\"PDU\": \"0102ff\"}", init_ue.data(), init_ue.size(), spoofed) != SRSRAN_SUCCESS or
+      spoofed != std::vector<uint8_t>{0x01, 0x02, 0xff}) {
+    fprintf(stderr, "The message was not spoofed\n");
+    return SRSRAN_ERROR;
+  }
+  if (s1ap.spoof("{\"NAS-PDU\": \"0745\"}", s1_init.data(), s1_init.size(), spoofed) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "The EPS NAS PDU was not spoofed\n");
+    return SRSRAN_ERROR;
+  }
+
+  // More NAS PDUs than the message has, bad hex (also outside ASCII), verdicts that are not objects and malformed
+  // messages
+  const char* bad_verdicts[] = {"{\"NAS-PDU\": [\"7e\", \"7e\"]}",
+                                "{\"NAS-PDU\": \"7g\"}",
+                                "{\"NAS-PDU\": \"7e0\"}",
+                                "{\"NAS-PDU\": \"7e\xc3\xa9\"}",
+                                "{\"PDU\": \"00\xc3\xa9\"}",
+                                "[\"7e\"]",
+                                "{\"SDU\": \"7e\"}",
+                                "{"};
+  for (const char* verdict : bad_verdicts) {
+    if (ngap.spoof(verdict, init_ue.data(), init_ue.size(), spoofed) != SRSRAN_ERROR) {
+      fprintf(stderr, "Verdict %s was applied\n", verdict);
+      return SRSRAN_ERROR;
+    }
+  }
+  uint8_t           truncated[] = {0x00, 0x0f, 0x40, 0x50};
+  asn1::json_writer json_buffer;
+  if (ngap.decode(n2_relay::FROM_RAN, truncated, sizeof(truncated), json_buffer) != SRSRAN_ERROR or
+      ngap.spoof("{\"NAS-PDU\": \"7e\"}", truncated, sizeof(truncated), spoofed) != SRSRAN_ERROR) {
+    fprintf(stderr, "A truncated message was decoded\n");
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// Messages the relay sent, in order
+struct capture_t {
+  std::mutex                                               mutex;
+  std::condition_variable                                  cvar;
+  std::vector<std::pair<uint16_t, std::vector<uint8_t> > > sent;
+
+  void push(uint16_t stream, const uint8_t* msg, uint32_t len)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      sent.emplace_back(stream, std::vector<uint8_t>(msg, msg + len));
+    }
+    cvar.notify_all();
+  }
+
+  bool wait(size_t nof_sent)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cvar.wait_for(lock, std::chrono::seconds(5), [this, nof_sent] { return sent.size() >= nof_sent; });
+  }
+};
+
+// Scenario handler answering every message with the verdict of the moment, except for the first one, which is answered
+// once release is set
+struct scenario_handler_t {
+  int                   sock;
+  std::atomic<bool>     running{true};
+  std::atomic<bool>     release{false};
+  std::atomic<uint32_t> nof_received{0};
+  std::string           verdict = std::string(1, '\0');
+  std::mutex            mutex;
+
+  void set_verdict(const std::string& v)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    verdict = v;
+  }
+
+  void run()
+  {
+    char        buf[65535];
+    sockaddr_in held = {}, from;
+    while (running) {
+      socklen_t len = sizeof(from);
+      int       n   = recvfrom(sock, buf, sizeof(buf), 0, (sockaddr*)&from, &len);
+      if (release and held.sin_port != 0) {
+        sendto(sock, "\0", 1, 0, (sockaddr*)&held, sizeof(held));
+        held.sin_port = 0;
+      }
+      if (n <= 0) {
+        continue;
+      }
+      if (nof_received++ == 0) {
+        held = from;
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      sendto(sock, verdict.data(), verdict.size(), 0, (sockaddr*)&from, sizeof(from));
+    }
+  }
+};
+
+// SCTP socket as the RAN node and the core use it: with the stream of each message, and a receive timeout
+static int open_sctp_socket()
+{
+  int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP);
+  if (fd < 0) {
+    return -1;
+  }
+  sctp_initmsg init_opts        = {};
+  init_opts.sinit_num_ostreams  = n2_sctp::max_streams;
+  init_opts.sinit_max_instreams = n2_sctp::max_streams;
+  sctp_event_subscribe events   = {};
+  events.sctp_data_io_event     = 1;
+  timeval timeout               = {5, 0};
+  setsockopt(fd, IPPROTO_SCTP, SCTP_INITMSG, &init_opts, sizeof(init_opts));
+  setsockopt(fd, IPPROTO_SCTP, SCTP_EVENTS, &events, sizeof(events));
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  return fd;
+}
+
+// Receives the next data message on fd, skipping notifications. Returns false on timeout or error
+static bool recv_sctp(int fd, std::vector<uint8_t>& msg, uint16_t& stream)
+{
+  msg.resize(n2_sctp::max_msg);
+  while (true) {
+    sctp_sndrcvinfo sri   = {};
+    int             flags = 0;
+    int             n     = sctp_recvmsg(fd, msg.data(), msg.size(), nullptr, nullptr, &sri, &flags);
+    if (n <= 0) {
+      return false;
+    }
+    if (not(flags & MSG_NOTIFICATION)) {
+      msg.resize(n);
+      stream = sri.sinfo_stream;
+      return true;
+    }
+  }
+}
+
+// Round trip over loopback SCTP associations: a RAN node connects to the relay, which connects to a core, and a message
+// of each is relayed to the other on the stream it came in on. Skipped if the kernel has no SCTP support
+static int check_sctp_round_trip(const sockaddr_in& scenario_addr, std::mutex& decode_mutex)
+{
+  int core_listen_fd = open_sctp_socket();
+  if (core_listen_fd < 0) {
+    printf("No SCTP support (%s), skipped the SCTP round trip\n", strerror(errno));
+    return SRSRAN_SUCCESS;
+  }
+  sockaddr_in core_addr     = {};
+  core_addr.sin_family      = AF_INET;
+  core_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+  sockaddr_in relay_addr    = core_addr;
+  socklen_t   len           = sizeof(core_addr);
+  if (bind(core_listen_fd, (sockaddr*)&core_addr, sizeof(core_addr)) < 0 or listen(core_listen_fd, 1) < 0 or
+      getsockname(core_listen_fd, (sockaddr*)&core_addr, &len) < 0) {
+    perror("SCTP core");
+    return SRSRAN_ERROR;
+  }
+  // A free port for the relay to listen on
+  int probe_fd = open_sctp_socket();
+  len          = sizeof(relay_addr);
+  if (bind(probe_fd, (sockaddr*)&relay_addr, sizeof(relay_addr)) < 0 or
+      getsockname(probe_fd, (sockaddr*)&relay_addr, &len) < 0) {
+    perror("SCTP relay port");
+    return SRSRAN_ERROR;
+  }
+  close(probe_fd);
+
+  n2_sctp  associations(n2_relay::NGAP, core_addr);
+  n2_relay relay(n2_relay::NGAP,
+                 scenario_addr,
+                 decode_mutex,
+                 [&associations](n2_relay::direction_t dir, uint16_t stream, const uint8_t* msg, uint32_t len) {
+                   associations.send(dir, stream, msg, len);
+                 });
+  if (not associations.listen(relay_addr)) {
+    return SRSRAN_ERROR;
+  }
+  std::thread relay_thread([&associations, &relay]() { associations.run(relay); });
+
+  int                  ran_fd  = open_sctp_socket();
+  int                  core_fd = -1;
+  std::vector<uint8_t> init_ue = make_initial_ue_message(1);
+  std::vector<uint8_t> dl_nas  = make_dl_nas_transport();
+  std::vector<uint8_t> rx_msg;
+  uint16_t             rx_stream = 0;
+  uint32_t             ppid      = htonl(n2_relay::ppid(n2_relay::NGAP));
+  int                  ret       = SRSRAN_ERROR;
+  if (connect(ran_fd, (sockaddr*)&relay_addr, sizeof(relay_addr)) < 0 or
+      (core_fd = accept(core_listen_fd, nullptr, nullptr)) < 0) {
+    perror("SCTP connect");
+  } else if (sctp_sendmsg(ran_fd, init_ue.data(), init_ue.size(), nullptr, 0, ppid, 0, 3, 0, 0) < 0 or
+             not recv_sctp(core_fd, rx_msg, rx_stream) or rx_msg != init_ue or rx_stream != 3) {
+    fprintf(stderr, "The InitialUEMessage did not reach the core on stream 3\n");
+  } else if (sctp_sendmsg(core_fd, dl_nas.data(), dl_nas.size(), nullptr, 0, ppid, 0, 5, 0, 0) < 0 or
+             not recv_sctp(ran_fd, rx_msg, rx_stream) or rx_msg != dl_nas or rx_stream != 5) {
+    fprintf(stderr, "The DownlinkNASTransport did not reach the RAN node on stream 5\n");
+  } else {
+    printf("Relayed an NGAP message each way over loopback SCTP associations\n");
+    ret = SRSRAN_SUCCESS;
+  }
+
+  associations.stop();
+  relay_thread.join();
+  relay.stop();
+  close(ran_fd);
+  if (core_fd >= 0) {
+    close(core_fd);
+  }
+  close(core_listen_fd);
+  return ret;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+  srslog::init();
+
+  scenario_handler_t handler;
+  sockaddr_in        scenario_addr = {};
+  scenario_addr.sin_family         = AF_INET;
+  scenario_addr.sin_addr.s_addr    = inet_addr("127.0.0.1");
+  socklen_t len                    = sizeof(scenario_addr);
+  handler.sock                     = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+  timeval timeout                  = {0, 100000};
+  setsockopt(handler.sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  if (bind(handler.sock, (sockaddr*)&scenario_addr, sizeof(scenario_addr)) < 0 or
+      getsockname(handler.sock, (sockaddr*)&scenario_addr, &len) < 0) {
+    perror("bind");
+    return SRSRAN_ERROR;
+  }
+
+  std::mutex decode_mutex;
+  if (check_codec(scenario_addr, decode_mutex) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  printf("Decoded and spoofed NGAP and S1AP NAS PDUs\n");
+
+  std::thread handler_thread([&handler]() { handler.run(); });
+  capture_t   capture;
+  n2_relay    relay(n2_relay::NGAP,
+                 scenario_addr,
+                 decode_mutex,
+                 [&capture](n2_relay::direction_t, uint16_t stream, const uint8_t* msg, uint32_t len) {
+                   capture.push(stream, msg, len);
+                 });
+
+  // The verdict of the message of stream 1 is held back while the messages of stream 2 go through
+  const uint32_t                      nof_unblocked = 16;
+  std::vector<std::vector<uint8_t> > msgs;
+  for (uint32_t i = 0; i <= nof_unblocked; i++) {
+    msgs.push_back(make_initial_ue_message(i));
+  }
+  relay.push(n2_relay::FROM_RAN, 1, msgs[0].data(), msgs[0].size());
+  while (handler.nof_received == 0) {
+    std::this_thread::yield();
+  }
+  for (uint32_t i = 1; i <= nof_unblocked; i++) {
+    relay.push(n2_relay::FROM_RAN, 2, msgs[i].data(), msgs[i].size());
+  }
+  if (not capture.wait(nof_unblocked)) {
+    fprintf(stderr, "Stream 2 was blocked by stream 1\n");
+    return SRSRAN_ERROR;
+  }
+  handler.release = true;
+  if (not capture.wait(nof_unblocked + 1)) {
+    fprintf(stderr, "The held back message was not relayed\n");
+    return SRSRAN_ERROR;
+  }
+  for (uint32_t i = 0; i < nof_unblocked; i++) {
+    if (capture.sent[i].first != 2 or capture.sent[i].second != msgs[i + 1]) {
+      fprintf(stderr, "Message %d of stream 2 was not relayed in order\n", i);
+      return SRSRAN_ERROR;
+    }
+  }
+  if (capture.sent[nof_unblocked].first != 1 or capture.sent[nof_unblocked].second != msgs[0]) {
+    fprintf(stderr, "The message of stream 1 was not relayed\n");
+    return SRSRAN_ERROR;
+  }
+
+  // Spoofing and dropping verdicts, one message at a time
+  handler.set_verdict(std::string(1, '\1') + "{\"NAS-PDU\": \"7e00417900\"}");
+  relay.push(n2_relay::FROM_RAN, 3, msgs[1].data(), msgs[1].size());
+  if (not capture.wait(nof_unblocked + 2) or ngap_nas_pdu(capture.sent.back().second).size() != 5) {
+    fprintf(stderr, "The spoofing verdict was not applied\n");
+    return SRSRAN_ERROR;
+  }
+  handler.set_verdict(std::string(1, '\2'));
+  relay.push(n2_relay::FROM_RAN, 3, msgs[2].data(), msgs[2].size());
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (relay.get_metrics().dropped == 0 and std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  n2_relay::metrics_t metrics = relay.get_metrics();
+  if (metrics.relayed != nof_unblocked + 1 or metrics.spoofed != 1 or metrics.dropped != 1 or
+      metrics.nas_pdus != nof_unblocked + 3 or capture.sent.size() != nof_unblocked + 2) {
+    fprintf(stderr, "Unexpected metrics\n%s\n", relay.metrics_to_string().c_str());
+    return SRSRAN_ERROR;
+  }
+  printf("Relayed stream 2 while stream 1 waited for its verdict, applied every verdict\n");
+
+  // Timed pass
+  handler.set_verdict(std::string(1, '\0'));
+  std::vector<uint8_t> dl_nas   = make_dl_nas_transport();
+  size_t               nof_sent = capture.sent.size();
+  size_t               nof_msgs = nof_repetitions * nof_streams * 8;
+  auto                 t_start  = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_msgs; i++) {
+    relay.push(n2_relay::FROM_CORE, i % nof_streams, dl_nas.data(), dl_nas.size());
+    // Stay below the lane queue limit
+    if (i % n2_relay::max_lane_queue == n2_relay::max_lane_queue - 1) {
+      capture.wait(nof_sent + i - n2_relay::max_lane_queue / 2);
+    }
+  }
+  bool   done    = capture.wait(nof_sent + nof_msgs);
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+  if (not done) {
+    fprintf(stderr, "Relayed %d of %d messages\n%s\n", (int)(capture.sent.size() - nof_sent), (int)nof_msgs,
+            relay.metrics_to_string().c_str());
+    return SRSRAN_ERROR;
+  }
+  printf("Relayed %d DownlinkNASTransport messages over %d streams in %.3f s\n", (int)nof_msgs, nof_streams, elapsed);
+  printf("  %.1f kmsg/s\n", nof_msgs / elapsed / 1e3);
+  printf("  %s\n", relay.metrics_to_string().c_str());
+
+  relay.stop();
+  if (check_sctp_round_trip(scenario_addr, decode_mutex) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  handler.running = false;
+  handler_thread.join();
+  close(handler.sock);
+  return SRSRAN_SUCCESS;
+}
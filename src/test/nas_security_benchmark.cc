@@ -0,0 +1,216 @@
+/**
+ * Benchmark of the 5G NAS security context of the relay.
+ *
+ * The relay first follows a NAS security setup as it crosses it, with a second context playing the network side: a
+ * Security Mode Command is only taken over once its MAC has been checked with the keys it establishes, and a PDU with
+ * a bad MAC neither passes nor moves the context. A failed check makes the run fail, so this also runs as a ctest.
+ *
+ * With the context active, the network side then protects DL NAS Transport messages, integrity protected and
+ * ciphered, which the relay verifies, deciphers and decodes through handle_nas_msg() as the controller does for every
+ * relayed NAS PDU.
+ */
+
+#include "src/nas_packet_handler.h"
+#include "src/nas_security.h"
+
+#include "mitm_lib/asn1/nas_5g_msg.h"
+#include "mitm_lib/config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <getopt.h>
+#include <vector>
+
+static uint32_t nof_repetitions = 10000;
+static uint32_t payload_len     = 256;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nl]\n", prog);
+  printf("\t-n Number of protected NAS PDUs [Default %d]\n", nof_repetitions);
+  printf("\t-l Payload container length [Default %d]\n", payload_len);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nlh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        payload_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Copy of pdu through handle_nas_msg(), as the controller decodes a NAS PDU it relays
+static std::string handle_nas_copy(const srsran::byte_buffer_t& pdu, srsran::security_direction_t dir)
+{
+  srsran::unique_byte_buffer_t copy = srsran::make_byte_buffer();
+  copy->append_bytes(pdu.msg, pdu.N_bytes);
+  asn1::json_writer json_buffer;
+  handle_nas_msg(std::move(copy), json_buffer, dir);
+  return json_buffer.to_string();
+}
+
+static bool integrity_check_is(const std::string& json, const char* outcome)
+{
+  return json.find(std::string("\"Integrity check\": \"") + outcome + "\"") != std::string::npos;
+}
+
+static int check_security_setup(nas_security_ctx& network)
+{
+  using namespace srsran::nas_5g;
+  const srsran::security_direction_t dl = srsran::SECURITY_DIRECTION_DOWNLINK;
+
+  const char* k    = "465b5ce8b199b49faa5f0a2ee238a6bc";
+  const char* opc  = "cd63cb71954a9f4e48a5994e37a02baf";
+  const char* supi = "001010123456789";
+  const char* snn  = "5G:mnc001.mcc001.3gppnetwork.org";
+  if (not network.configure(k, opc, supi, snn) or not nas_sec_ctx.configure(k, opc, supi, snn)) {
+    return SRSRAN_ERROR;
+  }
+
+  auto make_auth_req = [](uint8_t rand_seed) {
+    nas_5gs_msg               nas;
+    authentication_request_t& auth_req             = nas.set_authentication_request();
+    auth_req.abba.abba_contents                    = {0x00, 0x00};
+    auth_req.authentication_parameter_rand_present = true;
+    auth_req.authentication_parameter_rand.rand.fill(rand_seed);
+    auth_req.authentication_parameter_autn_present = true;
+    auth_req.authentication_parameter_autn.autn.assign(16, 0xc3);
+    return nas;
+  };
+
+  nas_5gs_msg              smc_msg;
+  security_mode_command_t& smc     = smc_msg.set_security_mode_command();
+  smc_msg.hdr.security_header_type = nas_5gs_hdr::integrity_protected_with_new_5G_nas_context;
+  smc_msg.hdr.sequence_number      = 0;
+  smc.selected_nas_security_algorithms.ciphering_algorithm =
+      security_algorithms_t::ciphering_algorithm_type_::options::ea2_128_5g;
+  smc.selected_nas_security_algorithms.integrity_protection_algorithm =
+      security_algorithms_t::integrity_protection_algorithm_type_::options::ia2_128_5g;
+  srsran::unique_byte_buffer_t smc_pdu = srsran::make_byte_buffer();
+  smc_msg.pack(smc_pdu);
+
+  // Nothing can be protected before the context is set up
+  std::vector<uint8_t> packed(smc_pdu->msg, smc_pdu->msg + smc_pdu->N_bytes);
+  if (nas_sec_ctx.protect(*smc_pdu, dl) != SRSRAN_ERROR or
+      std::vector<uint8_t>(smc_pdu->msg, smc_pdu->msg + smc_pdu->N_bytes) != packed) {
+    fprintf(stderr, "A NAS PDU was protected without a security context\n");
+    return SRSRAN_ERROR;
+  }
+
+  nas_5gs_msg                  auth_msg = make_auth_req(0x3c);
+  srsran::unique_byte_buffer_t auth_pdu = srsran::make_byte_buffer();
+  auth_msg.pack(auth_pdu);
+  network.observe(auth_msg, dl);
+  handle_nas_copy(*auth_pdu, dl);
+  network.observe(smc_msg, dl);
+  if (network.protect(*smc_pdu, dl) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "The network side could not protect the Security Mode Command\n");
+    return SRSRAN_ERROR;
+  }
+
+  // A Security Mode Command with a bad MAC leaves the relay without a context, the genuine one sets it up
+  srsran::unique_byte_buffer_t tampered = srsran::make_byte_buffer();
+  tampered->append_bytes(smc_pdu->msg, smc_pdu->N_bytes);
+  tampered->msg[2] ^= 0x01;
+  std::string json = handle_nas_copy(*tampered, dl);
+  if (not integrity_check_is(json, "Failed") or nas_sec_ctx.is_active()) {
+    fprintf(stderr, "A Security Mode Command with a bad MAC was taken over:\n%s\n", json.c_str());
+    return SRSRAN_ERROR;
+  }
+  json = handle_nas_copy(*smc_pdu, dl);
+  if (not integrity_check_is(json, "Passed") or not nas_sec_ctx.is_active()) {
+    fprintf(stderr, "The Security Mode Command did not set up the context:\n%s\n", json.c_str());
+    return SRSRAN_ERROR;
+  }
+
+  // A protected re-authentication only moves the context once its MAC has been checked
+  srsran::as_key_t k_gnb, k_gnb_after;
+  nas_sec_ctx.get_k_gnb(k_gnb);
+  nas_5gs_msg reauth_msg              = make_auth_req(0x4d);
+  reauth_msg.hdr.security_header_type = nas_5gs_hdr::integrity_protected;
+  reauth_msg.hdr.sequence_number      = network.next_sequence_number(dl);
+  srsran::unique_byte_buffer_t reauth_pdu = srsran::make_byte_buffer();
+  reauth_msg.pack(reauth_pdu);
+  network.protect(*reauth_pdu, dl);
+  tampered->clear();
+  tampered->append_bytes(reauth_pdu->msg, reauth_pdu->N_bytes);
+  tampered->msg[tampered->N_bytes - 1] ^= 0x01;
+  json = handle_nas_copy(*tampered, dl);
+  nas_sec_ctx.get_k_gnb(k_gnb_after);
+  if (not integrity_check_is(json, "Failed") or k_gnb_after != k_gnb) {
+    fprintf(stderr, "An Authentication Request with a bad MAC moved the context:\n%s\n", json.c_str());
+    return SRSRAN_ERROR;
+  }
+  json = handle_nas_copy(*reauth_pdu, dl);
+  nas_sec_ctx.get_k_gnb(k_gnb_after);
+  if (not integrity_check_is(json, "Passed") or k_gnb_after == k_gnb) {
+    fprintf(stderr, "The protected Authentication Request was not followed:\n%s\n", json.c_str());
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  using namespace srsran::nas_5g;
+
+  parse_args(argc, argv);
+
+  srslog::init();
+
+  nas_security_ctx network;
+  if (check_security_setup(network) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  printf("Checked the integrity of the NAS Security Mode Command and a protected NAS PDU before following them\n");
+
+  const srsran::security_direction_t dl = srsran::SECURITY_DIRECTION_DOWNLINK;
+  nas_5gs_msg                        transport_msg;
+  dl_nas_transport_t&                transport = transport_msg.set_dl_nas_transport();
+  transport_msg.hdr.security_header_type     = nas_5gs_hdr::integrity_protected_and_ciphered;
+  transport.payload_container.payload_container_contents.assign(payload_len, 0xa5);
+
+  uint64_t nof_bytes = 0;
+  double   elapsed   = 0;
+  for (uint32_t rep = 0; rep < nof_repetitions; ++rep) {
+    transport_msg.hdr.sequence_number = network.next_sequence_number(dl);
+    srsran::unique_byte_buffer_t pdu  = srsran::make_byte_buffer();
+    transport_msg.pack(pdu);
+    nof_bytes += pdu->N_bytes;
+
+    auto tstart = std::chrono::steady_clock::now();
+    if (network.protect(*pdu, dl) != SRSRAN_SUCCESS) {
+      fprintf(stderr, "The network side could not protect a DL NAS Transport\n");
+      return SRSRAN_ERROR;
+    }
+    asn1::json_writer json_buffer;
+    handle_nas_msg(std::move(pdu), json_buffer, dl);
+    auto tend = std::chrono::steady_clock::now();
+    elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(tend - tstart).count() / 1e9;
+
+    std::string json = json_buffer.to_string();
+    if (not integrity_check_is(json, "Passed")) {
+      fprintf(stderr, "A protected DL NAS Transport was not deciphered:\n%s\n", json.c_str());
+      return SRSRAN_ERROR;
+    }
+  }
+
+  printf("Protected and relayed %d NAS PDUs (%lu bytes) in %.3f s\n", nof_repetitions, nof_bytes, elapsed);
+  printf("  %.1f kPDU/s, %.2f us/PDU\n", nof_repetitions / elapsed / 1e3, elapsed * 1e6 / nof_repetitions);
+
+  srslog::flush();
+
+  return SRSRAN_SUCCESS;
+}
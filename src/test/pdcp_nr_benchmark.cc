@@ -0,0 +1,476 @@
+/**
+ * Benchmark of the NR PDCP entity at DRB rates.
+ *
+ * A transmitting entity with a discard timer feeds a receiving entity with t-Reordering, both without security so that
+ * the window and timer bookkeeping dominates. The check pass verifies that the discard timers expire exactly after
+ * discardTimer unless the RLC confirmed the delivery, and that the receiver delivers in COUNT order, holding SDUs back
+ * behind a lost PDU until t-Reordering expires, and that with 128-EEA2 and 128-EIA2 write_sdus() and write_pdus() build
+ * and accept the same PDUs as write_sdu() and write_pdu(). The timed pass measures write_sdu() and write_pdu() over
+ * bursts with the PDUs of every burst received pairwise swapped, then both pairs of functions with security.
+ */
+
+#include "mitm_lib/common/task_scheduler.h"
+#include "mitm_lib/config.h"
+#include "mitm_lib/upper/pdcp_entity_nr.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+
+static uint32_t nof_repetitions = 1000;
+static uint32_t sdu_len         = 1400;
+static uint8_t  sn_len          = srsran::PDCP_SN_LEN_18;
+
+static const uint32_t burst_size = 64;
+static const uint32_t lcid       = 4;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nlsh]\n", prog);
+  printf("\t-n Number of bursts of %d SDUs [Default %d]\n", burst_size, nof_repetitions);
+  printf("\t-l SDU length [Default %d]\n", sdu_len);
+  printf("\t-s PDCP SN length, 12 or 18 [Default %d]\n", sn_len);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nlsh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        sdu_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        sn_len = (uint8_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+// RLC below the transmitter and upper layers above the receiver
+class test_stack : public srsue::rlc_interface_pdcp, public srsue::rrc_interface_pdcp, public srsue::gw_interface_pdcp
+{
+public:
+  std::vector<srsran::unique_byte_buffer_t> tx_pdus;
+  std::vector<uint32_t>                     discarded;
+  std::vector<uint32_t>                     delivered; // sequence numbers carried by the SDUs
+  uint32_t                                  integrity_failures = 0;
+
+  void write_sdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu) override { tx_pdus.push_back(std::move(sdu)); }
+  void discard_sdu(uint32_t lcid, uint32_t discard_sn) override { discarded.push_back(discard_sn); }
+  bool rb_is_um(uint32_t lcid) override { return false; }
+  bool sdu_queue_is_full(uint32_t lcid) override { return false; }
+  bool is_suspended(const uint32_t lcid) override { return false; }
+
+  void write_pdu(uint32_t lcid, srsran::unique_byte_buffer_t pdu) override
+  {
+    uint32_t seq;
+    memcpy(&seq, pdu->msg, sizeof(seq));
+    delivered.push_back(seq);
+  }
+  void        write_pdu_bcch_bch(srsran::unique_byte_buffer_t pdu) override {}
+  void        write_pdu_bcch_dlsch(srsran::unique_byte_buffer_t pdu) override {}
+  void        write_pdu_pcch(srsran::unique_byte_buffer_t pdu) override {}
+  void        write_pdu_mch(uint32_t lcid, srsran::unique_byte_buffer_t pdu) override {}
+  void        notify_pdcp_integrity_error(uint32_t lcid) override { integrity_failures++; }
+  const char* get_rb_name(uint32_t lcid) override { return "DRB1"; }
+};
+
+struct test_bed {
+  srsran::task_scheduler task_sched{64, 0};
+  srslog::basic_logger&  logger = srslog::fetch_basic_logger("PDCP", false);
+  test_stack             stack;
+  srsran::pdcp_entity_nr tx{&stack, &stack, &stack, &task_sched, logger, lcid};
+  srsran::pdcp_entity_nr rx{&stack, &stack, &stack, &task_sched, logger, lcid};
+  uint32_t               next_seq = 0;
+  uint8_t                sn       = sn_len;
+
+  bool configure()
+  {
+    logger.set_level(srslog::basic_levels::none);
+    srsran::pdcp_config_t cfg(1,
+                              srsran::PDCP_RB_IS_DRB,
+                              srsran::SECURITY_DIRECTION_DOWNLINK,
+                              srsran::SECURITY_DIRECTION_DOWNLINK,
+                              sn,
+                              srsran::pdcp_t_reordering_t::ms50,
+                              srsran::pdcp_discard_timer_t::ms100,
+                              false,
+                              srsran::srsran_rat_t::nr);
+    return tx.configure(cfg) and rx.configure(cfg);
+  }
+
+  // 128-EEA2 and 128-EIA2 in both directions
+  void secure()
+  {
+    srsran::as_security_config_t sec_cfg = {};
+    for (uint32_t i = 0; i < sec_cfg.k_up_int.size(); i++) {
+      sec_cfg.k_up_int[i] = (uint8_t)(i * 7 + 1);
+      sec_cfg.k_up_enc[i] = (uint8_t)(i * 13 + 2);
+    }
+    sec_cfg.integ_algo  = srsran::INTEGRITY_ALGORITHM_ID_128_EIA2;
+    sec_cfg.cipher_algo = srsran::CIPHERING_ALGORITHM_ID_128_EEA2;
+    for (srsran::pdcp_entity_nr* entity : {&tx, &rx}) {
+      entity->config_security(sec_cfg);
+      entity->enable_integrity(srsran::DIRECTION_TXRX);
+      entity->enable_encryption(srsran::DIRECTION_TXRX);
+    }
+  }
+
+  // SDU carrying the next sequence number
+  srsran::unique_byte_buffer_t make_sdu()
+  {
+    srsran::unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    memset(sdu->msg, 0, sdu_len);
+    memcpy(sdu->msg, &next_seq, sizeof(next_seq));
+    sdu->N_bytes = sdu_len;
+    next_seq++;
+    return sdu;
+  }
+
+  // Transmits one SDU, the PDU lands in stack.tx_pdus
+  void write_sdu() { tx.write_sdu(make_sdu()); }
+
+  void tic(uint32_t nof_tics)
+  {
+    for (uint32_t i = 0; i < nof_tics; i++) {
+      task_sched.tic();
+    }
+  }
+};
+
+static bool check_discard()
+{
+  test_bed tb;
+  if (not tb.configure()) {
+    fprintf(stderr, "Could not configure the PDCP entities\n");
+    return false;
+  }
+
+  // Half of a first burst is confirmed by the RLC, a second burst follows 30 ms later
+  for (uint32_t i = 0; i < burst_size; i++) {
+    tb.write_sdu();
+  }
+  srsran::pdcp_sn_vector_t acked;
+  for (uint32_t i = 0; i < burst_size; i += 2) {
+    acked.push_back(i);
+  }
+  tb.tx.notify_delivery(acked);
+  tb.tic(30);
+  for (uint32_t i = 0; i < burst_size; i++) {
+    tb.write_sdu();
+  }
+  if (tb.tx.nof_discard_timers() != burst_size + burst_size / 2) {
+    fprintf(stderr, "%d discard timers running, expected %d\n", tb.tx.nof_discard_timers(), burst_size * 3 / 2);
+    return false;
+  }
+
+  tb.tic(69);
+  if (not tb.stack.discarded.empty()) {
+    fprintf(stderr, "SDUs discarded before discardTimer expired\n");
+    return false;
+  }
+  tb.tic(1);
+  if (tb.stack.discarded.size() != burst_size / 2 or tb.tx.nof_discard_timers() != burst_size) {
+    fprintf(stderr, "%zd SDUs of the first burst discarded, expected %d\n", tb.stack.discarded.size(), burst_size / 2);
+    return false;
+  }
+  for (uint32_t i = 0; i < burst_size / 2; i++) {
+    if (tb.stack.discarded[i] != 2 * i + 1) {
+      fprintf(stderr, "SDU %d discarded, expected %d\n", tb.stack.discarded[i], 2 * i + 1);
+      return false;
+    }
+  }
+
+  tb.tic(29);
+  if (tb.stack.discarded.size() != burst_size / 2) {
+    fprintf(stderr, "SDUs of the second burst discarded before discardTimer expired\n");
+    return false;
+  }
+  tb.tic(1);
+  if (tb.stack.discarded.size() != burst_size * 3 / 2 or tb.tx.nof_discard_timers() != 0) {
+    fprintf(stderr, "%zd SDUs discarded in total, expected %d\n", tb.stack.discarded.size(), burst_size * 3 / 2);
+    return false;
+  }
+  return true;
+}
+
+static bool check_reordering()
+{
+  test_bed tb;
+  if (not tb.configure()) {
+    fprintf(stderr, "Could not configure the PDCP entities\n");
+    return false;
+  }
+  for (uint32_t i = 0; i < burst_size; i++) {
+    tb.write_sdu();
+  }
+
+  // Pairwise swapped, with the PDU of COUNT 10 lost
+  const uint32_t lost = 10;
+  for (uint32_t i = 0; i < burst_size; i += 2) {
+    for (uint32_t j : {i + 1, i}) {
+      if (j != lost) {
+        tb.rx.write_pdu(std::move(tb.stack.tx_pdus[j]));
+      }
+    }
+  }
+  if (tb.stack.delivered.size() != lost) {
+    fprintf(stderr, "%zd SDUs delivered before the lost PDU, expected %d\n", tb.stack.delivered.size(), lost);
+    return false;
+  }
+  tb.tic(50);
+  if (tb.stack.delivered.size() != burst_size - 1 or tb.rx.get_rx_deliv() != burst_size) {
+    fprintf(stderr, "%zd SDUs delivered after t-Reordering, expected %d\n", tb.stack.delivered.size(), burst_size - 1);
+    return false;
+  }
+  for (uint32_t i = 0, seq = 0; i < tb.stack.delivered.size(); i++, seq++) {
+    seq += seq == lost ? 1 : 0;
+    if (tb.stack.delivered[i] != seq) {
+      fprintf(stderr, "SDU %d delivered in position %d\n", tb.stack.delivered[i], i);
+      return false;
+    }
+  }
+
+  // A late PDU is dropped
+  tb.rx.write_pdu(std::move(tb.stack.tx_pdus[lost]));
+  if (tb.stack.delivered.size() != burst_size - 1) {
+    fprintf(stderr, "PDU received after t-Reordering was delivered\n");
+    return false;
+  }
+  return true;
+}
+
+static bool check_delivered(const test_stack& stack, uint32_t nof_sdus)
+{
+  if (stack.delivered.size() != nof_sdus) {
+    fprintf(stderr, "%zd SDUs delivered, expected %d\n", stack.delivered.size(), nof_sdus);
+    return false;
+  }
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    if (stack.delivered[i] != i) {
+      fprintf(stderr, "SDU %d delivered in position %d\n", stack.delivered[i], i);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool check_batches()
+{
+  test_bed single, batched;
+  if (not single.configure() or not batched.configure()) {
+    fprintf(stderr, "Could not configure the PDCP entities\n");
+    return false;
+  }
+  single.secure();
+  batched.secure();
+
+  // Longer than one run of the batched security functions
+  const uint32_t                            nof_sdus = 2 * srsran::pdcp_entity_nr::max_batch_len + 7;
+  std::vector<srsran::unique_byte_buffer_t> sdus;
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    single.write_sdu();
+    sdus.push_back(batched.make_sdu());
+  }
+  batched.tx.write_sdus(sdus);
+  if (batched.stack.tx_pdus.size() != nof_sdus) {
+    fprintf(stderr, "write_sdus() built %zd PDUs, expected %d\n", batched.stack.tx_pdus.size(), nof_sdus);
+    return false;
+  }
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    const srsran::unique_byte_buffer_t& a = single.stack.tx_pdus[i];
+    const srsran::unique_byte_buffer_t& b = batched.stack.tx_pdus[i];
+    if (a->N_bytes != b->N_bytes or memcmp(a->msg, b->msg, a->N_bytes) != 0) {
+      fprintf(stderr, "PDU %d of write_sdus() differs from the one of write_sdu()\n", i);
+      return false;
+    }
+  }
+
+  // Pairwise swapped, with the MAC-I of the last PDU corrupted
+  srsran::unique_byte_buffer_t& last = batched.stack.tx_pdus.back();
+  last->msg[last->N_bytes - 1] ^= 1;
+  std::vector<srsran::unique_byte_buffer_t> pdus;
+  for (uint32_t i = 0; i < nof_sdus; i += 2) {
+    if (i + 1 < nof_sdus) {
+      pdus.push_back(std::move(batched.stack.tx_pdus[i + 1]));
+    }
+    pdus.push_back(std::move(batched.stack.tx_pdus[i]));
+  }
+  batched.rx.write_pdus(pdus);
+  if (batched.stack.integrity_failures != 1) {
+    fprintf(stderr, "%d integrity failures, expected 1\n", batched.stack.integrity_failures);
+    return false;
+  }
+  if (not check_delivered(batched.stack, nof_sdus - 1)) {
+    return false;
+  }
+  if (sn_len != srsran::PDCP_SN_LEN_12) {
+    return true;
+  }
+
+  // With COUNTs 1 to Window_Size - 1 held back for COUNT 0, the COUNT of an SN in the next window is only known once
+  // COUNT 0 is delivered: a run of COUNT 0 and COUNT Window_Size must verify the latter with the right COUNT
+  test_bed wrap;
+  wrap.sn = srsran::PDCP_SN_LEN_12;
+  if (not wrap.configure()) {
+    fprintf(stderr, "Could not configure the PDCP entities\n");
+    return false;
+  }
+  wrap.secure();
+  const uint32_t window = 1 << (srsran::PDCP_SN_LEN_12 - 1);
+  for (uint32_t i = 0; i <= window; i++) {
+    wrap.write_sdu();
+  }
+  wrap.rx.write_pdus(srsran::span<srsran::unique_byte_buffer_t>(&wrap.stack.tx_pdus[1], window - 1));
+  pdus.clear();
+  pdus.push_back(std::move(wrap.stack.tx_pdus[0]));
+  pdus.push_back(std::move(wrap.stack.tx_pdus[window]));
+  wrap.rx.write_pdus(pdus);
+  if (wrap.stack.integrity_failures != 0) {
+    fprintf(stderr, "%d integrity failures across the window edge\n", wrap.stack.integrity_failures);
+    return false;
+  }
+  return check_delivered(wrap.stack, window + 1);
+}
+
+// Bursts with 128-EEA2 and 128-EIA2 through write_sdu() and write_pdu(), or through write_sdus() and write_pdus()
+static bool timed_secure_pass(bool batched, std::chrono::nanoseconds& tx_time, std::chrono::nanoseconds& rx_time)
+{
+  test_bed tb;
+  if (not tb.configure()) {
+    fprintf(stderr, "Could not configure the PDCP entities\n");
+    return false;
+  }
+  tb.secure();
+
+  std::vector<srsran::unique_byte_buffer_t> sdus;
+  srsran::pdcp_sn_vector_t                  acked;
+  for (uint32_t burst = 0; burst < nof_repetitions; burst++) {
+    tb.stack.tx_pdus.clear();
+    tb.stack.delivered.clear();
+    sdus.clear();
+    for (uint32_t i = 0; i < burst_size; i++) {
+      sdus.push_back(tb.make_sdu());
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (batched) {
+      tb.tx.write_sdus(sdus);
+    } else {
+      for (srsran::unique_byte_buffer_t& sdu : sdus) {
+        tb.tx.write_sdu(std::move(sdu));
+      }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    tx_time += end - start;
+
+    acked.clear();
+    for (uint32_t i = 0; i < burst_size; i++) {
+      acked.push_back(burst * burst_size + i);
+    }
+    tb.tx.notify_delivery(acked);
+    start = std::chrono::high_resolution_clock::now();
+    if (batched) {
+      tb.rx.write_pdus(tb.stack.tx_pdus);
+    } else {
+      for (srsran::unique_byte_buffer_t& pdu : tb.stack.tx_pdus) {
+        tb.rx.write_pdu(std::move(pdu));
+      }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    rx_time += end - start;
+
+    if (tb.stack.delivered.size() != burst_size or tb.stack.integrity_failures != 0) {
+      fprintf(stderr, "Burst %d was not delivered in full with security\n", burst);
+      return false;
+    }
+    tb.tic(1);
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  if (not check_discard() or not check_reordering() or not check_batches()) {
+    return SRSRAN_ERROR;
+  }
+
+  test_bed tb;
+  if (not tb.configure()) {
+    fprintf(stderr, "Could not configure the PDCP entities\n");
+    return SRSRAN_ERROR;
+  }
+
+  // Every burst is confirmed by the RLC and received within a TTI
+  std::chrono::nanoseconds tx_time{0}, rx_time{0};
+  srsran::pdcp_sn_vector_t acked;
+  for (uint32_t burst = 0; burst < nof_repetitions; burst++) {
+    tb.stack.tx_pdus.clear();
+    tb.stack.delivered.clear();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < burst_size; i++) {
+      tb.write_sdu();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    tx_time += end - start;
+
+    acked.clear();
+    for (uint32_t i = 0; i < burst_size; i++) {
+      acked.push_back(burst * burst_size + i);
+    }
+    start = std::chrono::high_resolution_clock::now();
+    tb.tx.notify_delivery(acked);
+    for (uint32_t i = 0; i < burst_size; i += 2) {
+      tb.rx.write_pdu(std::move(tb.stack.tx_pdus[i + 1]));
+      tb.rx.write_pdu(std::move(tb.stack.tx_pdus[i]));
+    }
+    end = std::chrono::high_resolution_clock::now();
+    rx_time += end - start;
+
+    if (tb.stack.delivered.size() != burst_size or tb.stack.delivered.back() != tb.next_seq - 1) {
+      fprintf(stderr, "Burst %d was not delivered in full\n", burst);
+      return SRSRAN_ERROR;
+    }
+    tb.tic(1);
+  }
+  if (not tb.stack.discarded.empty()) {
+    fprintf(stderr, "%zd SDUs discarded despite the delivery notifications\n", tb.stack.discarded.size());
+    return SRSRAN_ERROR;
+  }
+
+  uint64_t nof_sdus = (uint64_t)nof_repetitions * burst_size;
+  printf("PDCP NR, %d-bit SN, %d B SDUs, %ld SDUs\n", sn_len, sdu_len, nof_sdus);
+  printf("\twrite_sdu: %.1f ns/SDU, %.1f kSDU/s\n",
+         (double)tx_time.count() / nof_sdus,
+         nof_sdus * 1e6 / std::max((int64_t)tx_time.count(), (int64_t)1));
+  printf("\twrite_pdu: %.1f ns/PDU, %.1f kPDU/s (notify_delivery included)\n",
+         (double)rx_time.count() / nof_sdus,
+         nof_sdus * 1e6 / std::max((int64_t)rx_time.count(), (int64_t)1));
+
+  std::chrono::nanoseconds single_tx{0}, single_rx{0}, batched_tx{0}, batched_rx{0};
+  if (not timed_secure_pass(false, single_tx, single_rx) or not timed_secure_pass(true, batched_tx, batched_rx)) {
+    return SRSRAN_ERROR;
+  }
+  printf("\t128-EEA2/128-EIA2 write_sdu:  %.1f ns/SDU, write_pdu:  %.1f ns/PDU\n",
+         (double)single_tx.count() / nof_sdus,
+         (double)single_rx.count() / nof_sdus);
+  printf("\t128-EEA2/128-EIA2 write_sdus: %.1f ns/SDU, write_pdus: %.1f ns/PDU\n",
+         (double)batched_tx.count() / nof_sdus,
+         (double)batched_rx.count() / nof_sdus);
+
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,368 @@
+/**
+ * Benchmark of the per-TTI MAC and RLC PDU handling, and of its heap activity.
+ *
+ * Every TTI a UL-SCH TB with a long BSR, C-RNTI and PHR CEs, an SRB and a DRB SDU is parsed with mac_sch_pdu_nr and
+ * its CEs read, and an RLC AM NR status PDU with single, range and segment NACKs is built, packed and read back. The
+ * check pass verifies the parsed values and the status PDU round trip, and that a status PDU with more NACKs than the
+ * NACK list holds is cut at the first NACK that did not fit, both when built and when read. The timed pass counts the
+ * heap allocations made while handling the TTIs, which must be none.
+ */
+
+#include "mitm_lib/common/common_nr.h"
+#include "mitm_lib/config.h"
+#include "mitm_lib/mac/mac_sch_pdu_nr.h"
+#include "mitm_lib/rlc/rlc_am_nr_packing.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <new>
+#include <vector>
+
+static uint32_t nof_ttis  = 100000;
+static uint32_t tb_len    = 1500;
+static uint32_t nof_nacks = 64;
+static uint32_t sn_len    = 18;
+
+static const uint16_t crnti       = 0x4601;
+static const uint32_t srb_sdu_len = 40;
+
+// Allocations made through the global operator new, in this process
+static uint64_t nof_allocs = 0;
+
+void* operator new(std::size_t size)
+{
+  nof_allocs++;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t size) noexcept
+{
+  std::free(ptr);
+}
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nlksh]\n", prog);
+  printf("\t-n Number of TTIs [Default %d]\n", nof_ttis);
+  printf("\t-l TB length [Default %d]\n", tb_len);
+  printf("\t-k NACKs per status PDU [Default %d]\n", nof_nacks);
+  printf("\t-s RLC SN length, 12 or 18 [Default %d]\n", sn_len);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nlksh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_ttis = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        tb_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'k':
+        nof_nacks = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        sn_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+// Long BSR of LCGs 0, 1 and 3, then C-RNTI and PHR CEs, an SRB1 and a DRB SDU and padding. mac_sch_pdu_nr doesn't
+// write long BSRs, that CE is written here.
+static const uint8_t lbsr_ce[] = {srsran::mac_sch_subpdu_nr::LONG_BSR, 4, 0x0b, 10, 20, 30};
+
+static std::vector<uint8_t> make_ul_tb()
+{
+  std::vector<uint8_t> srb_sdu(srb_sdu_len, 0x11);
+  std::vector<uint8_t> drb_sdu(tb_len / 2, 0x22);
+
+  srsran::byte_buffer_t  rest;
+  srsran::mac_sch_pdu_nr pdu(true);
+  pdu.init_tx(&rest, tb_len - sizeof(lbsr_ce), true);
+  pdu.add_crnti_ce(crnti);
+  pdu.add_se_phr_ce(40, 50);
+  pdu.add_sdu((uint32_t)srsran::nr_srb::srb1, srb_sdu.data(), srb_sdu.size());
+  pdu.add_sdu(4, drb_sdu.data(), drb_sdu.size());
+  pdu.pack();
+
+  std::vector<uint8_t> tb(lbsr_ce, lbsr_ce + sizeof(lbsr_ce));
+  tb.insert(tb.end(), rest.msg, rest.msg + rest.N_bytes);
+  return tb;
+}
+
+// Parses the TB and reads its CEs, returns the sum of the values read
+static uint32_t parse_tb(srsran::mac_sch_pdu_nr& pdu, const std::vector<uint8_t>& tb)
+{
+  pdu.init_rx(true);
+  if (pdu.unpack(tb.data(), tb.size()) != SRSRAN_SUCCESS) {
+    return 0;
+  }
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < pdu.get_num_subpdus(); i++) {
+    srsran::mac_sch_subpdu_nr& subpdu = pdu.get_subpdu(i);
+    switch (subpdu.get_lcid()) {
+      case srsran::mac_sch_subpdu_nr::LONG_BSR: {
+        srsran::mac_sch_subpdu_nr::lbsr_t lbsr = subpdu.get_lbsr();
+        for (const srsran::mac_sch_subpdu_nr::lcg_bsr_t& bsr : lbsr.list) {
+          sum += bsr.lcg_id + bsr.buffer_size;
+        }
+      } break;
+      case srsran::mac_sch_subpdu_nr::CRNTI:
+        sum += subpdu.get_c_rnti();
+        break;
+      case srsran::mac_sch_subpdu_nr::SE_PHR:
+        sum += subpdu.get_phr() + subpdu.get_pcmax();
+        break;
+      case srsran::mac_sch_subpdu_nr::PADDING:
+        break;
+      default:
+        sum += subpdu.get_sdu_length();
+        break;
+    }
+  }
+  return sum;
+}
+
+// Lost SNs of a status PDU: every third SN, every fourth of them with a segment missing and every eighth followed by
+// the next SN, so that the two are merged into a range
+static std::vector<srsran::rlc_status_nack_t> make_nacks(uint32_t mod)
+{
+  std::vector<srsran::rlc_status_nack_t> nacks;
+  for (uint32_t i = 0; i < nof_nacks; i++) {
+    srsran::rlc_status_nack_t nack = {};
+    nack.nack_sn                   = (3 * i) % mod;
+    if (i % 4 == 1) {
+      nack.has_so   = true;
+      nack.so_start = 100;
+      nack.so_end   = 199;
+    }
+    nacks.push_back(nack);
+    if (i % 8 == 0) {
+      nack.nack_sn = (nack.nack_sn + 1) % mod;
+      nacks.push_back(nack);
+    }
+  }
+  return nacks;
+}
+
+// Builds, packs and reads back a status PDU, returns the number of NACKs read
+static uint32_t status_round_trip(srsran::rlc_am_nr_sn_size_t                   sn_size,
+                                  const std::vector<srsran::rlc_status_nack_t>& nacks,
+                                  srsran::rlc_am_nr_status_pdu_t&               tx,
+                                  srsran::rlc_am_nr_status_pdu_t&               rx,
+                                  srsran::byte_buffer_t&                        pdu)
+{
+  tx.reset();
+  for (const srsran::rlc_status_nack_t& nack : nacks) {
+    tx.push_nack(nack);
+  }
+  tx.ack_sn = (nacks.back().nack_sn + 1) % cardinality(sn_size);
+  pdu.clear();
+  if (srsran::rlc_am_nr_write_status_pdu(tx, sn_size, &pdu) != SRSRAN_SUCCESS) {
+    return 0;
+  }
+  if (srsran::rlc_am_nr_read_status_pdu(&pdu, sn_size, &rx) != SRSRAN_SUCCESS) {
+    return 0;
+  }
+  return rx.nacks.size();
+}
+
+static bool check_mac(srsran::mac_sch_pdu_nr& pdu, const std::vector<uint8_t>& tb)
+{
+  uint32_t expected = (0 + 10) + (1 + 20) + (3 + 30) + crnti + 40 + 50 + srb_sdu_len + tb_len / 2;
+  uint32_t sum      = parse_tb(pdu, tb);
+  if (tb.size() != tb_len or sum != expected) {
+    fprintf(stderr, "%zd B UL-SCH TB parsed to a sum of %d, expected %d\n", tb.size(), sum, expected);
+    return false;
+  }
+
+  // A long BSR with all LCGs reported fills the list
+  const uint8_t full_lbsr[] = {srsran::mac_sch_subpdu_nr::LONG_BSR, 9, 0xff, 1, 2, 3, 4, 5, 6, 7, 8};
+  pdu.init_rx(true);
+  if (pdu.unpack(full_lbsr, sizeof(full_lbsr)) != SRSRAN_SUCCESS or
+      pdu.get_subpdu(0).get_lbsr().list.size() != srsran::mac_sch_subpdu_nr::max_num_lcg_lbsr or
+      pdu.get_subpdu(0).get_lbsr().list.back().buffer_size != 8) {
+    fprintf(stderr, "Long BSR of all LCGs not parsed\n");
+    return false;
+  }
+  return true;
+}
+
+static bool check_status(srsran::rlc_am_nr_sn_size_t                   sn_size,
+                         const std::vector<srsran::rlc_status_nack_t>& nacks,
+                         srsran::rlc_am_nr_status_pdu_t&               tx,
+                         srsran::rlc_am_nr_status_pdu_t&               rx,
+                         srsran::byte_buffer_t&                        pdu)
+{
+  uint32_t nof_rx = status_round_trip(sn_size, nacks, tx, rx, pdu);
+  if (nof_rx == 0 or nof_rx != tx.nacks.size() or nof_rx >= nacks.size() or rx.ack_sn != tx.ack_sn or
+      rx.packed_size != pdu.N_bytes) {
+    fprintf(stderr, "Status PDU of %zd NACKs read back with %d NACKs\n", nacks.size(), nof_rx);
+    return false;
+  }
+  for (uint32_t i = 0; i < nof_rx; i++) {
+    const srsran::rlc_status_nack_t& a = tx.nacks[i];
+    const srsran::rlc_status_nack_t& b = rx.nacks[i];
+    if (a.nack_sn != b.nack_sn or a.has_so != b.has_so or a.so_start != b.so_start or a.so_end != b.so_end or
+        a.has_nack_range != b.has_nack_range or a.nack_range != b.nack_range) {
+      fprintf(stderr, "NACK %d of the status PDU read back as SN=%d, expected SN=%d\n", i, b.nack_sn, a.nack_sn);
+      return false;
+    }
+  }
+  return true;
+}
+
+// A status PDU with one NACK more than the list holds, with 18 bit SNs so that they don't wrap
+static bool check_status_overflow()
+{
+  srsran::rlc_am_nr_sn_size_t    sn_size = srsran::rlc_am_nr_sn_size_t::size18bits;
+  srsran::rlc_am_nr_status_pdu_t status(sn_size);
+  srsran::rlc_status_nack_t      nack = {};
+
+  // Built: ACK_SN goes back to the NACK that did not fit
+  status.reset();
+  for (uint32_t i = 0; i < RLC_AM_NR_MAX_NACKS; i++) {
+    nack.nack_sn = 2 * i;
+    if (not status.push_nack(nack)) {
+      fprintf(stderr, "NACK %d of %d refused\n", i, RLC_AM_NR_MAX_NACKS);
+      return false;
+    }
+  }
+  nack.nack_sn = 2 * RLC_AM_NR_MAX_NACKS;
+  if (status.push_nack(nack) or not status.has_dropped_nacks()) {
+    fprintf(stderr, "NACK beyond the list capacity accepted\n");
+    return false;
+  }
+  status.ack_sn = 2 * RLC_AM_NR_MAX_NACKS + 10;
+  if (not status.trim(UINT32_MAX) or status.ack_sn != 2 * RLC_AM_NR_MAX_NACKS or
+      status.nacks.size() != RLC_AM_NR_MAX_NACKS) {
+    fprintf(stderr, "Status PDU with a dropped NACK cut at ACK_SN=%d\n", status.ack_sn);
+    return false;
+  }
+
+  // Built: the other segments of a dropped SN are not reported either
+  status.reset();
+  for (uint32_t i = 0; i < RLC_AM_NR_MAX_NACKS - 1; i++) {
+    nack.nack_sn = 2 * i;
+    status.push_nack(nack);
+  }
+  nack.nack_sn  = 2 * RLC_AM_NR_MAX_NACKS;
+  nack.has_so   = true;
+  nack.so_start = 0;
+  nack.so_end   = 9;
+  status.push_nack(nack);
+  nack.so_start = 20;
+  nack.so_end   = 29;
+  status.push_nack(nack);
+  status.ack_sn = 2 * RLC_AM_NR_MAX_NACKS + 1;
+  if (not status.trim(UINT32_MAX) or status.ack_sn != 2 * RLC_AM_NR_MAX_NACKS or
+      status.nacks.size() != RLC_AM_NR_MAX_NACKS - 1) {
+    fprintf(stderr, "Status PDU with a dropped segment NACK cut at ACK_SN=%d\n", status.ack_sn);
+    return false;
+  }
+
+  // Read: a full list is packed, one more NACK is appended to the PDU by hand
+  status.reset();
+  nack = {};
+  for (uint32_t i = 0; i < RLC_AM_NR_MAX_NACKS; i++) {
+    nack.nack_sn = 2 * i;
+    status.push_nack(nack);
+  }
+  status.ack_sn = 2 * RLC_AM_NR_MAX_NACKS + 10;
+  srsran::byte_buffer_t pdu;
+  if (srsran::rlc_am_nr_write_status_pdu(status, sn_size, &pdu) != SRSRAN_SUCCESS) {
+    return false;
+  }
+  uint32_t extra_sn        = 2 * RLC_AM_NR_MAX_NACKS;
+  pdu.msg[pdu.N_bytes - 1] |= 0x20; // E1 of the last NACK
+  pdu.msg[pdu.N_bytes++]   = (extra_sn >> 10) & 0xff;
+  pdu.msg[pdu.N_bytes++]   = (extra_sn >> 2) & 0xff;
+  pdu.msg[pdu.N_bytes++]   = (extra_sn & 0x03) << 6;
+  srsran::rlc_am_nr_status_pdu_t rx(sn_size);
+  if (srsran::rlc_am_nr_read_status_pdu(&pdu, sn_size, &rx) != SRSRAN_SUCCESS or rx.ack_sn != extra_sn or
+      rx.nacks.size() != RLC_AM_NR_MAX_NACKS) {
+    fprintf(stderr, "Status PDU with %d NACKs read with ACK_SN=%d\n", RLC_AM_NR_MAX_NACKS + 1, rx.ack_sn);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::fetch_basic_logger("MAC-NR", false).set_level(srslog::basic_levels::none);
+
+  srsran::rlc_am_nr_sn_size_t sn_size =
+      sn_len == 12 ? srsran::rlc_am_nr_sn_size_t::size12bits : srsran::rlc_am_nr_sn_size_t::size18bits;
+  std::vector<uint8_t>                   tb    = make_ul_tb();
+  std::vector<srsran::rlc_status_nack_t> nacks = make_nacks(cardinality(sn_size));
+  srsran::mac_sch_pdu_nr                 mac_pdu(true);
+  srsran::rlc_am_nr_status_pdu_t         tx(sn_size), rx(sn_size);
+  srsran::byte_buffer_t                  status_pdu;
+
+  if (not check_mac(mac_pdu, tb) or not check_status(sn_size, nacks, tx, rx, status_pdu) or
+      not check_status_overflow()) {
+    return SRSRAN_ERROR;
+  }
+
+  uint64_t sum    = 0;
+  uint64_t allocs = nof_allocs;
+  auto     start  = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_ttis; i++) {
+    sum += parse_tb(mac_pdu, tb);
+  }
+  std::chrono::duration<double, std::nano> mac_time   = std::chrono::high_resolution_clock::now() - start;
+  uint64_t                                 mac_allocs = nof_allocs - allocs;
+
+  uint64_t nof_rx = 0;
+  allocs          = nof_allocs;
+  start           = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_ttis; i++) {
+    nof_rx += status_round_trip(sn_size, nacks, tx, rx, status_pdu);
+  }
+  std::chrono::duration<double, std::nano> rlc_time   = std::chrono::high_resolution_clock::now() - start;
+  uint64_t                                 rlc_allocs = nof_allocs - allocs;
+
+  if (sum != (uint64_t)nof_ttis * parse_tb(mac_pdu, tb) or nof_rx != (uint64_t)nof_ttis * tx.nacks.size()) {
+    fprintf(stderr, "Timed pass: TBs parsed to %ld, %ld NACKs read\n", sum, nof_rx);
+    return SRSRAN_ERROR;
+  }
+  if (mac_allocs != 0 or rlc_allocs != 0) {
+    fprintf(stderr,
+            "Heap allocations in %d TTIs: %ld parsing TBs, %ld on status PDUs\n",
+            nof_ttis,
+            mac_allocs,
+            rlc_allocs);
+    return SRSRAN_ERROR;
+  }
+
+  printf("MAC/RLC PDUs, %d B UL-SCH TBs, status PDUs of %d NACKs, %d bit SN, %d TTIs\n",
+         tb_len,
+         (uint32_t)tx.nacks.size(),
+         sn_len,
+         nof_ttis);
+  printf("\tMAC parse:   %.1f ns/TB\n", mac_time.count() / nof_ttis);
+  printf("\tRLC status:  %.1f ns/PDU (built, packed and read)\n", rlc_time.count() / nof_ttis);
+  printf("\theap allocs: 0 per TTI\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/**
+ * Benchmark of an RLC AM NR bearer under segmentation, loss and retransmission.
+ *
+ * A transmitting and a receiving entity are connected back to back. Every TTI the transmitter gets grants smaller than
+ * an SDU, so that every SDU is segmented, and a share of its data PDUs is lost on the way. The receiver answers the
+ * polls with status PDUs, from which the transmitter schedules the retransmissions of the lost SDUs and segments.
+ * Every SDU must be delivered exactly once. The rate is that of the SDU bytes delivered over the CPU time spent in
+ * the RLC.
+ */
+
+#include "mitm_lib/common/timers.h"
+#include "mitm_lib/config.h"
+#include "mitm_lib/interfaces/ue_pdcp_interfaces.h"
+#include "mitm_lib/interfaces/ue_rrc_interfaces.h"
+#include "mitm_lib/rlc/rlc_am_base.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+
+static uint32_t nof_sdus   = 100000;
+static uint32_t sdu_len    = 1500;
+static uint32_t grant_len  = 600;
+static uint32_t loss_ppm   = 20000;
+static uint32_t sn_len     = 18;
+static uint32_t grants_tti = 64; // grants of the transmitter per TTI
+
+static const uint32_t lcid = 4;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nlgpsh]\n", prog);
+  printf("\t-n Number of SDUs [Default %d]\n", nof_sdus);
+  printf("\t-l SDU length [Default %d]\n", sdu_len);
+  printf("\t-g Grant length [Default %d]\n", grant_len);
+  printf("\t-p Data PDU loss, in parts per million [Default %d]\n", loss_ppm);
+  printf("\t-s RLC SN length, 12 or 18 [Default %d]\n", sn_len);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nlgpsh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_sdus = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        sdu_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'g':
+        grant_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        loss_ppm = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        sn_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+// PDCP and RRC of both ends
+class test_upper : public srsue::pdcp_interface_rlc, public srsue::rrc_interface_rlc
+{
+public:
+  std::vector<uint8_t> received;
+  uint64_t             nof_delivered = 0;
+  uint64_t             nof_bytes     = 0;
+  uint64_t             nof_dups      = 0;
+  uint64_t             nof_failures  = 0;
+
+  void write_pdu(uint32_t lcid, srsran::unique_byte_buffer_t sdu) override
+  {
+    uint32_t seq;
+    memcpy(&seq, sdu->msg, sizeof(seq));
+    if (seq >= received.size() or received[seq]) {
+      nof_dups++;
+      return;
+    }
+    received[seq] = 1;
+    nof_delivered++;
+    nof_bytes += sdu->N_bytes;
+  }
+  void write_pdu_bcch_bch(srsran::unique_byte_buffer_t sdu) override {}
+  void write_pdu_bcch_dlsch(srsran::unique_byte_buffer_t sdu) override {}
+  void write_pdu_pcch(srsran::unique_byte_buffer_t sdu) override {}
+  void write_pdu_mch(uint32_t lcid, srsran::unique_byte_buffer_t sdu) override {}
+  void notify_delivery(uint32_t lcid, const srsran::pdcp_sn_vector_t& pdcp_sn) override {}
+  void notify_failure(uint32_t lcid, const srsran::pdcp_sn_vector_t& pdcp_sn) override {}
+
+  void        max_retx_attempted() override { nof_failures++; }
+  void        protocol_failure() override { nof_failures++; }
+  const char* get_rb_name(uint32_t lcid) override { return "DRB1"; }
+};
+
+// Deterministic loss pattern
+static bool is_lost(uint32_t& state)
+{
+  state = state * 1664525 + 1013904223;
+  return (state >> 8) % 1000000 < loss_ppm;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("RLC", false);
+  logger.set_level(srslog::basic_levels::none);
+
+  srsran::timer_handler timers(8);
+  test_upper            upper;
+  upper.received.resize(nof_sdus);
+  srsran::rlc_am tx(srsran::srsran_rat_t::nr, logger, lcid, &upper, &upper, &timers);
+  srsran::rlc_am rx(srsran::srsran_rat_t::nr, logger, lcid, &upper, &upper, &timers);
+
+  srsran::rlc_config_t cfg    = srsran::rlc_config_t::default_rlc_am_nr_config(sn_len);
+  cfg.am_nr.max_retx_thresh   = 32;
+  cfg.am_nr.t_status_prohibit = 1;
+  cfg.am_nr.t_reassembly      = 5;
+  cfg.am_nr.t_poll_retx       = 10;
+  cfg.tx_queue_length         = 256;
+  if (not tx.configure(cfg) or not rx.configure(cfg)) {
+    fprintf(stderr, "Could not configure the RLC entities\n");
+    return SRSRAN_ERROR;
+  }
+
+  std::vector<uint8_t>     pdu(std::max(grant_len, sdu_len + 16));
+  uint32_t                 loss_state = 1, next_sdu = 0, nof_tti = 0;
+  uint64_t                 nof_data_pdus = 0, nof_lost = 0, nof_status = 0;
+  std::chrono::nanoseconds elapsed{0};
+  while (upper.nof_delivered + upper.nof_failures < nof_sdus and nof_tti < 100 * nof_sdus) {
+    // Fill up the SDU queue as the PDCP would
+    srsran::unique_byte_buffer_t sdu;
+    for (; next_sdu < nof_sdus and not tx.sdu_queue_is_full(); next_sdu++) {
+      sdu = srsran::make_byte_buffer();
+      if (sdu == nullptr) {
+        break;
+      }
+      memset(sdu->msg, 0, sdu_len);
+      memcpy(sdu->msg, &next_sdu, sizeof(next_sdu));
+      sdu->N_bytes    = sdu_len;
+      sdu->md.pdcp_sn = next_sdu;
+
+      auto start = std::chrono::steady_clock::now();
+      tx.write_sdu(std::move(sdu));
+      elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    // Grants follow the buffer state as in the MAC, has_data() does not account for the SDU under segmentation
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t g = 0; g < grants_tti and tx.get_buffer_state() > 0; g++) {
+      uint32_t n = tx.read_pdu(pdu.data(), grant_len);
+      if (n == 0) {
+        break;
+      }
+      nof_data_pdus++;
+      if (is_lost(loss_state)) {
+        nof_lost++;
+        continue;
+      }
+      rx.write_pdu(pdu.data(), n);
+    }
+    // Status PDUs are not lost
+    while (rx.has_data()) {
+      uint32_t n = rx.read_pdu(pdu.data(), pdu.size());
+      if (n == 0) {
+        break;
+      }
+      nof_status++;
+      tx.write_pdu(pdu.data(), n);
+    }
+    timers.step_all();
+    elapsed += std::chrono::steady_clock::now() - start;
+    nof_tti++;
+  }
+
+  if (upper.nof_delivered != nof_sdus or upper.nof_dups > 0 or upper.nof_failures > 0) {
+    fprintf(stderr,
+            "%ld of %d SDUs delivered, %ld duplicates, %ld failures\n",
+            upper.nof_delivered,
+            nof_sdus,
+            upper.nof_dups,
+            upper.nof_failures);
+    return SRSRAN_ERROR;
+  }
+
+  printf("RLC AM NR, %d-bit SN, %d B SDUs in %d B grants, %.1f%% data PDU loss\n",
+         sn_len,
+         sdu_len,
+         grant_len,
+         loss_ppm / 1e4);
+  printf("\t%ld SDUs in %d TTIs, %ld data PDUs of which %ld lost, %ld status PDUs\n",
+         upper.nof_delivered,
+         nof_tti,
+         nof_data_pdus,
+         nof_lost,
+         nof_status);
+  printf("\t%.1f ns/SDU, %.1f Mbps\n",
+         (double)elapsed.count() / nof_sdus,
+         upper.nof_bytes * 8 * 1e3 / std::max((int64_t)elapsed.count(), (int64_t)1));
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,530 @@
+/**
+ * Benchmark of the NAS/PDCP integrity and ciphering primitives.
+ *
+ * Every algorithm is first checked against the 3GPP test vectors, then timed over message sizes that span a short
+ * RRC/NAS PDU up to a full PDCP SDU. A failed test vector makes the run fail, so this also runs as a ctest.
+ *
+ * The ZUC and SNOW 3G keystream generators are also checked and timed through their multi-buffer API, for a batch of
+ * streams as produced by many UEs/bearers.
+ *
+ * The batched PDCP primitives must give the same result as the per-PDU ones, and are timed against them for a burst of
+ * PDUs of one bearer.
+ *
+ * The 5G key derivations go through the KDF cache. They are checked against the liblte implementation, with and
+ * without a cache hit, and the cost of re-keying a UE is timed for both cases.
+ *
+ * 5G authentication vectors are generated in batches and checked against Milenage test set 1 and the per-call
+ * functions.
+ */
+
+#include "mitm_lib/asn1/asn1_utils.h"
+#include "mitm_lib/common/liblte_security.h"
+#include "mitm_lib/common/s3g.h"
+#include "mitm_lib/common/security.h"
+#include "mitm_lib/common/zuc.h"
+#include "mitm_lib/config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <getopt.h>
+#include <vector>
+
+static uint32_t nof_repetitions = 10000;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nh]\n", prog);
+  printf("\t-n Number of PDUs per algorithm and size [Default %d]\n", nof_repetitions);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nh")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+struct test_vector_t {
+  const char* name;
+  const char* key;
+  uint32_t    count;
+  uint8_t     bearer;
+  uint8_t     direction;
+  uint32_t    len_bits;
+  const char* msg;
+  const char* expected;
+};
+
+// 128-EIA3 test sets 1 to 3 (TS 35.223 / TS 33.401 Annex C.4)
+static const test_vector_t eia3_vectors[] = {
+    {"128-EIA3 set 1", "00000000000000000000000000000000", 0x0, 0x0, 0, 1, "00000000", "c8a9595e"},
+    {"128-EIA3 set 2",
+     "47054125561eb2dda94059da05097850",
+     0x561eb2dd,
+     0x14,
+     0,
+     90,
+     "000000000000000000000000",
+     "6719a088"},
+    {"128-EIA3 set 3",
+     "c9e6cec4607c72db000aefa88385ab0a",
+     0xa94059da,
+     0xa,
+     1,
+     577,
+     "983b41d47d780c9e1ad11d7eb70391b1de0b35da2dc62f83e7b78d6306ca0ea07e941b7be91348f9fcb170e2217fecd97f9f68adb16e"
+     "5d7d21e569d280ed775cebde3f4093c5388100000000",
+     "fae8ff0b"},
+};
+
+// ZUC test sets 1 to 3 (TS 35.222 / ZUC specification v1.6), first two keystream words
+struct zuc_test_vector_t {
+  const char* key;
+  const char* iv;
+  uint32_t    z[2];
+};
+static const zuc_test_vector_t zuc_vectors[] = {
+    {"00000000000000000000000000000000", "00000000000000000000000000000000", {0x27bede74, 0x018082da}},
+    {"ffffffffffffffffffffffffffffffff", "ffffffffffffffffffffffffffffffff", {0x0657cfa0, 0x7096398b}},
+    {"3d4c4be96a82fdaeb58f641db17b455b", "84319aa8de6915ca1f6bda6bfbd8c766", {0x14f1c272, 0x3279c419}},
+};
+
+// SNOW 3G test set 1 (SNOW 3G specification, document 4), first two keystream words
+struct s3g_test_vector_t {
+  uint32_t k[4];
+  uint32_t iv[4];
+  uint32_t z[2];
+};
+static const s3g_test_vector_t s3g_vectors[] = {
+    {{0x2bd6459f, 0x82c5b300, 0x952c4910, 0x4881ff48},
+     {0xea024714, 0xad5c4d84, 0xdf1f9b25, 0x1c0bf45f},
+     {0xabee9704, 0x7ac31373}},
+};
+
+static std::vector<uint8_t> from_hex(const char* hex)
+{
+  std::vector<uint8_t> v(strlen(hex) / 2);
+  asn1::hex_to_octstring(v.data(), hex, strlen(hex));
+  return v;
+}
+
+static bool check_eia3_vectors()
+{
+  bool ok = true;
+  for (const test_vector_t& t : eia3_vectors) {
+    std::vector<uint8_t> key = from_hex(t.key);
+    std::vector<uint8_t> msg = from_hex(t.msg);
+    std::vector<uint8_t> exp = from_hex(t.expected);
+    uint8_t              mac[4];
+    liblte_security_128_eia3(key.data(), t.count, t.bearer, t.direction, msg.data(), t.len_bits, mac);
+    bool match = memcmp(mac, exp.data(), sizeof(mac)) == 0;
+    printf("%-16s %s\n", t.name, match ? "ok" : "FAILED");
+    ok &= match;
+  }
+  return ok;
+}
+
+// Every vector in every lane: the batch holds each vector more than once per lane group
+static bool check_keystream_vectors()
+{
+  bool ok = true;
+
+  const uint32_t                    nof_zuc = 2 * zuc_mb_lanes() + 1;
+  std::vector<std::vector<uint8_t>> keys, ivs;
+  std::vector<zuc_mb_job_t>         zuc_jobs(nof_zuc);
+  std::vector<uint32_t>             zuc_out(2 * nof_zuc);
+  for (const zuc_test_vector_t& t : zuc_vectors) {
+    keys.push_back(from_hex(t.key));
+    ivs.push_back(from_hex(t.iv));
+  }
+  for (uint32_t j = 0; j < nof_zuc; ++j) {
+    uint32_t v  = j % (sizeof(zuc_vectors) / sizeof(zuc_vectors[0]));
+    zuc_jobs[j] = {keys[v].data(), ivs[v].data(), &zuc_out[2 * j], 2};
+  }
+  zuc_generate_keystream_mb(zuc_jobs.data(), nof_zuc);
+  for (uint32_t v = 0; v < keys.size(); ++v) {
+    zuc_state_t state;
+    uint32_t    z[2];
+    zuc_initialize(&state, keys[v].data(), ivs[v].data());
+    zuc_generate_keystream(&state, 2, z);
+    bool match = memcmp(z, zuc_vectors[v].z, sizeof(z)) == 0;
+    for (uint32_t j = v; j < nof_zuc; j += keys.size()) {
+      match &= memcmp(&zuc_out[2 * j], zuc_vectors[v].z, sizeof(z)) == 0;
+    }
+    printf("ZUC set %u         %s\n", v + 1, match ? "ok" : "FAILED");
+    ok &= match;
+  }
+
+  const uint32_t            nof_s3g = 2 * s3g_mb_lanes() + 1;
+  std::vector<s3g_mb_job_t> s3g_jobs(nof_s3g);
+  std::vector<uint32_t>     s3g_out(2 * nof_s3g);
+  for (const s3g_test_vector_t& t : s3g_vectors) {
+    S3G_STATE state;
+    uint32_t  k[4], iv[4], z[2];
+    memcpy(k, t.k, sizeof(k));
+    memcpy(iv, t.iv, sizeof(iv));
+    s3g_initialize(&state, k, iv);
+    s3g_generate_keystream(&state, 2, z);
+    s3g_deinitialize(&state);
+    for (uint32_t j = 0; j < nof_s3g; ++j) {
+      s3g_jobs[j] = {t.k, t.iv, &s3g_out[2 * j], 2};
+    }
+    s3g_generate_keystream_mb(s3g_jobs.data(), nof_s3g);
+    bool match = memcmp(z, t.z, sizeof(z)) == 0;
+    for (uint32_t j = 0; j < nof_s3g; ++j) {
+      match &= memcmp(&s3g_out[2 * j], t.z, sizeof(z)) == 0;
+    }
+    printf("SNOW 3G set %u     %s\n", (uint32_t)(&t - s3g_vectors) + 1, match ? "ok" : "FAILED");
+    ok &= match;
+  }
+
+  return ok;
+}
+
+// Every batched algorithm against its per-PDU version, over a burst of PDUs of mixed lengths
+static bool check_batch()
+{
+  const uint32_t nof_pdus = 37;
+  uint8_t        key[16];
+  for (uint32_t i = 0; i < sizeof(key); ++i) {
+    key[i] = (uint8_t)(0xa5 ^ (31 * i));
+  }
+  srsran::security_128_eia2_ctx_t eia2_ctx;
+  srsran::security_128_eea2_ctx_t eea2_ctx;
+  srsran::security_128_eia2_init(eia2_ctx, key);
+  srsran::security_128_eea2_init(eea2_ctx, key);
+
+  std::vector<std::vector<uint8_t>> msgs(nof_pdus);
+  for (uint32_t j = 0; j < nof_pdus; ++j) {
+    msgs[j].resize(1 + (j * 97) % 300);
+    for (uint32_t i = 0; i < msgs[j].size(); ++i) {
+      msgs[j][i] = (uint8_t)(i * 13 + j);
+    }
+  }
+
+  std::vector<std::vector<uint8_t>>   out(nof_pdus);
+  std::vector<srsran::security_pdu_t> pdus(nof_pdus);
+  auto                                run_batch = [&](bool mac) {
+    for (uint32_t j = 0; j < nof_pdus; ++j) {
+      out[j].assign(mac ? 4 : msgs[j].size(), 0);
+      pdus[j] = {msgs[j].data(), (uint32_t)msgs[j].size(), 1000 + 7 * j, out[j].data()};
+    }
+  };
+  auto compare = [&](const char* name, std::function<void(uint32_t, uint8_t*)> single, bool mac) {
+    bool match = true;
+    for (uint32_t j = 0; j < nof_pdus; ++j) {
+      std::vector<uint8_t> exp(mac ? 4 : msgs[j].size());
+      single(j, exp.data());
+      match &= exp == out[j];
+    }
+    printf("%-16s %s\n", name, match ? "ok" : "FAILED");
+    return match;
+  };
+
+  bool ok = true;
+  run_batch(true);
+  srsran::security_128_eia1_batch(key, 3, 1, pdus);
+  ok &= compare("128-EIA1 batch", [&](uint32_t j, uint8_t* mac) {
+    srsran::security_128_eia1(key, pdus[j].count, 3, 1, msgs[j].data(), msgs[j].size(), mac);
+  }, true);
+  run_batch(true);
+  srsran::security_128_eia2_batch(eia2_ctx, 3, 1, pdus);
+  ok &= compare("128-EIA2 batch", [&](uint32_t j, uint8_t* mac) {
+    srsran::security_128_eia2(key, pdus[j].count, 3, 1, msgs[j].data(), msgs[j].size(), mac);
+  }, true);
+  run_batch(true);
+  srsran::security_128_eia3_batch(key, 3, 1, pdus);
+  ok &= compare("128-EIA3 batch", [&](uint32_t j, uint8_t* mac) {
+    srsran::security_128_eia3(key, pdus[j].count, 3, 1, msgs[j].data(), msgs[j].size(), mac);
+  }, true);
+  run_batch(false);
+  srsran::security_128_eea1_batch(key, 3, 1, pdus);
+  ok &= compare("128-EEA1 batch", [&](uint32_t j, uint8_t* ct) {
+    srsran::security_128_eea1(key, pdus[j].count, 3, 1, msgs[j].data(), msgs[j].size(), ct);
+  }, false);
+  run_batch(false);
+  srsran::security_128_eea2_batch(eea2_ctx, 3, 1, pdus);
+  ok &= compare("128-EEA2 batch", [&](uint32_t j, uint8_t* ct) {
+    srsran::security_128_eea2(key, pdus[j].count, 3, 1, msgs[j].data(), msgs[j].size(), ct);
+  }, false);
+  run_batch(false);
+  srsran::security_128_eea3_batch(key, 3, 1, pdus);
+  ok &= compare("128-EEA3 batch", [&](uint32_t j, uint8_t* ct) {
+    srsran::security_128_eea3(key, pdus[j].count, 3, 1, msgs[j].data(), msgs[j].size(), ct);
+  }, false);
+  return ok;
+}
+
+// RRC and UP keys of a few gNB keys, derived twice: the second pass must hit the cache and give the same keys
+static bool check_kdf_cache()
+{
+  bool ok = true;
+  srsran::kdf_cache_clear();
+  srsran::kdf_cache_metrics_t before = srsran::kdf_cache_get_metrics();
+  for (uint32_t pass = 0; pass < 2; ++pass) {
+    for (uint32_t ue = 0; ue < 4; ++ue) {
+      uint8_t k_gnb[32];
+      uint8_t k_enc[32], k_int[32], exp_enc[32], exp_int[32];
+      for (uint32_t i = 0; i < sizeof(k_gnb); ++i) {
+        k_gnb[i] = (uint8_t)(ue * 41 + i);
+      }
+      auto enc = (srsran::CIPHERING_ALGORITHM_ID_ENUM)(ue % 4);
+      auto in  = (srsran::INTEGRITY_ALGORITHM_ID_ENUM)((ue + 1) % 4);
+      srsran::security_generate_k_nr_rrc(k_gnb, enc, in, k_enc, k_int);
+      liblte_security_generate_k_nr_rrc(k_gnb,
+                                        (LIBLTE_SECURITY_CIPHERING_ALGORITHM_ID_ENUM)enc,
+                                        (LIBLTE_SECURITY_INTEGRITY_ALGORITHM_ID_ENUM)in,
+                                        exp_enc,
+                                        exp_int);
+      ok &= memcmp(k_enc, exp_enc, 32) == 0 and memcmp(k_int, exp_int, 32) == 0;
+      srsran::security_generate_k_nr_up(k_gnb, enc, in, k_enc, k_int);
+      liblte_security_generate_k_nr_up(k_gnb,
+                                       (LIBLTE_SECURITY_CIPHERING_ALGORITHM_ID_ENUM)enc,
+                                       (LIBLTE_SECURITY_INTEGRITY_ALGORITHM_ID_ENUM)in,
+                                       exp_enc,
+                                       exp_int);
+      ok &= memcmp(k_enc, exp_enc, 32) == 0 and memcmp(k_int, exp_int, 32) == 0;
+    }
+  }
+  srsran::kdf_cache_metrics_t after = srsran::kdf_cache_get_metrics();
+  ok &= after.misses - before.misses == 16 and after.hits - before.hits == 16;
+  printf("KDF cache        %s\n", ok ? "ok" : "FAILED");
+  return ok;
+}
+
+// Milenage test set 1 (TS 35.208 4.3)
+static const char* milenage_k    = "465b5ce8b199b49faa5f0a2ee238a6bc";
+static const char* milenage_opc  = "cd63cb71954a9f4e48a5994e37a02baf";
+static const char* milenage_rand = "23553cbe9637a89d218ae64dae47bf35";
+static const char* milenage_sqn  = "ff9bb4d0b607";
+static const char* milenage_amf  = "b9b9";
+static const char* milenage_autn = "55f328b43577b9b94a9ffac354dfafb3";
+static const char* serving_net   = "5G:mnc001.mcc001.3gppnetwork.org";
+
+// Vectors of several subscribers and RANDs in one batch, against the per-call functions
+static bool check_av_batch()
+{
+  const uint32_t                                      nof_subs = 3, nof_avs = 11;
+  std::vector<srsran::security_milenage_subscriber_t> subs(nof_subs);
+  std::vector<std::vector<uint8_t>>                   keys(nof_subs), opcs(nof_subs), rands(nof_avs);
+  std::vector<srsran::security_5g_av_t>               avs(nof_avs);
+  std::vector<srsran::security_5g_av_req_t>           reqs(nof_avs);
+  std::vector<uint8_t>                                sqn = from_hex(milenage_sqn), amf = from_hex(milenage_amf);
+  for (uint32_t u = 0; u < nof_subs; ++u) {
+    keys[u] = from_hex(milenage_k);
+    opcs[u] = from_hex(milenage_opc);
+    keys[u][0] ^= u;
+    opcs[u][1] ^= u;
+    srsran::security_milenage_subscriber_init(subs[u], keys[u].data(), opcs[u].data());
+  }
+  for (uint32_t j = 0; j < nof_avs; ++j) {
+    rands[j] = from_hex(milenage_rand);
+    rands[j][15] ^= j;
+    reqs[j] = {&subs[j % nof_subs], rands[j].data(), sqn.data(), amf.data(), &avs[j]};
+  }
+  bool ok = srsran::security_generate_5g_av_batch(reqs, serving_net) == SRSRAN_SUCCESS;
+
+  // The first vector is test set 1 itself
+  ok &= memcmp(avs[0].autn, from_hex(milenage_autn).data(), 16) == 0;
+  for (uint32_t j = 0; j < nof_avs; ++j) {
+    uint32_t u = j % nof_subs;
+    uint8_t  res[8], ck[16], ik[16], ak[6], mac_a[8], sqn_xor_ak[6], xres_star[16], k_ausf[32];
+    srsran::security_milenage_f2345(keys[u].data(), opcs[u].data(), rands[j].data(), res, ck, ik, ak);
+    srsran::security_milenage_f1(keys[u].data(), opcs[u].data(), rands[j].data(), sqn.data(), amf.data(), mac_a);
+    for (uint32_t i = 0; i < 6; ++i) {
+      sqn_xor_ak[i] = sqn[i] ^ ak[i];
+    }
+    srsran::security_generate_res_star(ck, ik, serving_net, rands[j].data(), res, sizeof(res), xres_star);
+    srsran::security_generate_k_ausf(ck, ik, sqn_xor_ak, serving_net, k_ausf);
+    ok &= memcmp(avs[j].rand, rands[j].data(), 16) == 0 and memcmp(avs[j].autn, sqn_xor_ak, 6) == 0 and
+          memcmp(avs[j].autn + 8, mac_a, 8) == 0 and memcmp(avs[j].xres_star, xres_star, 16) == 0 and
+          memcmp(avs[j].k_ausf, k_ausf, 32) == 0;
+  }
+  printf("5G AV batch      %s\n", ok ? "ok" : "FAILED");
+  return ok;
+}
+
+template <class Fn>
+static double time_ns_per_pdu(Fn&& fn)
+{
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    fn(i);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / nof_repetitions;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  if (not check_eia3_vectors() or not check_keystream_vectors() or not check_batch() or
+      not check_kdf_cache() or not check_av_batch()) {
+    return -1;
+  }
+
+  uint8_t              key[16];
+  std::vector<uint8_t> msg(9000);
+  for (uint32_t i = 0; i < sizeof(key); ++i) {
+    key[i] = (uint8_t)(0x5a + 13 * i);
+  }
+  for (uint32_t i = 0; i < msg.size(); ++i) {
+    msg[i] = (uint8_t)(i * 7);
+  }
+
+  printf("\n%-10s %8s %12s %10s\n", "Algorithm", "Bytes", "ns/PDU", "Mbit/s");
+  for (uint32_t len : {32, 128, 512, 1500, 9000}) {
+    uint8_t mac[4];
+    double  ns = time_ns_per_pdu([&](uint32_t count) {
+      srsran::security_128_eia3(key, count, 1, srsran::SECURITY_DIRECTION_UPLINK, msg.data(), len, mac);
+    });
+    printf("%-10s %8u %12.0f %10.1f\n", "128-EIA3", len, ns, len * 8 / ns * 1000);
+  }
+
+  // Keystream for a batch of 1500 byte PDUs, one stream at a time and through the multi-buffer API
+  const uint32_t                     nof_streams = 64;
+  const uint32_t                     ks_words    = 1500 / 4;
+  std::vector<std::vector<uint32_t>> ks(nof_streams, std::vector<uint32_t>(ks_words));
+  std::vector<zuc_mb_job_t>          zuc_jobs(nof_streams);
+  std::vector<s3g_mb_job_t>          s3g_jobs(nof_streams);
+  uint32_t                           k32[4] = {0x01234567, 0x89abcdef, 0xfedcba98, 0x76543210};
+  for (uint32_t j = 0; j < nof_streams; ++j) {
+    zuc_jobs[j] = {key, key, ks[j].data(), (int)ks_words};
+    s3g_jobs[j] = {k32, k32, ks[j].data(), ks_words};
+  }
+  uint32_t reps = std::max(nof_repetitions / nof_streams, 1U);
+
+  printf("\n%-14s %8s %12s %10s\n", "Keystream", "Streams", "ns/stream", "Mbit/s");
+  auto report = [&](const char* name, uint32_t lanes, double ns) {
+    printf("%-10s x%-3u %8u %12.0f %10.1f\n", name, lanes, nof_streams, ns, ks_words * 32 / ns * 1000);
+  };
+  auto time_batch = [&](std::function<void()> fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < reps; ++r) {
+      fn();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (reps * nof_streams);
+  };
+  report("ZUC", 1, time_batch([&]() {
+           for (uint32_t j = 0; j < nof_streams; ++j) {
+             zuc_state_t state;
+             zuc_initialize(&state, key, key);
+             zuc_generate_keystream(&state, ks_words, ks[j].data());
+           }
+         }));
+  report("ZUC", zuc_mb_lanes(), time_batch([&]() { zuc_generate_keystream_mb(zuc_jobs.data(), nof_streams); }));
+  report("SNOW 3G", 1, time_batch([&]() {
+           for (uint32_t j = 0; j < nof_streams; ++j) {
+             S3G_STATE state;
+             s3g_initialize(&state, k32, k32);
+             s3g_generate_keystream(&state, ks_words, ks[j].data());
+             s3g_deinitialize(&state);
+           }
+         }));
+  report("SNOW 3G", s3g_mb_lanes(), time_batch([&]() { s3g_generate_keystream_mb(s3g_jobs.data(), nof_streams); }));
+
+  // PDCP burst of one bearer: one call per PDU against one batched call
+  std::vector<std::vector<uint8_t>>   pdu_buf(nof_streams, std::vector<uint8_t>(msg.begin(), msg.begin() + 1500));
+  std::vector<srsran::security_pdu_t> pdus(nof_streams);
+  std::vector<uint8_t>                macs(4 * nof_streams);
+  srsran::security_128_eia2_ctx_t     eia2_ctx;
+  srsran::security_128_eea2_ctx_t     eea2_ctx;
+  srsran::security_128_eia2_init(eia2_ctx, key);
+  srsran::security_128_eea2_init(eea2_ctx, key);
+  auto set_pdus = [&](bool mac) {
+    for (uint32_t j = 0; j < nof_streams; ++j) {
+      pdus[j] = {pdu_buf[j].data(), 1500, j, mac ? &macs[4 * j] : pdu_buf[j].data()};
+    }
+  };
+
+  printf("\n%-14s %8s %12s %10s\n", "PDCP burst", "PDUs", "ns/PDU", "Mbit/s");
+  auto report_pdcp = [&](const char* name, double ns) {
+    printf("%-14s %8u %12.0f %10.1f\n", name, nof_streams, ns, 1500 * 8 / ns * 1000);
+  };
+  set_pdus(false);
+  report_pdcp("128-EEA2", time_batch([&]() {
+                for (const srsran::security_pdu_t& p : pdus) {
+                  srsran::security_128_eea2(eea2_ctx, p.count, 1, 0, p.msg, p.msg_len, p.out);
+                }
+              }));
+  report_pdcp("128-EEA2 batch", time_batch([&]() { srsran::security_128_eea2_batch(eea2_ctx, 1, 0, pdus); }));
+  report_pdcp("128-EEA3", time_batch([&]() {
+                for (const srsran::security_pdu_t& p : pdus) {
+                  srsran::security_128_eea3(key, p.count, 1, 0, (uint8_t*)p.msg, p.msg_len, p.out);
+                }
+              }));
+  report_pdcp("128-EEA3 batch", time_batch([&]() { srsran::security_128_eea3_batch(key, 1, 0, pdus); }));
+  set_pdus(true);
+  report_pdcp("128-EIA2", time_batch([&]() {
+                for (const srsran::security_pdu_t& p : pdus) {
+                  srsran::security_128_eia2(eia2_ctx, p.count, 1, 0, p.msg, p.msg_len, p.out);
+                }
+              }));
+  report_pdcp("128-EIA2 batch", time_batch([&]() { srsran::security_128_eia2_batch(eia2_ctx, 1, 0, pdus); }));
+
+  // Re-keying of a UE: K_gNB, then the RRC and UP keys
+  srsran::as_key_t k_amf, k_gnb;
+  uint8_t          k_rrc_enc[32], k_rrc_int[32], k_up_enc[32], k_up_int[32];
+  k_amf.fill(0x3c);
+  auto rekey = [&](uint32_t nas_count) {
+    srsran::security_generate_k_gnb(k_amf, nas_count, k_gnb);
+    srsran::security_generate_k_nr_rrc(k_gnb.data(),
+                                       srsran::CIPHERING_ALGORITHM_ID_128_EEA2,
+                                       srsran::INTEGRITY_ALGORITHM_ID_128_EIA2,
+                                       k_rrc_enc,
+                                       k_rrc_int);
+    srsran::security_generate_k_nr_up(k_gnb.data(),
+                                      srsran::CIPHERING_ALGORITHM_ID_128_EEA2,
+                                      srsran::INTEGRITY_ALGORITHM_ID_128_EIA2,
+                                      k_up_enc,
+                                      k_up_int);
+  };
+  printf("\n%-14s %12s\n", "Re-keying", "ns/UE");
+  printf("%-14s %12.0f\n", "uncached", time_ns_per_pdu([&](uint32_t i) { rekey(16 + i); }));
+  printf("%-14s %12.0f\n", "cached", time_ns_per_pdu([&](uint32_t i) { rekey(i % 16); }));
+
+  // Authentication vectors of one subscriber, one at a time and in batches
+  std::vector<uint8_t>                      av_k = from_hex(milenage_k), av_opc = from_hex(milenage_opc);
+  std::vector<uint8_t>                      av_sqn = from_hex(milenage_sqn), av_amf = from_hex(milenage_amf);
+  std::vector<std::vector<uint8_t>>         av_rand(nof_streams, from_hex(milenage_rand));
+  std::vector<srsran::security_5g_av_t>     avs(nof_streams);
+  std::vector<srsran::security_5g_av_req_t> av_reqs(nof_streams);
+  srsran::security_milenage_subscriber_t    sub;
+  srsran::security_milenage_subscriber_init(sub, av_k.data(), av_opc.data());
+  for (uint32_t j = 0; j < nof_streams; ++j) {
+    av_rand[j][0] = j;
+    av_reqs[j]    = {&sub, av_rand[j].data(), av_sqn.data(), av_amf.data(), &avs[j]};
+  }
+  printf("\n%-14s %12s\n", "5G AV", "ns/vector");
+  printf("%-14s %12.0f\n", "per call", time_batch([&]() {
+           for (uint32_t j = 0; j < nof_streams; ++j) {
+             uint8_t res[8], ck[16], ik[16], ak[6], sqn_xor_ak[6];
+             srsran::security_milenage_f2345(av_k.data(), av_opc.data(), av_rand[j].data(), res, ck, ik, ak);
+             srsran::security_milenage_f1(
+                 av_k.data(), av_opc.data(), av_rand[j].data(), av_sqn.data(), av_amf.data(), avs[j].autn + 8);
+             for (uint32_t i = 0; i < 6; ++i) {
+               sqn_xor_ak[i] = av_sqn[i] ^ ak[i];
+             }
+             srsran::security_generate_res_star(
+                 ck, ik, serving_net, av_rand[j].data(), res, sizeof(res), avs[j].xres_star);
+             srsran::security_generate_k_ausf(ck, ik, sqn_xor_ak, serving_net, avs[j].k_ausf);
+           }
+         }));
+  printf("%-14s %12.0f\n", "batch", time_batch([&]() { srsran::security_generate_5g_av_batch(av_reqs, serving_net); }));
+
+  return 0;
+}
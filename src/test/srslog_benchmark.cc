@@ -0,0 +1,198 @@
+/**
+ * Benchmark of srslog log calls from concurrent producer threads.
+ *
+ * A number of producer threads, as the relay threads do, log through log channels writing into a counting sink. The
+ * check pass logs fewer entries than the backend queue holds and verifies that every entry reaches the sink, in the
+ * order of its thread, and that a flush returns once all of them did. The timed pass measures the latency of the log
+ * calls seen by the producers, which the backend must not stretch, and of a flush.
+ */
+
+#include "mitm_lib/config.h"
+#include "mitm_lib/srslog/detail/support/backend_capacity.h"
+#include "mitm_lib/srslog/srslog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+static uint32_t nof_threads = 4;
+static uint32_t nof_entries = 100000;
+static uint32_t period_ns   = 1000; // between log calls of a producer
+
+static const uint32_t max_threads = 64;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [tnph]\n", prog);
+  printf("\t-t Number of producer threads [Default %d]\n", nof_threads);
+  printf("\t-n Log calls per thread [Default %d]\n", nof_entries);
+  printf("\t-p Period between the log calls of a thread, in ns [Default %d]\n", period_ns);
+  printf("\t-h show this message\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "tnph")) != -1) {
+    switch (opt) {
+      case 't':
+        nof_threads = std::min((uint32_t)strtol(argv[optind], NULL, 10), max_threads);
+        break;
+      case 'n':
+        nof_entries = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        period_ns = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        exit(0);
+    }
+  }
+}
+
+/// Counts the entries written from each producer, and those written after a later one of the same producer. Written
+/// from the backend thread only.
+class counting_sink : public srslog::sink
+{
+public:
+  counting_sink() : sink(srslog::create_text_formatter()) {}
+
+  void reset()
+  {
+    std::fill(std::begin(counts), std::end(counts), 0);
+    std::fill(std::begin(next_seq), std::end(next_seq), 0);
+    nof_unordered = 0;
+  }
+
+  srslog::detail::error_string write(srslog::detail::memory_buffer buffer) override
+  {
+    // The message is "producer <thread> entry <seq>"
+    std::string line(buffer.data(), buffer.size());
+    size_t      pos = line.find("producer ");
+    uint32_t    thread, seq;
+    if (pos == std::string::npos or sscanf(line.c_str() + pos, "producer %u entry %u", &thread, &seq) != 2 or
+        thread >= max_threads) {
+      return "Unexpected log entry: " + line;
+    }
+    if (seq < next_seq[thread]) {
+      nof_unordered++;
+    }
+    next_seq[thread] = seq + 1;
+    counts[thread]++;
+    return {};
+  }
+
+  srslog::detail::error_string flush() override { return {}; }
+
+  uint32_t counts[max_threads]   = {};
+  uint32_t next_seq[max_threads] = {};
+  uint32_t nof_unordered         = 0;
+};
+
+static counting_sink sink;
+
+// Logs n entries from each thread, returns the latencies of the log calls
+static std::vector<uint32_t> run_producers(uint32_t n, uint32_t period)
+{
+  std::vector<uint32_t>    latencies(nof_threads * n);
+  std::vector<std::thread> threads;
+  std::atomic<bool>        go{false};
+  for (uint32_t t = 0; t < nof_threads; t++) {
+    threads.emplace_back([t, n, period, &latencies, &go]() {
+      srslog::log_channel& channel = srslog::fetch_log_channel("PROD" + std::to_string(t), sink, {});
+      uint32_t*            lat     = latencies.data() + t * n;
+      while (!go) {
+      }
+      auto next = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < n; i++) {
+        auto start = std::chrono::steady_clock::now();
+        channel("producer %u entry %u", t, i);
+        auto end = std::chrono::steady_clock::now();
+        lat[i]   = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        next += std::chrono::nanoseconds(period);
+        while (std::chrono::steady_clock::now() < next) {
+        }
+      }
+    });
+  }
+  go = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return latencies;
+}
+
+static bool check_delivery()
+{
+  const uint32_t n = SRSLOG_QUEUE_CAPACITY / 2 / nof_threads;
+
+  sink.reset();
+  run_producers(n, 0);
+  auto start = std::chrono::steady_clock::now();
+  srslog::flush();
+  std::chrono::duration<double, std::micro> flush_time = std::chrono::steady_clock::now() - start;
+
+  for (uint32_t t = 0; t < nof_threads; t++) {
+    if (sink.counts[t] != n) {
+      fprintf(stderr, "Producer %d: %d of %d entries written after the flush\n", t, sink.counts[t], n);
+      return false;
+    }
+  }
+  if (sink.nof_unordered != 0) {
+    fprintf(stderr, "%d entries written out of order\n", sink.nof_unordered);
+    return false;
+  }
+  printf("Check pass: %d entries from %d threads written, flushed in %.1f us\n",
+         n * nof_threads,
+         nof_threads,
+         flush_time.count());
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::set_error_handler([](const std::string& error) { fprintf(stderr, "%s\n", error.c_str()); });
+  srslog::init();
+
+  if (not check_delivery()) {
+    return SRSRAN_ERROR;
+  }
+
+  sink.reset();
+  std::vector<uint32_t> latencies = run_producers(nof_entries, period_ns);
+  auto                  start     = std::chrono::steady_clock::now();
+  srslog::flush();
+  std::chrono::duration<double, std::micro> flush_time = std::chrono::steady_clock::now() - start;
+
+  // Entries are dropped when the queue is full, never reordered
+  uint64_t nof_written = 0;
+  for (uint32_t t = 0; t < nof_threads; t++) {
+    nof_written += sink.counts[t];
+  }
+  if (nof_written == 0 or sink.nof_unordered != 0) {
+    fprintf(stderr, "Timed pass: %ld entries written, %d out of order\n", nof_written, sink.nof_unordered);
+    return SRSRAN_ERROR;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) { return latencies[(size_t)(p * (latencies.size() - 1))]; };
+  printf("srslog, %d producer threads, %d log calls each, one every %d ns\n", nof_threads, nof_entries, period_ns);
+  printf("\tlog call: p50 %d ns, p99 %d ns, p99.9 %d ns, max %d ns\n",
+         percentile(0.5),
+         percentile(0.99),
+         percentile(0.999),
+         latencies.back());
+  printf("\tflush:    %.1f us\n", flush_time.count());
+  printf("\twritten:  %ld of %ld entries\n", nof_written, (uint64_t)nof_threads * nof_entries);
+  return SRSRAN_SUCCESS;
+}
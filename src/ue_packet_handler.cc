@@ -1,5 +1,6 @@
 #include "ue_packet_handler.h"
 #include "nas_packet_handler.h"
+#include "drb_lane.h"
 
 #include <iostream>
 
@@ -13,28 +14,38 @@ int decode_ul_dcch(uint8_t * buf, int n, asn1::json_writer & json_buffer);
 
 int UE::decode_packet(uint8_t *buf, int n, asn1::json_writer & json_buffer)
 {
-    struct from_ue_struct
+    uint32_t channel;
+    if (n < (int)sizeof(channel))
     {
-        uint32_t channel;
-        uint8_t msg[32768];
-    } buffer;
-    
-    memcpy(&buffer, buf, n);
+        std::cerr << "Datagram too short for its channel" << std::endl;
+        return SRSRAN_ERROR;
+    }
+    memcpy(&channel, buf, sizeof(channel));
+    return decode_sdu(channel, buf + sizeof(channel), n - sizeof(channel), json_buffer);
+}
 
-    switch (static_cast<srsran::nr_srb>(buffer.channel))
+int UE::decode_sdu(uint32_t channel, uint8_t *sdu, int n, asn1::json_writer & json_buffer)
+{
+    switch (static_cast<srsran::nr_srb>(channel))
     {
     case srsran::nr_srb::srb0:
         // ccch
-        return decode_ul_ccch(buffer.msg, n - sizeof(uint32_t), json_buffer);
+        return decode_ul_ccch(sdu, n, json_buffer);
         break;
     case srsran::nr_srb::srb1:
     case srsran::nr_srb::srb2:
     case srsran::nr_srb::srb3:
         // dcch
-        return decode_ul_dcch(buffer.msg, n - sizeof(uint32_t), json_buffer);
+        return decode_ul_dcch(sdu, n, json_buffer);
         break;
     default:
-        std::string errcause = fmt::format("Invalid LCID=%d", buffer.channel);
+        if (drb_lane::is_drb_lcid(channel))
+        {
+            // Sampled by the DRB lane, user data is not decoded
+            drb_lane::to_json(channel, sdu, n, json_buffer);
+            break;
+        }
+        std::string errcause = fmt::format("Invalid LCID=%d", channel);
         std::cerr <<errcause <<std::endl;
         break;
     }
@@ -79,7 +90,7 @@ int decode_ul_dcch(uint8_t * buf, int n, asn1::json_writer & json_buffer)
             pdu->N_bytes = ul_info_transfer.crit_exts.ul_info_transfer().ded_nas_msg.size();
             memcpy(pdu->msg, ul_info_transfer.crit_exts.ul_info_transfer().ded_nas_msg.data(), pdu->N_bytes);
 
-            handle_nas_msg(std::move(pdu), json_buffer);
+            handle_nas_msg(std::move(pdu), json_buffer, srsran::SECURITY_DIRECTION_UPLINK);
             break;
         }
         case ul_dcch_msg_type_c::c1_c_::types::rrc_setup_complete:
@@ -97,7 +108,7 @@ int decode_ul_dcch(uint8_t * buf, int n, asn1::json_writer & json_buffer)
             pdu->N_bytes = rrc_setup_complete.crit_exts.rrc_setup_complete().ded_nas_msg.size();
             memcpy(pdu->msg, rrc_setup_complete.crit_exts.rrc_setup_complete().ded_nas_msg.data(), pdu->N_bytes);
 
-            handle_nas_msg(std::move(pdu), json_buffer);
+            handle_nas_msg(std::move(pdu), json_buffer, srsran::SECURITY_DIRECTION_UPLINK);
             break;
         }
     }
@@ -10,6 +10,8 @@
 namespace UE
 {
     int decode_packet(uint8_t * buf, int n, asn1::json_writer & json_buffer);
+    // The payload of a datagram on the given channel, without the channel in front
+    int decode_sdu(uint32_t channel, uint8_t * sdu, int n, asn1::json_writer & json_buffer);
     int encode_packet(std::string json_buf, uint8_t * buf);
 }
 